@@ -0,0 +1,54 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/aot/cache.h - AOT compiled library cache definition ----------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the declaration of the Cache class, which keeps the AOT
+/// compiled libraries of the Wasm binaries in a directory by their contents.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "aot/compiler.h"
+#include "ast/module.h"
+#include "common/configure.h"
+#include "common/errcode.h"
+#include "common/filesystem.h"
+#include "common/span.h"
+
+#include <cstdint>
+#include <string>
+
+namespace SSVM {
+namespace AOT {
+
+class Cache {
+public:
+  /// The total size of the libraries in the directory is kept under the size.
+  Cache(const std::filesystem::path &Dir, const uint64_t MaxSize)
+      : Dir(Dir), MaxSize(MaxSize) {}
+
+  /// Get the compiled library of the Wasm binary, and compile the validated
+  /// module of the binary into the cache on a miss.
+  Expect<std::filesystem::path> get(Span<const Byte> Data,
+                                    const AST::Module &Module,
+                                    const Configure &Conf, Compiler &Compiler);
+
+  /// Get the path of the library in the cache without compiling.
+  std::filesystem::path getPath(Span<const Byte> Data, const Configure &Conf,
+                                const Compiler &Compiler) const;
+
+  /// Remove the least recently used libraries until the total size fits,
+  /// except the kept one.
+  void evict(const std::filesystem::path &Keep = {});
+
+private:
+  const std::filesystem::path Dir;
+  const uint64_t MaxSize;
+};
+
+} // namespace AOT
+} // namespace SSVM
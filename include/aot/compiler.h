@@ -14,7 +14,9 @@
 #include "ast/module.h"
 #include "common/errcode.h"
 #include "common/filesystem.h"
+#include <algorithm>
 #include <cstdint>
+#include <string>
 #include <string_view>
 
 namespace SSVM {
@@ -45,6 +47,10 @@ public:
 
   Expect<void> compile(Span<const Byte> Data, const AST::Module &Module,
                        std::filesystem::path OutputPath);
+  /// Compile the module in the memory by the ORC JIT instead of linking a
+  /// shared library, and set the compiled functions into the module. The
+  /// lazy JIT compiles the functions on their first calls through stubs.
+  Expect<void> compileJIT(AST::Module &Module, bool Lazy = false);
   void compile(const AST::ImportSection &ImportSection);
   void compile(const AST::ExportSection &ExportSection);
   void compile(const AST::TypeSection &TypeSection);
@@ -63,13 +69,29 @@ public:
     InstructionCounting = Value;
   }
   void setGasMeasuring(bool Value = true) { GasMeasuring = Value; }
+  /// Check the memory accesses against the memory size instead of relying on
+  /// the guard region, so the memory is allocated at its actual size.
+  void setBoundsChecking(bool Value = true) { BoundsChecking = Value; }
+  /// Split the module into partitions, which are optimized and generated on
+  /// the threads in parallel, and link them together.
+  void setJobs(uint32_t Value) { Jobs = std::max(Value, UINT32_C(1)); }
+
+  /// Get the string of the options and the host CPU which the generated code
+  /// depends on.
+  std::string getFingerprint() const;
 
 private:
+  /// Generate the IR of the module into the context. The Wasm binary is
+  /// embedded if not empty.
+  void generate(Span<const Byte> Data, const AST::Module &Module);
+
   CompileContext *Context = nullptr;
   bool DumpIR = false;
   OptimizationLevel Level = OptimizationLevel::O3;
   bool InstructionCounting = false;
   bool GasMeasuring = false;
+  bool BoundsChecking = false;
+  uint32_t Jobs = 1;
 };
 
 } // namespace AOT
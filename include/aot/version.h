@@ -16,7 +16,7 @@
 namespace SSVM {
 namespace AOT {
 
-static inline uint32_t kBinaryVersion [[maybe_unused]] = 1;
+static inline uint32_t kBinaryVersion [[maybe_unused]] = 5;
 
 } // namespace AOT
 } // namespace SSVM
@@ -40,6 +40,9 @@ public:
   /// Getter of instructions vector.
   InstrView getInstrs() const { return Instrs; }
 
+  /// Getter of mutable instructions vector.
+  InstrVec &getInstrs() { return Instrs; }
+
   /// Append instruction.
   void pushInstr(Instruction &&Instr) { Instrs.push_back(std::move(Instr)); }
   void pushInstr(const Instruction &Instr) { Instrs.emplace_back(Instr); }
@@ -12,6 +12,7 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <algorithm>
 #include <memory>
 #include <vector>
 
@@ -31,15 +32,65 @@ using InstrVec = std::vector<Instruction>;
 using InstrView = Span<const Instruction>;
 
 /// Instruction node class.
+///
+/// The instruction nodes are executed directly by the interpreter, so the
+/// immediates are packed into a union selected by the OpCode to keep a node in
+/// 32 bytes. The variable-length br_table labels and select value types are
+/// stored in side arrays owned by the node.
 class Instruction {
 public:
+  /// Branch target resolved in validation.
+  ///
+  /// Taking the branch erases the value stack entries in
+  /// [top - StackEraseBegin, top - StackEraseEnd) and moves the PC by
+  /// PCOffset, onto the End instruction of a block or the Loop instruction of
+  /// a loop. The execution continues at the next instruction.
+  struct JumpDescriptor {
+    uint32_t TargetIndex;
+    uint32_t StackEraseBegin;
+    uint32_t StackEraseEnd;
+    int32_t PCOffset;
+  };
+
   /// Constructor assigns the OpCode.
-  Instruction(const OpCode Byte, const uint32_t Off = 0)
+  Instruction(const OpCode Byte, const uint32_t Off = 0) noexcept
       : Code(Byte), Offset(Off) {}
   /// Copy constructor.
-  Instruction(const Instruction &Instr) = default;
+  Instruction(const Instruction &Instr) noexcept
+      : Code(Instr.Code), Offset(Instr.Offset), IsLast(Instr.IsLast),
+        Fused(Instr.Fused), BlockEntry(Instr.BlockEntry),
+        BlockCost(Instr.BlockCost), Data(Instr.Data) {
+    if (Code == OpCode::Br_table && Data.BrTable.LabelListSize > 0) {
+      Data.BrTable.LabelList = new JumpDescriptor[Data.BrTable.LabelListSize];
+      std::copy_n(Instr.Data.BrTable.LabelList, Data.BrTable.LabelListSize,
+                  Data.BrTable.LabelList);
+    } else if (Code == OpCode::Select_t && Data.SelectT.ValTypeListSize > 0) {
+      Data.SelectT.ValTypeList = new ValType[Data.SelectT.ValTypeListSize];
+      std::copy_n(Instr.Data.SelectT.ValTypeList, Data.SelectT.ValTypeListSize,
+                  Data.SelectT.ValTypeList);
+    }
+  }
+  /// Move constructor.
+  Instruction(Instruction &&Instr) noexcept
+      : Code(Instr.Code), Offset(Instr.Offset), IsLast(Instr.IsLast),
+        Fused(Instr.Fused), BlockEntry(Instr.BlockEntry),
+        BlockCost(Instr.BlockCost), Data(Instr.Data) {
+    if (Code == OpCode::Br_table) {
+      Instr.Data.BrTable.LabelList = nullptr;
+      Instr.Data.BrTable.LabelListSize = 0;
+    } else if (Code == OpCode::Select_t) {
+      Instr.Data.SelectT.ValTypeList = nullptr;
+      Instr.Data.SelectT.ValTypeListSize = 0;
+    }
+  }
 
-  ~Instruction() noexcept = default;
+  ~Instruction() noexcept {
+    if (Code == OpCode::Br_table) {
+      delete[] Data.BrTable.LabelList;
+    } else if (Code == OpCode::Select_t) {
+      delete[] Data.SelectT.ValTypeList;
+    }
+  }
 
   /// Binary loading from file manager.
   Expect<void> loadBinary(FileMgr &Mgr, const Configure &Conf);
@@ -50,56 +101,122 @@ public:
   /// Getter of Offset.
   uint32_t getOffset() const { return Offset; }
 
+  /// Getter and setter of the flag of the last End instruction in a function
+  /// body or an expression.
+  bool isLast() const { return IsLast; }
+  void setLast(const bool Last = true) { IsLast = Last; }
+
+  /// Getter and setter of the superinstruction starting at this instruction.
+  /// The following instructions covered by it are kept in place.
+  SuperOp getSuperOp() const { return Fused; }
+  void setSuperOp(const SuperOp Op) { Fused = Op; }
+
+  /// Getter and setter of the basic block starting at this instruction. The
+  /// cost is the sum of the instruction costs in the block, charged once on
+  /// entering it. kBlockCostOverflow marks a sum not fitting in 32 bits.
+  static inline constexpr const uint32_t kBlockCostOverflow = UINT32_MAX;
+  bool isBlockEntry() const { return BlockEntry; }
+  uint32_t getBlockCost() const { return BlockCost; }
+  void setBlock(const bool Entry, const uint32_t Cost = 0) {
+    BlockEntry = Entry;
+    BlockCost = Cost;
+  }
+
   /// Getter of block type.
-  BlockType getBlockType() const { return ResType; }
+  BlockType getBlockType() const { return Data.Blocks.ResType; }
 
   /// Getter and setter of jump count to End instruction.
-  uint32_t getJumpEnd() const { return JumpEnd; }
-  void setJumpEnd(const uint32_t Cnt) { JumpEnd = Cnt; }
+  uint32_t getJumpEnd() const { return Data.Blocks.JumpEnd; }
+  void setJumpEnd(const uint32_t Cnt) { Data.Blocks.JumpEnd = Cnt; }
 
   /// Getter and setter of jump count to Else instruction.
-  uint32_t getJumpElse() const { return JumpElse; }
-  void setJumpElse(const uint32_t Cnt) { JumpElse = Cnt; }
+  uint32_t getJumpElse() const { return Data.Blocks.JumpElse; }
+  void setJumpElse(const uint32_t Cnt) { Data.Blocks.JumpElse = Cnt; }
 
   /// Getter of reference type.
-  RefType getReferenceType() const { return ReferenceType; }
+  RefType getReferenceType() const { return Data.ReferenceType; }
+
+  /// Getter of branch target of br and br_if.
+  const JumpDescriptor &getJump() const { return Data.Jump; }
+  JumpDescriptor &getJump() { return Data.Jump; }
 
-  /// Getter of label list.
-  Span<const uint32_t> getLabelList() const { return LabelList; }
+  /// Getter of label list of br_table. The default label is the last one.
+  Span<const JumpDescriptor> getLabelList() const {
+    return Span<const JumpDescriptor>(Data.BrTable.LabelList,
+                                      Data.BrTable.LabelListSize);
+  }
+  Span<JumpDescriptor> getLabelList() {
+    return Span<JumpDescriptor>(Data.BrTable.LabelList,
+                                Data.BrTable.LabelListSize);
+  }
 
   /// Getter of selecting value types list.
-  Span<const ValType> getValTypeList() const { return ValTypeList; }
+  Span<const ValType> getValTypeList() const {
+    return Span<const ValType>(Data.SelectT.ValTypeList,
+                               Data.SelectT.ValTypeListSize);
+  }
 
   /// Getter of target index.
-  uint32_t getTargetIndex() const { return TargetIdx; }
+  uint32_t getTargetIndex() const { return Data.Indices.TargetIdx; }
 
   /// Getter of source index.
-  uint32_t getSourceIndex() const { return SourceIdx; }
+  uint32_t getSourceIndex() const { return Data.Indices.SourceIdx; }
 
   /// Getter of memory alignment.
-  uint32_t getMemoryAlign() const { return MemAlign; }
+  uint32_t getMemoryAlign() const { return Data.Memories.MemAlign; }
 
   /// Getter of memory offset.
-  uint32_t getMemoryOffset() const { return MemOffset; }
+  uint32_t getMemoryOffset() const { return Data.Memories.MemOffset; }
 
   /// Getter of the constant value.
-  ValVariant getNum() const { return Num; }
+  ValVariant getNum() const { return Data.Num; }
 
 private:
   /// OpCode of this instruction node.
   const OpCode Code;
   const uint32_t Offset;
-  BlockType ResType = ValType::None;
-  uint32_t JumpEnd = 0;
-  uint32_t JumpElse = 0;
-  RefType ReferenceType = RefType::FuncRef;
-  std::vector<uint32_t> LabelList;
-  std::vector<ValType> ValTypeList;
-  uint32_t TargetIdx = 0;
-  uint32_t SourceIdx = 0;
-  uint32_t MemAlign = 0;
-  uint32_t MemOffset = 0;
-  ValVariant Num = 0U;
+  bool IsLast = false;
+  SuperOp Fused = SuperOp::None;
+  bool BlockEntry = false;
+  uint32_t BlockCost = 0;
+  /// Immediates of this instruction node. Only the member selected by the
+  /// OpCode is valid.
+  union Inner {
+    Inner() noexcept : Num(uint128_t(0U)) {}
+    /// Block, Loop, If, and Else.
+    struct {
+      uint32_t JumpEnd;
+      uint32_t JumpElse;
+      BlockType ResType;
+    } Blocks;
+    /// Call, variable, table, and lane instructions. The br, br_if, and
+    /// br_table share the leading target index.
+    struct {
+      uint32_t TargetIdx;
+      uint32_t SourceIdx;
+    } Indices;
+    /// Br and Br_if.
+    JumpDescriptor Jump;
+    /// Br_table with the default label as the leading target index.
+    struct {
+      uint32_t TargetIdx;
+      uint32_t LabelListSize;
+      JumpDescriptor *LabelList;
+    } BrTable;
+    struct {
+      uint32_t ValTypeListSize;
+      ValType *ValTypeList;
+    } SelectT;
+    /// Memory load and store instructions.
+    struct {
+      uint32_t MemAlign;
+      uint32_t MemOffset;
+    } Memories;
+    /// Reference instructions.
+    RefType ReferenceType;
+    /// Const instructions.
+    ValVariant Num;
+  } Data;
 };
 
 /// Load OpCode from file manager.
@@ -122,5 +239,26 @@ Expect<OpCode> loadOpCode(FileMgr &Mgr, const Configure &Conf);
 /// \returns InstrVec if success, ErrCode when failed.
 Expect<InstrVec> loadInstrSeq(FileMgr &Mgr, const Configure &Conf);
 
+/// Find the basic block entries of instructions.
+///
+/// A block ends at a control instruction, and the execution continues at a new
+/// block, which covers the branch targets after the Loop and End instructions.
+/// The End instruction of an If without Else is also an entry, as the If jumps
+/// onto it.
+///
+/// \param Instrs the instructions of a function body or an expression.
+///
+/// \returns flags of the block entries indexed by the instructions.
+std::vector<bool> findBlockEntries(InstrView Instrs);
+
+/// Mark the instruction sequences in superop.inc on their first instruction.
+///
+/// Sequences are matched greedily from the front, longest first. The marks are
+/// written once into the validated module, and are copied with the
+/// instructions into the function instances.
+///
+/// \param Instrs the instructions of a function body.
+void fuseSuperInstructions(Span<Instruction> Instrs);
+
 } // namespace AST
 } // namespace SSVM
@@ -12,6 +12,7 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <map>
 #include <memory>
 #include <string>
 #include <string_view>
@@ -62,10 +63,24 @@ public:
   const DataSection &getDataSection() const { return DataSec; }
   const DataCountSection &getDataCountSection() const { return DataCountSec; }
 
+  /// Getter of mutable code section, whose instructions are annotated by the
+  /// validator.
+  CodeSection &getCodeSection() { return CodeSec; }
+
+  /// Getter of the compiled functions relying on the guard region of the
+  /// memory instead of checking the bounds.
+  bool needsGuardRegion() const noexcept { return GuardRegion; }
+
+  /// Getter of function names in the name section by function indices.
+  const std::map<uint32_t, std::string> &getFunctionNames() const {
+    return FuncNames;
+  }
+
   enum class Intrinsics : uint32_t {
     kTrap,
     kCall,
     kCallIndirect,
+    kCallIndirectCode,
     kMemCopy,
     kMemFill,
     kMemGrow,
@@ -81,6 +96,8 @@ public:
     kTableInit,
     kElemDrop,
     kRefFunc,
+    kProfileEnter,
+    kProfileLeave,
     kIntrinsicMax,
   };
   using IntrinsicsTable = void * [uint32_t(Intrinsics::kIntrinsicMax)];
@@ -89,6 +106,9 @@ public:
   const ASTNodeAttr NodeAttr = ASTNodeAttr::Module;
 
 private:
+  /// Load the function names subsection of the name section.
+  void loadFunctionNames(Span<const Byte> Content);
+
   /// \name Data of Module node.
   /// @{
   std::vector<Byte> Magic;
@@ -111,6 +131,12 @@ private:
   DataSection DataSec;
   DataCountSection DataCountSec;
   /// @}
+
+  /// Function names in the name section.
+  std::map<uint32_t, std::string> FuncNames;
+
+  /// Compiled functions without the bounds checks.
+  bool GuardRegion = false;
 };
 
 } // namespace AST
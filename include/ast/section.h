@@ -14,6 +14,8 @@
 
 #include <memory>
 #include <optional>
+#include <string>
+#include <string_view>
 #include <vector>
 
 #include "common/log.h"
@@ -91,6 +93,14 @@ protected:
 /// AST CustomSection node.
 class CustomSection : public Section {
 public:
+  /// Getter of name.
+  std::string_view getName() const { return Name; }
+
+  /// Getter of content vector, which follows the name.
+  Span<const Byte> getContent() const {
+    return Span<const Byte>(Content).subspan(NameSize);
+  }
+
   /// The node type should be ASTNodeAttr::Sec_Custom.
   const ASTNodeAttr NodeAttr = ASTNodeAttr::Sec_Custom;
 
@@ -99,8 +109,12 @@ protected:
   Expect<void> loadContent(FileMgr &Mgr, const Configure &Conf) override;
 
 private:
+  /// Name of custom section.
+  std::string Name;
   /// Vector of raw bytes of content.
   std::vector<Byte> Content;
+  /// Size of the encoded name in the content.
+  uint32_t NameSize = 0;
 };
 
 /// AST TypeSection node.
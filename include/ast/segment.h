@@ -34,6 +34,9 @@ public:
   /// Getter of locals vector.
   InstrView getInstrs() const { return Expr.getInstrs(); }
 
+  /// Getter of mutable instructions vector.
+  InstrVec &getInstrs() { return Expr.getInstrs(); }
+
 protected:
   /// Load binary from file manager.
   ///
@@ -135,6 +138,13 @@ public:
   /// Getter of locals vector.
   Span<const std::pair<uint32_t, ValType>> getLocals() const { return Locals; }
 
+  /// Getter and setter of the maximum height of operands, which is recorded
+  /// by the validator.
+  uint32_t getMaxStackHeight() const noexcept { return MaxStackHeight; }
+  void setMaxStackHeight(const uint32_t Height) noexcept {
+    MaxStackHeight = Height;
+  }
+
   /// Getter of compiled symbol.
   const auto &getSymbol() const noexcept { return Symbol; }
   /// Setter of compiled symbol.
@@ -148,6 +158,7 @@ private:
   /// @{
   uint32_t SegSize = 0;
   std::vector<std::pair<uint32_t, ValType>> Locals;
+  uint32_t MaxStackHeight = 0;
   /// @}
 
   Loader::Symbol<void> Symbol;
@@ -12,6 +12,8 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include "common/filesystem.h"
+
 #include <bitset>
 #include <cstdint>
 #include <initializer_list>
@@ -75,12 +77,83 @@ public:
 
   uint32_t getMaxMemoryPage() const noexcept { return MaxMemPage; }
 
+  void setMaxCallDepth(const uint32_t Depth) noexcept { MaxCallDepth = Depth; }
+
+  uint32_t getMaxCallDepth() const noexcept { return MaxCallDepth; }
+
+  void setValueStackSize(const uint32_t Size) noexcept {
+    ValueStackSize = Size;
+  }
+
+  uint32_t getValueStackSize() const noexcept { return ValueStackSize; }
+
+  void setRegisterTier(const bool Enable) noexcept { RegisterTier = Enable; }
+
+  bool isRegisterTier() const noexcept { return RegisterTier; }
+
+  void setGuardPageCheck(const bool Enable) noexcept {
+    GuardPageCheck = Enable;
+  }
+
+  bool isGuardPageCheck() const noexcept { return GuardPageCheck; }
+
+  /// Compile the Wasm modules in the memory by the JIT on instantiation
+  /// instead of interpreting them. The lazy JIT compiles the functions on
+  /// their first calls.
+  void setJIT(const bool Enable) noexcept { JIT = Enable; }
+
+  bool isJIT() const noexcept { return JIT; }
+
+  void setLazyJIT(const bool Enable) noexcept { LazyJIT = Enable; }
+
+  bool isLazyJIT() const noexcept { return LazyJIT; }
+
+  /// Directory of the cached AOT compiled libraries. The Wasm binaries are
+  /// compiled into the cache when loaded, and the cached libraries are loaded
+  /// instead. The least recently used libraries are evicted over the size.
+  void setAOTCache(const std::filesystem::path &Dir) { AOTCacheDir = Dir; }
+
+  const std::filesystem::path &getAOTCache() const noexcept {
+    return AOTCacheDir;
+  }
+
+  void setAOTCacheSize(const uint64_t Size) noexcept { AOTCacheSize = Size; }
+
+  uint64_t getAOTCacheSize() const noexcept { return AOTCacheSize; }
+
+  /// Statistics recorded by the interpreter. The execution without them runs
+  /// without any statistics overhead.
+  void setInstructionCounting(const bool Enable) noexcept {
+    InstrCounting = Enable;
+  }
+
+  bool isInstructionCounting() const noexcept { return InstrCounting; }
+
+  void setCostMeasuring(const bool Enable) noexcept { CostMeasuring = Enable; }
+
+  bool isCostMeasuring() const noexcept { return CostMeasuring; }
+
+  void setTimeMeasuring(const bool Enable) noexcept { TimeMeasuring = Enable; }
+
+  bool isTimeMeasuring() const noexcept { return TimeMeasuring; }
+
 private:
   void addSet(const Proposal P) noexcept { addProposal(P); }
   void addSet(const HostRegistration H) noexcept { addHostRegistration(H); }
   std::bitset<static_cast<uint8_t>(Proposal::Max)> Proposals;
   std::bitset<static_cast<uint8_t>(HostRegistration::Max)> Hosts;
   uint32_t MaxMemPage = 65536;
+  uint32_t MaxCallDepth = 65536;
+  uint32_t ValueStackSize = UINT32_C(1) << 22;
+  bool RegisterTier = false;
+  bool GuardPageCheck = false;
+  bool JIT = false;
+  bool LazyJIT = false;
+  std::filesystem::path AOTCacheDir;
+  uint64_t AOTCacheSize = UINT64_C(1) << 30;
+  bool InstrCounting = false;
+  bool CostMeasuring = false;
+  bool TimeMeasuring = false;
 };
 
 } // namespace SSVM
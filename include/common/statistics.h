@@ -16,19 +16,33 @@
 #include "span.h"
 #include "timer.h"
 
+#include <algorithm>
+#include <ostream>
+#include <string>
 #include <vector>
 
 namespace SSVM {
 namespace Statistics {
 
+/// Output formats of the execution profile.
+enum class ProfileFormat : uint8_t { JSON, CSV };
+
 class Statistics {
 public:
+  /// Profile of a function. The instruction count and time exclude the
+  /// functions called from it.
+  struct FunctionProfile {
+    uint64_t CallCnt = 0;
+    uint64_t InstrCnt = 0;
+    Timer::Timer::Clock::duration Time = Timer::Timer::Clock::duration::zero();
+  };
+
   Statistics(const uint64_t Lim = UINT64_MAX)
-      : CostTab(UINT16_MAX + 1, 1ULL), InstrCnt(0), CostLimit(Lim), CostSum(0) {
-  }
+      : CostTab(UINT16_MAX + 1, 1ULL), OpCnt(UINT16_MAX + 1, 0ULL),
+        InstrCnt(0), CostLimit(Lim), CostSum(0) {}
   Statistics(Span<const uint64_t> Tab, const uint64_t Lim = UINT64_MAX)
-      : CostTab(Tab.begin(), Tab.end()), InstrCnt(0), CostLimit(Lim),
-        CostSum(0) {
+      : CostTab(Tab.begin(), Tab.end()), CostTabSet(true),
+        OpCnt(UINT16_MAX + 1, 0ULL), InstrCnt(0), CostLimit(Lim), CostSum(0) {
     if (CostTab.size() < UINT16_MAX + 1) {
       CostTab.resize(UINT16_MAX + 1, 0ULL);
     }
@@ -47,15 +61,19 @@ public:
     return InstrCnt / std::chrono::duration<double>(getWasmExecTime()).count();
   }
 
-  /// Setter and setter of cost table.
+  /// Setter and getter of cost table. The interpreter sums the costs of the
+  /// basic blocks by the table, so the table is only replaced by the setter,
+  /// which bumps the table version. The entries are overwritten in place, as
+  /// the compiled functions keep the pointer to the table.
   void setCostTable(Span<const uint64_t> NewTable) {
-    CostTab.assign(NewTable.begin(), NewTable.end());
-    if (unlikely(CostTab.size() < UINT16_MAX + 1)) {
-      CostTab.resize(UINT16_MAX + 1, 0ULL);
-    }
+    const size_t Size = std::min(NewTable.size(), CostTab.size());
+    std::copy_n(NewTable.begin(), Size, CostTab.begin());
+    std::fill(CostTab.begin() + Size, CostTab.end(), 0ULL);
+    CostTabSet = true;
+    ++CostTabVersion;
   }
+  uint32_t getCostTableVersion() const noexcept { return CostTabVersion; }
   Span<const uint64_t> getCostTable() const noexcept { return CostTab; }
-  Span<uint64_t> getCostTable() noexcept { return CostTab; }
 
   /// Adder of instruction costs.
   bool addInstrCost(OpCode Code) { return addCost(CostTab[uint16_t(Code)]); }
@@ -71,6 +89,12 @@ public:
   void setCostLimit(uint64_t Lim) { CostLimit = Lim; }
   uint64_t getCostLimit() const { return CostLimit; }
 
+  /// Check whether a cost limit or a cost table is set, either of which turns
+  /// on the cost measuring without the configuration.
+  bool isCostMetered() const noexcept {
+    return CostTabSet || CostLimit != UINT64_MAX;
+  }
+
   /// Add cost and return false if exceeded limit.
   bool addCost(const uint64_t &Cost) {
     CostSum += Cost;
@@ -91,11 +115,60 @@ public:
     return false;
   }
 
+  /// Getter and setter of profiling mode, which records the counts of every
+  /// opcode and the profiles of every function.
+  void setProfiling(const bool Enable) noexcept { Profiling = Enable; }
+  bool isProfiling() const noexcept { return Profiling; }
+
+  /// Increment of opcode counter.
+  void incOpCount(OpCode Code) { ++OpCnt[uint16_t(Code)]; }
+
+  /// Getter of opcode counters, indexed by the opcode values.
+  Span<const uint64_t> getOpCounts() const noexcept { return OpCnt; }
+  Span<uint64_t> getOpCounts() noexcept { return OpCnt; }
+
+  /// Getter of function profiles, indexed by the function addresses.
+  Span<const FunctionProfile> getFunctionProfiles() const noexcept {
+    return FuncProf;
+  }
+
+  /// Record entering the function at the address.
+  void enterFunction(const uint32_t FuncAddr) {
+    chargeFunction();
+    if (FuncAddr >= FuncProf.size()) {
+      FuncProf.resize(FuncAddr + 1);
+    }
+    ++FuncProf[FuncAddr].CallCnt;
+    ProfStack.push_back(FuncAddr);
+  }
+
+  /// Record leaving the function on top of the profile stack.
+  void leaveFunction() {
+    chargeFunction();
+    if (!ProfStack.empty()) {
+      ProfStack.pop_back();
+    }
+  }
+
+  /// Leave all functions, such as the frames unwound by a trap.
+  void leaveAllFunctions() {
+    chargeFunction();
+    ProfStack.clear();
+  }
+
+  /// Write the profile. The function names are indexed by the function
+  /// addresses, and the functions without names are written as addresses.
+  void dumpProfile(std::ostream &OS, ProfileFormat Format,
+                   Span<const std::string> FuncNames) const;
+
   /// Clear measurement data for instructions.
   void clear() {
     TimeRecorder.reset();
     InstrCnt = 0;
     CostSum = 0;
+    std::fill(OpCnt.begin(), OpCnt.end(), 0ULL);
+    FuncProf.clear();
+    ProfStack.clear();
   }
 
   /// Start recording wasm time.
@@ -125,7 +198,28 @@ public:
   }
 
 private:
+  /// Charge the instructions and time since the last function event to the
+  /// function on top of the profile stack.
+  void chargeFunction() {
+    const auto Now = Timer::Timer::Clock::now();
+    if (!ProfStack.empty()) {
+      auto &Prof = FuncProf[ProfStack.back()];
+      Prof.InstrCnt += InstrCnt - LastInstrCnt;
+      Prof.Time += Now - LastTime;
+    }
+    LastInstrCnt = InstrCnt;
+    LastTime = Now;
+  }
+
   std::vector<uint64_t> CostTab;
+  bool CostTabSet = false;
+  uint32_t CostTabVersion = 0;
+  std::vector<uint64_t> OpCnt;
+  std::vector<FunctionProfile> FuncProf;
+  std::vector<uint32_t> ProfStack;
+  uint64_t LastInstrCnt = 0;
+  Timer::Timer::Clock::time_point LastTime;
+  bool Profiling = false;
   uint64_t InstrCnt;
   uint64_t CostLimit;
   uint64_t CostSum;
@@ -15,6 +15,7 @@
 #include "variant.h"
 
 #include <cstdint>
+#include <type_traits>
 #include <vector>
 
 namespace SSVM {
@@ -27,6 +28,13 @@ using ValVariant =
             FuncRef, ExternRef>;
 using Byte = uint8_t;
 
+/// A value is an untagged 16-byte slot. Validation guarantees the static type
+/// of every slot, so values are moved as raw bytes and read by typed access.
+static_assert(sizeof(ValVariant) == 16 && alignof(ValVariant) == 16,
+              "value must be a v128-capable 16-byte slot");
+static_assert(std::is_trivially_copyable_v<ValVariant>,
+              "value must be copied as raw bytes");
+
 /// Reference types helper functions.
 inline constexpr RefVariant genNullRef(const RefType Type) {
   return UINT64_C(0);
@@ -6,65 +6,83 @@
 #include "runtime/instance/memory.h"
 
 #include <cstdint>
+#include <cstring>
 
 namespace SSVM {
 namespace Interpreter {
 
-template <typename T>
+template <typename T, bool Guarded>
 TypeT<T> Interpreter::runLoadOp(Runtime::Instance::MemoryInstance &MemInst,
                                 const AST::Instruction &Instr,
                                 const uint32_t BitWidth) {
-  /// Calculate EA
+  /// Calculate EA. The 64-bit sum of the 32-bit operands cannot overflow.
   ValVariant &Val = StackMgr.getTop();
-  if (retrieveValue<uint32_t>(Val) >
-      std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    LOG(ERROR) << ErrCode::MemoryOutOfBounds;
-    LOG(ERROR) << ErrInfo::InfoBoundary(
-        retrieveValue<uint32_t>(Val) +
-            static_cast<uint64_t>(Instr.getMemoryOffset()),
-        BitWidth / 8, MemInst.getBoundIdx());
-    LOG(ERROR) << ErrInfo::InfoInstruction(Instr.getOpCode(),
-                                           Instr.getOffset());
-    return Unexpect(ErrCode::MemoryOutOfBounds);
+  const uint32_t Length = BitWidth / 8;
+  const uint64_t EA = static_cast<uint64_t>(retrieveValue<uint32_t>(Val)) +
+                      Instr.getMemoryOffset();
+
+  /// Check the bound cached in the instance context. The guarded accesses out
+  /// of bounds fault in the guard region instead.
+  if constexpr (!Guarded) {
+    if (unlikely(EA + Length > InstCtx.MemSize)) {
+      LOG(ERROR) << ErrCode::MemoryOutOfBounds;
+      LOG(ERROR) << ErrInfo::InfoBoundary(EA, Length, MemInst.getBoundIdx());
+      LOG(ERROR) << ErrInfo::InfoInstruction(Instr.getOpCode(),
+                                             Instr.getOffset());
+      return Unexpect(ErrCode::MemoryOutOfBounds);
+    }
   }
-  uint32_t EA = retrieveValue<uint32_t>(Val) + Instr.getMemoryOffset();
 
   /// Value = Mem.Data[EA : N / 8]
-  if (auto Res = MemInst.loadValue(retrieveValue<T>(Val), EA, BitWidth / 8);
-      !Res) {
-    LOG(ERROR) << ErrInfo::InfoInstruction(Instr.getOpCode(),
-                                           Instr.getOffset());
-    return Unexpect(Res);
+  const uint8_t *Ptr = InstCtx.MemData + EA;
+  if constexpr (std::is_floating_point_v<T>) {
+    std::memcpy(&retrieveValue<T>(Val), Ptr, sizeof(T));
+  } else if constexpr (sizeof(T) > 8) {
+    static_assert(sizeof(T) == 16);
+    T Value = 0;
+    std::memcpy(&Value, Ptr, Length);
+    retrieveValue<T>(Val) = Value;
+  } else {
+    uint64_t LoadVal = 0;
+    std::memcpy(&LoadVal, Ptr, Length);
+    if constexpr (std::is_signed_v<T>) {
+      /// Signed extend.
+      const uint32_t Shift = 64 - BitWidth;
+      LoadVal = static_cast<uint64_t>(static_cast<int64_t>(LoadVal << Shift) >>
+                                      Shift);
+    }
+    retrieveValue<T>(Val) = static_cast<T>(LoadVal);
   }
   return {};
 }
 
-template <typename T>
+template <typename T, bool Guarded>
 TypeN<T> Interpreter::runStoreOp(Runtime::Instance::MemoryInstance &MemInst,
                                  const AST::Instruction &Instr,
                                  const uint32_t BitWidth) {
   /// Pop the value t.const c from the Stack
-  T C = retrieveValue<T>(StackMgr.pop());
+  T C = StackMgr.popAs<T>();
 
   /// Calculate EA = i + offset
-  uint32_t I = retrieveValue<uint32_t>(StackMgr.pop());
-  if (I > std::numeric_limits<uint32_t>::max() - Instr.getMemoryOffset()) {
-    LOG(ERROR) << ErrCode::MemoryOutOfBounds;
-    LOG(ERROR) << ErrInfo::InfoBoundary(
-        I + static_cast<uint64_t>(Instr.getMemoryOffset()), BitWidth / 8,
-        MemInst.getBoundIdx());
-    LOG(ERROR) << ErrInfo::InfoInstruction(Instr.getOpCode(),
-                                           Instr.getOffset());
-    return Unexpect(ErrCode::MemoryOutOfBounds);
+  const uint32_t Length = BitWidth / 8;
+  const uint64_t EA =
+      static_cast<uint64_t>(StackMgr.popAs<uint32_t>()) +
+      Instr.getMemoryOffset();
+
+  /// Check the bound cached in the instance context. The guarded accesses out
+  /// of bounds fault in the guard region instead.
+  if constexpr (!Guarded) {
+    if (unlikely(EA + Length > InstCtx.MemSize)) {
+      LOG(ERROR) << ErrCode::MemoryOutOfBounds;
+      LOG(ERROR) << ErrInfo::InfoBoundary(EA, Length, MemInst.getBoundIdx());
+      LOG(ERROR) << ErrInfo::InfoInstruction(Instr.getOpCode(),
+                                             Instr.getOffset());
+      return Unexpect(ErrCode::MemoryOutOfBounds);
+    }
   }
-  uint32_t EA = I + Instr.getMemoryOffset();
 
   /// Store value to bytes.
-  if (auto Res = MemInst.storeValue(C, EA, BitWidth / 8); !Res) {
-    LOG(ERROR) << ErrInfo::InfoInstruction(Instr.getOpCode(),
-                                           Instr.getOffset());
-    return Unexpect(Res);
-  }
+  std::memcpy(InstCtx.MemData + EA, &C, Length);
   return {};
 }
 
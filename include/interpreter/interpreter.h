@@ -18,7 +18,11 @@
 #include "common/errcode.h"
 #include "common/statistics.h"
 #include "common/value.h"
+#include "interpreter/regir.h"
+#include "interpreter/sampler.h"
+#include "interpreter/tiering.h"
 #include "runtime/importobj.h"
+#include "runtime/snapshot.h"
 #include "runtime/stackmgr.h"
 #include "runtime/storemgr.h"
 
@@ -26,7 +30,9 @@
 #include <csetjmp>
 #include <csignal>
 #include <memory>
+#include <shared_mutex>
 #include <type_traits>
+#include <unordered_map>
 #include <vector>
 
 namespace SSVM {
@@ -84,13 +90,15 @@ using TypeNN =
 class Interpreter {
 public:
   Interpreter(const Configure &Conf, Statistics::Statistics *S = nullptr)
-      : Conf(Conf), Stat(S) {
+      : Conf(Conf),
+        StackMgr(Conf.getValueStackSize(), Conf.getMaxCallDepth()), Stat(S) {
     assert(This == nullptr);
     This = this;
     if (Stat) {
       ExecutionContext.InstrCount = &Stat->getInstrCountRef();
       ExecutionContext.CostTable = Stat->getCostTable().data();
       ExecutionContext.Gas = &Stat->getTotalCostRef();
+      ExecutionContext.OpCount = Stat->getOpCounts().data();
     }
   }
   ~Interpreter() noexcept { This = nullptr; }
@@ -99,6 +107,18 @@ public:
   Expect<void> instantiateModule(Runtime::StoreManager &StoreMgr,
                                  const AST::Module &Mod);
 
+  /// Instantiate Wasm Module as the anonymous active module from the snapshot
+  /// of its initialized instance. The initializations and the start function
+  /// are skipped.
+  Expect<void> instantiateModule(Runtime::StoreManager &StoreMgr,
+                                 const AST::Module &Mod,
+                                 const Runtime::Snapshot &Snap);
+
+  /// Take the snapshot of the memory, globals, tables, and segments of the
+  /// active module. The imported memories and tables are not supported.
+  Expect<std::unique_ptr<Runtime::Snapshot>>
+  snapshotModule(Runtime::StoreManager &StoreMgr);
+
   /// Register host module.
   Expect<void> registerModule(Runtime::StoreManager &StoreMgr,
                               const Runtime::ImportObject &Obj);
@@ -112,6 +132,13 @@ public:
                                          const uint32_t FuncAddr,
                                          Span<const ValVariant> Params);
 
+  /// Setter of the sampling profiler, which samples the invocations.
+  void setSampler(Sampler *S) noexcept { Samp = S; }
+
+  /// Setter of the tiering, which switches the hot functions to the compiled
+  /// code.
+  void setTiering(Tiering *T) noexcept { Tier = T; }
+
 private:
   /// Run Wasm bytecode expression for initialization.
   Expect<void> runExpression(Runtime::StoreManager &StoreMgr,
@@ -119,6 +146,7 @@ private:
 
   /// Run Wasm function.
   Expect<void> runFunction(Runtime::StoreManager &StoreMgr,
+                           const uint32_t FuncAddr,
                            const Runtime::Instance::FunctionInstance &Func,
                            Span<const ValVariant> Params);
 
@@ -127,11 +155,21 @@ private:
                        const AST::InstrView::iterator Start,
                        const AST::InstrView::iterator End);
 
+  /// Execute instructions. If GuardedMemory, the memory accesses are not
+  /// checked and rely on the guard regions to trap. The instructions are
+  /// counted if Count, and charged to the cost limit if Gas.
+  template <bool GuardedMemory, bool Count, bool Gas>
+  Expect<void> executeLoop(Runtime::StoreManager &StoreMgr,
+                           const AST::InstrView::iterator Start,
+                           const AST::InstrView::iterator End);
+
   /// \name Functions for instantiation.
   /// @{
-  /// Instantiation of Module Instance.
+  /// Instantiation of Module Instance. The instance is restored from Snap if
+  /// not null.
   Expect<void> instantiate(Runtime::StoreManager &StoreMgr,
-                           const AST::Module &Mod, std::string_view Name);
+                           const AST::Module &Mod, std::string_view Name,
+                           const Runtime::Snapshot *Snap = nullptr);
 
   /// Instantiation of Import Section.
   Expect<void> instantiate(Runtime::StoreManager &StoreMgr,
@@ -154,10 +192,12 @@ private:
                            Runtime::Instance::ModuleInstance &ModInst,
                            const AST::TableSection &TabSec);
 
-  /// Instantiation of Memory Instances.
+  /// Instantiation of Memory Instances. The guard regions are reserved only
+  /// if required.
   Expect<void> instantiate(Runtime::StoreManager &StoreMgr,
                            Runtime::Instance::ModuleInstance &ModInst,
-                           const AST::MemorySection &MemSec);
+                           const AST::MemorySection &MemSec,
+                           const bool Guard);
 
   /// Instantiation of Element Instances.
   Expect<void> instantiate(Runtime::StoreManager &StoreMgr,
@@ -183,27 +223,102 @@ private:
   Expect<void> instantiate(Runtime::StoreManager &StoreMgr,
                            Runtime::Instance::ModuleInstance &ModInst,
                            const AST::ExportSection &ExportSec);
+
+  /// Instantiation of Memory Instances from the pages of the snapshot. Fail
+  /// if the guard regions are required but not reserved.
+  Expect<void> restoreMemory(Runtime::StoreManager &StoreMgr,
+                             Runtime::Instance::ModuleInstance &ModInst,
+                             const AST::MemorySection &MemSec,
+                             const Runtime::Snapshot &Snap,
+                             const bool RequireGuard);
+
+  /// Restore the tables, globals, and segments from the snapshot.
+  Expect<void> restore(Runtime::StoreManager &StoreMgr,
+                       Runtime::Instance::ModuleInstance &ModInst,
+                       const Runtime::Snapshot &Snap);
+  /// @}
+
+  /// \name Functions for basic block gas metering.
+  /// @{
+  /// Mark the basic block entries with the summed costs of the blocks by the
+  /// statistics cost table. A block ends at a control instruction or before a
+  /// branch target, so it is entered only at the first instruction.
+  void markBasicBlocks(Span<AST::Instruction> Instrs) const;
+
+  /// Sum the block costs of all functions in the store again if the cost
+  /// table has been replaced since.
+  void updateBlockCosts(Runtime::StoreManager &StoreMgr);
+
+  /// Charge the instructions from PC to the end of the block one by one, for
+  /// the block whose cost overflows the 32 bits block cost and the constant
+  /// expressions not marked into blocks.
+  bool chargeLargeBlock(AST::InstrView::iterator PC) const;
+  /// @}
+
+  /// \name Functions for the register tier.
+  /// @{
+  /// Translate the function into register IR if not translated yet. Return
+  /// the translated body, or nullptr if the function cannot run on the
+  /// register tier.
+  const RegFunction *
+  prepareRegFunction(Runtime::StoreManager &StoreMgr, const uint32_t FuncAddr,
+                     const Runtime::Instance::FunctionInstance &Func);
+
+  /// Drop the register IR of the functions removed from the store, whose
+  /// addresses will be reused.
+  void pruneRegFunctions(const Runtime::StoreManager &StoreMgr);
+
+  /// Run function in register IR with the arguments on top of stack.
+  Expect<void>
+  runRegFunction(Runtime::StoreManager &StoreMgr, const uint32_t FuncAddr,
+                 const Runtime::Instance::FunctionInstance &Func,
+                 const RegFunction &RegFunc);
   /// @}
 
   /// \name Helper Functions for block controls.
   /// @{
   /// Helper function for calling functions. Return the continuation iterator.
   Expect<AST::InstrView::iterator>
-  enterFunction(Runtime::StoreManager &StoreMgr,
+  enterFunction(Runtime::StoreManager &StoreMgr, const uint32_t FuncAddr,
                 const Runtime::Instance::FunctionInstance &Func,
                 const AST::InstrView::iterator From);
 
-  /// Helper function for branching to label.
-  Expect<void> branchToLabel(Runtime::StoreManager &StoreMgr,
-                             const uint32_t Cnt, AST::InstrView::iterator &PC);
+  /// Helper function for counting the hotness of the function, and switching
+  /// it to the compiled code when hot. Return true if switched.
+  bool tierUpFunction(const uint32_t FuncAddr,
+                      const Runtime::Instance::FunctionInstance &Func);
+
+  /// Helper function for selecting the statistics recorded in the next run by
+  /// the configuration. Profiling needs the instruction counts, and a cost
+  /// limit or cost table set on the statistics needs the cost measuring.
+  void selectStatistics() noexcept {
+    CountInstr = Stat && (Conf.isInstructionCounting() || Stat->isProfiling());
+    MeasureCost = Stat && (Conf.isCostMeasuring() || Stat->isCostMetered());
+    MeasureTime = Stat && Conf.isTimeMeasuring();
+  }
 
-  /// Helper function for getting arity from block type.
-  std::pair<uint32_t, uint32_t> getBlockArity(Runtime::StoreManager &StoreMgr,
-                                              const BlockType &BType);
+  /// Helper function for recording leaving a function in the profile.
+  void leaveFunctionProfile() {
+    if (Stat && Stat->isProfiling()) {
+      Stat->leaveFunction();
+    }
+  }
+
+  /// Helper function for branching with the jump resolved in validation.
+  Expect<void> branchToLabel(Runtime::StoreManager &StoreMgr,
+                             const AST::Instruction::JumpDescriptor &Jump,
+                             AST::InstrView::iterator &PC);
   /// @}
 
   /// \name Helper Functions for getting instances.
   /// @{
+  /// Helper function for getting the function address of the indirect call
+  /// from compiled functions, which is checked against the function type.
+  Expect<uint32_t> getIndirectFuncAddr(Runtime::StoreManager &StoreMgr,
+                                       const uint32_t TableIndex,
+                                       const uint32_t FuncTypeIndex,
+                                       const uint32_t FuncIndex);
+
   /// Helper function for get table instance by index.
   Runtime::Instance::TableInstance *
   getTabInstByIdx(Runtime::StoreManager &StoreMgr, const uint32_t Idx);
@@ -223,19 +338,30 @@ private:
   /// Helper function for get data instance by index.
   Runtime::Instance::DataInstance *
   getDataInstByIdx(Runtime::StoreManager &StoreMgr, const uint32_t Idx);
+
+  /// Helper function for resolving the instance context of the top frame.
+  /// The globals and tables are resolved once per module instance and kept by
+  /// the module address, so switching modules only reloads the pointers and
+  /// the memory bound.
+  void updateInstanceContext(Runtime::StoreManager &StoreMgr);
+
+  /// Helper function for dropping the resolved instance context. Must be called
+  /// when the module addresses in store may be reused.
+  void resetInstanceContext();
+
+  /// Drop the resolved globals and tables of the modules removed from the
+  /// store, whose addresses will be reused.
+  void pruneModuleContexts(const Runtime::StoreManager &StoreMgr);
+
+  /// Helper function for reloading the memory of the compiled functions, which
+  /// may be moved or grown by the intrinsics.
+  void updateExecutionMemory() noexcept;
   /// @}
 
   /// \name Run instructions functions
   /// @{
   /// ======= Control instructions =======
-  Expect<void> runBlockOp(Runtime::StoreManager &StoreMgr,
-                          const AST::Instruction &Instr,
-                          AST::InstrView::iterator &PC);
-  Expect<void> runLoopOp(Runtime::StoreManager &StoreMgr,
-                         const AST::Instruction &Instr,
-                         AST::InstrView::iterator &PC);
-  Expect<void> runIfElseOp(Runtime::StoreManager &StoreMgr,
-                           const AST::Instruction &Instr,
+  Expect<void> runIfElseOp(const AST::Instruction &Instr,
                            AST::InstrView::iterator &PC);
   Expect<void> runBrOp(Runtime::StoreManager &StoreMgr,
                        const AST::Instruction &Instr,
@@ -246,21 +372,22 @@ private:
   Expect<void> runBrTableOp(Runtime::StoreManager &StoreMgr,
                             const AST::Instruction &Instr,
                             AST::InstrView::iterator &PC);
-  Expect<void> runReturnOp(AST::InstrView::iterator &PC);
+  Expect<void> runReturnOp(Runtime::StoreManager &StoreMgr,
+                           AST::InstrView::iterator &PC);
   Expect<void> runCallOp(Runtime::StoreManager &StoreMgr,
                          const AST::Instruction &Instr,
-                         AST::InstrView::iterator &PC);
+                         AST::InstrView::iterator &PC,
+                         const bool IsTailCall = false);
   Expect<void> runCallIndirectOp(Runtime::StoreManager &StoreMgr,
                                  const AST::Instruction &Instr,
-                                 AST::InstrView::iterator &PC);
+                                 AST::InstrView::iterator &PC,
+                                 const bool IsTailCall = false);
   /// ======= Variable instructions =======
   Expect<void> runLocalGetOp(const uint32_t Idx);
   Expect<void> runLocalSetOp(const uint32_t Idx);
   Expect<void> runLocalTeeOp(const uint32_t Idx);
-  Expect<void> runGlobalGetOp(Runtime::StoreManager &StoreMgr,
-                              const uint32_t Idx);
-  Expect<void> runGlobalSetOp(Runtime::StoreManager &StoreMgr,
-                              const uint32_t Idx);
+  Expect<void> runGlobalGetOp(const uint32_t Idx);
+  Expect<void> runGlobalSetOp(const uint32_t Idx);
   /// ======= Table instructions =======
   Expect<void> runTableGetOp(Runtime::Instance::TableInstance &TabInst,
                              const AST::Instruction &Instr);
@@ -278,11 +405,11 @@ private:
   Expect<void> runTableFillOp(Runtime::Instance::TableInstance &TabInst,
                               const AST::Instruction &Instr);
   /// ======= Memory instructions =======
-  template <typename T>
+  template <typename T, bool Guarded = false>
   TypeT<T> runLoadOp(Runtime::Instance::MemoryInstance &MemInst,
                      const AST::Instruction &Instr,
                      const uint32_t BitWidth = sizeof(T) * 8);
-  template <typename T>
+  template <typename T, bool Guarded = false>
   TypeN<T> runStoreOp(Runtime::Instance::MemoryInstance &MemInst,
                       const AST::Instruction &Instr,
                       const uint32_t BitWidth = sizeof(T) * 8);
@@ -463,6 +590,10 @@ public:
                             const uint32_t FuncTypeIndex,
                             const uint32_t FuncIndex, const ValVariant *Args,
                             ValVariant *Rets) noexcept;
+  Expect<void *> callIndirectCode(Runtime::StoreManager &StoreMgr,
+                                  const uint32_t TableIndex,
+                                  const uint32_t FuncTypeIndex,
+                                  const uint32_t FuncIndex) noexcept;
 
   Expect<uint32_t> memGrow(Runtime::StoreManager &StoreMgr,
                            const uint32_t NewSize) noexcept;
@@ -504,12 +635,40 @@ public:
   Expect<RefVariant> refFunc(Runtime::StoreManager &StoreMgr,
                              const uint32_t FuncIndex) noexcept;
 
+  /// Record entering and leaving functions of the profile from compiled
+  /// functions, which run without the signal handlers changed.
+  static void profileEnter(const uint32_t FuncIndex) noexcept;
+  static void profileLeave() noexcept;
+
   static void signalEnable() noexcept;
   static void signalDisable() noexcept;
   static void signalHandler(int Signal, siginfo_t *Siginfo, void *) noexcept;
+  static void guardSignalHandler(int Signal, siginfo_t *Siginfo,
+                                 void *) noexcept;
   struct SignalEnabler {
-    SignalEnabler() noexcept { Interpreter::signalEnable(); }
-    ~SignalEnabler() noexcept { Interpreter::signalDisable(); }
+    SignalEnabler() noexcept {
+      sigaction(SIGFPE, nullptr, &OldFPE);
+      sigaction(SIGSEGV, nullptr, &OldSEGV);
+      Interpreter::signalEnable();
+    }
+    ~SignalEnabler() noexcept {
+      sigaction(SIGFPE, &OldFPE, nullptr);
+      sigaction(SIGSEGV, &OldSEGV, nullptr);
+    }
+    struct sigaction OldFPE {};
+    struct sigaction OldSEGV {};
+  };
+
+  /// Trap the faults in the guard regions during guarded execution.
+  struct GuardSignalEnabler {
+    GuardSignalEnabler() noexcept {
+      struct sigaction Action {};
+      Action.sa_sigaction = &Interpreter::guardSignalHandler;
+      Action.sa_flags = SA_SIGINFO;
+      sigaction(SIGSEGV, &Action, &OldSEGV);
+    }
+    ~GuardSignalEnabler() noexcept { sigaction(SIGSEGV, &OldSEGV, nullptr); }
+    struct sigaction OldSEGV {};
   };
 
   struct SignalDisabler {
@@ -530,9 +689,14 @@ private:
     uint8_t *Memory;
     ValVariant *const *Globals;
     uint64_t *InstrCount;
-    uint64_t *CostTable;
+    const uint64_t *CostTable;
     uint64_t *Gas;
+    uint64_t *OpCount;
+    uint64_t CostLimit;
+    uint64_t MemorySize;
   } ExecutionContext;
+  /// Memory instance of the running compiled functions
+  Runtime::Instance::MemoryInstance *ExecutionMemory = nullptr;
   /// @}
 
 private:
@@ -546,6 +710,44 @@ private:
   Runtime::StackManager StackMgr;
   /// Interpreter statistics
   Statistics::Statistics *Stat;
+  /// Statistics recorded in the current run
+  bool CountInstr = false;
+  bool MeasureCost = false;
+  bool MeasureTime = false;
+  /// Cost table version of the block costs in the store
+  uint32_t BlockCostVersion = 0;
+  /// Sampling profiler
+  Sampler *Samp = nullptr;
+  /// Tiering of the hot functions
+  Tiering *Tier = nullptr;
+  /// Resolved instances of the module of the top frame
+  struct InstanceContext {
+    uint32_t ModAddr = UINT32_MAX;
+    Runtime::Instance::ModuleInstance *ModInst = nullptr;
+    Runtime::Instance::MemoryInstance *MemInst = nullptr;
+    uint8_t *MemData = nullptr;
+    uint64_t MemSize = 0;
+    Runtime::Instance::GlobalInstance *const *Globals = nullptr;
+    Runtime::Instance::TableInstance *const *Tables = nullptr;
+  } InstCtx;
+  /// Globals and tables of the module instances resolved on the first use by
+  /// the module addresses.
+  struct ModuleContext {
+    std::vector<Runtime::Instance::GlobalInstance *> Globals;
+    std::vector<Runtime::Instance::TableInstance *> Tables;
+  };
+  std::unordered_map<uint32_t, ModuleContext> ModContexts;
+  /// Caller frames of the register tier
+  struct RegCallInfo {
+    const RegFunction *Func;
+    const RegInstr *PC;
+    Runtime::Instance::MemoryInstance *MemInst;
+  };
+  std::vector<RegCallInfo> RegCallStack;
+  /// Register IR bodies translated on demand by the function addresses. The
+  /// null bodies mark the functions not supported by the register tier.
+  std::unordered_map<uint32_t, std::unique_ptr<RegFunction>> RegFuncs;
+  std::shared_mutex RegFuncsMutex;
 };
 
 } // namespace Interpreter
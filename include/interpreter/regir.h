@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/interpreter/regir.h - Register IR definition -----------------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the definition of the register-based IR which the
+/// interpreter translates validated function bodies into.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "ast/instruction.h"
+#include "common/astdef.h"
+#include "common/value.h"
+
+#include <cstdint>
+#include <vector>
+
+namespace SSVM {
+namespace Interpreter {
+
+/// Register IR instruction.
+///
+/// Registers are indices relative to the base of the current frame on the
+/// value stack. A frame is laid out as [params | locals | constants | slots],
+/// and the operand stack entry at depth D lives in register `SlotBase + D`.
+///
+/// An instruction keeps the Wasm opcode it was translated from, with its
+/// operands read from and its result written to registers. Control flow and
+/// data movement reuse the Wasm opcodes with these meanings:
+///   Nop:           No-op which only charges statistics.
+///   Local__set:    Register move, Dst = A.
+///   Br:            Jump to Imm.
+///   Br_if:         Jump to Imm if A is non-zero.
+///   If:            Jump to Imm if A is zero.
+///   Br_table:      Jump to JumpTable[Imm + min(A, B)], where B is the label
+///                  count and the entry at B is the default target.
+///   Return:        Copy B registers starting at A to the frame base, then
+///                  leave the frame.
+///   Call:          Call function address Imm with its frame starting at Dst.
+///   Call_indirect: Call through table C with index A, checked against
+///                  function type index Imm, with its frame starting at Dst.
+///   Select:        Dst = C ? A : B.
+///   Global__get:   Dst = value of global address Imm.
+///   Global__set:   Value of global address Imm = A.
+///   Loads:         Dst = memory[A + Imm].
+///   Stores:        memory[A + Imm] = B.
+struct RegInstr {
+  /// Translated Wasm opcode.
+  OpCode Code;
+  /// Count of Wasm instructions to charge to statistics before executing.
+  uint16_t ChargeCnt;
+  /// Start index of the charged opcodes in RegFunction::Charges.
+  uint32_t ChargeBegin;
+  /// Register operands.
+  uint32_t Dst;
+  uint32_t A;
+  uint32_t B;
+  uint32_t C;
+  /// Immediate: jump target, memory offset, or store address.
+  uint32_t Imm;
+  /// Index of the source instruction in the function body.
+  uint32_t SrcIdx;
+};
+
+/// Translated function body.
+struct RegFunction {
+  /// Register instructions.
+  std::vector<RegInstr> Instrs;
+  /// Initial values of locals followed by the constants, which are copied
+  /// into the registers right after the params on entering a frame.
+  std::vector<ValVariant> Init;
+  /// Targets of Br_table instructions.
+  std::vector<uint32_t> JumpTable;
+  /// Opcodes charged to statistics, referred by the register instructions.
+  std::vector<OpCode> Charges;
+  /// Source function body for trap information.
+  AST::InstrView Source;
+  /// Count of params, returns, and registers of a frame.
+  uint32_t ParamNum = 0;
+  uint32_t ReturnNum = 0;
+  uint32_t RegNum = 0;
+};
+
+} // namespace Interpreter
+} // namespace SSVM
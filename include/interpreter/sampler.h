@@ -0,0 +1,94 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/interpreter/sampler.h - Sampling profiler definition ---------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the declaration of the Sampler class, which samples the
+/// Wasm call stacks by the SIGPROF timer of the executing thread.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/defines.h"
+#include "common/span.h"
+#include "runtime/stackmgr.h"
+
+#include <csignal>
+#include <cstdint>
+#include <ctime>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace SSVM {
+namespace Interpreter {
+
+class Sampler {
+public:
+  /// Stacks deeper than this are truncated to the innermost frames.
+  static inline constexpr const uint32_t kMaxDepth = 256;
+
+  /// The tables of distinct stacks are allocated at construction, so no
+  /// memory is allocated in the signal handler. Samples of new stacks are
+  /// dropped when the tables are full.
+  Sampler(const uint32_t Hz = 1000, const uint32_t MaxStacks = 16384,
+          const uint32_t MaxFrames = 1U << 20);
+  ~Sampler() noexcept { stop(); }
+  Sampler(const Sampler &) = delete;
+  Sampler &operator=(const Sampler &) = delete;
+
+  /// Start sampling the frames of the stack manager by the CPU time of the
+  /// calling thread, which is the only thread signaled. Only one sampler can
+  /// run at a time.
+  bool start(const Runtime::StackManager &StackMgr) noexcept;
+
+  /// Stop sampling and restore the previous SIGPROF handler.
+  void stop() noexcept;
+
+  /// Getter of the counts of recorded and dropped samples, which are read
+  /// after stopping.
+  uint64_t getSampleCount() const noexcept { return SampleCnt; }
+  uint64_t getDroppedCount() const noexcept { return DroppedCnt; }
+
+  /// Write the samples as folded stacks, one line of the frames from the
+  /// outermost one separated by semicolons and the count per distinct stack.
+  /// The function names are indexed by the function addresses, and the
+  /// functions without names are written as addresses.
+  void dumpFolded(std::ostream &OS, Span<const std::string> FuncNames) const;
+
+private:
+  struct Entry {
+    uint64_t Hash;
+    uint32_t Offset;
+    uint32_t Depth;
+    uint64_t Count;
+  };
+
+  static void signalHandler(int Signal) noexcept;
+
+  /// Record the current stack. Called in the signal handler.
+  void record() noexcept;
+
+  /// The sampler running.
+  static Sampler *Active;
+
+  const uint32_t Interval;
+  const Runtime::StackManager *Stack = nullptr;
+  /// Open addressing table of the distinct stacks.
+  std::vector<Entry> Table;
+  /// Function addresses of the distinct stacks.
+  std::vector<uint32_t> Frames;
+  uint32_t FrameUsed = 0;
+  uint64_t SampleCnt = 0;
+  uint64_t DroppedCnt = 0;
+  struct sigaction OldAction {};
+#if SSVM_OS_LINUX
+  timer_t Timer{};
+#endif
+};
+
+} // namespace Interpreter
+} // namespace SSVM
@@ -0,0 +1,87 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/interpreter/tiering.h - Tiered execution definition ----------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the declaration of the Tiering class, which compiles the
+/// module in the background when its functions get hot and switches them to
+/// the compiled code.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "ast/module.h"
+#include "common/errcode.h"
+#include "common/filesystem.h"
+#include "loader/ldmgr.h"
+#include "runtime/instance/function.h"
+#include "runtime/instance/module.h"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <unordered_map>
+
+namespace SSVM {
+namespace Interpreter {
+
+class Tiering {
+public:
+  /// Compile the module into the shared library at the output path. Called on
+  /// the background thread.
+  using CompileFunc =
+      std::function<Expect<void>(const std::filesystem::path &OutputPath)>;
+
+  /// The calls and the loop back edges of a function count to the threshold.
+  Tiering(CompileFunc Func, const uint32_t Threshold = 1000)
+      : Compile(std::move(Func)), Threshold(Threshold) {}
+  ~Tiering() noexcept { wait(); }
+  Tiering(const Tiering &) = delete;
+  Tiering &operator=(const Tiering &) = delete;
+
+  /// Set the module instance of the functions to tier up, and the module
+  /// which the instance is instantiated from.
+  void attach(const AST::Module &Mod,
+              const Runtime::Instance::ModuleInstance &ModInst);
+
+  /// Getter of the hotness threshold.
+  uint32_t getThreshold() const noexcept { return Threshold; }
+
+  /// Switch the hot function to the compiled code if ready. The first call
+  /// starts compiling the module in the background. Called at the call
+  /// boundaries by the interpreter.
+  bool tierUp(const uint32_t FuncAddr,
+              const Runtime::Instance::FunctionInstance &Func);
+
+  /// Wait for the background compilation.
+  void wait() noexcept;
+
+  /// Getter of the compilation result, which is valid after waiting.
+  bool isCompiled() const noexcept { return State == StateType::Compiled; }
+  bool isFailed() const noexcept { return State == StateType::Failed; }
+
+private:
+  enum class StateType : uint8_t { Idle, Compiling, Compiled, Failed };
+
+  /// Compile and load the module. Run on the background thread.
+  void run() noexcept;
+
+  const CompileFunc Compile;
+  const uint32_t Threshold;
+  /// Code and type indices of the functions by addresses.
+  std::unordered_map<uint32_t, std::pair<uint32_t, uint32_t>> Entries;
+  /// Loaded library, written by the background thread before publishing the
+  /// compiled state.
+  LDMgr Library;
+  Loader::Symbol<void *[]> Codes;
+  Loader::Symbol<AST::FunctionType::Wrapper *[]> Types;
+  std::atomic<StateType> State = StateType::Idle;
+  std::thread Worker;
+};
+
+} // namespace Interpreter
+} // namespace SSVM
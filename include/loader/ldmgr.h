@@ -29,6 +29,11 @@ public:
   /// Set the file path.
   Expect<void> setPath(const std::filesystem::path &FilePath);
 
+  /// Set the library loaded in other ways, such as compiled in the memory.
+  void setLibrary(std::shared_ptr<Loader::SharedLibrary> Lib) noexcept {
+    Library = std::move(Lib);
+  }
+
   /// Read embedded Wasm binary.
   Expect<std::vector<Byte>> getWasm();
 
@@ -106,7 +106,7 @@ public:
 #endif
 
   SharedLibrary() noexcept = default;
-  ~SharedLibrary() noexcept { unload(); }
+  virtual ~SharedLibrary() noexcept { unload(); }
   Expect<void> load(const std::filesystem::path &Path) noexcept;
   void unload() noexcept;
 
@@ -115,8 +115,12 @@ public:
                      reinterpret_cast<T *>(getSymbolAddr(Name)));
   }
 
+protected:
+  /// Getter of the symbol address. Overridden by the libraries not loaded
+  /// from files, such as the code compiled in the memory.
+  virtual void *getSymbolAddr(const char *Name) const noexcept;
+
 private:
-  void *getSymbolAddr(const char *Name) const noexcept;
   NativeHandle Handle{};
 };
 
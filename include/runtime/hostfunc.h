@@ -37,6 +37,21 @@ public:
                            Span<const ValVariant> Args,
                            Span<ValVariant> Rets) = 0;
 
+  /// Run host function body on the value stack slots in place.
+  /// The arguments are read from Slots[0 : ArgsN - 1] and the returns are
+  /// written into Slots[0 : RetsN - 1], where Slots has room for both. An
+  /// override must read all the arguments before writing any return, and the
+  /// slots are only valid until the host function calls back into the VM.
+  /// The default implementation runs the body through run() with a copy of
+  /// the arguments.
+  virtual Expect<void> runInPlace(Instance::MemoryInstance *MemInst,
+                                  ValVariant *Slots) {
+    const size_t ArgsN = FuncType.Params.size();
+    const size_t RetsN = FuncType.Returns.size();
+    std::vector<ValVariant> Args(Slots, Slots + ArgsN);
+    return run(MemInst, Args, Span<ValVariant>(Slots, RetsN));
+  }
+
   /// Getter of function type.
   const Instance::FType &getFuncType() const { return FuncType; }
 
@@ -67,6 +82,15 @@ public:
     return invoke(MemInst, Args.first<F::ArgsN>(), Rets.first<F::RetsN>());
   }
 
+  Expect<void> runInPlace(Instance::MemoryInstance *MemInst,
+                          ValVariant *Slots) override {
+    /// The arguments are copied into the tuple before the body runs, so the
+    /// returns can overwrite them.
+    using F = FuncTraits<decltype(&T::body)>;
+    return invoke(MemInst, Span<const ValVariant, F::ArgsN>(Slots, F::ArgsN),
+                  Span<ValVariant, F::RetsN>(Slots, F::RetsN));
+  }
+
 protected:
   template <typename SpanA, typename SpanR>
   Expect<void> invoke(Instance::MemoryInstance *MemInst, SpanA &&Args,
@@ -102,6 +126,7 @@ protected:
       using RetsT = typename F::RetsT;
       pushRetType<RetsT>(std::make_index_sequence<F::RetsN>());
     }
+    FuncType.updateTypeID();
   }
 
 private:
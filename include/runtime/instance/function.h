@@ -16,6 +16,7 @@
 #include "runtime/hostfunc.h"
 
 #include <memory>
+#include <numeric>
 #include <string>
 #include <vector>
 
@@ -30,23 +31,25 @@ public:
   FunctionInstance() = delete;
   /// Move constructor.
   FunctionInstance(FunctionInstance &&Inst) noexcept
-      : ModuleAddr(Inst.ModuleAddr), FuncType(Inst.FuncType),
-        Data(std::move(Inst.Data)) {}
+      : ModuleAddr(Inst.ModuleAddr), TypeID(Inst.TypeID),
+        FuncType(Inst.FuncType), Data(std::move(Inst.Data)) {}
   /// Constructor for native function.
   FunctionInstance(const uint32_t ModAddr, const FType &Type,
                    Span<const std::pair<uint32_t, ValType>> Locs,
-                   AST::InstrView Expr) noexcept
-      : ModuleAddr(ModAddr), FuncType(Type),
-        Data(std::in_place_type_t<WasmFunction>(), Locs, Expr) {}
+                   AST::InstrView Expr, const uint32_t MaxStackHeight) noexcept
+      : ModuleAddr(ModAddr), TypeID(Type.TypeID), FuncType(Type),
+        Data(std::in_place_type_t<WasmFunction>(), Locs, Expr,
+             MaxStackHeight) {}
   /// Constructor for compiled function.
   FunctionInstance(const uint32_t ModAddr, const FType &Type,
                    Loader::Symbol<CompiledFunction> S) noexcept
-      : ModuleAddr(ModAddr), FuncType(Type),
+      : ModuleAddr(ModAddr), TypeID(Type.TypeID), FuncType(Type),
         Data(std::in_place_type_t<Loader::Symbol<CompiledFunction>>(),
              std::move(S)) {}
   /// Constructor for host function. Module address will not be used.
   FunctionInstance(std::unique_ptr<HostFunctionBase> &&Func) noexcept
-      : ModuleAddr(0), FuncType(Func->getFuncType()),
+      : ModuleAddr(0), TypeID(Func->getFuncType().TypeID),
+        FuncType(Func->getFuncType()),
         Data(std::in_place_type_t<std::unique_ptr<HostFunctionBase>>(),
              std::move(Func)) {}
 
@@ -73,11 +76,20 @@ public:
   /// Getter of function type.
   const FType &getFuncType() const { return FuncType; }
 
+  /// Getter of canonical type ID of the function type.
+  uint32_t getTypeID() const { return TypeID; }
+
   /// Getter of function local variables.
   Span<const std::pair<uint32_t, ValType>> getLocals() const noexcept {
     return std::get_if<WasmFunction>(&Data)->Locals;
   }
 
+  /// Getter of the value stack entries used over the arguments, which are the
+  /// locals and the operands.
+  uint32_t getStackSize() const noexcept {
+    return std::get_if<WasmFunction>(&Data)->StackSize;
+  }
+
   /// Getter of function body instrs.
   AST::InstrView getInstrs() const noexcept {
     if (std::holds_alternative<WasmFunction>(Data)) {
@@ -87,6 +99,50 @@ public:
     }
   }
 
+  /// Getter of function body instrs for updating the annotations of the
+  /// interpreter, such as the basic block costs.
+  Span<AST::Instruction> getMutableInstrs() const noexcept {
+    if (auto *Func = std::get_if<WasmFunction>(&Data)) {
+      return Func->Instrs;
+    }
+    return {};
+  }
+
+  /// Add the hotness counted by the calls and the loop back edges, and return
+  /// the new hotness.
+  uint32_t addHotness(const uint32_t N) const noexcept {
+    if (auto *Func = std::get_if<WasmFunction>(&Data)) {
+      return Func->Hotness += N;
+    }
+    return 0;
+  }
+
+  /// Getter of checking the function has been switched to compiled code.
+  bool isTiered() const noexcept {
+    if (auto *Func = std::get_if<WasmFunction>(&Data)) {
+      return static_cast<bool>(Func->TieredCode);
+    }
+    return false;
+  }
+
+  /// Getter of the compiled code and its wrapper switched to by tiering.
+  const auto &getTieredCode() const noexcept {
+    return std::get_if<WasmFunction>(&Data)->TieredCode;
+  }
+  const auto &getTieredWrapper() const noexcept {
+    return std::get_if<WasmFunction>(&Data)->TieredWrapper;
+  }
+
+  /// Setter of the compiled code to run instead of the body. The body is kept
+  /// for the frames still running it.
+  void setTieredCode(Loader::Symbol<AST::FunctionType::Wrapper> Wrapper,
+                     Loader::Symbol<CompiledFunction> Code) const noexcept {
+    if (auto *Func = std::get_if<WasmFunction>(&Data)) {
+      Func->TieredWrapper = std::move(Wrapper);
+      Func->TieredCode = std::move(Code);
+    }
+  }
+
   /// Getter of symbol
   const auto getSymbol() const noexcept {
     return *std::get_if<Loader::Symbol<CompiledFunction>>(&Data);
@@ -100,15 +156,25 @@ public:
 private:
   struct WasmFunction {
     const std::vector<std::pair<uint32_t, ValType>> Locals;
-    const AST::InstrVec Instrs;
+    mutable AST::InstrVec Instrs;
+    const uint32_t StackSize;
+    /// Calls and loop back edges counted for tiering.
+    mutable uint32_t Hotness = 0;
+    /// Compiled code switched to by tiering.
+    mutable Loader::Symbol<AST::FunctionType::Wrapper> TieredWrapper;
+    mutable Loader::Symbol<CompiledFunction> TieredCode;
     WasmFunction(Span<const std::pair<uint32_t, ValType>> Locs,
-                 AST::InstrView Expr) noexcept
-        : Locals(Locs.begin(), Locs.end()), Instrs(Expr.begin(), Expr.end()) {}
+                 AST::InstrView Expr, const uint32_t MaxStackHeight) noexcept
+        : Locals(Locs.begin(), Locs.end()), Instrs(Expr.begin(), Expr.end()),
+          StackSize(std::accumulate(
+              Locs.begin(), Locs.end(), MaxStackHeight,
+              [](uint32_t N, const auto &L) { return N + L.first; })) {}
   };
 
   /// \name Data of function instance.
   /// @{
   const uint32_t ModuleAddr;
+  const uint32_t TypeID;
   const FType &FuncType;
   std::variant<WasmFunction, Loader::Symbol<CompiledFunction>,
                std::unique_ptr<HostFunctionBase>>
@@ -17,91 +17,161 @@
 #include "common/span.h"
 #include "common/types.h"
 #include "common/value.h"
+#include "runtime/mempool.h"
 
 #include <algorithm>
 #include <cstdint>
 #include <cstring>
-#include <fstream>
 #include <memory>
-#include <set>
 #include <utility>
 
 #include <linux/mman.h>
 #include <sys/mman.h>
+#include <unistd.h>
 
 namespace SSVM {
 namespace Runtime {
 namespace Instance {
 
 class MemoryInstance {
-private:
-  static uintptr_t getUsableAddress() {
-    /// Parse smaps for available memory region
-    std::set<std::pair<uintptr_t, uintptr_t>> Regions;
-    std::ifstream Smaps("/proc/self/smaps");
-    for (std::string Line; std::getline(Smaps, Line);) {
-      if (std::isdigit(Line.front()) || std::islower(Line.front())) {
-        char *Cursor = nullptr;
-        const uintptr_t Begin = std::strtoull(Line.c_str(), &Cursor, 16);
-        const uintptr_t End = std::strtoull(++Cursor, &Cursor, 16);
-        Regions.emplace(Begin, End);
-      }
-    }
-    for (auto Prev = Regions.cbegin(), Next = std::next(Prev);
-         Next != Regions.cend(); ++Prev, ++Next) {
-      if (Next->first - Prev->second >= k12G) {
-        const auto PaddedBegin = (Prev->second + kPageMask) & ~kPageMask;
-        if (Next->first - PaddedBegin >= k12G) {
-          return PaddedBegin + k4G;
-        }
-      }
-    }
-    return UINT64_C(-1);
-  }
-
 public:
   static inline constexpr const uint64_t kPageSize = UINT64_C(65536);
   static inline constexpr const uint64_t kPageMask = UINT64_C(65535);
   static inline constexpr const uint64_t k4G = UINT64_C(0x100000000);
   static inline constexpr const uint64_t k8G = UINT64_C(0x200000000);
-  static inline constexpr const uint64_t k12G = k4G + k8G;
+  /// Size of the address window reserved after the data pointer. Any address
+  /// of a 32-bit base, a 32-bit offset, and an access of at most 16 bytes lies
+  /// in the window, so an out of bounds access hits the guard region.
+  static inline constexpr const uint64_t kGuardWindow = k8G + kPageSize;
+  /// Number of the guard windows reserved at once by the memory pool.
+  static inline constexpr const uint32_t kPoolRegionSlots = 16;
   MemoryInstance() = delete;
   MemoryInstance(MemoryInstance &&Inst) noexcept
       : HasMaxPage(Inst.HasMaxPage), MinPage(Inst.MinPage),
         MaxPage(Inst.MaxPage), DataPtr(Inst.DataPtr),
-        PageLimit(Inst.PageLimit) {
+        PageLimit(Inst.PageLimit), HasGuard(Inst.HasGuard),
+        FilePage(Inst.FilePage) {
     Inst.DataPtr = nullptr;
   }
-  MemoryInstance(const AST::Limit &Lim, const uint32_t PageLim = 65536)
+  /// Reserve the guard window for the compiled functions relying on it, or
+  /// map the pages only at their actual size, which may move on growing.
+  MemoryInstance(const AST::Limit &Lim, const uint32_t PageLim = 65536,
+                 const bool Reserve = true)
       : HasMaxPage(Lim.hasMax()), MinPage(Lim.getMin()), MaxPage(Lim.getMax()),
         PageLimit(PageLim) {
-    const auto UsableAddress = getUsableAddress();
-    if (UsableAddress == UINT64_C(-1)) {
-      LOG(ERROR) << "Unable to find usable memory address";
+    if (MinPage > PageLimit) {
+      LOG(ERROR)
+          << "Create memory instance failed -- exceeded limit page size: "
+          << PageLimit;
       return;
     }
+
+    /// Take the whole window from the pool as the guard region and make the
+    /// pages accessible. Fall back to map the pages only when the address
+    /// space is not enough.
+    if (Reserve) {
+      DataPtr = getPool().acquire();
+      HasGuard = DataPtr != nullptr;
+    }
+    if (MinPage != 0) {
+      if (HasGuard) {
+        if (mprotect(DataPtr, MinPage * kPageSize, PROT_READ | PROT_WRITE) !=
+            0) {
+          LOG(ERROR) << "mprotect failed";
+          getPool().release(DataPtr, 0);
+          DataPtr = nullptr;
+          return;
+        }
+      } else if (void *Ptr = mmap(nullptr, MinPage * kPageSize,
+                                  PROT_READ | PROT_WRITE,
+                                  MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+                 Ptr != MAP_FAILED) {
+        DataPtr = reinterpret_cast<uint8_t *>(Ptr);
+      } else {
+        LOG(ERROR) << "mmap failed";
+        return;
+      }
+    }
+  }
+  /// Map the pages of the snapshot file privately in the guard window, so the
+  /// pages are shared until written. Fall back to copy the pages when the
+  /// address space is not enough, unless the guard region is required. The
+  /// data pointer is null on failure.
+  MemoryInstance(const AST::Limit &Lim, const uint32_t Pages, const int Fd,
+                 const uint32_t PageLim, const bool RequireGuard)
+      : HasMaxPage(Lim.hasMax()), MinPage(Pages), MaxPage(Lim.getMax()),
+        PageLimit(PageLim) {
     if (MinPage > PageLimit) {
       LOG(ERROR)
           << "Create memory instance failed -- exceeded limit page size: "
           << PageLimit;
       return;
     }
-    DataPtr = reinterpret_cast<uint8_t *>(UsableAddress);
-    if (MinPage != 0) {
-      if ((mmap(DataPtr, MinPage * kPageSize, PROT_READ | PROT_WRITE,
-                MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0)) ==
-          MAP_FAILED) {
+
+    DataPtr = getPool().acquire();
+    HasGuard = DataPtr != nullptr;
+    if (!HasGuard && RequireGuard) {
+      LOG(ERROR) << "Create memory instance failed -- no guard region";
+      return;
+    }
+    if (MinPage == 0) {
+      return;
+    }
+    if (HasGuard) {
+      if (mmap(DataPtr, MinPage * kPageSize, PROT_READ | PROT_WRITE,
+               MAP_PRIVATE | MAP_FIXED, Fd, 0) == MAP_FAILED) {
         LOG(ERROR) << "mmap failed";
+        getPool().release(DataPtr, 0);
+        DataPtr = nullptr;
+        return;
+      }
+      FilePage = MinPage;
+      return;
+    }
+    void *Ptr = mmap(nullptr, MinPage * kPageSize, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (Ptr == MAP_FAILED) {
+      LOG(ERROR) << "mmap failed";
+      return;
+    }
+    DataPtr = reinterpret_cast<uint8_t *>(Ptr);
+    for (uint64_t Done = 0; Done < MinPage * kPageSize;) {
+      const ssize_t Size =
+          pread(Fd, DataPtr + Done, MinPage * kPageSize - Done, Done);
+      if (Size <= 0) {
+        LOG(ERROR) << "pread failed";
+        munmap(DataPtr, MinPage * kPageSize);
+        DataPtr = nullptr;
         return;
       }
+      Done += Size;
     }
   }
   ~MemoryInstance() noexcept {
-    if (DataPtr) {
+    if (DataPtr && HasGuard) {
+      /// Dropping the file-backed pages reloads them from the file, so replace
+      /// the mapping by the anonymous one before recycling the window.
+      if (FilePage > 0) {
+        mmap(DataPtr, FilePage * kPageSize, PROT_NONE,
+             MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE | MAP_FIXED, -1, 0);
+      }
+      getPool().release(DataPtr, MinPage * kPageSize);
+    } else if (DataPtr) {
       munmap(DataPtr, MinPage * kPageSize);
     }
   }
 
+  /// Getter of the pool of the guard windows, which is never destroyed as the
+  /// memory instances may be destroyed later at exit.
+  static MemoryPool &getPool() noexcept {
+    static MemoryPool *Pool = new MemoryPool(kGuardWindow, kPoolRegionSlots);
+    return *Pool;
+  }
+
+  /// Getter of the guard region. If true, any access in
+  /// [DataPtr, DataPtr + kGuardWindow) out of the pages raises SIGSEGV.
+  bool hasGuardRegion() const noexcept { return HasGuard; }
+
   /// Get page size of memory.data
   uint32_t getDataPageSize() const noexcept { return MinPage; }
 
@@ -144,14 +214,22 @@ public:
                  << PageLimit;
       return false;
     }
-    if (MinPage == 0) {
-      if (mmap(DataPtr, Count * kPageSize, PROT_READ | PROT_WRITE,
-               MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED, -1, 0) == MAP_FAILED) {
+    if (HasGuard) {
+      if (mprotect(DataPtr + MinPage * kPageSize, Count * kPageSize,
+                   PROT_READ | PROT_WRITE) != 0) {
         return false;
       }
-    } else if (mremap(DataPtr, MinPage * kPageSize,
-                      (MinPage + Count) * kPageSize, 0) == MAP_FAILED) {
-      return false;
+    } else {
+      /// Without the guard region, the pages may move to fit the new size.
+      void *Ptr = MinPage == 0
+                      ? mmap(nullptr, Count * kPageSize, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0)
+                      : mremap(DataPtr, MinPage * kPageSize,
+                               (MinPage + Count) * kPageSize, MREMAP_MAYMOVE);
+      if (Ptr == MAP_FAILED) {
+        return false;
+      }
+      DataPtr = reinterpret_cast<uint8_t *>(Ptr);
     }
     MinPage += Count;
     return true;
@@ -373,6 +451,9 @@ private:
   const uint32_t MaxPage;
   uint8_t *DataPtr = nullptr;
   const uint32_t PageLimit;
+  bool HasGuard = false;
+  /// Number of the pages mapped from the snapshot file.
+  uint32_t FilePage = 0;
   /// @}
 };
 
@@ -19,12 +19,17 @@
 #include <map>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <vector>
 
 namespace SSVM {
 namespace Runtime {
 namespace Instance {
 
+class GlobalInstance;
+class MemoryInstance;
+class TableInstance;
+
 class ModuleInstance {
 public:
   ModuleInstance(std::string_view Name) : ModName(Name) {}
@@ -86,6 +91,17 @@ public:
   uint32_t getMemImportNum() const { return ImpMemNum; }
   uint32_t getGlobalImportNum() const { return ImpGlobalNum; }
 
+  /// Getter and setter of function names by function indices.
+  void setFuncNames(const std::map<uint32_t, std::string> &Names) {
+    FuncNames = Names;
+  }
+  std::string_view getFuncName(const uint32_t Idx) const {
+    if (auto It = FuncNames.find(Idx); It != FuncNames.end()) {
+      return It->second;
+    }
+    return {};
+  }
+
   /// Get export maps.
   const std::map<std::string, uint32_t, std::less<>> &getFuncExports() const {
     return ExpFuncs;
@@ -179,7 +195,7 @@ public:
 
   /// \name Data for compiled functions.
   /// @{
-  uint8_t *MemoryPtr;
+  MemoryInstance *MemoryInst;
   std::vector<ValVariant *> GlobalsPtr;
   /// @}
 
@@ -210,6 +226,9 @@ private:
   std::map<std::string, uint32_t, std::less<>> ExpMems;
   std::map<std::string, uint32_t, std::less<>> ExpGlobals;
 
+  /// Function names in the name section.
+  std::map<uint32_t, std::string> FuncNames;
+
   /// Start function address
   bool HasStartFunc = false;
   uint32_t StartAddr;
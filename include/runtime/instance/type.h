@@ -22,14 +22,18 @@ namespace SSVM {
 namespace Runtime {
 namespace Instance {
 
+/// Intern the function signature into a process-wide canonical type ID. Equal
+/// signatures get the same ID, so comparing function types is comparing IDs.
+uint32_t getCanonicalTypeID(Span<const ValType> P, Span<const ValType> R);
+
 /// Function type definition in this module.
 struct FType {
   using Wrapper = AST::FunctionType::Wrapper;
 
-  FType() = default;
+  FType() : TypeID(getCanonicalTypeID({}, {})) {}
   FType(Span<const ValType> P, Span<const ValType> R, Loader::Symbol<Wrapper> S)
       : Params(P.begin(), P.end()), Returns(R.begin(), R.end()),
-        Symbol(std::move(S)) {}
+        Symbol(std::move(S)), TypeID(getCanonicalTypeID(P, R)) {}
 
   friend bool operator==(const FType &LHS, const FType &RHS) noexcept {
     return LHS.Params == RHS.Params && LHS.Returns == RHS.Returns;
@@ -42,10 +46,16 @@ struct FType {
   /// Getter of symbol
   const auto &getSymbol() const noexcept { return Symbol; }
 
+  /// Intern the signature again after filling the Params and Returns.
+  void updateTypeID() { TypeID = getCanonicalTypeID(Params, Returns); }
+
   std::vector<ValType> Params;
   std::vector<ValType> Returns;
 
   Loader::Symbol<Wrapper> Symbol;
+
+  /// Canonical type ID of the signature.
+  uint32_t TypeID;
 };
 
 } // namespace Instance
@@ -0,0 +1,88 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/runtime/mempool.h - Memory slot pool definition --------------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the definition of the memory pool, which hands out the
+/// reserved address ranges of the linear memories.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include <sys/mman.h>
+
+namespace SSVM {
+namespace Runtime {
+
+/// Pool of fixed-stride slots in the large PROT_NONE regions reserved at once.
+/// The slots are reset and recycled after released, so no address space is
+/// searched or mapped at the fixed addresses when instantiating.
+class MemoryPool {
+public:
+  MemoryPool(const uint64_t SlotSize, const uint32_t SlotsPerRegion) noexcept
+      : SlotSize(SlotSize), SlotsPerRegion(SlotsPerRegion) {}
+  MemoryPool(const MemoryPool &) = delete;
+  MemoryPool &operator=(const MemoryPool &) = delete;
+
+  /// Acquire an inaccessible slot. Return nullptr if the address space is
+  /// exhausted.
+  uint8_t *acquire() noexcept {
+    std::lock_guard Lock(Mutex);
+    if (FreeSlots.empty() && !reserve(SlotsPerRegion) && !reserve(1)) {
+      return nullptr;
+    }
+    uint8_t *Slot = FreeSlots.back();
+    FreeSlots.pop_back();
+    return Slot;
+  }
+
+  /// Release the slot with the first bytes used. The used pages are dropped,
+  /// so they are zero-filled when accessible again.
+  void release(uint8_t *Slot, const uint64_t UsedSize) noexcept {
+    if (UsedSize > 0) {
+      madvise(Slot, UsedSize, MADV_DONTNEED);
+      mprotect(Slot, UsedSize, PROT_NONE);
+    }
+    std::lock_guard Lock(Mutex);
+    FreeSlots.push_back(Slot);
+  }
+
+  /// Getter of the number of the reserved slots.
+  uint64_t getSlotNum() const noexcept {
+    std::lock_guard Lock(Mutex);
+    return SlotNum;
+  }
+
+private:
+  /// Reserve a region of the slots. The regions are kept until the process
+  /// exits.
+  bool reserve(const uint32_t Count) noexcept {
+    void *Ptr = mmap(nullptr, SlotSize * Count, PROT_NONE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (Ptr == MAP_FAILED) {
+      return false;
+    }
+    /// Hand out the lower slots first.
+    for (uint32_t I = Count; I > 0; --I) {
+      FreeSlots.push_back(static_cast<uint8_t *>(Ptr) + SlotSize * (I - 1));
+    }
+    SlotNum += Count;
+    return true;
+  }
+
+  const uint64_t SlotSize;
+  const uint32_t SlotsPerRegion;
+  mutable std::mutex Mutex;
+  std::vector<uint8_t *> FreeSlots;
+  uint64_t SlotNum = 0;
+};
+
+} // namespace Runtime
+} // namespace SSVM
@@ -0,0 +1,60 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/runtime/snapshot.h - Instance snapshot definition ------------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the definition of the snapshot of an initialized module
+/// instance, which new instances are created from without initializing.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "ast/module.h"
+#include "common/value.h"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include <unistd.h>
+
+namespace SSVM {
+namespace Runtime {
+
+class Snapshot {
+public:
+  Snapshot() = default;
+  Snapshot(const Snapshot &) = delete;
+  Snapshot &operator=(const Snapshot &) = delete;
+  ~Snapshot() noexcept {
+    if (MemoryFd >= 0) {
+      close(MemoryFd);
+    }
+  }
+
+  /// Validated module of the instance, which is shared by the instances
+  /// created from the snapshot.
+  std::shared_ptr<AST::Module> Module;
+
+  /// File of the pages of the defined memory, or -1 without the memory. The
+  /// instances map the file privately, so the pages are shared until written.
+  int MemoryFd = -1;
+  uint32_t MemoryPages = 0;
+
+  /// Values of the defined globals.
+  std::vector<ValVariant> Globals;
+
+  /// References of the defined tables. The function references are the
+  /// function indices in the module instead of the addresses in the store.
+  std::vector<std::vector<RefVariant>> Tables;
+
+  /// Dropped states of the element and data segments.
+  std::vector<bool> DroppedElements;
+  std::vector<bool> DroppedData;
+};
+
+} // namespace Runtime
+} // namespace SSVM
@@ -11,11 +11,15 @@
 //===----------------------------------------------------------------------===//
 #pragma once
 
+#include <algorithm>
+#include <atomic>
 #include <cassert>
-#include <optional>
-#include <vector>
+#include <new>
+#include <sys/mman.h>
+#include <unistd.h>
 
 #include "ast/instruction.h"
+#include "common/log.h"
 #include "common/span.h"
 #include "common/value.h"
 
@@ -24,157 +28,199 @@ namespace Runtime {
 
 class StackManager {
 public:
-  struct Label {
-    Label() = delete;
-    Label(const uint32_t S, const uint32_t A, AST::InstrView::iterator FromIt,
-          std::optional<AST::InstrView::iterator> ContIt)
-        : VStackOff(S), Arity(A), From(FromIt), Cont(ContIt) {}
-    uint32_t VStackOff;
-    uint32_t Arity;
-    AST::InstrView::iterator From;
-    std::optional<AST::InstrView::iterator> Cont;
-  };
+  /// Function address of the frames not in functions.
+  static inline constexpr const uint32_t kNoFunction = UINT32_MAX;
 
   struct Frame {
     Frame() = delete;
-    Frame(const uint32_t Addr, const uint32_t VS, const uint32_t LS,
-          const uint32_t A, const bool Dummy = false)
-        : ModAddr(Addr), VStackOff(VS), LStackOff(LS), Arity(A),
-          IsDummy(Dummy) {}
+    Frame(const uint32_t Addr, const uint32_t VS, const uint32_t A,
+          AST::InstrView::iterator FromIt, const bool Dummy = false,
+          const uint32_t Func = kNoFunction)
+        : ModAddr(Addr), VStackOff(VS), Arity(A), FuncAddr(Func),
+          From(FromIt), IsDummy(Dummy) {}
     uint32_t ModAddr;
     uint32_t VStackOff;
-    uint32_t LStackOff;
     uint32_t Arity;
+    uint32_t FuncAddr;
+    AST::InstrView::iterator From;
     bool IsDummy;
   };
 
   using Value = ValVariant;
 
+  /// Frames reserved over the call depth limit for the dummy frames and the
+  /// frames of instantiation and constant expressions.
+  static inline constexpr const uint32_t kFrameSlack = 8;
+  /// Values reserved over the capacity for the constant expressions.
+  static inline constexpr const uint32_t kValueSlack = 64;
+
   /// Stack manager provides the stack control for Wasm execution with VALIDATED
   /// modules. All operations of instructions passed validation, therefore no
   /// unexpect operations will occur.
-  StackManager() {
-    ValueStack.reserve(2048U);
-    LabelStack.reserve(64U);
-    FrameStack.reserve(16U);
-  };
-  ~StackManager() = default;
+  ///
+  /// The value stack and the frame stack are reserved at once in a region with
+  /// a guard page after each of them, so they never reallocate. The callers
+  /// check isReserved() before using the stacks, which fails if the region
+  /// cannot be mapped, and hasCapacity() before entering a function frame.
+  StackManager(const uint32_t ValueNum = UINT32_C(1) << 22,
+               const uint32_t FrameNum = UINT32_C(65536)) noexcept {
+    const size_t PageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    auto RoundUp = [PageSize](size_t Size) {
+      return (Size + PageSize - 1) / PageSize * PageSize;
+    };
+    const size_t ValueBytes =
+        RoundUp((static_cast<size_t>(ValueNum) + kValueSlack) * sizeof(Value));
+    const size_t FrameBytes =
+        RoundUp((static_cast<size_t>(FrameNum) + kFrameSlack) * sizeof(Frame));
+    RegionSize = ValueBytes + PageSize + FrameBytes + PageSize;
+    void *Ptr = mmap(nullptr, RegionSize, PROT_READ | PROT_WRITE,
+                     MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (Ptr == MAP_FAILED) {
+      LOG(ERROR) << "mmap failed";
+      RegionSize = 0;
+      return;
+    }
+    Region = static_cast<uint8_t *>(Ptr);
+    mprotect(Region + ValueBytes, PageSize, PROT_NONE);
+    mprotect(Region + RegionSize - PageSize, PageSize, PROT_NONE);
+
+    ValueBase = ValueTop = reinterpret_cast<Value *>(Region);
+    ValueLimit = ValueBase + ValueNum;
+    FrameBase = FrameTop =
+        reinterpret_cast<Frame *>(Region + ValueBytes + PageSize);
+    /// The dummy frame of the invocation is not counted in the call depth.
+    FrameLimit = FrameBase + FrameNum + 1;
+  }
+  StackManager(const StackManager &) = delete;
+  StackManager &operator=(const StackManager &) = delete;
+  ~StackManager() noexcept {
+    if (Region) {
+      munmap(Region, RegionSize);
+    }
+  }
 
   /// Getter of stack size.
-  size_t size() const { return ValueStack.size(); }
+  size_t size() const { return static_cast<size_t>(ValueTop - ValueBase); }
+
+  /// Check that the stacks are reserved.
+  bool isReserved() const noexcept { return Region != nullptr; }
+
+  /// Check that a new frame using N more values fits in the limits.
+  bool hasCapacity(const size_t N) const noexcept {
+    return Region != nullptr && FrameTop < FrameLimit &&
+           static_cast<size_t>(ValueLimit - ValueTop) >= N;
+  }
 
   /// Unsafe Getter of top entry of stack.
-  Value &getTop() { return ValueStack.back(); }
+  Value &getTop() { return ValueTop[-1]; }
 
   /// Unsafe Getter of bottom N-th value entry of stack.
-  Value &getBottomN(uint32_t N) { return ValueStack[N]; }
+  Value &getBottomN(uint32_t N) { return ValueBase[N]; }
 
   /// Unsafe Getter of top N value entries of stack.
-  Span<Value> getTopSpan(uint32_t N) {
-    return Span<Value>(ValueStack.end() - N, N);
-  }
+  Span<Value> getTopSpan(uint32_t N) { return Span<Value>(ValueTop - N, N); }
 
   /// Push a new value entry to stack.
   template <typename T> void push(T &&Val) {
-    ValueStack.push_back(std::forward<T>(Val));
+    new (ValueTop++) Value(std::forward<T>(Val));
   }
 
   /// Unsafe Pop and return the top entry.
-  Value pop() {
-    Value V = std::move(ValueStack.back());
-    ValueStack.pop_back();
-    return V;
+  Value pop() { return *--ValueTop; }
+
+  /// Unsafe Getter of top entry of stack in the validated type.
+  template <typename T> T &getTopAs() { return retrieveValue<T>(getTop()); }
+
+  /// Unsafe Pop and return the top entry in the validated type. Only the
+  /// bytes of the type are read from the slot.
+  template <typename T> T popAs() { return retrieveValue<T>(*--ValueTop); }
+
+  /// Unsafe resize of the value stack. The register tier uses it to reserve
+  /// the registers of the top frame and to drop the dead ones.
+  void resize(const size_t N) {
+    Value *NewTop = ValueBase + N;
+    for (; ValueTop < NewTop; ++ValueTop) {
+      new (ValueTop) Value();
+    }
+    ValueTop = NewTop;
   }
 
-  /// Push a new frame entry to stack.
+  /// Push a new frame entry to stack. The frame is written before it is
+  /// exposed to the signal handlers reading the frames.
   void pushFrame(const uint32_t ModuleAddr, const uint32_t LocalNum = 0,
-                 const uint32_t ArityNum = 0) {
-    FrameStack.emplace_back(ModuleAddr, ValueStack.size() - LocalNum,
-                            LabelStack.size(), ArityNum);
+                 const uint32_t ArityNum = 0,
+                 AST::InstrView::iterator From = {},
+                 const uint32_t FuncAddr = kNoFunction) {
+    new (FrameTop) Frame(ModuleAddr, static_cast<uint32_t>(size()) - LocalNum,
+                         ArityNum, From, false, FuncAddr);
+    std::atomic_signal_fence(std::memory_order_release);
+    ++FrameTop;
   }
 
-  /// Push a dummy frame for invokation base.
-  void pushDummyFrame() {
-    FrameStack.emplace_back(0, ValueStack.size(), LabelStack.size(), 0, true);
+  /// Getter of the frames from the bottom.
+  Span<const Frame> getFrames() const noexcept {
+    return Span<const Frame>(FrameBase, FrameTop - FrameBase);
   }
 
-  /// Unsafe pop top frame.
-  void popFrame() {
-    assert(LabelStack.size() >= FrameStack.back().LStackOff);
-    LabelStack.erase(LabelStack.begin() + FrameStack.back().LStackOff,
-                     LabelStack.end());
-    assert(ValueStack.size() >=
-           FrameStack.back().VStackOff + FrameStack.back().Arity);
-    ValueStack.erase(ValueStack.begin() + FrameStack.back().VStackOff,
-                     ValueStack.end() - FrameStack.back().Arity);
-    FrameStack.pop_back();
+  /// Push a dummy frame for invokation base.
+  void pushDummyFrame() {
+    new (FrameTop++) Frame(0, static_cast<uint32_t>(size()), 0,
+                           AST::InstrView::iterator{}, true);
   }
 
-  /// Push a new label entry to stack.
-  void pushLabel(const uint32_t LocalNum, const uint32_t ArityNum,
-                 AST::InstrView::iterator From,
-                 std::optional<AST::InstrView::iterator> Cont = std::nullopt) {
-    LabelStack.emplace_back(ValueStack.size() - LocalNum, ArityNum, From, Cont);
+  /// Unsafe pop top frame and return the continuation instruction.
+  AST::InstrView::iterator popFrame() {
+    const Frame &F = FrameTop[-1];
+    assert(size() >= F.VStackOff + F.Arity);
+    ValueTop = std::copy(ValueTop - F.Arity, ValueTop, ValueBase + F.VStackOff);
+    return (--FrameTop)->From;
   }
 
-  /// Unsafe pop top label.
-  AST::InstrView::iterator popLabel(const uint32_t Cnt = 1) {
-    const auto &L = getLabelWithCount(Cnt - 1);
-    ValueStack.erase(ValueStack.begin() + L.VStackOff,
-                     ValueStack.end() - L.Arity);
-    auto It = L.From;
-    for (uint32_t I = 0; I < Cnt; ++I) {
-      LabelStack.pop_back();
-    }
-    return It;
+  /// Unsafe pop top frame for a tail call and return its continuation. The
+  /// top N entries are kept as the arguments of the callee, which takes the
+  /// place of the frame and returns to the continuation.
+  AST::InstrView::iterator popFrameForTailCall(const uint32_t N) {
+    const Frame &F = FrameTop[-1];
+    assert(size() >= F.VStackOff + N);
+    ValueTop = std::copy(ValueTop - N, ValueTop, ValueBase + F.VStackOff);
+    return (--FrameTop)->From;
   }
 
-  /// Unsafe leave top label.
-  AST::InstrView::iterator leaveLabel() {
-    auto It = LabelStack.back().From;
-    LabelStack.pop_back();
-    if (FrameStack.size() > 1 &&
-        FrameStack.back().LStackOff == LabelStack.size()) {
-      /// Noted that there's always a base frame in stack.
-      popFrame();
-    }
-    return It;
+  /// Unsafe erase value entries in [top - EraseBegin, top - EraseEnd) for
+  /// branching.
+  void stackErase(const uint32_t EraseBegin, const uint32_t EraseEnd) {
+    assert(EraseEnd <= EraseBegin && EraseBegin <= size());
+    ValueTop = std::copy(ValueTop - EraseEnd, ValueTop, ValueTop - EraseBegin);
   }
 
   /// Unsafe getter of module address.
-  uint32_t getModuleAddr() const { return FrameStack.back().ModAddr; }
+  uint32_t getModuleAddr() const { return FrameTop[-1].ModAddr; }
 
   /// Unsafe getter for stack offset of local values by index.
   uint32_t getOffset(uint32_t Idx) const {
-    return FrameStack.back().VStackOff + Idx;
-  }
-
-  /// Unsafe getter of the top count of label which index start from 0.
-  const Label &getLabelWithCount(const uint32_t Count) const {
-    return LabelStack[LabelStack.size() - Count - 1];
-  }
-
-  /// Unsafe getter of the bottom label on the top frame.
-  const Label &getBottomLabel() const {
-    return LabelStack[FrameStack.back().LStackOff];
+    return FrameTop[-1].VStackOff + Idx;
   }
 
   /// Unsafe checker of top frame is a dummy frame.
-  bool isTopDummyFrame() { return FrameStack.back().IsDummy; }
+  bool isTopDummyFrame() { return FrameTop[-1].IsDummy; }
 
   /// Reset stack.
   void reset() {
-    ValueStack.clear();
-    LabelStack.clear();
-    FrameStack.clear();
+    ValueTop = ValueBase;
+    FrameTop = FrameBase;
   }
 
 private:
   /// \name Data of stack manager.
   /// @{
-  std::vector<Value> ValueStack;
-  std::vector<Label> LabelStack;
-  std::vector<Frame> FrameStack;
+  uint8_t *Region = nullptr;
+  size_t RegionSize = 0;
+  Value *ValueBase = nullptr;
+  Value *ValueTop = nullptr;
+  Value *ValueLimit = nullptr;
+  Frame *FrameBase = nullptr;
+  Frame *FrameTop = nullptr;
+  Frame *FrameLimit = nullptr;
   /// @}
 };
 
@@ -18,7 +18,7 @@
 #include "instance/memory.h"
 #include "instance/module.h"
 #include "instance/table.h"
-
+#include <algorithm>
 #include <memory>
 #include <type_traits>
 #include <vector>
@@ -167,6 +167,24 @@ public:
     return getInstance(Addr, DataInsts);
   }
 
+  /// Get all function instances in the store, indexed by the addresses.
+  Span<Instance::FunctionInstance *const> getFunctions() const noexcept {
+    return FuncInsts;
+  }
+
+  /// Get all module instances in the store, indexed by the addresses.
+  Span<Instance::ModuleInstance *const> getModules() const noexcept {
+    return ModInsts;
+  }
+
+  /// Check that every memory instance reserved its guard region.
+  bool isAllMemoryGuarded() const noexcept {
+    return std::all_of(MemInsts.cbegin(), MemInsts.cend(),
+                       [](const Instance::MemoryInstance *MemInst) {
+                         return MemInst->hasGuardRegion();
+                       });
+  }
+
   /// Get exported instances of instantiated module.
   const std::map<std::string, uint32_t, std::less<>> getFuncExports() const {
     if (NumMod > 0) {
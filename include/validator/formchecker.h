@@ -54,6 +54,10 @@ public:
   Expect<void> validate(AST::InstrView Instrs, Span<const ValType> RetVals);
   Expect<void> validate(AST::InstrView Instrs, Span<const VType> RetVals);
 
+  /// Write the branch targets resolved in the last validation into the
+  /// instructions validated.
+  void writeJumps(Span<AST::Instruction> Instrs) const;
+
   /// Adder of contexts
   void addType(const AST::FunctionType &Func);
   void addFunc(const uint32_t TypeIdx, const bool IsImport = false);
@@ -74,6 +78,9 @@ public:
   auto &getGlobals() { return Globals; }
   uint32_t getNumImportFuncs() const { return NumImportFuncs; }
   uint32_t getNumImportGlobals() const { return NumImportGlobals; }
+  uint32_t getMaxStackHeight() const {
+    return static_cast<uint32_t>(MaxHeight);
+  }
 
   /// Helper function
   VType ASTToVType(const ValType &V);
@@ -85,16 +92,20 @@ public:
     CtrlFrame() = default;
     CtrlFrame(struct CtrlFrame &&F)
         : StartTypes(std::move(F.StartTypes)), EndTypes(std::move(F.EndTypes)),
-          Height(F.Height), IsUnreachable(F.IsUnreachable), Code(F.Code) {}
+          Jump(F.Jump), Height(F.Height), IsUnreachable(F.IsUnreachable),
+          Code(F.Code) {}
     CtrlFrame(const struct CtrlFrame &F)
-        : StartTypes(F.StartTypes), EndTypes(F.EndTypes), Height(F.Height),
-          IsUnreachable(F.IsUnreachable), Code(F.Code) {}
-    CtrlFrame(Span<const VType> In, Span<const VType> Out, size_t H,
+        : StartTypes(F.StartTypes), EndTypes(F.EndTypes), Jump(F.Jump),
+          Height(F.Height), IsUnreachable(F.IsUnreachable), Code(F.Code) {}
+    CtrlFrame(Span<const VType> In, Span<const VType> Out,
+              const AST::Instruction *J, size_t H,
               OpCode Op = OpCode::Unreachable)
         : StartTypes(In.begin(), In.end()), EndTypes(Out.begin(), Out.end()),
-          Height(H), IsUnreachable(false), Code(Op) {}
+          Jump(J), Height(H), IsUnreachable(false), Code(Op) {}
     std::vector<VType> StartTypes;
     std::vector<VType> EndTypes;
+    /// Branch target instruction: the End of a block or the Loop of a loop.
+    const AST::Instruction *Jump;
     size_t Height;
     bool IsUnreachable;
     OpCode Code;
@@ -117,11 +128,15 @@ private:
   Expect<VType> popType(VType E);
   Expect<void> popTypes(Span<const VType> Input);
   void pushCtrl(Span<const VType> In, Span<const VType> Out,
+                const AST::Instruction *Jump,
                 OpCode Code = OpCode::Unreachable);
   Expect<CtrlFrame> popCtrl();
   Span<const VType> getLabelTypes(const CtrlFrame &F);
+  void addJump(const AST::Instruction &Instr, const uint32_t LabelIdx,
+               const uint32_t TargetIndex, const CtrlFrame &F);
   Expect<void> unreachable();
   Expect<void> StackTrans(Span<const VType> Take, Span<const VType> Put);
+  Expect<void> checkTailCall(Span<const VType> Take, Span<const VType> Put);
 
   /// Helper functions
   Expect<std::pair<Span<const VType>, Span<const VType>>>
@@ -144,6 +159,18 @@ private:
   /// Running stack.
   std::vector<CtrlFrame> CtrlStack;
   std::vector<VType> ValStack;
+  /// Maximum height of the value stack.
+  size_t MaxHeight = 0;
+
+  /// Branch targets resolved, which are written into the instructions by
+  /// writeJumps().
+  struct ResolvedJump {
+    uint32_t InstrIdx;
+    uint32_t LabelIdx;
+    AST::Instruction::JumpDescriptor Jump;
+  };
+  std::vector<ResolvedJump> Jumps;
+  const AST::Instruction *ExprBegin = nullptr;
 };
 
 } // namespace Validator
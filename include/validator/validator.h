@@ -28,8 +28,9 @@ public:
   Validator(const Configure &Conf) noexcept : Conf(Conf) {}
   ~Validator() = default;
 
-  /// Validate AST::Module.
-  Expect<void> validate(const AST::Module &Mod);
+  /// Validate AST::Module. The instructions of the function bodies are
+  /// annotated with the branch targets resolved in validation.
+  Expect<void> validate(AST::Module &Mod);
 
 private:
   /// Validate AST::Types
@@ -41,8 +42,7 @@ private:
   /// Validate AST::Segments
   Expect<void> validate(const AST::GlobalSegment &GlobSeg);
   Expect<void> validate(const AST::ElementSegment &ElemSeg);
-  Expect<void> validate(const AST::CodeSegment &CodeSeg,
-                        const uint32_t TypeIdx);
+  Expect<void> validate(AST::CodeSegment &CodeSeg, const uint32_t TypeIdx);
   Expect<void> validate(const AST::DataSegment &DataSeg);
 
   /// Validate AST::Desc
@@ -56,7 +56,7 @@ private:
   Expect<void> validate(const AST::MemorySection &MemSec);
   Expect<void> validate(const AST::GlobalSection &GlobSec);
   Expect<void> validate(const AST::ElementSection &ElemSec);
-  Expect<void> validate(const AST::CodeSection &CodeSec);
+  Expect<void> validate(AST::CodeSection &CodeSec);
   Expect<void> validate(const AST::DataSection &DataSec);
   Expect<void> validate(const AST::StartSection &StartSec);
   Expect<void> validate(const AST::ExportSection &ExportSec);
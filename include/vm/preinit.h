@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: Apache-2.0
+//===-- ssvm/vm/preinit.h - Pre-initialized module writer definition ------===//
+//
+// Part of the SSVM Project.
+//
+//===----------------------------------------------------------------------===//
+///
+/// \file
+/// This file contains the definition of rewriting the Wasm binary into the
+/// module which starts from the initialized state.
+///
+//===----------------------------------------------------------------------===//
+#pragma once
+
+#include "common/errcode.h"
+#include "common/span.h"
+#include "common/types.h"
+#include "runtime/snapshot.h"
+
+#include <string_view>
+#include <vector>
+
+namespace SSVM {
+namespace VM {
+
+/// Rewrite the Wasm binary of the snapshot module into the module which starts
+/// from the snapshot. The memory becomes the active data segments, the globals
+/// become the constants, and the start function and the export of the
+/// initializer are removed, so the initialization is skipped when loaded.
+///
+/// The tables and the element segments are kept as in the binary, so they
+/// must be the same as in Base, which is the snapshot of the module without
+/// the start function. See removeStart().
+Expect<std::vector<Byte>> preinitialize(Span<const Byte> Code,
+                                        const Runtime::Snapshot &Base,
+                                        const Runtime::Snapshot &Snap,
+                                        std::string_view InitFunc);
+
+/// Remove the start section from the Wasm binary, so the instance is taken as
+/// Base before the start function changes the tables.
+Expect<std::vector<Byte>> removeStart(Span<const Byte> Code);
+
+} // namespace VM
+} // namespace SSVM
@@ -22,6 +22,7 @@
 #include "validator/validator.h"
 
 #include "runtime/importobj.h"
+#include "runtime/snapshot.h"
 #include "runtime/storemgr.h"
 
 #include <cstdint>
@@ -82,7 +83,15 @@ public:
                                           std::string_view Func,
                                           Span<const ValVariant> Params = {});
 
+  /// Take the snapshot of the instantiated module, which new instances are
+  /// created from by instantiate(Snap).
+  Expect<std::shared_ptr<const Runtime::Snapshot>> snapshot();
+
   /// ======= Functions which are stageless. =======
+  /// Instantiate the module of the snapshot with the copy-on-write memory,
+  /// instead of loading, validating, and initializing it.
+  Expect<void> instantiate(const Runtime::Snapshot &Snap);
+
   /// Clean up VM status
   void cleanup();
 
@@ -99,11 +108,38 @@ public:
   /// Getter of statistics.
   Statistics::Statistics &getStatistics() { return Stat; }
 
+  /// Setter of the sampling profiler of the executions.
+  void setSampler(Interpreter::Sampler *S) { InterpreterEngine.setSampler(S); }
+
+  /// Setter of the tiering of the hot functions in the instantiated module.
+  void setTiering(Interpreter::Tiering *T) {
+    Tier = T;
+    InterpreterEngine.setTiering(T);
+  }
+
 private:
   enum class VMStage : uint8_t { Inited, Loaded, Validated, Instantiated };
 
   void initVM();
 
+  /// Validate and register the module, which is annotated in place.
+  Expect<void> registerModuleImpl(std::string_view Name, AST::Module &Module);
+
+  /// Validate, instantiate, and run the module, which is annotated in place.
+  Expect<std::vector<ValVariant>>
+  runWasmFileImpl(AST::Module &Module, std::string_view Func,
+                  Span<const ValVariant> Params);
+
+  /// Compile the validated module by the JIT if configured. The module is
+  /// left to be interpreted if the JIT is not built.
+  Expect<void> compileJIT(AST::Module &Module);
+
+  /// Parse the module, which is loaded from the AOT cache instead if
+  /// configured. The module is compiled into the cache on a miss.
+  Expect<std::unique_ptr<AST::Module>>
+  parseModule(const std::filesystem::path &Path);
+  Expect<std::unique_ptr<AST::Module>> parseModule(Span<const Byte> Code);
+
   /// VM environment.
   const Configure Conf;
   Statistics::Statistics Stat;
@@ -113,9 +149,10 @@ private:
   Loader::Loader LoaderEngine;
   Validator::Validator ValidatorEngine;
   Interpreter::Interpreter InterpreterEngine;
+  Interpreter::Tiering *Tier = nullptr;
 
   /// VM Storage.
-  std::unique_ptr<AST::Module> Mod;
+  std::shared_ptr<AST::Module> Mod;
   std::unique_ptr<Runtime::StoreManager> Store;
   Runtime::StoreManager &StoreRef;
   std::map<HostRegistration, std::unique_ptr<Runtime::ImportObject>> ImpObjs;
@@ -0,0 +1,123 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "aot/cache.h"
+#include "common/hexstr.h"
+#include "common/log.h"
+
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/SHA1.h>
+
+#include <algorithm>
+#include <string_view>
+#include <vector>
+
+namespace SSVM {
+namespace AOT {
+
+std::filesystem::path Cache::getPath(Span<const Byte> Data,
+                                     const Configure &Conf,
+                                     const Compiler &Compiler) const {
+  using namespace std::literals;
+  llvm::SHA1 Hasher;
+  Hasher.update(llvm::ArrayRef<uint8_t>(Data.data(), Data.size()));
+  std::string Options = Compiler.getFingerprint() + " proposals:";
+  for (uint8_t I = 0; I < uint8_t(Proposal::Max); ++I) {
+    Options += Conf.hasProposal(Proposal(I)) ? '1' : '0';
+  }
+  Hasher.update(llvm::StringRef(Options));
+
+  const auto Result = Hasher.result();
+  const std::vector<uint8_t> Digest(Result.begin(), Result.end());
+  std::string Key;
+  convertBytesToHexStr(Digest, Key);
+  return Dir / (Key + ".so"s);
+}
+
+Expect<std::filesystem::path> Cache::get(Span<const Byte> Data,
+                                         const AST::Module &Module,
+                                         const Configure &Conf,
+                                         Compiler &Compiler) {
+  namespace fs = std::filesystem;
+  std::error_code Error;
+  const fs::path Path = getPath(Data, Conf, Compiler);
+  if (fs::exists(Path, Error)) {
+    /// The modification time orders the libraries by the last use.
+    fs::last_write_time(Path, fs::file_time_type::clock::now(), Error);
+    return Path;
+  }
+
+  /// Compile into a temporary file, and move it into the cache at once, so
+  /// other processes never see a partial library. The temporary file is
+  /// created exclusively, so no two threads or processes share it.
+  if (fs::create_directories(Dir, Error); Error) {
+    LOG(ERROR) << ErrInfo::InfoFile(Dir);
+    return Unexpect(ErrCode::InvalidPath);
+  }
+  llvm::SmallString<128> UniquePath;
+  if (llvm::sys::fs::createUniqueFile(
+          (Dir / (Path.stem().string() + ".%%%%%%%%.tmp")).string(),
+          UniquePath)) {
+    LOG(ERROR) << ErrInfo::InfoFile(Dir);
+    return Unexpect(ErrCode::InvalidPath);
+  }
+  const fs::path TmpPath(UniquePath.str().str());
+  if (auto Res = Compiler.compile(Data, Module, TmpPath); !Res) {
+    fs::remove(TmpPath, Error);
+    return Unexpect(Res);
+  }
+  if (fs::rename(TmpPath, Path, Error); Error) {
+    LOG(ERROR) << ErrInfo::InfoFile(Path);
+    fs::remove(TmpPath, Error);
+    return Unexpect(ErrCode::InvalidPath);
+  }
+  evict(Path);
+  return Path;
+}
+
+void Cache::evict(const std::filesystem::path &Keep) {
+  namespace fs = std::filesystem;
+  using namespace std::literals;
+  struct Entry {
+    fs::path Path;
+    fs::file_time_type Time;
+    uint64_t Size;
+  };
+  std::vector<Entry> Entries;
+  uint64_t Total = 0;
+  std::error_code Error;
+  for (auto It = fs::directory_iterator(Dir, Error);
+       !Error && It != fs::directory_iterator(); It.increment(Error)) {
+    const auto &Path = It->path();
+    if (Path.extension() != ".so"sv) {
+      continue;
+    }
+    const auto Size = fs::file_size(Path, Error);
+    const auto Time = fs::last_write_time(Path, Error);
+    if (Error) {
+      /// Removed by other processes.
+      Error.clear();
+      continue;
+    }
+    Entries.push_back({Path, Time, Size});
+    Total += Size;
+  }
+
+  std::sort(Entries.begin(), Entries.end(),
+            [](const Entry &A, const Entry &B) { return A.Time < B.Time; });
+  for (const auto &E : Entries) {
+    if (Total <= MaxSize) {
+      break;
+    }
+    if (E.Path == Keep) {
+      continue;
+    }
+    /// The loaded libraries keep mapped after removed.
+    fs::remove(E.Path, Error);
+    Total -= E.Size;
+  }
+}
+
+} // namespace AOT
+} // namespace SSVM
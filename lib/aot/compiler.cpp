@@ -3,10 +3,18 @@
 #include "aot/compiler.h"
 #include "common/filesystem.h"
 #include "common/log.h"
+#include "loader/ldmgr.h"
 #include "runtime/instance/memory.h"
 #include "runtime/instance/table.h"
+#if SSVM_AOT_LLD
 #include <lld/Common/Driver.h>
+#endif
+#include <llvm/Analysis/AliasAnalysis.h>
 #include <llvm/Analysis/TargetLibraryInfo.h>
+#include <llvm/Bitcode/BitcodeReader.h>
+#include <llvm/Bitcode/BitcodeWriter.h>
+#include <llvm/ExecutionEngine/Orc/ExecutionUtils.h>
+#include <llvm/ExecutionEngine/Orc/LLJIT.h>
 #include <llvm/IR/IRBuilder.h>
 #include <llvm/IR/LegacyPassManager.h>
 #include <llvm/IR/Verifier.h>
@@ -14,12 +22,25 @@
 #include <llvm/Passes/PassBuilder.h>
 #include <llvm/Support/FileSystem.h>
 #include <llvm/Support/Host.h>
+#if LLVM_VERSION_MAJOR >= 14
+#include <llvm/MC/TargetRegistry.h>
+#else
 #include <llvm/Support/TargetRegistry.h>
+#endif
 #include <llvm/Support/TargetSelect.h>
 #include <llvm/Target/TargetMachine.h>
 #include <llvm/Transforms/IPO/AlwaysInliner.h>
+#include <llvm/Transforms/Scalar/InductiveRangeCheckElimination.h>
 #include <llvm/Transforms/Utils/BasicBlockUtils.h>
+#include <llvm/Transforms/Utils/SplitModule.h>
+#include <atomic>
 #include <numeric>
+#include <thread>
+#if !SSVM_AOT_LLD
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
 
 #if LLVM_VERSION_MAJOR >= 10
 #include <llvm/IR/IntrinsicsAArch64.h>
@@ -104,23 +125,38 @@ static inline constexpr const bool kForceDivCheck = true;
 /// Size of a ValVariant
 static inline constexpr const uint32_t kValSize = sizeof(SSVM::ValVariant);
 
+#if LLVM_VERSION_MAJOR >= 14
+using LLVMOptimizationLevel = llvm::OptimizationLevel;
+#else
+using LLVMOptimizationLevel = llvm::PassBuilder::OptimizationLevel;
+#endif
+
+/// Number of elements of the fixed vector type
+static inline unsigned getVectorSize(llvm::VectorType *Ty) {
+#if LLVM_VERSION_MAJOR >= 12
+  return Ty->getElementCount().getKnownMinValue();
+#else
+  return Ty->getElementCount().Min;
+#endif
+}
+
 /// Translate Compiler::OptimizationLevel to llvm::PassBuilder version
-static inline llvm::PassBuilder::OptimizationLevel
+static inline LLVMOptimizationLevel
 toLLVMLevel(SSVM::AOT::Compiler::OptimizationLevel Level) {
   using OL = SSVM::AOT::Compiler::OptimizationLevel;
   switch (Level) {
   case OL::O0:
-    return llvm::PassBuilder::OptimizationLevel::O0;
+    return LLVMOptimizationLevel::O0;
   case OL::O1:
-    return llvm::PassBuilder::OptimizationLevel::O1;
+    return LLVMOptimizationLevel::O1;
   case OL::O2:
-    return llvm::PassBuilder::OptimizationLevel::O2;
+    return LLVMOptimizationLevel::O2;
   case OL::O3:
-    return llvm::PassBuilder::OptimizationLevel::O3;
+    return LLVMOptimizationLevel::O3;
   case OL::Os:
-    return llvm::PassBuilder::OptimizationLevel::Os;
+    return LLVMOptimizationLevel::Os;
   case OL::Oz:
-    return llvm::PassBuilder::OptimizationLevel::Oz;
+    return LLVMOptimizationLevel::Oz;
   default:
     assert(false);
     __builtin_unreachable();
@@ -150,6 +186,7 @@ struct SSVM::AOT::Compiler::CompileContext {
   llvm::PointerType *Int32PtrTy;
   llvm::PointerType *Int64PtrTy;
   llvm::PointerType *Int128PtrTy;
+  llvm::ArrayType *CostTableTy;
   llvm::StructType *ExecCtxTy;
   llvm::PointerType *ExecCtxPtrTy;
   llvm::SubtargetFeatures SubtargetFeatures;
@@ -171,13 +208,15 @@ struct SSVM::AOT::Compiler::CompileContext {
 
   std::vector<const AST::FunctionType *> FunctionTypes;
   std::vector<llvm::Function *> FunctionWrappers;
+  std::vector<llvm::Function *> IndirectCallThunks;
   std::vector<
       std::tuple<uint32_t, llvm::Function *, const SSVM::AST::CodeSegment *>>
       Functions;
   std::vector<llvm::Type *> Globals;
   llvm::GlobalVariable *IntrinsicsTable;
   llvm::Function *Trap;
-  uint32_t MemMin = 1, MemMax = 65536;
+  uint32_t MemMin = 0, MemMax = 65536;
+  bool BoundsChecking = false;
   CompileContext(llvm::Module &M)
       : LLContext(M.getContext()), LLModule(M),
         VoidTy(llvm::Type::getVoidTy(LLContext)),
@@ -199,6 +238,7 @@ struct SSVM::AOT::Compiler::CompileContext {
         Int32PtrTy(llvm::Type::getInt32PtrTy(LLContext)),
         Int64PtrTy(Int64Ty->getPointerTo()),
         Int128PtrTy(Int128Ty->getPointerTo()),
+        CostTableTy(llvm::ArrayType::get(Int64Ty, UINT16_MAX + 1)),
         ExecCtxTy(llvm::StructType::create(
             "ExecCtx",
             /// Memory
@@ -208,9 +248,15 @@ struct SSVM::AOT::Compiler::CompileContext {
             /// InstrCount
             Int64PtrTy,
             /// CostTable
-            llvm::ArrayType::get(Int64Ty, UINT16_MAX + 1)->getPointerTo(),
+            CostTableTy->getPointerTo(),
             /// Gas
-            Int64PtrTy)),
+            Int64PtrTy,
+            /// OpCount
+            CostTableTy->getPointerTo(),
+            /// CostLimit
+            Int64Ty,
+            /// MemorySize
+            Int64Ty)),
         ExecCtxPtrTy(ExecCtxTy->getPointerTo()),
         IntrinsicsTable(new llvm::GlobalVariable(
             LLModule,
@@ -280,8 +326,9 @@ struct SSVM::AOT::Compiler::CompileContext {
                           uint32_t Index) {
     llvm::Type *Type = Globals[Index];
     auto *Array = Builder.CreateExtractValue(ExecCtx, {1});
-    auto *VPtr =
-        Builder.CreateLoad(Builder.CreateConstInBoundsGEP1_64(Array, Index));
+    auto *VPtr = Builder.CreateLoad(
+        Int128PtrTy,
+        Builder.CreateConstInBoundsGEP1_64(Int128PtrTy, Array, Index));
     auto *Ptr = Builder.CreateBitCast(VPtr, Type);
     return Ptr;
   }
@@ -296,17 +343,26 @@ struct SSVM::AOT::Compiler::CompileContext {
   llvm::Value *getGas(llvm::IRBuilder<> &Builder, llvm::LoadInst *ExecCtx) {
     return Builder.CreateExtractValue(ExecCtx, {4});
   }
+  llvm::Value *getOpCount(llvm::IRBuilder<> &Builder,
+                          llvm::LoadInst *ExecCtx) {
+    return Builder.CreateExtractValue(ExecCtx, {5});
+  }
+  llvm::Value *getCostLimit(llvm::IRBuilder<> &Builder,
+                            llvm::LoadInst *ExecCtx) {
+    return Builder.CreateExtractValue(ExecCtx, {6});
+  }
   llvm::FunctionCallee getIntrinsic(llvm::IRBuilder<> &Builder,
                                     AST::Module::Intrinsics Index,
                                     llvm::FunctionType *Ty) {
     auto *VPtr = llvm::ConstantExpr::getInBoundsGetElementPtr(
-        nullptr, IntrinsicsTable,
+        IntrinsicsTable->getValueType(), IntrinsicsTable,
         std::array<llvm::Constant *, 2>{
             llvm::ConstantInt::get(Int64Ty, 0),
             llvm::ConstantInt::get(Int64Ty, uint32_t(Index))});
     return llvm::FunctionCallee(
-        Ty, Builder.CreateLoad(llvm::ConstantExpr::getBitCast(
-                VPtr, Ty->getPointerTo()->getPointerTo())));
+        Ty, Builder.CreateLoad(Ty->getPointerTo(),
+                               llvm::ConstantExpr::getBitCast(
+                                   VPtr, Ty->getPointerTo()->getPointerTo())));
   }
   std::pair<std::vector<ValType>, std::vector<ValType>>
   resolveBlockType(const BlockType &Type) const {
@@ -428,13 +484,13 @@ class FunctionCompiler {
 
 public:
   FunctionCompiler(AOT::Compiler::CompileContext &Context, llvm::Function *F,
-                   Span<const ValType> Locals, bool InstructionCounting,
-                   bool GasMeasuring, bool OptNone)
+                   uint32_t FuncIndex, Span<const ValType> Locals,
+                   bool InstructionCounting, bool GasMeasuring, bool OptNone)
       : Context(Context), LLContext(Context.LLContext), OptNone(OptNone), F(F),
         Builder(llvm::BasicBlock::Create(LLContext, "entry", F)) {
     if (F) {
       setIsFPConstrained(Builder);
-      ExecCtx = Builder.CreateLoad(F->arg_begin());
+      ExecCtx = Builder.CreateLoad(Context.ExecCtxTy, F->arg_begin());
 
       if (InstructionCounting) {
         LocalInstrCount = Builder.CreateAlloca(Context.Int64Ty);
@@ -446,18 +502,36 @@ public:
         readGas();
       }
 
+      if (Context.BoundsChecking) {
+        LocalMemory = Builder.CreateAlloca(Context.Int8PtrTy);
+        LocalMemorySize = Builder.CreateAlloca(Context.Int64Ty);
+        readMemory();
+      }
+
       for (llvm::Argument *Arg = F->arg_begin() + 1; Arg != F->arg_end();
            ++Arg) {
-        llvm::Value *ArgPtr = Builder.CreateAlloca(Arg->getType());
+        auto *ArgPtr = Builder.CreateAlloca(Arg->getType());
         Builder.CreateStore(Arg, ArgPtr);
         Local.push_back(ArgPtr);
       }
 
       for (const auto &Type : Locals) {
-        llvm::Value *ArgPtr = Builder.CreateAlloca(toLLVMType(LLContext, Type));
+        auto *ArgPtr = Builder.CreateAlloca(toLLVMType(LLContext, Type));
         Builder.CreateStore(toLLVMConstantZero(LLContext, Type), ArgPtr);
         Local.push_back(ArgPtr);
       }
+
+      if (InstructionCounting) {
+        /// Record the function profile, which is discarded by the runtime if
+        /// profiling is disabled.
+        Profiling = true;
+        Builder.CreateCall(
+            Context.getIntrinsic(
+                Builder, AST::Module::Intrinsics::kProfileEnter,
+                llvm::FunctionType::get(Context.VoidTy, {Context.Int32Ty},
+                                        false)),
+            {Builder.getInt32(FuncIndex)});
+      }
     }
   }
 
@@ -492,6 +566,10 @@ public:
     for (auto &[Error, BB] : TrapBB) {
       Builder.SetInsertPoint(BB);
       updateInstrCount();
+      if (Error == ErrCode::CostLimitExceeded) {
+        /// Leave the gas at the limit, the same as the interpreter.
+        Builder.CreateStore(Context.getCostLimit(Builder, ExecCtx), LocalGas);
+      }
       writeGas();
       auto *CallTrap = Builder.CreateCall(
           Context.Trap, {Builder.getInt8(static_cast<uint8_t>(Error))});
@@ -648,14 +726,17 @@ public:
         break;
       }
       case OpCode::Br_table: {
-        const auto &LabelTable = Instr.getLabelList();
+        const auto LabelTable = Instr.getLabelList();
         auto *Value = stackPop();
         setLableJumpPHI(Instr.getTargetIndex());
+        /// The last entry of the label table is the default label.
+        const size_t LabelNum = LabelTable.size() - 1;
         auto *Switch = Builder.CreateSwitch(
-            Value, getLabel(Instr.getTargetIndex()), LabelTable.size());
-        for (size_t I = 0; I < LabelTable.size(); ++I) {
-          setLableJumpPHI(LabelTable[I]);
-          Switch->addCase(Builder.getInt32(I), getLabel(LabelTable[I]));
+            Value, getLabel(Instr.getTargetIndex()), LabelNum);
+        for (size_t I = 0; I < LabelNum; ++I) {
+          const auto Label = LabelTable[I].TargetIndex;
+          setLableJumpPHI(Label);
+          Switch->addCase(Builder.getInt32(I), getLabel(Label));
         }
         setUnreachable();
         Builder.SetInsertPoint(
@@ -672,6 +753,23 @@ public:
         writeGas();
         compileIndirectCallOp(Instr.getSourceIndex(), Instr.getTargetIndex());
         break;
+      case OpCode::Return_call:
+        updateInstrCount();
+        writeGas();
+        compileReturnCallOp(Instr.getTargetIndex());
+        setUnreachable();
+        Builder.SetInsertPoint(
+            llvm::BasicBlock::Create(LLContext, "ret_call.end", F));
+        break;
+      case OpCode::Return_call_indirect:
+        updateInstrCount();
+        writeGas();
+        compileReturnIndirectCallOp(Instr.getSourceIndex(),
+                                    Instr.getTargetIndex());
+        setUnreachable();
+        Builder.SetInsertPoint(
+            llvm::BasicBlock::Create(LLContext, "ret_call_indirect.end", F));
+        break;
       case OpCode::Ref__null:
         stackPush(Builder.getInt64(0));
         break;
@@ -700,7 +798,9 @@ public:
         break;
       }
       case OpCode::Local__get:
-        stackPush(Builder.CreateLoad(Local[Instr.getTargetIndex()]));
+        stackPush(Builder.CreateLoad(
+            Local[Instr.getTargetIndex()]->getAllocatedType(),
+            Local[Instr.getTargetIndex()]));
         break;
       case OpCode::Local__set:
         Builder.CreateStore(stackPop(), Local[Instr.getTargetIndex()]);
@@ -710,6 +810,7 @@ public:
         break;
       case OpCode::Global__get:
         stackPush(Builder.CreateLoad(
+            Context.Globals[Instr.getTargetIndex()]->getPointerElementType(),
             Context.getGlobals(Builder, ExecCtx, Instr.getTargetIndex())));
         break;
       case OpCode::Global__set:
@@ -917,6 +1018,7 @@ public:
                                                          {Context.Int32Ty},
                                                          false)),
             {Diff}));
+        readMemory();
         break;
       }
       case OpCode::Memory__init: {
@@ -1809,13 +1911,15 @@ public:
             Builder.CreateAlloca(Context.Int8Ty, Builder.getInt64(16));
         for (size_t I = 0; I < 16; ++I) {
           Builder.CreateStore(Builder.CreateExtractElement(Vector, I),
-                              Builder.CreateConstInBoundsGEP1_64(Array, I));
+                              Builder.CreateConstInBoundsGEP1_64(
+                                  Context.Int8Ty, Array, I));
         }
         llvm::Value *Ret = llvm::UndefValue::get(Context.Int8x16Ty);
         for (size_t I = 0; I < 16; ++I) {
           auto *Idx = Builder.CreateExtractElement(InboundIndex, I);
-          auto *Value =
-              Builder.CreateLoad(Builder.CreateInBoundsGEP(Array, {Idx}));
+          auto *Value = Builder.CreateLoad(
+              Context.Int8Ty,
+              Builder.CreateInBoundsGEP(Context.Int8Ty, Array, {Idx}));
           Ret = Builder.CreateInsertElement(Ret, Value, I);
         }
         Ret = Builder.CreateSelect(IsOver, Zero, Ret);
@@ -2431,26 +2535,100 @@ public:
       }
       return;
     };
-    for (const auto &Instr : Instrs) {
+    /// The gas is charged per basic block on entering it, the same as the
+    /// interpreter. The End of an If without Else is charged after merging the
+    /// paths, as the If jumps onto it.
+    std::vector<bool> Entries;
+    std::vector<bool> IfEnds;
+    if (LocalGas) {
+      Entries = AST::findBlockEntries(Instrs);
+      IfEnds.resize(Instrs.size(), false);
+      for (uint32_t I = 0; I < Instrs.size(); ++I) {
+        if (Instrs[I].getOpCode() == OpCode::If &&
+            Instrs[I].getJumpElse() == Instrs[I].getJumpEnd()) {
+          IfEnds[I + Instrs[I].getJumpEnd()] = true;
+        }
+      }
+    }
+    for (uint32_t I = 0; I < Instrs.size(); ++I) {
+      const auto &Instr = Instrs[I];
       /// Update instruction count
       if (LocalInstrCount) {
         Builder.CreateStore(
-            Builder.CreateAdd(Builder.CreateLoad(LocalInstrCount),
-                              Builder.getInt64(1)),
+            Builder.CreateAdd(
+                Builder.CreateLoad(Context.Int64Ty, LocalInstrCount),
+                Builder.getInt64(1)),
             LocalInstrCount);
+        auto *OpCountPtr = Builder.CreateConstInBoundsGEP2_64(
+            Context.CostTableTy, Context.getOpCount(Builder, ExecCtx), 0,
+            uint16_t(Instr.getOpCode()));
+        Builder.CreateStore(
+            Builder.CreateAdd(Builder.CreateLoad(Context.Int64Ty, OpCountPtr),
+                              Builder.getInt64(1)),
+            OpCountPtr);
       }
       if (LocalGas) {
-        auto *NewGas = Builder.CreateAdd(
-            Builder.CreateLoad(LocalGas),
-            Builder.CreateLoad(Builder.CreateConstInBoundsGEP2_64(
-                Context.getCostTable(Builder, ExecCtx), 0,
-                uint16_t(Instr.getOpCode()))));
-        Builder.CreateStore(NewGas, LocalGas);
+        if (Entries[I] && !IfEnds[I]) {
+          chargeBlock(Instrs, I, Entries);
+        }
+        if (Instr.getOpCode() == OpCode::Else) {
+          /// The then-path leaves through the End instead of the Else.
+          chargeGas(Builder.CreateSub(getCost(OpCode::End),
+                                      getCost(OpCode::Else)));
+        }
       }
 
       /// Make the instruction node according to Code.
       Dispatch(Instr);
+
+      if (LocalGas) {
+        if (Instr.getOpCode() == OpCode::Else) {
+          /// The else-path enters through the Else.
+          chargeGas(getCost(OpCode::Else));
+        }
+        if (IfEnds[I]) {
+          chargeBlock(Instrs, I, Entries);
+        }
+      }
+    }
+  }
+
+  /// Load the cost of the opcode from the cost table.
+  llvm::Value *getCost(OpCode Code) {
+    return Builder.CreateLoad(
+        Context.Int64Ty,
+        Builder.CreateConstInBoundsGEP2_64(
+            Context.CostTableTy, Context.getCostTable(Builder, ExecCtx), 0,
+            uint16_t(Code)));
+  }
+
+  /// Charge the costs of the basic block starting at Begin.
+  void chargeBlock(AST::InstrView Instrs, uint32_t Begin,
+                   const std::vector<bool> &Entries) {
+    if (isUnreachable()) {
+      return;
+    }
+    llvm::Value *Cost = getCost(Instrs[Begin].getOpCode());
+    for (uint32_t I = Begin + 1; I < Instrs.size() && !Entries[I]; ++I) {
+      Cost = Builder.CreateAdd(Cost, getCost(Instrs[I].getOpCode()));
     }
+    chargeGas(Cost);
+  }
+
+  /// Add the cost to the gas, and trap if the gas exceeds the limit.
+  void chargeGas(llvm::Value *Cost) {
+    if (isUnreachable()) {
+      return;
+    }
+    auto *NewGas =
+        Builder.CreateAdd(Builder.CreateLoad(Context.Int64Ty, LocalGas), Cost);
+    Builder.CreateStore(NewGas, LocalGas);
+    auto *OkBB = llvm::BasicBlock::Create(LLContext, "gas.ok", F);
+    auto *IsOk = createLikely(
+        Builder,
+        Builder.CreateICmpULE(NewGas, Context.getCostLimit(Builder, ExecCtx)));
+    Builder.CreateCondBr(IsOk, OkBB, getTrapBB(ErrCode::CostLimitExceeded));
+    Builder.SetInsertPoint(OkBB);
   }
   void compileSignedTrunc(llvm::IntegerType *IntType) {
     const auto MinInt = llvm::APInt::getSignedMinValue(IntType->getBitWidth());
@@ -2608,6 +2786,7 @@ public:
   void compileReturn() {
     updateInstrCount();
     writeGas();
+    leaveProfile();
     auto *Ty = F->getReturnType();
     if (Ty->isVoidTy()) {
       Builder.CreateRetVoid();
@@ -2624,30 +2803,57 @@ public:
     }
   }
 
+  void leaveProfile() {
+    if (Profiling) {
+      Builder.CreateCall(Context.getIntrinsic(
+          Builder, AST::Module::Intrinsics::kProfileLeave,
+          llvm::FunctionType::get(Context.VoidTy, false)));
+    }
+  }
+
   void updateInstrCount() {
     if (LocalInstrCount) {
       auto *Ptr = Context.getInstrCount(Builder, ExecCtx);
-      Builder.CreateStore(Builder.CreateAdd(Builder.CreateLoad(LocalInstrCount),
-                                            Builder.CreateLoad(Ptr)),
-                          Ptr);
+      Builder.CreateStore(
+          Builder.CreateAdd(
+              Builder.CreateLoad(Context.Int64Ty, LocalInstrCount),
+              Builder.CreateLoad(Context.Int64Ty, Ptr)),
+          Ptr);
       Builder.CreateStore(Builder.getInt64(0), LocalInstrCount);
     }
   }
 
   void readGas() {
     if (LocalGas) {
-      Builder.CreateStore(Builder.CreateLoad(Context.getGas(Builder, ExecCtx)),
-                          LocalGas);
+      Builder.CreateStore(
+          Builder.CreateLoad(Context.Int64Ty, Context.getGas(Builder, ExecCtx)),
+          LocalGas);
     }
   }
 
   void writeGas() {
     if (LocalGas) {
-      Builder.CreateStore(Builder.CreateLoad(LocalGas),
+      Builder.CreateStore(Builder.CreateLoad(Context.Int64Ty, LocalGas),
                           Context.getGas(Builder, ExecCtx));
     }
   }
 
+  /// Reload the memory, which may be moved or grown by the calls.
+  void readMemory() {
+    if (LocalMemory) {
+      Builder.CreateStore(
+          Builder.CreateLoad(
+              Context.Int8PtrTy,
+              Builder.CreateStructGEP(Context.ExecCtxTy, F->arg_begin(), 0)),
+          LocalMemory);
+      Builder.CreateStore(
+          Builder.CreateLoad(
+              Context.Int64Ty,
+              Builder.CreateStructGEP(Context.ExecCtxTy, F->arg_begin(), 7)),
+          LocalMemorySize);
+    }
+  }
+
 private:
   void compileCallOp(const unsigned int FuncIndex) {
     const auto &FuncType =
@@ -2663,6 +2869,7 @@ private:
     }
 
     auto *Ret = Builder.CreateCall(Function, Args);
+    Ret->setCallingConv(llvm::CallingConv::Tail);
     auto *Ty = Ret->getType();
     if (Ty->isVoidTy()) {
       // nothing to do
@@ -2675,6 +2882,92 @@ private:
     }
 
     readGas();
+    readMemory();
+  }
+
+  void compileReturnCallOp(const unsigned int FuncIndex) {
+    const auto &FuncType =
+        *Context.FunctionTypes[std::get<0>(Context.Functions[FuncIndex])];
+    const auto &Function = std::get<1>(Context.Functions[FuncIndex]);
+    const auto &ParamTypes = FuncType.getParamTypes();
+
+    std::vector<llvm::Value *> Args(ParamTypes.size() + 1);
+    Args[0] = F->arg_begin();
+    for (size_t I = 0; I < ParamTypes.size(); ++I) {
+      const size_t J = ParamTypes.size() - 1 - I;
+      Args[J + 1] = stackPop();
+    }
+
+    /// The callee replaces this function in the profile. Nothing may be
+    /// placed between the tail call and the return.
+    leaveProfile();
+    compileTailCall(Function, Args);
+  }
+
+  void compileReturnIndirectCallOp(const uint32_t TableIndex,
+                                   const uint32_t FuncTypeIndex) {
+    llvm::Value *FuncIndex = stackPop();
+    const auto &FuncType = *Context.FunctionTypes[FuncTypeIndex];
+    auto *FTy = toLLVMType(Context.ExecCtxPtrTy, FuncType);
+    const auto &ParamTypes = FuncType.getParamTypes();
+
+    std::vector<llvm::Value *> Args(ParamTypes.size() + 1);
+    Args[0] = F->arg_begin();
+    for (size_t I = 0; I < ParamTypes.size(); ++I) {
+      const size_t J = ParamTypes.size() - 1 - I;
+      Args[J + 1] = stackPop();
+    }
+
+    /// The runtime checks the callee, and returns its code if it is a
+    /// compiled function of this module, or null for the others.
+    auto *Code = Builder.CreateCall(
+        Context.getIntrinsic(
+            Builder, AST::Module::Intrinsics::kCallIndirectCode,
+            llvm::FunctionType::get(
+                Context.Int8PtrTy,
+                {Context.Int32Ty, Context.Int32Ty, Context.Int32Ty}, false)),
+        {Builder.getInt32(TableIndex), Builder.getInt32(FuncTypeIndex),
+         FuncIndex});
+    leaveProfile();
+
+    /// Jump to the code directly, or to the thunk calling the callee through
+    /// the runtime.
+    auto *DirectBB =
+        llvm::BasicBlock::Create(LLContext, "ret_call_indirect.direct", F);
+    auto *ThunkBB =
+        llvm::BasicBlock::Create(LLContext, "ret_call_indirect.thunk", F);
+    Builder.CreateCondBr(createLikely(Builder, Builder.CreateIsNotNull(Code)),
+                         DirectBB, ThunkBB);
+
+    Builder.SetInsertPoint(DirectBB);
+    compileTailCall(
+        llvm::FunctionCallee(
+            FTy, Builder.CreateBitCast(Code, FTy->getPointerTo())),
+        Args);
+
+    Builder.SetInsertPoint(ThunkBB);
+    Args.insert(Args.begin() + 1, {Builder.getInt32(TableIndex), FuncIndex});
+    compileTailCall(Context.IndirectCallThunks[FuncTypeIndex], Args);
+  }
+
+  /// Compile the tail call and the return of its results. The functions all
+  /// use the tailcc calling convention, so the tail calls are guaranteed
+  /// even if the prototypes are different.
+  void compileTailCall(llvm::FunctionCallee Callee,
+                       llvm::ArrayRef<llvm::Value *> Args) {
+    auto *Ret = Builder.CreateCall(Callee, Args);
+    Ret->setCallingConv(llvm::CallingConv::Tail);
+#if LLVM_VERSION_MAJOR >= 13
+    Ret->setTailCallKind(llvm::CallInst::TCK_MustTail);
+#else
+    /// musttail requires the same prototypes before LLVM 13.
+    Ret->setTailCallKind(llvm::CallInst::TCK_Tail);
+#endif
+    if (Ret->getType()->isVoidTy()) {
+      Builder.CreateRetVoid();
+    } else {
+      Builder.CreateRet(Ret);
+    }
   }
 
   void compileIndirectCallOp(const uint32_t TableIndex,
@@ -2710,7 +3003,8 @@ private:
     for (unsigned I = 0; I < ArgSize; ++I) {
       const unsigned J = ArgSize - 1 - I;
       auto *Arg = stackPop();
-      auto *Ptr = Builder.CreateConstInBoundsGEP1_64(Args, J * kValSize);
+      auto *Ptr = Builder.CreateConstInBoundsGEP1_64(Context.Int8Ty, Args,
+                                                     J * kValSize);
       Builder.CreateStore(
           Arg, Builder.CreateBitCast(Ptr, Arg->getType()->getPointerTo()));
     }
@@ -2729,19 +3023,48 @@ private:
     if (RetSize == 0) {
       // nothing to do
     } else if (RetSize == 1) {
-      auto *VPtr = Builder.CreateConstInBoundsGEP1_64(Rets, 0);
+      auto *VPtr = Builder.CreateConstInBoundsGEP1_64(Context.Int8Ty, Rets, 0);
       auto *Ptr = Builder.CreateBitCast(VPtr, RTy->getPointerTo());
-      stackPush(Builder.CreateLoad(Ptr));
+      stackPush(Builder.CreateLoad(RTy, Ptr));
     } else {
       for (unsigned I = 0; I < RetSize; ++I) {
-        auto *VPtr = Builder.CreateConstInBoundsGEP1_64(Rets, I * kValSize);
+        auto *VPtr = Builder.CreateConstInBoundsGEP1_64(Context.Int8Ty, Rets,
+                                                        I * kValSize);
         auto *Ptr = Builder.CreateBitCast(
             VPtr, RTy->getStructElementType(I)->getPointerTo());
-        stackPush(Builder.CreateLoad(Ptr));
+        stackPush(Builder.CreateLoad(RTy->getStructElementType(I), Ptr));
       }
     }
 
     readGas();
+    readMemory();
+  }
+
+  /// Get the pointer of the access in the memory. Without the guard region,
+  /// the access is checked against the memory size, except the constant
+  /// offsets in the minimum pages.
+  llvm::Value *getMemoryPointer(llvm::Value *Off, llvm::Type *Ty) {
+    if (!LocalMemory) {
+      return Builder.CreateInBoundsGEP(
+          Context.Int8Ty, Context.getMemory(Builder, ExecCtx), {Off});
+    }
+    const uint64_t Size = uint64_t(Ty->getPrimitiveSizeInBits()) / 8;
+    const uint64_t MinSize = uint64_t(Context.MemMin) *
+                             SSVM::Runtime::Instance::MemoryInstance::kPageSize;
+    auto *Const = llvm::dyn_cast<llvm::ConstantInt>(Off);
+    if (!Const || Const->getZExtValue() + Size > MinSize) {
+      auto *OkBB = llvm::BasicBlock::Create(LLContext, "mem.ok", F);
+      auto *Last = Builder.CreateAdd(Off, Builder.getInt64(Size - 1));
+      auto *IsOk = createLikely(
+          Builder,
+          Builder.CreateICmpULT(
+              Last, Builder.CreateLoad(Context.Int64Ty, LocalMemorySize)));
+      Builder.CreateCondBr(IsOk, OkBB, getTrapBB(ErrCode::MemoryOutOfBounds));
+      Builder.SetInsertPoint(OkBB);
+    }
+    return Builder.CreateInBoundsGEP(
+        Context.Int8Ty, Builder.CreateLoad(Context.Int8PtrTy, LocalMemory),
+        {Off});
   }
 
   void compileLoadOp(unsigned Offset, unsigned Alignment, llvm::Type *LoadTy) {
@@ -2753,10 +3076,9 @@ private:
       Off = Builder.CreateAdd(Off, Builder.getInt64(Offset));
     }
 
-    auto *VPtr =
-        Builder.CreateInBoundsGEP(Context.getMemory(Builder, ExecCtx), {Off});
+    auto *VPtr = getMemoryPointer(Off, LoadTy);
     auto *Ptr = Builder.CreateBitCast(VPtr, LoadTy->getPointerTo());
-    auto *LoadInst = Builder.CreateLoad(Ptr, OptNone);
+    auto *LoadInst = Builder.CreateLoad(LoadTy, Ptr, OptNone);
     LoadInst->setAlignment(Align(UINT64_C(1) << Alignment));
     stackPush(LoadInst);
   }
@@ -2802,8 +3124,7 @@ private:
     if (BitCast) {
       V = Builder.CreateBitCast(V, LoadTy);
     }
-    auto *VPtr =
-        Builder.CreateInBoundsGEP(Context.getMemory(Builder, ExecCtx), {Off});
+    auto *VPtr = getMemoryPointer(Off, LoadTy);
     auto *Ptr = Builder.CreateBitCast(VPtr, LoadTy->getPointerTo());
     auto *StoreInst = Builder.CreateStore(V, Ptr, OptNone);
     StoreInst->setAlignment(Align(UINT64_C(1) << Alignment));
@@ -2812,7 +3133,7 @@ private:
     const uint32_t kZero = 0;
     auto *Undef = llvm::UndefValue::get(VectorTy);
     auto *Zeros = llvm::ConstantAggregateZero::get(llvm::VectorType::get(
-        Context.Int32Ty, VectorTy->getElementCount().Min, false));
+        Context.Int32Ty, getVectorSize(VectorTy), false));
     auto *Value = Builder.CreateTrunc(Stack.back(), VectorTy->getElementType());
     auto *Vector = Builder.CreateInsertElement(Undef, Value, kZero);
     Vector = Builder.CreateShuffleVector(Vector, Undef, Zeros);
@@ -2883,7 +3204,7 @@ private:
   }
   void compileVectorAnyTrue(llvm::VectorType *VectorTy) {
     compileVectorReduceIOp(VectorTy, [this, VectorTy](auto *V) {
-      const auto Size = VectorTy->getElementCount().Min;
+      const auto Size = getVectorSize(VectorTy);
       auto *IntType = Builder.getIntNTy(Size);
       auto *Zero = llvm::ConstantAggregateZero::get(VectorTy);
       auto *Cmp = Builder.CreateBitCast(Builder.CreateICmpNE(V, Zero), IntType);
@@ -2893,7 +3214,7 @@ private:
   }
   void compileVectorAllTrue(llvm::VectorType *VectorTy) {
     compileVectorReduceIOp(VectorTy, [this, VectorTy](auto *V) {
-      const auto Size = VectorTy->getElementCount().Min;
+      const auto Size = getVectorSize(VectorTy);
       auto *IntType = Builder.getIntNTy(Size);
       auto *Zero = llvm::ConstantAggregateZero::get(VectorTy);
       auto *Cmp = Builder.CreateBitCast(Builder.CreateICmpEQ(V, Zero), IntType);
@@ -2903,7 +3224,7 @@ private:
   }
   void compileVectorBitMask(llvm::VectorType *VectorTy) {
     compileVectorReduceIOp(VectorTy, [this, VectorTy](auto *V) {
-      const auto Size = VectorTy->getElementCount().Min;
+      const auto Size = getVectorSize(VectorTy);
       auto *IntType = Builder.getIntNTy(Size);
       auto *Zero = llvm::ConstantAggregateZero::get(VectorTy);
       return Builder.CreateBitCast(Builder.CreateICmpSLT(V, Zero), IntType);
@@ -2914,7 +3235,7 @@ private:
     const uint64_t Mask = VectorTy->getElementType()->getIntegerBitWidth() - 1;
     auto *N = Builder.CreateAnd(stackPop(), Builder.getInt32(Mask));
     auto *RHS = Builder.CreateVectorSplat(
-        VectorTy->getElementCount().Min,
+        getVectorSize(VectorTy),
         Builder.CreateZExtOrTrunc(N, VectorTy->getElementType()));
     auto *LHS = Builder.CreateBitCast(stackPop(), VectorTy);
     stackPush(Builder.CreateBitCast(Op(LHS, RHS), Context.Int64x2Ty));
@@ -3007,7 +3328,7 @@ private:
         auto *EL = Builder.CreateZExt(LHS, ExtendTy);
         auto *ER = Builder.CreateZExt(RHS, ExtendTy);
         auto *One = Builder.CreateZExt(
-            Builder.CreateVectorSplat(ExtendTy->getElementCount().Min,
+            Builder.CreateVectorSplat(getVectorSize(ExtendTy),
                                       Builder.getTrue()),
             ExtendTy);
         return Builder.CreateTrunc(
@@ -3026,7 +3347,7 @@ private:
                          : llvm::APInt::getMaxValue(IntWidth / 2);
     MaxInt = Signed ? MaxInt.sext(IntWidth) : MaxInt.zext(IntWidth);
 
-    const auto Count = FromTy->getElementCount().Min;
+    const auto Count = getVectorSize(FromTy);
     auto *VMin = Builder.CreateVectorSplat(Count, Builder.getInt(MinInt));
     auto *VMax = Builder.CreateVectorSplat(Count, Builder.getInt(MaxInt));
 
@@ -3049,7 +3370,7 @@ private:
   }
   void compileVectorWiden(llvm::VectorType *FromTy, bool Signed, bool Low) {
     auto *ExtTy = llvm::VectorType::getExtendedElementVectorType(FromTy);
-    const auto Count = FromTy->getElementCount().Min;
+    const auto Count = getVectorSize(FromTy);
     std::vector<ShuffleElement> Mask(Count / 2);
     std::iota(Mask.begin(), Mask.end(), Low ? 0 : Count / 2);
     auto *F = Builder.CreateBitCast(Stack.back(), FromTy);
@@ -3185,7 +3506,7 @@ private:
   }
   void compileVectorTruncSatS(llvm::VectorType *VectorTy, unsigned IntWidth) {
     compileVectorOp(VectorTy, [this, VectorTy, IntWidth](auto *V) {
-      const auto Size = VectorTy->getElementCount().Min;
+      const auto Size = getVectorSize(VectorTy);
       auto *FPTy = VectorTy->getElementType();
       auto *IntZero = Builder.getIntN(IntWidth, 0);
       auto *IntMin = Builder.getInt(llvm::APInt::getSignedMinValue(IntWidth));
@@ -3211,7 +3532,7 @@ private:
   }
   void compileVectorTruncSatU(llvm::VectorType *VectorTy, unsigned IntWidth) {
     compileVectorOp(VectorTy, [this, VectorTy, IntWidth](auto *V) {
-      const auto Size = VectorTy->getElementCount().Min;
+      const auto Size = getVectorSize(VectorTy);
       auto *FPTy = VectorTy->getElementType();
       auto *IntMin = Builder.getInt(llvm::APInt::getMinValue(IntWidth));
       auto *IntMax = Builder.getInt(llvm::APInt::getMaxValue(IntWidth));
@@ -3388,13 +3709,16 @@ private:
 
   AOT::Compiler::CompileContext &Context;
   llvm::LLVMContext &LLContext;
-  std::vector<llvm::Value *> Local;
+  std::vector<llvm::AllocaInst *> Local;
   std::vector<llvm::Value *> Stack;
   llvm::Value *LocalInstrCount = nullptr;
   llvm::Value *LocalGas = nullptr;
+  llvm::Value *LocalMemory = nullptr;
+  llvm::Value *LocalMemorySize = nullptr;
   std::unordered_map<ErrCode, llvm::BasicBlock *> TrapBB;
   bool IsUnreachable = false;
   bool OptNone = false;
+  bool Profiling = false;
   struct Control {
     size_t StackSize;
     llvm::BasicBlock *JumpBlock;
@@ -3440,6 +3764,156 @@ static llvm::Value *createLikely(llvm::IRBuilder<> &Builder,
                                        Builder.getTrue());
 }
 
+/// Optimize the module by the pipeline of the level. The bounds checks in the
+/// loops are eliminated by splitting the iteration ranges.
+void optimize(llvm::Module &LLModule, llvm::TargetMachine &TM,
+              SSVM::AOT::Compiler::OptimizationLevel Level,
+              bool BoundsChecking) {
+  llvm::TargetLibraryInfoImpl TLII(llvm::Triple(LLModule.getTargetTriple()));
+
+#if LLVM_VERSION_MAJOR >= 9
+  llvm::PassBuilder PB(&TM, llvm::PipelineTuningOptions(), llvm::None);
+#else
+  llvm::PassBuilder PB(&TM, llvm::None);
+#endif
+
+#if LLVM_VERSION_MAJOR >= 13
+  llvm::LoopAnalysisManager LAM;
+  llvm::FunctionAnalysisManager FAM;
+  llvm::CGSCCAnalysisManager CGAM;
+  llvm::ModuleAnalysisManager MAM;
+#else
+  llvm::LoopAnalysisManager LAM(false);
+  llvm::FunctionAnalysisManager FAM(false);
+  llvm::CGSCCAnalysisManager CGAM(false);
+  llvm::ModuleAnalysisManager MAM(false);
+#endif
+
+  // Register the AA manager first so that our version is the one
+  // used.
+  FAM.registerPass([&] { return PB.buildDefaultAAPipeline(); });
+
+  // Register the target library analysis directly and give it a
+  // customized preset TLI.
+  FAM.registerPass([&] { return llvm::TargetLibraryAnalysis(TLII); });
+#if LLVM_VERSION_MAJOR <= 9
+  MAM.registerPass([&] { return llvm::TargetLibraryAnalysis(TLII); });
+#endif
+
+  // Register all the basic analyses with the managers.
+  PB.registerModuleAnalyses(MAM);
+  PB.registerCGSCCAnalyses(CGAM);
+  PB.registerFunctionAnalyses(FAM);
+  PB.registerLoopAnalyses(LAM);
+  PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+
+  if (BoundsChecking) {
+#if LLVM_VERSION_MAJOR >= 12
+    PB.registerScalarOptimizerLateEPCallback(
+        [](llvm::FunctionPassManager &FPM, auto) {
+          FPM.addPass(llvm::IRCEPass());
+        });
+#else
+    PB.registerLoopOptimizerEndEPCallback(
+        [](llvm::LoopPassManager &LPM, auto) {
+          LPM.addPass(llvm::IRCEPass());
+        });
+#endif
+  }
+
+#if LLVM_VERSION_MAJOR >= 13
+  llvm::ModulePassManager MPM;
+#else
+  llvm::ModulePassManager MPM(false);
+#endif
+  if (Level == SSVM::AOT::Compiler::OptimizationLevel::O0) {
+    MPM.addPass(llvm::AlwaysInlinerPass(false));
+  } else {
+    MPM.addPass(PB.buildPerModuleDefaultPipeline(toLLVMLevel(Level)));
+  }
+
+  MPM.run(LLModule, MAM);
+}
+
+/// Create the target machine of the host CPU.
+std::unique_ptr<llvm::TargetMachine>
+createTargetMachine(const std::string &Triple, const std::string &Features) {
+  std::string Error;
+  const llvm::Target *TheTarget =
+      llvm::TargetRegistry::lookupTarget(Triple, Error);
+  if (!TheTarget) {
+    // TODO:return error
+    LOG(ERROR) << "lookupTarget failed";
+    return nullptr;
+  }
+
+  llvm::TargetOptions Options;
+  llvm::Reloc::Model RM = llvm::Reloc::PIC_;
+  return std::unique_ptr<llvm::TargetMachine>(TheTarget->createTargetMachine(
+      Triple, llvm::sys::getHostCPUName(), Features, Options, RM, llvm::None,
+      llvm::CodeGenOpt::Level::Aggressive));
+}
+
+/// Generate the object file of the optimized module.
+bool codegen(llvm::Module &LLModule, llvm::TargetMachine &TM,
+             llvm::raw_pwrite_stream &OS) {
+  llvm::TargetLibraryInfoImpl TLII(llvm::Triple(LLModule.getTargetTriple()));
+  llvm::legacy::PassManager CodeGenPasses;
+  CodeGenPasses.add(
+      llvm::createTargetTransformInfoWrapperPass(TM.getTargetIRAnalysis()));
+
+  // Add LibraryInfo.
+  CodeGenPasses.add(new llvm::TargetLibraryInfoWrapperPass(TLII));
+
+#if LLVM_VERSION_MAJOR >= 10
+  using llvm::CGFT_ObjectFile;
+#else
+  const auto CGFT_ObjectFile = llvm::TargetMachine::CGFT_ObjectFile;
+#endif
+  if (TM.addPassesToEmitFile(CodeGenPasses, OS, nullptr, CGFT_ObjectFile,
+                             false)) {
+    // TODO:return error
+    LOG(ERROR) << "addPassesToEmitFile failed";
+    return false;
+  }
+
+  CodeGenPasses.run(LLModule);
+  return true;
+}
+
+/// Set the compile context during compiling.
+struct RAIICleanup {
+  RAIICleanup(SSVM::AOT::Compiler::CompileContext *&Context,
+              SSVM::AOT::Compiler::CompileContext &NewContext)
+      : Context(Context) {
+    Context = &NewContext;
+  }
+  ~RAIICleanup() { Context = nullptr; }
+  SSVM::AOT::Compiler::CompileContext *&Context;
+};
+
+/// Library of the code compiled in the memory by the JIT.
+class JITLibrary : public SSVM::Loader::SharedLibrary {
+public:
+  JITLibrary(std::unique_ptr<llvm::orc::LLJIT> J) noexcept
+      : JIT(std::move(J)) {}
+
+protected:
+  void *getSymbolAddr(const char *Name) const noexcept override {
+    auto Symbol = JIT->lookup(Name);
+    if (!Symbol) {
+      LOG(ERROR) << "JIT symbol lookup failed:" << Name;
+      llvm::consumeError(Symbol.takeError());
+      return nullptr;
+    }
+    return reinterpret_cast<void *>(
+        static_cast<uintptr_t>(Symbol->getAddress()));
+  }
+
+private:
+  std::unique_ptr<llvm::orc::LLJIT> JIT;
+};
+
 } // namespace
 
 namespace SSVM {
@@ -3464,15 +3938,283 @@ Expect<void> Compiler::compile(Span<const Byte> Data, const AST::Module &Module,
   LLModule->setTargetTriple(llvm::sys::getProcessTriple());
   LLModule->setPICLevel(llvm::PICLevel::Level::SmallPIC);
   CompileContext NewContext(*LLModule);
-  struct RAIICleanup {
-    RAIICleanup(CompileContext *&Context, CompileContext &NewContext)
-        : Context(Context) {
-      Context = &NewContext;
+  RAIICleanup Cleanup(Context, NewContext);
+  generate(Data, Module);
+
+  const std::string Triple = LLModule->getTargetTriple();
+  const std::string Features = Context->SubtargetFeatures.getString();
+  auto TM = createTargetMachine(Triple, Features);
+  if (!TM) {
+    return Unexpect(ErrCode::InvalidPath);
+  }
+  LLModule->setDataLayout(TM->createDataLayout());
+
+  // split
+  /// The partitions are passed to the threads as bitcode, since the modules
+  /// in the same context cannot be used by several threads.
+  std::vector<llvm::SmallString<0>> Bitcodes;
+  if (const auto Parts = std::min(
+          Jobs, uint32_t(Module.getCodeSection().getContent().size()));
+      Parts > 1) {
+    LOG(INFO) << "split start";
+    llvm::SplitModule(
+#if LLVM_VERSION_MAJOR >= 13
+        *LLModule,
+#else
+        std::move(LLModule),
+#endif
+        Parts, [&Bitcodes](std::unique_ptr<llvm::Module> Part) {
+          llvm::raw_svector_ostream OS(Bitcodes.emplace_back());
+          llvm::WriteBitcodeToFile(*Part, OS);
+        });
+  }
+
+  // tempfile
+  const uint32_t ObjectNum = std::max(uint32_t(Bitcodes.size()), 1U);
+  std::vector<llvm::sys::fs::TempFile> Objects;
+  auto Discard = [&Objects]() {
+    for (auto &Object : Objects) {
+      llvm::consumeError(Object.discard());
     }
-    ~RAIICleanup() { Context = nullptr; }
-    CompileContext *&Context;
   };
+  for (uint32_t I = 0; I < ObjectNum; ++I) {
+    auto Object = llvm::sys::fs::TempFile::create(OPath.u8string());
+    if (!Object) {
+      // TODO:return error
+      LOG(ERROR) << "so file creation failed:" << OPath.native();
+      llvm::consumeError(Object.takeError());
+      Discard();
+      return Unexpect(ErrCode::InvalidPath);
+    }
+    Objects.push_back(std::move(*Object));
+  }
+
+  // optimize + codegen
+  auto Generate = [this, &Objects, ObjectNum](llvm::Module &LLModule,
+                                              llvm::TargetMachine &TM,
+                                              uint32_t Index) {
+    optimize(LLModule, TM, Level, BoundsChecking);
+    if (DumpIR) {
+      int Fd;
+      llvm::sys::fs::openFileForWrite(
+          ObjectNum > 1 ? "wasm-opt." + std::to_string(Index) + ".ll"
+                        : "wasm-opt.ll",
+          Fd);
+      llvm::raw_fd_ostream OS(Fd, true);
+      LLModule.print(OS, nullptr);
+    }
+    std::error_code EC;
+    llvm::raw_fd_ostream OS(Objects[Index].TmpName, EC);
+    if (EC) {
+      // TODO:return error
+      LOG(ERROR) << "object file creation failed:" << Objects[Index].TmpName;
+      return false;
+    }
+    return codegen(LLModule, TM, OS);
+  };
+
+  LOG(INFO) << "codegen start";
+  if (Bitcodes.empty()) {
+    if (!Generate(*LLModule, *TM, 0)) {
+      Discard();
+      return Unexpect(ErrCode::InvalidPath);
+    }
+  } else {
+    std::vector<uint8_t> Results(ObjectNum, 0);
+    std::atomic<uint32_t> Next = 0;
+    auto Worker = [&]() {
+      for (uint32_t I; (I = Next.fetch_add(1)) < ObjectNum;) {
+        llvm::LLVMContext PartContext;
+        auto Part = llvm::parseBitcodeFile(
+            llvm::MemoryBufferRef(
+                llvm::StringRef(Bitcodes[I].data(), Bitcodes[I].size()),
+                "partition"),
+            PartContext);
+        if (!Part) {
+          LOG(ERROR) << "partition parsing failed";
+          llvm::consumeError(Part.takeError());
+          continue;
+        }
+        if (auto PartTM = createTargetMachine(Triple, Features)) {
+          Results[I] = Generate(**Part, *PartTM, I);
+        }
+      }
+    };
+    std::vector<std::thread> Threads;
+    for (uint32_t I = 1; I < ObjectNum; ++I) {
+      Threads.emplace_back(Worker);
+    }
+    Worker();
+    for (auto &Thread : Threads) {
+      Thread.join();
+    }
+    if (std::find(Results.begin(), Results.end(), 0) != Results.end()) {
+      Discard();
+      return Unexpect(ErrCode::InvalidPath);
+    }
+  }
+
+  // link
+  const std::string Output = OutputPath.u8string();
+#if SSVM_AOT_LLD
+#ifdef __APPLE__
+  using lld::mach_o::link;
+#else
+  using lld::elf::link;
+#endif
+  std::vector<const char *> Args = {"lld", "--shared", "--gc-sections"};
+#elif defined(__APPLE__)
+  std::vector<const char *> Args = {"ld", "-dylib", "-dead_strip"};
+#else
+  std::vector<const char *> Args = {"ld", "--shared", "--gc-sections"};
+#endif
+  for (const auto &Object : Objects) {
+    Args.push_back(Object.TmpName.c_str());
+  }
+  Args.push_back("-o");
+  Args.push_back(Output.c_str());
+#if SSVM_AOT_LLD
+  link(Args, false,
+#if LLVM_VERSION_MAJOR >= 10
+       llvm::outs(), llvm::errs()
+#else
+       llvm::errs()
+#endif
+  );
+#else
+  /// Link by the system linker without the lld libraries.
+  Args.push_back(nullptr);
+  pid_t Pid;
+  int Status = 0;
+  if (posix_spawnp(&Pid, Args[0], nullptr, nullptr,
+                   const_cast<char *const *>(Args.data()), environ) != 0 ||
+      waitpid(Pid, &Status, 0) != Pid || !WIFEXITED(Status) ||
+      WEXITSTATUS(Status) != 0) {
+    LOG(ERROR) << "link failed";
+    Discard();
+    return Unexpect(ErrCode::InvalidPath);
+  }
+#endif
+
+  Discard();
+  LOG(INFO) << "compile done";
+
+  return {};
+}
+
+Expect<void> Compiler::compileJIT(AST::Module &Module, bool Lazy) {
+  LOG(INFO) << "compile start";
+  llvm::InitializeNativeTarget();
+  llvm::InitializeNativeTargetAsmPrinter();
+
+  llvm::orc::ThreadSafeContext TSContext(std::make_unique<llvm::LLVMContext>());
+  auto LLModule =
+      std::make_unique<llvm::Module>("wasm", *TSContext.getContext());
+  LLModule->setTargetTriple(llvm::sys::getProcessTriple());
+  LLModule->setPICLevel(llvm::PICLevel::Level::SmallPIC);
+  CompileContext NewContext(*LLModule);
   RAIICleanup Cleanup(Context, NewContext);
+  generate({}, Module);
+
+  auto JTMB = llvm::orc::JITTargetMachineBuilder::detectHost();
+  if (!JTMB) {
+    LOG(ERROR) << "detectHost failed";
+    llvm::consumeError(JTMB.takeError());
+    return Unexpect(ErrCode::InvalidPath);
+  }
+  JTMB->setCodeGenOptLevel(llvm::CodeGenOpt::Level::Aggressive);
+  auto TM = JTMB->createTargetMachine();
+  if (!TM) {
+    LOG(ERROR) << "createTargetMachine failed";
+    llvm::consumeError(TM.takeError());
+    return Unexpect(ErrCode::InvalidPath);
+  }
+  LLModule->setDataLayout((*TM)->createDataLayout());
+
+  auto JIT = [&]() -> llvm::Expected<std::unique_ptr<llvm::orc::LLJIT>> {
+    if (Lazy) {
+      return llvm::orc::LLLazyJITBuilder()
+          .setJITTargetMachineBuilder(std::move(*JTMB))
+          .create();
+    }
+    return llvm::orc::LLJITBuilder()
+        .setJITTargetMachineBuilder(std::move(*JTMB))
+        .create();
+  }();
+  if (!JIT) {
+    LOG(ERROR) << "JIT creation failed";
+    llvm::consumeError(JIT.takeError());
+    return Unexpect(ErrCode::InvalidPath);
+  }
+
+  /// The intrinsics table is resolved from the process, the same as the
+  /// shared libraries.
+  auto Generator =
+      llvm::orc::DynamicLibrarySearchGenerator::GetForCurrentProcess(
+          (*JIT)->getDataLayout().getGlobalPrefix());
+  if (!Generator) {
+    LOG(ERROR) << "process symbols lookup failed";
+    llvm::consumeError(Generator.takeError());
+    return Unexpect(ErrCode::InvalidPath);
+  }
+  (*JIT)->getMainJITDylib().addGenerator(std::move(*Generator));
+
+  /// Optimize the modules when they are materialized, which are the partitions
+  /// of the functions called in the lazy JIT.
+  (*JIT)->getIRTransformLayer().setTransform(
+      [TM = std::move(*TM), Level = Level,
+       BoundsChecking = BoundsChecking](llvm::orc::ThreadSafeModule TSM,
+                                        const auto &)
+          -> llvm::Expected<llvm::orc::ThreadSafeModule> {
+        TSM.withModuleDo(
+            [&](llvm::Module &M) { optimize(M, *TM, Level, BoundsChecking); });
+        return std::move(TSM);
+      });
+
+  llvm::orc::ThreadSafeModule TSM(std::move(LLModule), TSContext);
+  if (auto Err = Lazy ? static_cast<llvm::orc::LLLazyJIT &>(**JIT)
+                            .addLazyIRModule(std::move(TSM))
+                      : (*JIT)->addIRModule(std::move(TSM))) {
+    LOG(ERROR) << "adding module failed";
+    llvm::consumeError(std::move(Err));
+    return Unexpect(ErrCode::InvalidPath);
+  }
+
+  LDMgr Mgr;
+  Mgr.setLibrary(std::make_shared<JITLibrary>(std::move(*JIT)));
+  if (!Mgr.getSymbol<void *[]>("codes")) {
+    return Unexpect(ErrCode::InvalidPath);
+  }
+  LOG(INFO) << "compile done";
+  return Module.loadCompiled(Mgr);
+}
+
+std::string Compiler::getFingerprint() const {
+  std::string Fingerprint = "version:" + std::to_string(kBinaryVersion) +
+                            " level:" + std::to_string(uint32_t(Level)) +
+                            " ic:" + std::to_string(InstructionCounting) +
+                            " gas:" + std::to_string(GasMeasuring) +
+                            " bounds:" + std::to_string(BoundsChecking) +
+                            " cpu:" + llvm::sys::getHostCPUName().str();
+  /// The features are sorted, as the order of the map is unspecified.
+  llvm::StringMap<bool> FeatureMap;
+  llvm::sys::getHostCPUFeatures(FeatureMap);
+  std::vector<std::string> Features;
+  for (auto &Feature : FeatureMap) {
+    Features.push_back((Feature.second ? "+" : "-") + Feature.first().str());
+  }
+  std::sort(Features.begin(), Features.end());
+  for (const auto &Feature : Features) {
+    Fingerprint += ' ';
+    Fingerprint += Feature;
+  }
+  return Fingerprint;
+}
+
+void Compiler::generate(Span<const Byte> Data, const AST::Module &Module) {
+  auto &LLModule = Context->LLModule;
+  auto &LLContext = Context->LLContext;
+  Context->BoundsChecking = BoundsChecking;
 
   /// Compile Function Types
   compile(Module.getTypeSection());
@@ -3490,19 +4232,26 @@ Expect<void> Compiler::compile(Span<const Byte> Data, const AST::Module &Module,
   compile(Module.getExportSection());
   /// StartSection is not required to compile
 
+  /// create memory.bounds, which is set if the functions do not rely on the
+  /// guard region of the memory
+  new llvm::GlobalVariable(
+      LLModule, Context->Int32Ty, true, llvm::GlobalValue::ExternalLinkage,
+      llvm::ConstantInt::get(Context->Int32Ty, BoundsChecking),
+      "memory.bounds");
+
   /// create wasm.code and wasm.size
-  {
+  if (!Data.empty()) {
     auto *Int32Ty = Context->Int32Ty;
     auto *Content = llvm::ConstantDataArray::getString(
         LLContext,
         llvm::StringRef(reinterpret_cast<const char *>(Data.data()),
                         Data.size()),
         false);
-    new llvm::GlobalVariable(Context->LLModule, Content->getType(), false,
+    new llvm::GlobalVariable(LLModule, Content->getType(), false,
                              llvm::GlobalValue::ExternalLinkage, Content,
                              "wasm.code");
     new llvm::GlobalVariable(
-        Context->LLModule, Int32Ty, false, llvm::GlobalValue::ExternalLinkage,
+        LLModule, Int32Ty, false, llvm::GlobalValue::ExternalLinkage,
         llvm::ConstantInt::get(Int32Ty, Data.size()), "wasm.size");
   }
 
@@ -3510,143 +4259,12 @@ Expect<void> Compiler::compile(Span<const Byte> Data, const AST::Module &Module,
     int Fd;
     llvm::sys::fs::openFileForWrite("wasm.ll", Fd);
     llvm::raw_fd_ostream OS(Fd, true);
-    LLModule->print(OS, nullptr);
+    LLModule.print(OS, nullptr);
   }
 
   LOG(INFO) << "verify start";
-  llvm::verifyModule(*LLModule, &llvm::errs());
+  llvm::verifyModule(LLModule, &llvm::errs());
   LOG(INFO) << "optimize start";
-
-  // tempfile
-  auto Object = llvm::sys::fs::TempFile::create(OPath.u8string());
-  if (!Object) {
-    // TODO:return error
-    LOG(ERROR) << "so file creation failed:" << OPath.native();
-    llvm::consumeError(Object.takeError());
-    return Unexpect(ErrCode::InvalidPath);
-  }
-  std::error_code EC;
-  auto OS = std::make_unique<llvm::raw_fd_ostream>(Object->TmpName, EC);
-  if (EC) {
-    // TODO:return error
-    LOG(ERROR) << "object file creation failed:" << Object->TmpName;
-    llvm::consumeError(Object->discard());
-    return Unexpect(ErrCode::InvalidPath);
-  }
-
-  // optimize + codegen
-  {
-    std::string Error;
-    std::string Triple = LLModule->getTargetTriple();
-    const llvm::Target *TheTarget =
-        llvm::TargetRegistry::lookupTarget(Triple, Error);
-    if (!TheTarget) {
-      // TODO:return error
-      LOG(ERROR) << "lookupTarget failed";
-      llvm::consumeError(Object->discard());
-      return Unexpect(ErrCode::InvalidPath);
-    }
-
-    llvm::TargetOptions Options;
-    llvm::Reloc::Model RM = llvm::Reloc::PIC_;
-    std::unique_ptr<llvm::TargetMachine> TM(TheTarget->createTargetMachine(
-        Triple, llvm::sys::getHostCPUName(),
-        Context->SubtargetFeatures.getString(), Options, RM, llvm::None,
-        llvm::CodeGenOpt::Level::Aggressive));
-    LLModule->setDataLayout(TM->createDataLayout());
-
-    llvm::TargetLibraryInfoImpl TLII(llvm::Triple(LLModule->getTargetTriple()));
-
-    {
-#if LLVM_VERSION_MAJOR >= 9
-      llvm::PassBuilder PB(TM.get(), llvm::PipelineTuningOptions(), llvm::None);
-#else
-      llvm::PassBuilder PB(TM.get(), llvm::None);
-#endif
-
-      llvm::LoopAnalysisManager LAM(false);
-      llvm::FunctionAnalysisManager FAM(false);
-      llvm::CGSCCAnalysisManager CGAM(false);
-      llvm::ModuleAnalysisManager MAM(false);
-
-      // Register the AA manager first so that our version is the one
-      // used.
-      FAM.registerPass([&] { return PB.buildDefaultAAPipeline(); });
-
-      // Register the target library analysis directly and give it a
-      // customized preset TLI.
-      FAM.registerPass([&] { return llvm::TargetLibraryAnalysis(TLII); });
-#if LLVM_VERSION_MAJOR <= 9
-      MAM.registerPass([&] { return llvm::TargetLibraryAnalysis(TLII); });
-#endif
-
-      // Register all the basic analyses with the managers.
-      PB.registerModuleAnalyses(MAM);
-      PB.registerCGSCCAnalyses(CGAM);
-      PB.registerFunctionAnalyses(FAM);
-      PB.registerLoopAnalyses(LAM);
-      PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
-
-      llvm::ModulePassManager MPM(false);
-      if (optNone()) {
-        MPM.addPass(llvm::AlwaysInlinerPass(false));
-      } else {
-        MPM.addPass(PB.buildPerModuleDefaultPipeline(toLLVMLevel(Level)));
-      }
-
-      MPM.run(*LLModule, MAM);
-    }
-
-    llvm::legacy::PassManager CodeGenPasses;
-    CodeGenPasses.add(
-        llvm::createTargetTransformInfoWrapperPass(TM->getTargetIRAnalysis()));
-
-    // Add LibraryInfo.
-    CodeGenPasses.add(new llvm::TargetLibraryInfoWrapperPass(TLII));
-
-#if LLVM_VERSION_MAJOR >= 10
-    using llvm::CGFT_ObjectFile;
-#else
-    const auto CGFT_ObjectFile = llvm::TargetMachine::CGFT_ObjectFile;
-#endif
-    if (TM->addPassesToEmitFile(CodeGenPasses, *OS, nullptr, CGFT_ObjectFile,
-                                false)) {
-      // TODO:return error
-      LOG(ERROR) << "addPassesToEmitFile failed";
-      llvm::consumeError(Object->discard());
-      return Unexpect(ErrCode::InvalidPath);
-    }
-
-    if (DumpIR) {
-      int Fd;
-      llvm::sys::fs::openFileForWrite("wasm-opt.ll", Fd);
-      llvm::raw_fd_ostream OS(Fd, true);
-      LLModule->print(OS, nullptr);
-    }
-    LOG(INFO) << "codegen start";
-    CodeGenPasses.run(*LLModule);
-  }
-
-  // link
-#ifdef __APPLE__
-  using lld::mach_o::link;
-#else
-  using lld::elf::link;
-#endif
-  link(std::array{"lld", "--shared", "--gc-sections", Object->TmpName.c_str(),
-                  "-o", OutputPath.u8string().c_str()},
-       false,
-#if LLVM_VERSION_MAJOR >= 10
-       llvm::outs(), llvm::errs()
-#else
-       llvm::errs()
-#endif
-  );
-
-  llvm::consumeError(Object->discard());
-  LOG(INFO) << "compile done";
-
-  return {};
 }
 
 void Compiler::compile(const AST::TypeSection &TypeSection) {
@@ -3664,6 +4282,7 @@ void Compiler::compile(const AST::TypeSection &TypeSection) {
   Types.reserve(Size);
   Context->FunctionTypes.reserve(Size);
   Context->FunctionWrappers.reserve(Size);
+  Context->IndirectCallThunks.reserve(Size);
 
   /// Iterate and compile types.
   for (size_t I = 0; I < Size; ++I) {
@@ -3679,6 +4298,8 @@ void Compiler::compile(const AST::TypeSection &TypeSection) {
           Context->FunctionTypes.push_back(&OldFuncType);
           auto *F = Context->FunctionWrappers[J];
           Context->FunctionWrappers.push_back(F);
+          Context->IndirectCallThunks.push_back(
+              Context->IndirectCallThunks[J]);
           Types.push_back(Types[J]);
           break;
         }
@@ -3695,7 +4316,9 @@ void Compiler::compile(const AST::TypeSection &TypeSection) {
     {
       F->addFnAttr(llvm::Attribute::StrictFP);
       F->addParamAttr(0, llvm::Attribute::AttrKind::ReadOnly);
-      F->addParamAttr(0, llvm::Attribute::AttrKind::NoAlias);
+      if (!Context->BoundsChecking) {
+        F->addParamAttr(0, llvm::Attribute::AttrKind::NoAlias);
+      }
       F->addParamAttr(1, llvm::Attribute::AttrKind::NoAlias);
       F->addParamAttr(2, llvm::Attribute::AttrKind::NoAlias);
       F->addParamAttr(3, llvm::Attribute::AttrKind::NoAlias);
@@ -3721,35 +4344,125 @@ void Compiler::compile(const AST::TypeSection &TypeSection) {
       Args.push_back(ExecCtxPtr);
       for (size_t I = 0; I < ArgCount; ++I) {
         auto *ArgTy = FTy->getParamType(I + 1);
-        llvm::Value *VPtr =
-            Builder.CreateConstInBoundsGEP1_64(RawArgs, I * kValSize);
+        llvm::Value *VPtr = Builder.CreateConstInBoundsGEP1_64(
+            Context->Int8Ty, RawArgs, I * kValSize);
         llvm::Value *Ptr = Builder.CreateBitCast(VPtr, ArgTy->getPointerTo());
-        Args.push_back(Builder.CreateLoad(Ptr));
+        Args.push_back(Builder.CreateLoad(ArgTy, Ptr));
       }
 
       auto Ret = Builder.CreateCall(RawFunc, Args);
+      Ret->setCallingConv(llvm::CallingConv::Tail);
       if (RTy->isVoidTy()) {
         // nothing to do
       } else if (RTy->isStructTy()) {
         auto Rets = unpackStruct(Builder, Ret);
         for (size_t I = 0; I < RetCount; ++I) {
-          llvm::Value *VPtr =
-              Builder.CreateConstInBoundsGEP1_64(RawRets, I * kValSize);
+          llvm::Value *VPtr = Builder.CreateConstInBoundsGEP1_64(
+              Context->Int8Ty, RawRets, I * kValSize);
           llvm::Value *Ptr =
               Builder.CreateBitCast(VPtr, Rets[I]->getType()->getPointerTo());
           Builder.CreateStore(Rets[I], Ptr);
         }
       } else {
-        llvm::Value *VPtr = Builder.CreateConstInBoundsGEP1_64(RawRets, 0);
+        llvm::Value *VPtr =
+            Builder.CreateConstInBoundsGEP1_64(Context->Int8Ty, RawRets, 0);
         llvm::Value *Ptr =
             Builder.CreateBitCast(VPtr, Ret->getType()->getPointerTo());
         Builder.CreateStore(Ret, Ptr);
       }
       Builder.CreateRetVoid();
     }
+    /// Create the thunk calling the function through the runtime, which the
+    /// indirect tail calls jump to if the callee is not a compiled function
+    /// of this module.
+    llvm::Function *Thunk;
+    {
+      auto *FTy = toLLVMType(Context->ExecCtxPtrTy, FuncType);
+      auto *RTy = FTy->getReturnType();
+      std::vector<llvm::Type *> ParamTys = {
+          Context->ExecCtxPtrTy, Context->Int32Ty, Context->Int32Ty};
+      ParamTys.insert(ParamTys.end(), FTy->param_begin() + 1,
+                      FTy->param_end());
+      Thunk = llvm::Function::Create(
+          llvm::FunctionType::get(RTy, ParamTys, false),
+          llvm::Function::InternalLinkage,
+          "i" + std::to_string(Context->FunctionTypes.size()),
+          Context->LLModule);
+      Thunk->setCallingConv(llvm::CallingConv::Tail);
+      Thunk->addFnAttr(llvm::Attribute::StrictFP);
+
+      llvm::IRBuilder<> Builder(
+          llvm::BasicBlock::Create(Thunk->getContext(), "entry", Thunk));
+      setIsFPConstrained(Builder);
+      const size_t ArgCount = FTy->getNumParams() - 1;
+      const size_t RetCount =
+          RTy->isVoidTy()
+              ? 0
+              : (RTy->isStructTy() ? RTy->getStructNumElements() : 1);
+
+      llvm::Value *Args;
+      if (ArgCount == 0) {
+        Args = llvm::ConstantPointerNull::get(Context->Int8PtrTy);
+      } else {
+        auto *Alloca = Builder.CreateAlloca(
+            Context->Int8Ty, Builder.getInt64(ArgCount * kValSize));
+        Alloca->setAlignment(Align(kValSize));
+        Args = Alloca;
+      }
+      llvm::Value *Rets;
+      if (RetCount == 0) {
+        Rets = llvm::ConstantPointerNull::get(Context->Int8PtrTy);
+      } else {
+        auto *Alloca = Builder.CreateAlloca(
+            Context->Int8Ty, Builder.getInt64(RetCount * kValSize));
+        Alloca->setAlignment(Align(kValSize));
+        Rets = Alloca;
+      }
+
+      for (size_t I = 0; I < ArgCount; ++I) {
+        llvm::Argument *Arg = Thunk->arg_begin() + 3 + I;
+        llvm::Value *Ptr = Builder.CreateConstInBoundsGEP1_64(
+            Context->Int8Ty, Args, I * kValSize);
+        Builder.CreateStore(
+            Arg, Builder.CreateBitCast(Ptr, Arg->getType()->getPointerTo()));
+      }
+
+      Builder.CreateCall(
+          Context->getIntrinsic(
+              Builder, AST::Module::Intrinsics::kCallIndirect,
+              llvm::FunctionType::get(Context->VoidTy,
+                                      {Context->Int32Ty, Context->Int32Ty,
+                                       Context->Int32Ty, Context->Int8PtrTy,
+                                       Context->Int8PtrTy},
+                                      false)),
+          {Thunk->arg_begin() + 1, Builder.getInt32(I),
+           Thunk->arg_begin() + 2, Args, Rets});
+
+      if (RetCount == 0) {
+        Builder.CreateRetVoid();
+      } else if (RetCount == 1) {
+        llvm::Value *VPtr =
+            Builder.CreateConstInBoundsGEP1_64(Context->Int8Ty, Rets, 0);
+        llvm::Value *Ptr = Builder.CreateBitCast(VPtr, RTy->getPointerTo());
+        Builder.CreateRet(Builder.CreateLoad(RTy, Ptr));
+      } else {
+        std::vector<llvm::Value *> Ret;
+        Ret.reserve(RetCount);
+        for (size_t J = 0; J < RetCount; ++J) {
+          llvm::Value *VPtr = Builder.CreateConstInBoundsGEP1_64(
+              Context->Int8Ty, Rets, J * kValSize);
+          llvm::Value *Ptr = Builder.CreateBitCast(
+              VPtr, RTy->getStructElementType(J)->getPointerTo());
+          Ret.push_back(Builder.CreateLoad(RTy->getStructElementType(J), Ptr));
+        }
+        Builder.CreateAggregateRet(Ret.data(), RetCount);
+      }
+    }
+
     /// Copy wrapper, param and return lists to module instance.
     Context->FunctionTypes.push_back(&FuncType);
     Context->FunctionWrappers.push_back(F);
+    Context->IndirectCallThunks.push_back(Thunk);
     Types.push_back(llvm::ConstantExpr::getBitCast(F, Context->Int8PtrTy));
   }
 
@@ -3780,9 +4493,12 @@ void Compiler::compile(const AST::ImportSection &ImportSec) {
       auto *F = llvm::Function::Create(FTy, llvm::Function::InternalLinkage,
                                        "f" + std::to_string(FuncID),
                                        Context->LLModule);
+      F->setCallingConv(llvm::CallingConv::Tail);
       F->addFnAttr(llvm::Attribute::StrictFP);
       F->addParamAttr(0, llvm::Attribute::AttrKind::ReadOnly);
-      F->addParamAttr(0, llvm::Attribute::AttrKind::NoAlias);
+      if (!Context->BoundsChecking) {
+        F->addParamAttr(0, llvm::Attribute::AttrKind::NoAlias);
+      }
 
       auto *Entry = llvm::BasicBlock::Create(Context->LLContext, "entry", F);
       llvm::IRBuilder<> Builder(Entry);
@@ -3814,8 +4530,8 @@ void Compiler::compile(const AST::ImportSection &ImportSec) {
 
       for (unsigned I = 0; I < ArgSize; ++I) {
         llvm::Argument *Arg = F->arg_begin() + 1 + I;
-        llvm::Value *Ptr =
-            Builder.CreateConstInBoundsGEP1_64(Args, I * kValSize);
+        llvm::Value *Ptr = Builder.CreateConstInBoundsGEP1_64(
+            Context->Int8Ty, Args, I * kValSize);
         Builder.CreateStore(
             Arg, Builder.CreateBitCast(Ptr, Arg->getType()->getPointerTo()));
       }
@@ -3832,19 +4548,20 @@ void Compiler::compile(const AST::ImportSection &ImportSec) {
       if (RetSize == 0) {
         Builder.CreateRetVoid();
       } else if (RetSize == 1) {
-        llvm::Value *VPtr = Builder.CreateConstInBoundsGEP1_64(Rets, 0);
+        llvm::Value *VPtr =
+            Builder.CreateConstInBoundsGEP1_64(Context->Int8Ty, Rets, 0);
         llvm::Value *Ptr =
             Builder.CreateBitCast(VPtr, F->getReturnType()->getPointerTo());
-        Builder.CreateRet(Builder.CreateLoad(Ptr));
+        Builder.CreateRet(Builder.CreateLoad(F->getReturnType(), Ptr));
       } else {
         std::vector<llvm::Value *> Ret;
         Ret.reserve(RetSize);
         for (unsigned I = 0; I < RetSize; ++I) {
-          llvm::Value *VPtr =
-              Builder.CreateConstInBoundsGEP1_64(Rets, I * kValSize);
+          llvm::Value *VPtr = Builder.CreateConstInBoundsGEP1_64(
+              Context->Int8Ty, Rets, I * kValSize);
           llvm::Value *Ptr = Builder.CreateBitCast(
               VPtr, RTy->getStructElementType(I)->getPointerTo());
-          Ret.push_back(Builder.CreateLoad(Ptr));
+          Ret.push_back(Builder.CreateLoad(RTy->getStructElementType(I), Ptr));
         }
         Builder.CreateAggregateRet(Ret.data(), RetSize);
       }
@@ -3859,7 +4576,10 @@ void Compiler::compile(const AST::ImportSection &ImportSec) {
     }
     case ExternalType::Memory: /// Memory type
     {
-      /// Nothing to do.
+      /// The imported memory has at least the minimum pages.
+      const auto &Limit = ImpDesc.getExternalMemoryType().getLimit();
+      Context->MemMin = Limit.getMin();
+      Context->MemMax = Limit.hasMax() ? Limit.getMax() : 65536;
       break;
     }
     case ExternalType::Global: /// Global type
@@ -3922,9 +4642,16 @@ void Compiler::compile(const AST::FunctionSection &FuncSec,
     auto *F =
         llvm::Function::Create(FTy, llvm::Function::InternalLinkage,
                                "f" + std::to_string(FuncID), Context->LLModule);
+    /// The functions use the calling convention guaranteeing the tail calls
+    /// between the different prototypes.
+    F->setCallingConv(llvm::CallingConv::Tail);
     F->addFnAttr(llvm::Attribute::StrictFP);
     F->addParamAttr(0, llvm::Attribute::AttrKind::ReadOnly);
-    F->addParamAttr(0, llvm::Attribute::AttrKind::NoAlias);
+    /// The memory is reloaded from the context, which is updated by the
+    /// calls, if the bounds are checked.
+    if (!Context->BoundsChecking) {
+      F->addParamAttr(0, llvm::Attribute::AttrKind::NoAlias);
+    }
 
     Context->Functions.emplace_back(TypeIdx, F, &Code);
     Codes.push_back(llvm::ConstantExpr::getBitCast(F, Context->Int8PtrTy));
@@ -3937,7 +4664,9 @@ void Compiler::compile(const AST::FunctionSection &FuncSec,
                              llvm::ConstantArray::get(ArrayTy, Codes), "codes");
   }
 
-  for (auto [T, F, Code] : Context->Functions) {
+  for (uint32_t FuncIndex = 0; FuncIndex < Context->Functions.size();
+       ++FuncIndex) {
+    auto [T, F, Code] = Context->Functions[FuncIndex];
     if (!Code) {
       continue;
     }
@@ -3948,8 +4677,8 @@ void Compiler::compile(const AST::FunctionSection &FuncSec,
         Locals.push_back(Local.second);
       }
     }
-    FunctionCompiler FC(*Context, F, Locals, InstructionCounting, GasMeasuring,
-                        optNone());
+    FunctionCompiler FC(*Context, F, FuncIndex, Locals, InstructionCounting,
+                        GasMeasuring, optNone());
     auto Type = Context->resolveBlockType(T);
     FC.compile(*Code, std::move(Type));
     llvm::EliminateUnreachableBlocks(*F);
@@ -3,10 +3,26 @@
 #include "ast/base.h"
 #include "common/log.h"
 
+#include <algorithm>
+#include <initializer_list>
+
 namespace SSVM {
 namespace AST {
 
 namespace {
+/// Superinstruction with its OpCode sequence.
+struct SuperOpPattern {
+  SuperOp Op;
+  std::initializer_list<OpCode> Codes;
+};
+
+/// Patterns in superop.inc order, where the longer sequences come first.
+const SuperOpPattern Patterns[] = {
+#define UseSuperOp(NAME, ...) {SuperOp::NAME, {__VA_ARGS__}},
+#include "common/superop.inc"
+#undef UseSuperOp
+};
+
 Expect<void> checkInstrProposals(OpCode Code, const Configure &Conf,
                                  uint32_t Offset) {
   if ((Code >= OpCode::Ref__null && Code <= OpCode::Ref__func) ||
@@ -27,6 +43,13 @@ Expect<void> checkInstrProposals(OpCode Code, const Configure &Conf,
       return logNeedProposal(ErrCode::InvalidOpCode, Proposal::ReferenceTypes,
                              Offset, ASTNodeAttr::Instruction);
     }
+  } else if (Code == OpCode::Return_call ||
+             Code == OpCode::Return_call_indirect) {
+    /// These instructions are for TailCall proposal.
+    if (!Conf.hasProposal(Proposal::TailCall)) {
+      return logNeedProposal(ErrCode::InvalidOpCode, Proposal::TailCall, Offset,
+                             ASTNodeAttr::Instruction);
+    }
   } else if (Code >= OpCode::V128__load &&
              Code <= OpCode::F64x2__convert_i64x2_u) {
     /// These instructions are for SIMD proposal.
@@ -88,10 +111,10 @@ Expect<void> Instruction::loadBinary(FileMgr &Mgr, const Configure &Conf) {
             !Check) {
           return Unexpect(Check);
         }
-        ResType = VType;
+        Data.Blocks.ResType = VType;
       } else {
         /// Type index case.
-        ResType = static_cast<uint32_t>(*Res);
+        Data.Blocks.ResType = static_cast<uint32_t>(*Res);
       }
     } else {
       return logLoadError(Res.error(), Mgr.getOffset(),
@@ -101,41 +124,44 @@ Expect<void> Instruction::loadBinary(FileMgr &Mgr, const Configure &Conf) {
 
   case OpCode::Br:
   case OpCode::Br_if:
-    return readU32(TargetIdx);
+    return readU32(Data.Jump.TargetIndex);
 
   case OpCode::Br_table:
     if (auto Res = Mgr.readU32()) {
-      /// Read the vector of labels.
+      /// Read the vector of labels and the default label, which is the last
+      /// one of the label list.
       uint32_t VecCnt = *Res;
-      LabelList.reserve(VecCnt);
-      for (uint32_t I = 0; I < VecCnt; ++I) {
-        uint32_t Label = 0;
-        if (auto Res = readU32(Label)) {
-          LabelList.push_back(Label);
+      Data.BrTable.LabelList = new JumpDescriptor[VecCnt + UINT64_C(1)]();
+      for (uint32_t I = 0; I <= VecCnt; ++I) {
+        if (auto Res = readU32(Data.BrTable.LabelList[I].TargetIndex)) {
+          Data.BrTable.LabelListSize++;
         } else {
           return Unexpect(Res);
         }
       }
-      /// Read default label.
-      return readU32(TargetIdx);
+      Data.BrTable.TargetIdx = Data.BrTable.LabelList[VecCnt].TargetIndex;
+      return {};
     } else {
       return logLoadError(Res.error(), Mgr.getOffset(),
                           ASTNodeAttr::Instruction);
     }
 
   case OpCode::Call:
-    return readU32(TargetIdx);
+  case OpCode::Return_call:
+    return readU32(Data.Indices.TargetIdx);
 
   case OpCode::Call_indirect:
+  case OpCode::Return_call_indirect:
     /// Read function index.
-    if (auto Res = readU32(TargetIdx); !Res) {
+    if (auto Res = readU32(Data.Indices.TargetIdx); !Res) {
       return Unexpect(Res);
     }
     /// Read the table index.
-    if (auto Res = readU32(SourceIdx); !Res) {
+    if (auto Res = readU32(Data.Indices.SourceIdx); !Res) {
       return Unexpect(Res);
     }
-    if (SourceIdx > 0 && !Conf.hasProposal(Proposal::ReferenceTypes)) {
+    if (Data.Indices.SourceIdx > 0 &&
+        !Conf.hasProposal(Proposal::ReferenceTypes)) {
       return logNeedProposal(ErrCode::InvalidGrammar, Proposal::ReferenceTypes,
                              Mgr.getOffset() - 1, ASTNodeAttr::Instruction);
     }
@@ -144,10 +170,10 @@ Expect<void> Instruction::loadBinary(FileMgr &Mgr, const Configure &Conf) {
   /// Reference Instructions.
   case OpCode::Ref__null:
     if (auto Res = Mgr.readByte()) {
-      ReferenceType = static_cast<RefType>(*Res);
-      if (auto Check =
-              checkRefTypeProposals(Conf, ReferenceType, Mgr.getOffset() - 1,
-                                    ASTNodeAttr::Instruction);
+      Data.ReferenceType = static_cast<RefType>(*Res);
+      if (auto Check = checkRefTypeProposals(Conf, Data.ReferenceType,
+                                             Mgr.getOffset() - 1,
+                                             ASTNodeAttr::Instruction);
           !Check) {
         return Unexpect(Check);
       }
@@ -159,7 +185,7 @@ Expect<void> Instruction::loadBinary(FileMgr &Mgr, const Configure &Conf) {
   case OpCode::Ref__is_null:
     return {};
   case OpCode::Ref__func:
-    return readU32(TargetIdx);
+    return readU32(Data.Indices.TargetIdx);
 
   /// Parametric Instructions.
   case OpCode::Drop:
@@ -169,7 +195,9 @@ Expect<void> Instruction::loadBinary(FileMgr &Mgr, const Configure &Conf) {
     if (auto Res = Mgr.readU32()) {
       /// Read the vector of value types.
       uint32_t VecCnt = *Res;
-      ValTypeList.reserve(VecCnt);
+      if (VecCnt > 0) {
+        Data.SelectT.ValTypeList = new ValType[VecCnt];
+      }
       for (uint32_t I = 0; I < VecCnt; ++I) {
         if (auto T = Mgr.readByte()) {
           ValType VType = static_cast<ValType>(*T);
@@ -178,7 +206,7 @@ Expect<void> Instruction::loadBinary(FileMgr &Mgr, const Configure &Conf) {
               !Check) {
             return Unexpect(Check);
           }
-          ValTypeList.push_back(VType);
+          Data.SelectT.ValTypeList[Data.SelectT.ValTypeListSize++] = VType;
         } else {
           return logLoadError(Res.error(), Mgr.getOffset(),
                               ASTNodeAttr::Instruction);
@@ -196,7 +224,7 @@ Expect<void> Instruction::loadBinary(FileMgr &Mgr, const Configure &Conf) {
   case OpCode::Local__tee:
   case OpCode::Global__get:
   case OpCode::Global__set:
-    return readU32(TargetIdx);
+    return readU32(Data.Indices.TargetIdx);
 
   /// Table Instructions.
   case OpCode::Table__get:
@@ -205,20 +233,20 @@ Expect<void> Instruction::loadBinary(FileMgr &Mgr, const Configure &Conf) {
   case OpCode::Table__grow:
   case OpCode::Table__size:
   case OpCode::Table__fill:
-    if (auto Res = readU32(TargetIdx); !Res) {
+    if (auto Res = readU32(Data.Indices.TargetIdx); !Res) {
       return Unexpect(Res);
     }
     if (Code == OpCode::Table__copy) {
-      return readU32(SourceIdx);
+      return readU32(Data.Indices.SourceIdx);
     }
     return {};
   case OpCode::Table__init:
-    if (auto Res = readU32(SourceIdx); !Res) {
+    if (auto Res = readU32(Data.Indices.SourceIdx); !Res) {
       return Unexpect(Res);
     }
     [[fallthrough]];
   case OpCode::Elem__drop:
-    return readU32(TargetIdx);
+    return readU32(Data.Indices.TargetIdx);
 
   /// Memory Instructions.
   case OpCode::I32__load:
@@ -245,10 +273,10 @@ Expect<void> Instruction::loadBinary(FileMgr &Mgr, const Configure &Conf) {
   case OpCode::I64__store16:
   case OpCode::I64__store32:
     /// Read memory arguments.
-    if (auto Res = readU32(MemAlign); !Res) {
+    if (auto Res = readU32(Data.Memories.MemAlign); !Res) {
       return Unexpect(Res);
     }
-    return readU32(MemOffset);
+    return readU32(Data.Memories.MemOffset);
 
   case OpCode::Memory__copy:
     if (auto Res = readCheck(0x00); !Res) {
@@ -260,17 +288,17 @@ Expect<void> Instruction::loadBinary(FileMgr &Mgr, const Configure &Conf) {
   case OpCode::Memory__fill:
     return readCheck(0x00);
   case OpCode::Memory__init:
-    if (auto Res = readU32(SourceIdx); !Res) {
+    if (auto Res = readU32(Data.Indices.SourceIdx); !Res) {
       return Unexpect(Res);
     }
     return readCheck(0x00);
   case OpCode::Data__drop:
-    return readU32(TargetIdx);
+    return readU32(Data.Indices.TargetIdx);
 
   /// Const Instructions.
   case OpCode::I32__const:
     if (auto Res = Mgr.readS32()) {
-      Num = static_cast<uint32_t>(*Res);
+      Data.Num = static_cast<uint32_t>(*Res);
     } else {
       return logLoadError(Res.error(), Mgr.getOffset(),
                           ASTNodeAttr::Instruction);
@@ -278,7 +306,7 @@ Expect<void> Instruction::loadBinary(FileMgr &Mgr, const Configure &Conf) {
     return {};
   case OpCode::I64__const:
     if (auto Res = Mgr.readS64()) {
-      Num = static_cast<uint64_t>(*Res);
+      Data.Num = static_cast<uint64_t>(*Res);
     } else {
       return logLoadError(Res.error(), Mgr.getOffset(),
                           ASTNodeAttr::Instruction);
@@ -286,7 +314,7 @@ Expect<void> Instruction::loadBinary(FileMgr &Mgr, const Configure &Conf) {
     return {};
   case OpCode::F32__const:
     if (auto Res = Mgr.readF32()) {
-      Num = *Res;
+      Data.Num = *Res;
     } else {
       return logLoadError(Res.error(), Mgr.getOffset(),
                           ASTNodeAttr::Instruction);
@@ -294,7 +322,7 @@ Expect<void> Instruction::loadBinary(FileMgr &Mgr, const Configure &Conf) {
     return {};
   case OpCode::F64__const:
     if (auto Res = Mgr.readF64()) {
-      Num = *Res;
+      Data.Num = *Res;
     } else {
       return logLoadError(Res.error(), Mgr.getOffset(),
                           ASTNodeAttr::Instruction);
@@ -459,10 +487,10 @@ Expect<void> Instruction::loadBinary(FileMgr &Mgr, const Configure &Conf) {
   case OpCode::V128__load64_zero:
   case OpCode::V128__store:
     /// Read memory arguments.
-    if (auto Res = readU32(MemAlign); !Res) {
+    if (auto Res = readU32(Data.Memories.MemAlign); !Res) {
       return Unexpect(Res);
     }
-    return readU32(MemOffset);
+    return readU32(Data.Memories.MemOffset);
 
   /// SIMD Const Instruction.
   case OpCode::V128__const:
@@ -478,7 +506,7 @@ Expect<void> Instruction::loadBinary(FileMgr &Mgr, const Configure &Conf) {
                             ASTNodeAttr::Instruction);
       }
     }
-    Num = Value;
+    Data.Num = Value;
     return {};
   }
 
@@ -499,7 +527,7 @@ Expect<void> Instruction::loadBinary(FileMgr &Mgr, const Configure &Conf) {
   case OpCode::F64x2__replace_lane:
     /// Read lane index.
     if (auto Res = Mgr.readByte()) {
-      TargetIdx = static_cast<uint32_t>(*Res);
+      Data.Indices.TargetIdx = static_cast<uint32_t>(*Res);
     } else {
       return logLoadError(Res.error(), Mgr.getOffset(),
                           ASTNodeAttr::Instruction);
@@ -765,10 +793,15 @@ Expect<InstrVec> loadInstrSeq(FileMgr &Mgr, const Configure &Conf) {
       if (BlockStack.size() > 0) {
         uint32_t Pos = BlockStack.back().second;
         Instrs[Pos].setJumpEnd(Cnt - Pos);
-        if (BlockStack.back().first == OpCode::If &&
-            Instrs[Pos].getJumpElse() == 0) {
-          /// If block without else. Set the else jump the same as end jump.
-          Instrs[Pos].setJumpElse(Cnt - Pos);
+        if (BlockStack.back().first == OpCode::If) {
+          if (Instrs[Pos].getJumpElse() == 0) {
+            /// If block without else. Set the else jump the same as end jump.
+            Instrs[Pos].setJumpElse(Cnt - Pos);
+          } else {
+            /// If block with else. Set the end jump of the else instruction.
+            const uint32_t ElsePos = Pos + Instrs[Pos].getJumpElse();
+            Instrs[ElsePos].setJumpEnd(Cnt - ElsePos);
+          }
         }
         BlockStack.pop_back();
       } else {
@@ -783,8 +816,67 @@ Expect<InstrVec> loadInstrSeq(FileMgr &Mgr, const Configure &Conf) {
     }
     Cnt++;
   } while (!IsReachEnd);
+  Instrs.back().setLast();
   return Instrs;
 }
 
+/// Find the basic block entries. See "include/ast/instruction.h".
+std::vector<bool> findBlockEntries(InstrView Instrs) {
+  std::vector<bool> Entries(Instrs.size(), false);
+  if (Instrs.empty()) {
+    return Entries;
+  }
+  Entries[0] = true;
+  for (uint32_t I = 0; I < Instrs.size(); ++I) {
+    switch (Instrs[I].getOpCode()) {
+    case OpCode::If:
+      if (Instrs[I].getJumpElse() == Instrs[I].getJumpEnd()) {
+        Entries[I + Instrs[I].getJumpEnd()] = true;
+      }
+      [[fallthrough]];
+    case OpCode::Unreachable:
+    case OpCode::Loop:
+    case OpCode::Else:
+    case OpCode::End:
+    case OpCode::Br:
+    case OpCode::Br_if:
+    case OpCode::Br_table:
+    case OpCode::Return:
+    case OpCode::Call:
+    case OpCode::Call_indirect:
+    case OpCode::Return_call:
+    case OpCode::Return_call_indirect:
+      if (I + 1 < Instrs.size()) {
+        Entries[I + 1] = true;
+      }
+      break;
+    default:
+      break;
+    }
+  }
+  return Entries;
+}
+
+/// Mark the superinstructions. See "include/ast/instruction.h".
+void fuseSuperInstructions(Span<Instruction> Instrs) {
+  for (auto It = Instrs.begin(); It != Instrs.end();) {
+    const size_t Remain = static_cast<size_t>(Instrs.end() - It);
+    size_t Len = 1;
+    It->setSuperOp(SuperOp::None);
+    for (const auto &Pattern : Patterns) {
+      if (Pattern.Codes.size() <= Remain &&
+          std::equal(Pattern.Codes.begin(), Pattern.Codes.end(), It,
+                     [](const OpCode Code, const Instruction &Instr) {
+                       return Code == Instr.getOpCode();
+                     })) {
+        It->setSuperOp(Pattern.Op);
+        Len = Pattern.Codes.size();
+        break;
+      }
+    }
+    It += Len;
+  }
+}
+
 } // namespace AST
 } // namespace SSVM
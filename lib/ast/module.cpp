@@ -45,11 +45,13 @@ Expect<void> Module::loadBinary(FileMgr &Mgr, const Configure &Conf) {
 
     switch (NewSectionId) {
     case 0x00:
-      /// TODO: Handle the messages in custom section.
       if (auto Res = CustomSec.loadBinary(Mgr, Conf); !Res) {
         LOG(ERROR) << ErrInfo::InfoAST(NodeAttr);
         return Unexpect(Res);
       }
+      if (CustomSec.getName() == "name") {
+        loadFunctionNames(CustomSec.getContent());
+      }
       break;
     case 0x01:
       if (auto Res = TypeSec.loadBinary(Mgr, Conf); !Res) {
@@ -169,8 +171,48 @@ Expect<void> Module::loadCompiled(LDMgr &Mgr) {
       CodeSegs[I].setSymbol(Symbol.index(I).deref());
     }
   }
+  const auto Bounds = Mgr.getSymbol<uint32_t>("memory.bounds");
+  GuardRegion = !Bounds || *Bounds == 0;
   return {};
 }
 
+/// Load function names. See "include/ast/module.h".
+void Module::loadFunctionNames(Span<const Byte> Content) {
+  /// Custom sections do not affect the semantics, so the malformed parts are
+  /// ignored.
+  FileMgrVector Mgr;
+  if (!Mgr.setCode(Content)) {
+    return;
+  }
+  while (Mgr.getRemainSize() > 0) {
+    auto Id = Mgr.readByte();
+    auto Size = Mgr.readU32();
+    if (!Id || !Size || *Size > Mgr.getRemainSize()) {
+      return;
+    }
+    if (*Id != 0x01U) {
+      /// Skip the subsections other than the function names.
+      Mgr.readBytes(*Size);
+      continue;
+    }
+    auto Cnt = Mgr.readU32();
+    if (!Cnt) {
+      return;
+    }
+    for (uint32_t I = 0; I < *Cnt; ++I) {
+      auto Idx = Mgr.readU32();
+      if (!Idx) {
+        return;
+      }
+      if (auto Name = Mgr.readName()) {
+        FuncNames.insert_or_assign(*Idx, std::move(*Name));
+      } else {
+        return;
+      }
+    }
+    return;
+  }
+}
+
 } // namespace AST
 } // namespace SSVM
@@ -32,6 +32,23 @@ Expect<void> CustomSection::loadContent(FileMgr &Mgr, const Configure &Conf) {
   } else {
     return logLoadError(Res.error(), Mgr.getOffset(), NodeAttr);
   }
+
+  /// Decode the name in the front of the contents. The contents are kept as is
+  /// if the name is malformed.
+  uint32_t NameLen = 0;
+  uint32_t Pos = 0;
+  for (uint32_t Shift = 0; Pos < Content.size() && Shift < 32; Shift += 7) {
+    const Byte B = Content[Pos++];
+    NameLen |= static_cast<uint32_t>(B & 0x7FU) << Shift;
+    if ((B & 0x80U) == 0) {
+      if (NameLen <= Content.size() - Pos) {
+        Name.assign(reinterpret_cast<const char *>(Content.data()) + Pos,
+                    NameLen);
+        NameSize = Pos + NameLen;
+      }
+      break;
+    }
+  }
   return {};
 }
 
@@ -147,6 +147,7 @@ Expect<void> ElementSegment::loadBinary(FileMgr &Mgr, const Configure &Conf) {
       InitExprs.emplace_back();
       Instruction RefFunc(OpCode::Ref__func);
       Instruction End(OpCode::End);
+      End.setLast();
       if (auto Res = RefFunc.loadBinary(Mgr, Conf); !Res) {
         LOG(ERROR) << ErrInfo::InfoAST(NodeAttr);
         return Unexpect(Res);
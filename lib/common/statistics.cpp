@@ -0,0 +1,131 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "common/statistics.h"
+
+#include <chrono>
+#include <cstdio>
+#include <string_view>
+
+namespace SSVM {
+namespace Statistics {
+
+namespace {
+
+/// Write the string as a JSON string literal.
+void writeJSONString(std::ostream &OS, std::string_view Str) {
+  OS << '"';
+  for (const char C : Str) {
+    switch (C) {
+    case '"':
+      OS << "\\\"";
+      break;
+    case '\\':
+      OS << "\\\\";
+      break;
+    default:
+      if (static_cast<unsigned char>(C) < 0x20U) {
+        char Buf[7];
+        std::snprintf(Buf, sizeof(Buf), "\\u%04x",
+                      static_cast<unsigned int>(C));
+        OS << Buf;
+      } else {
+        OS << C;
+      }
+      break;
+    }
+  }
+  OS << '"';
+}
+
+/// Write the string as a CSV field, which is quoted if needed.
+void writeCSVField(std::ostream &OS, std::string_view Str) {
+  if (Str.find_first_of(",\"\r\n") == std::string_view::npos) {
+    OS << Str;
+    return;
+  }
+  OS << '"';
+  for (const char C : Str) {
+    if (C == '"') {
+      OS << '"';
+    }
+    OS << C;
+  }
+  OS << '"';
+}
+
+} // namespace
+
+void Statistics::dumpProfile(std::ostream &OS, ProfileFormat Format,
+                             Span<const std::string> FuncNames) const {
+  /// Opcodes executed, from the most frequent one.
+  std::vector<std::pair<std::string_view, uint64_t>> Ops;
+  for (uint32_t I = 0; I < OpCnt.size(); ++I) {
+    if (OpCnt[I] == 0) {
+      continue;
+    }
+    if (auto It = OpCodeStr.find(static_cast<OpCode>(I));
+        It != OpCodeStr.end()) {
+      Ops.emplace_back(It->second, OpCnt[I]);
+    }
+  }
+  std::stable_sort(Ops.begin(), Ops.end(), [](const auto &L, const auto &R) {
+    return L.second > R.second;
+  });
+
+  /// Functions called, from the most time consuming one.
+  std::vector<uint32_t> Funcs;
+  for (uint32_t I = 0; I < FuncProf.size(); ++I) {
+    if (FuncProf[I].CallCnt > 0) {
+      Funcs.push_back(I);
+    }
+  }
+  std::stable_sort(Funcs.begin(), Funcs.end(), [this](uint32_t L, uint32_t R) {
+    return FuncProf[L].Time > FuncProf[R].Time;
+  });
+  auto Name = [&FuncNames](uint32_t Addr) -> std::string {
+    if (Addr < FuncNames.size() && !FuncNames[Addr].empty()) {
+      return FuncNames[Addr];
+    }
+    return "addr[" + std::to_string(Addr) + "]";
+  };
+  auto Nano = [](Timer::Timer::Clock::duration Time) -> uint64_t {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Time).count();
+  };
+
+  if (Format == ProfileFormat::JSON) {
+    OS << "{\n  \"instructions\": " << InstrCnt << ",\n  \"gas\": " << CostSum
+       << ",\n  \"opcodes\": [";
+    for (size_t I = 0; I < Ops.size(); ++I) {
+      OS << (I ? ",\n" : "\n") << "    {\"opcode\": ";
+      writeJSONString(OS, Ops[I].first);
+      OS << ", \"count\": " << Ops[I].second << '}';
+    }
+    OS << (Ops.empty() ? "" : "\n  ") << "],\n  \"functions\": [";
+    for (size_t I = 0; I < Funcs.size(); ++I) {
+      const auto &Prof = FuncProf[Funcs[I]];
+      OS << (I ? ",\n" : "\n") << "    {\"address\": " << Funcs[I]
+         << ", \"name\": ";
+      writeJSONString(OS, Name(Funcs[I]));
+      OS << ", \"calls\": " << Prof.CallCnt
+         << ", \"instructions\": " << Prof.InstrCnt
+         << ", \"time_ns\": " << Nano(Prof.Time) << '}';
+    }
+    OS << (Funcs.empty() ? "" : "\n  ") << "]\n}\n";
+  } else {
+    OS << "kind,name,count,instructions,time_ns\n";
+    for (const auto &[Op, Cnt] : Ops) {
+      OS << "opcode,";
+      writeCSVField(OS, Op);
+      OS << ',' << Cnt << ",,\n";
+    }
+    for (const uint32_t Addr : Funcs) {
+      const auto &Prof = FuncProf[Addr];
+      OS << "function,";
+      writeCSVField(OS, Name(Addr));
+      OS << ',' << Prof.CallCnt << ',' << Prof.InstrCnt << ','
+         << Nano(Prof.Time) << '\n';
+    }
+  }
+}
+
+} // namespace Statistics
+} // namespace SSVM
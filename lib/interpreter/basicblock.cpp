@@ -0,0 +1,58 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "interpreter/interpreter.h"
+
+namespace SSVM {
+namespace Interpreter {
+
+void Interpreter::markBasicBlocks(Span<AST::Instruction> Instrs) const {
+  if (Instrs.empty()) {
+    return;
+  }
+
+  const auto Entry = AST::findBlockEntries(Instrs);
+
+  /// Sum the costs of every block onto its entry. The sums are clamped to the
+  /// overflow mark.
+  constexpr uint64_t Overflow = AST::Instruction::kBlockCostOverflow;
+  const auto CostTab = Stat ? Stat->getCostTable() : Span<const uint64_t>();
+  uint32_t Begin = 0;
+  uint64_t Sum = 0;
+  for (uint32_t I = 0; I < Instrs.size(); ++I) {
+    if (!Entry[I]) {
+      Instrs[I].setBlock(false);
+    } else if (I > 0) {
+      Instrs[Begin].setBlock(true, static_cast<uint32_t>(Sum));
+      Begin = I;
+      Sum = 0;
+    }
+    if (!CostTab.empty()) {
+      const uint64_t Cost = CostTab[uint16_t(Instrs[I].getOpCode())];
+      Sum = Cost >= Overflow - Sum ? Overflow : Sum + Cost;
+    }
+  }
+  Instrs[Begin].setBlock(true, static_cast<uint32_t>(Sum));
+}
+
+void Interpreter::updateBlockCosts(Runtime::StoreManager &StoreMgr) {
+  if (BlockCostVersion == Stat->getCostTableVersion()) {
+    return;
+  }
+  for (auto *Func : StoreMgr.getFunctions()) {
+    markBasicBlocks(Func->getMutableInstrs());
+  }
+  BlockCostVersion = Stat->getCostTableVersion();
+}
+
+bool Interpreter::chargeLargeBlock(AST::InstrView::iterator PC) const {
+  for (;; ++PC) {
+    if (unlikely(!Stat->addInstrCost(PC->getOpCode()))) {
+      return false;
+    }
+    if (PC->isLast() || PC[1].isBlockEntry()) {
+      return true;
+    }
+  }
+}
+
+} // namespace Interpreter
+} // namespace SSVM
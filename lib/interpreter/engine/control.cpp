@@ -7,39 +7,10 @@
 namespace SSVM {
 namespace Interpreter {
 
-Expect<void> Interpreter::runBlockOp(Runtime::StoreManager &StoreMgr,
-                                     const AST::Instruction &Instr,
-                                     AST::InstrView::iterator &PC) {
-  /// Get result type for arity.
-  auto BlockSig = getBlockArity(StoreMgr, Instr.getBlockType());
-  AST::InstrView::iterator Cont = PC + Instr.getJumpEnd();
-
-  /// Create Label{ nothing } and push.
-  StackMgr.pushLabel(BlockSig.first, BlockSig.second, Cont);
-  return {};
-}
-
-Expect<void> Interpreter::runLoopOp(Runtime::StoreManager &StoreMgr,
-                                    const AST::Instruction &Instr,
-                                    AST::InstrView::iterator &PC) {
-  /// Get result type for arity.
-  auto BlockSig = getBlockArity(StoreMgr, Instr.getBlockType());
-  AST::InstrView::iterator Cont = PC + Instr.getJumpEnd();
-
-  /// Create Label{ loop-instruction } and push.
-  StackMgr.pushLabel(BlockSig.first, BlockSig.first, Cont, PC);
-  return {};
-}
-
-Expect<void> Interpreter::runIfElseOp(Runtime::StoreManager &StoreMgr,
-                                      const AST::Instruction &Instr,
+Expect<void> Interpreter::runIfElseOp(const AST::Instruction &Instr,
                                       AST::InstrView::iterator &PC) {
   /// Get condition.
-  uint32_t Cond = retrieveValue<uint32_t>(StackMgr.pop());
-
-  /// Get result type for arity.
-  auto BlockSig = getBlockArity(StoreMgr, Instr.getBlockType());
-  AST::InstrView::iterator Cont = PC + Instr.getJumpEnd();
+  uint32_t Cond = StackMgr.popAs<uint32_t>();
 
   /// If non-zero, run if-statement; else, run else-statement.
   if (Cond == 0) {
@@ -47,30 +18,29 @@ Expect<void> Interpreter::runIfElseOp(Runtime::StoreManager &StoreMgr,
       /// No else-statement case. Jump to right before End instruction.
       PC += (Instr.getJumpEnd() - 1);
     } else {
-      if (Stat) {
+      if (CountInstr) {
         Stat->incInstrCount();
-        if (unlikely(!Stat->addInstrCost(OpCode::Else))) {
-          return Unexpect(ErrCode::CostLimitExceeded);
-        }
+      }
+      if (MeasureCost && unlikely(!Stat->addInstrCost(OpCode::Else))) {
+        return Unexpect(ErrCode::CostLimitExceeded);
       }
       /// Have else-statement case. Jump to Else instruction to continue.
       PC += Instr.getJumpElse();
     }
   }
-  StackMgr.pushLabel(BlockSig.first, BlockSig.second, Cont);
   return {};
 }
 
 Expect<void> Interpreter::runBrOp(Runtime::StoreManager &StoreMgr,
                                   const AST::Instruction &Instr,
                                   AST::InstrView::iterator &PC) {
-  return branchToLabel(StoreMgr, Instr.getTargetIndex(), PC);
+  return branchToLabel(StoreMgr, Instr.getJump(), PC);
 }
 
 Expect<void> Interpreter::runBrIfOp(Runtime::StoreManager &StoreMgr,
                                     const AST::Instruction &Instr,
                                     AST::InstrView::iterator &PC) {
-  if (retrieveValue<uint32_t>(StackMgr.pop()) != 0) {
+  if (StackMgr.popAs<uint32_t>() != 0) {
     return runBrOp(StoreMgr, Instr, PC);
   }
   return {};
@@ -80,30 +50,37 @@ Expect<void> Interpreter::runBrTableOp(Runtime::StoreManager &StoreMgr,
                                        const AST::Instruction &Instr,
                                        AST::InstrView::iterator &PC) {
   /// Get value on top of stack.
-  uint32_t Value = retrieveValue<uint32_t>(StackMgr.pop());
+  uint32_t Value = StackMgr.popAs<uint32_t>();
 
-  /// Do branch.
-  const auto &LabelTable = Instr.getLabelList();
-  if (Value < LabelTable.size()) {
-    return branchToLabel(StoreMgr, LabelTable[Value], PC);
-  }
-  return branchToLabel(StoreMgr, Instr.getTargetIndex(), PC);
+  /// Do branch. The last entry of the label table is the default label.
+  const auto LabelTable = Instr.getLabelList();
+  const uint32_t LabelNum = static_cast<uint32_t>(LabelTable.size()) - 1;
+  return branchToLabel(StoreMgr, LabelTable[std::min(Value, LabelNum)], PC);
 }
 
-Expect<void> Interpreter::runReturnOp(AST::InstrView::iterator &PC) {
-  PC = StackMgr.getBottomLabel().From;
-  StackMgr.popFrame();
+Expect<void> Interpreter::runReturnOp(Runtime::StoreManager &StoreMgr,
+                                      AST::InstrView::iterator &PC) {
+  leaveFunctionProfile();
+  PC = StackMgr.popFrame();
+  updateInstanceContext(StoreMgr);
   return {};
 }
 
 Expect<void> Interpreter::runCallOp(Runtime::StoreManager &StoreMgr,
                                     const AST::Instruction &Instr,
-                                    AST::InstrView::iterator &PC) {
+                                    AST::InstrView::iterator &PC,
+                                    const bool IsTailCall) {
   /// Get Function address.
-  const auto *ModInst = *StoreMgr.getModule(StackMgr.getModuleAddr());
-  const uint32_t FuncAddr = *ModInst->getFuncAddr(Instr.getTargetIndex());
+  const uint32_t FuncAddr =
+      *InstCtx.ModInst->getFuncAddr(Instr.getTargetIndex());
   const auto *FuncInst = *StoreMgr.getFunction(FuncAddr);
-  if (auto Res = enterFunction(StoreMgr, *FuncInst, PC); !Res) {
+  if (IsTailCall) {
+    /// The callee replaces the current frame and returns to its caller.
+    leaveFunctionProfile();
+    PC = StackMgr.popFrameForTailCall(
+        static_cast<uint32_t>(FuncInst->getFuncType().Params.size()));
+  }
+  if (auto Res = enterFunction(StoreMgr, FuncAddr, *FuncInst, PC); !Res) {
     return Unexpect(Res);
   } else {
     PC = (*Res) - 1;
@@ -113,16 +90,17 @@ Expect<void> Interpreter::runCallOp(Runtime::StoreManager &StoreMgr,
 
 Expect<void> Interpreter::runCallIndirectOp(Runtime::StoreManager &StoreMgr,
                                             const AST::Instruction &Instr,
-                                            AST::InstrView::iterator &PC) {
+                                            AST::InstrView::iterator &PC,
+                                            const bool IsTailCall) {
   /// Get Table Instance
-  const auto *TabInst = getTabInstByIdx(StoreMgr, Instr.getSourceIndex());
+  const auto *TabInst = InstCtx.Tables[Instr.getSourceIndex()];
 
   /// Get function type at index x.
-  const auto *ModInst = *StoreMgr.getModule(StackMgr.getModuleAddr());
-  const auto *TargetFuncType = *ModInst->getFuncType(Instr.getTargetIndex());
+  const auto *TargetFuncType =
+      *InstCtx.ModInst->getFuncType(Instr.getTargetIndex());
 
   /// Pop the value i32.const i from the Stack.
-  uint32_t Idx = retrieveValue<uint32_t>(StackMgr.pop());
+  uint32_t Idx = StackMgr.popAs<uint32_t>();
 
   /// If idx not small than tab.elem, trap.
   if (Idx >= TabInst->getSize()) {
@@ -145,10 +123,10 @@ Expect<void> Interpreter::runCallIndirectOp(Runtime::StoreManager &StoreMgr,
   }
   FuncAddr = retrieveFuncIdx(Ref);
 
-  /// Check function type.
+  /// Check function type by the canonical type IDs.
   const auto *FuncInst = *StoreMgr.getFunction(FuncAddr);
-  const auto &FuncType = FuncInst->getFuncType();
-  if (*TargetFuncType != FuncType) {
+  if (TargetFuncType->TypeID != FuncInst->getTypeID()) {
+    const auto &FuncType = FuncInst->getFuncType();
     LOG(ERROR) << ErrCode::IndirectCallTypeMismatch;
     LOG(ERROR) << ErrInfo::InfoInstruction(Instr.getOpCode(), Instr.getOffset(),
                                            {Idx},
@@ -158,7 +136,13 @@ Expect<void> Interpreter::runCallIndirectOp(Runtime::StoreManager &StoreMgr,
                                         FuncType.Params, FuncType.Returns);
     return Unexpect(ErrCode::IndirectCallTypeMismatch);
   }
-  if (auto Res = enterFunction(StoreMgr, *FuncInst, PC); !Res) {
+  if (IsTailCall) {
+    /// The callee replaces the current frame and returns to its caller.
+    leaveFunctionProfile();
+    PC = StackMgr.popFrameForTailCall(
+        static_cast<uint32_t>(TargetFuncType->Params.size()));
+  }
+  if (auto Res = enterFunction(StoreMgr, FuncAddr, *FuncInst, PC); !Res) {
     return Unexpect(Res);
   } else {
     PC = (*Res) - 1;
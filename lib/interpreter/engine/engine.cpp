@@ -5,41 +5,79 @@
 #include "common/value.h"
 #include "interpreter/interpreter.h"
 
+#include <array>
+#include <cstdint>
+#include <utility>
+
 namespace SSVM {
 namespace Interpreter {
 
 Expect<void> Interpreter::runExpression(Runtime::StoreManager &StoreMgr,
                                         AST::InstrView Instrs) {
-  StackMgr.pushLabel(0, 0, Instrs.end() - 1);
+  /// Constant expression frame []->[result] continuing at the end.
+  StackMgr.pushFrame(StackMgr.getModuleAddr(), 0, 1, Instrs.end() - 1);
+  updateInstanceContext(StoreMgr);
+  selectStatistics();
+  /// Constant expressions have no branches, so they are charged at once
+  /// instead of being marked into the basic blocks.
+  if (MeasureCost && !Instrs.empty() &&
+      unlikely(!chargeLargeBlock(Instrs.begin()))) {
+    LOG(ERROR) << ErrCode::CostLimitExceeded;
+    return Unexpect(ErrCode::CostLimitExceeded);
+  }
   return execute(StoreMgr, Instrs.begin(), Instrs.end());
 }
 
 Expect<void>
 Interpreter::runFunction(Runtime::StoreManager &StoreMgr,
+                         const uint32_t FuncAddr,
                          const Runtime::Instance::FunctionInstance &Func,
                          Span<const ValVariant> Params) {
-  /// Set start time.
-  if (Stat) {
+  /// The stacks may be failed to reserve.
+  if (unlikely(!StackMgr.isReserved())) {
+    LOG(ERROR) << ErrCode::CallStackExhausted;
+    return Unexpect(ErrCode::CallStackExhausted);
+  }
+
+  /// Select the statistics and set start time.
+  selectStatistics();
+  if (MeasureCost) {
+    updateBlockCosts(StoreMgr);
+  }
+  if (MeasureTime) {
     Stat->startRecordWasm();
   }
 
   /// Reset and push a dummy frame into stack.
   StackMgr.reset();
   StackMgr.pushDummyFrame();
+  resetInstanceContext();
 
   /// Push arguments.
   for (auto &Val : Params) {
     StackMgr.push(Val);
   }
 
+  /// Start sampling. Host and compiled functions run in enterFunction.
+  if (Samp) {
+    Samp->start(StackMgr);
+  }
+
   /// Enter and execute function.
   AST::InstrView::iterator StartIt;
-  if (auto Res = enterFunction(StoreMgr, Func, Func.getInstrs().end() - 1)) {
+  if (auto Res = enterFunction(StoreMgr, FuncAddr, Func,
+                               Func.getInstrs().end() - 1)) {
     StartIt = *Res;
   } else {
+    if (Samp) {
+      Samp->stop();
+    }
     return Unexpect(Res);
   }
   auto Res = execute(StoreMgr, StartIt, Func.getInstrs().end());
+  if (Samp) {
+    Samp->stop();
+  }
 
   if (Res) {
     LOG(DEBUG) << " Execution succeeded.";
@@ -49,7 +87,13 @@ Interpreter::runFunction(Runtime::StoreManager &StoreMgr,
 
   /// Print time cost.
   if (Stat) {
-    Stat->stopRecordWasm();
+    if (MeasureTime) {
+      Stat->stopRecordWasm();
+    }
+    if (Stat->isProfiling()) {
+      /// Leave the frames unwound by a trap.
+      Stat->leaveAllFunctions();
+    }
 
     auto Nano = [](auto &&Duration) {
       return std::chrono::nanoseconds(Duration).count();
@@ -79,1395 +123,1652 @@ Interpreter::runFunction(Runtime::StoreManager &StoreMgr,
   return Unexpect(Res);
 }
 
+namespace {
+
+/// Count of superinstructions. Their handlers take the indices right after the
+/// fallback handler, so a superinstruction is its own handler index.
+constexpr uint16_t SuperOpNum = 0
+#define UseSuperOp(NAME, ...) +1
+#include "common/superop.inc"
+#undef UseSuperOp
+    ;
+
+/// Build the opcode slot to handler index mapping used by the threaded
+/// dispatcher in execute(). Unused slots map to index 0, the fallback handler.
+constexpr std::array<uint16_t, OpCodeSlotSize> makeHandlerIndex() {
+  std::array<uint16_t, OpCodeSlotSize> Index{};
+  uint16_t Cnt = 1 + SuperOpNum;
+#define UseOpCode(NAME, VALUE, STRING)                                         \
+  Index[getOpCodeSlot(OpCode::NAME)] = Cnt++;
+#include "common/opcode.inc"
+#undef UseOpCode
+  return Index;
+}
+
+constexpr std::array<uint16_t, OpCodeSlotSize> HandlerIndex =
+    makeHandlerIndex();
+
+} // namespace
+
 Expect<void> Interpreter::execute(Runtime::StoreManager &StoreMgr,
                                   const AST::InstrView::iterator Start,
                                   const AST::InstrView::iterator End) {
+  /// Select the loop without the statistics not recorded.
+  auto Run = [&](auto Guarded) -> Expect<void> {
+    constexpr bool G = decltype(Guarded)::value;
+    if (CountInstr) {
+      return MeasureCost ? executeLoop<G, true, true>(StoreMgr, Start, End)
+                         : executeLoop<G, true, false>(StoreMgr, Start, End);
+    }
+    return MeasureCost ? executeLoop<G, false, true>(StoreMgr, Start, End)
+                       : executeLoop<G, false, false>(StoreMgr, Start, End);
+  };
+
+  /// Keep the explicit bound checks if any memory failed to reserve its guard
+  /// region.
+  if (!Conf.isGuardPageCheck() || !StoreMgr.isAllMemoryGuarded()) {
+    return Run(std::false_type{});
+  }
+
+  /// Guarded execution: the out of bounds accesses fault in the guard region
+  /// and the handler jumps back here.
+  sigjmp_buf JumpBuffer;
+  auto OldTrapJump = std::exchange(TrapJump, &JumpBuffer);
+
+  Expect<void> Res;
+  int Status;
+  {
+    GuardSignalEnabler Enabler;
+    Status = sigsetjmp(*TrapJump, true);
+    if (Status == 0) {
+      Res = Run(std::true_type{});
+    }
+  }
+
+  TrapJump = std::move(OldTrapJump);
+
+  if (Status != 0) {
+    ErrCode Code = static_cast<ErrCode>(Status);
+    LOG(ERROR) << Code;
+    return Unexpect(Code);
+  }
+  return Res;
+}
+
+template <bool GuardedMemory, bool Count, bool Gas>
+Expect<void> Interpreter::executeLoop(Runtime::StoreManager &StoreMgr,
+                                      const AST::InstrView::iterator Start,
+                                      const AST::InstrView::iterator End) {
   AST::InstrView::iterator PC = Start;
   AST::InstrView::iterator PCEnd = End;
+  ErrCode Err = ErrCode::Success;
 
-  auto Dispatch = [this, &PC, &StoreMgr]() -> Expect<void> {
-    const AST::Instruction &Instr = *PC;
-    switch (Instr.getOpCode()) {
-    /// Control instructions.
-    case OpCode::Unreachable:
-      LOG(ERROR) << ErrCode::Unreachable;
-      LOG(ERROR) << ErrInfo::InfoInstruction(Instr.getOpCode(),
-                                             Instr.getOffset());
-      return Unexpect(ErrCode::Unreachable);
-    case OpCode::Nop:
-      return {};
-    case OpCode::Block:
-      return runBlockOp(StoreMgr, Instr, PC);
-    case OpCode::Loop:
-      return runLoopOp(StoreMgr, Instr, PC);
-    case OpCode::If:
-      return runIfElseOp(StoreMgr, Instr, PC);
-    case OpCode::Else:
-      if (Stat) {
-        /// Reach here means end of if-statement.
-        if (unlikely(!Stat->subInstrCost(Instr.getOpCode()))) {
-          return Unexpect(ErrCode::CostLimitExceeded);
-        }
-        if (unlikely(!Stat->addInstrCost(OpCode::End))) {
-          return Unexpect(ErrCode::CostLimitExceeded);
-        }
-      }
-      [[fallthrough]];
-    case OpCode::End:
-      PC = StackMgr.leaveLabel();
-      return {};
-    case OpCode::Br:
-      return runBrOp(StoreMgr, Instr, PC);
-    case OpCode::Br_if:
-      return runBrIfOp(StoreMgr, Instr, PC);
-    case OpCode::Br_table:
-      return runBrTableOp(StoreMgr, Instr, PC);
-    case OpCode::Return:
-      return runReturnOp(PC);
-    case OpCode::Call:
-      return runCallOp(StoreMgr, Instr, PC);
-    case OpCode::Call_indirect:
-      return runCallIndirectOp(StoreMgr, Instr, PC);
+/// Every handler ends by jumping to the next instruction directly instead of
+/// returning to a central loop. With GNU labels-as-values the jump is an
+/// indirect branch through a table indexed by opcode, so each handler gets its
+/// own branch-prediction site; otherwise it re-enters the switch below.
+#if defined(__GNUC__) || defined(__clang__)
+#define SSVM_THREADED_DISPATCH 1
+#else
+#define SSVM_THREADED_DISPATCH 0
+#endif
+
+#if SSVM_THREADED_DISPATCH
+  /// Handler addresses with the fallback at index 0, followed by the
+  /// superinstructions in superop.inc order and the opcodes in opcode.inc
+  /// order.
+  static const void *const DispatchTable[] = {
+      &&Handler_Default,
+#define UseSuperOp(NAME, ...) &&Fused_##NAME,
+#include "common/superop.inc"
+#undef UseSuperOp
+#define UseOpCode(NAME, VALUE, STRING) &&Handler_##NAME,
+#include "common/opcode.inc"
+#undef UseOpCode
+  };
+#define CASE(NAME)                                                             \
+  case OpCode::NAME:                                                           \
+  Handler_##NAME
+#define DISPATCH_JUMP()                                                        \
+  goto *DispatchTable[PC->getSuperOp() != SuperOp::None                        \
+                          ? static_cast<uint16_t>(PC->getSuperOp())            \
+                          : HandlerIndex[getOpCodeSlot(PC->getOpCode())]]
+#else
+#define CASE(NAME) case OpCode::NAME
+#define DISPATCH_JUMP() goto Dispatch
+#endif
 
-    /// Reference Instructions
-    case OpCode::Ref__null:
-      StackMgr.push(genNullRef(Instr.getReferenceType()));
-      return {};
-    case OpCode::Ref__is_null: {
-      ValVariant &Val = StackMgr.getTop();
-      if (isNullRef(Val)) {
-        retrieveValue<uint32_t>(Val) = 1;
-      } else {
-        retrieveValue<uint32_t>(Val) = 0;
+/// Add count per instruction and cost per basic block. The cost of a block is
+/// charged on entering it, so a block exceeding the limit traps before running
+/// any of its instructions. Note: if-else case should be processed
+/// additionally.
+#define DISPATCH()                                                             \
+  do {                                                                         \
+    if constexpr (Count) {                                                     \
+      Stat->incInstrCount();                                                   \
+      if (Stat->isProfiling()) {                                               \
+        Stat->incOpCount(PC->getOpCode());                                     \
+      }                                                                        \
+    }                                                                          \
+    if constexpr (Gas) {                                                       \
+      if (const uint32_t Cost = PC->getBlockCost(); Cost != 0) {               \
+        if (unlikely(Cost == AST::Instruction::kBlockCostOverflow              \
+                         ? !chargeLargeBlock(PC)                               \
+                         : !Stat->addCost(Cost))) {                            \
+          Err = ErrCode::CostLimitExceeded;                                    \
+          goto Trap;                                                           \
+        }                                                                      \
+      }                                                                        \
+    }                                                                          \
+    DISPATCH_JUMP();                                                           \
+  } while (0)
+#define DISPATCH_NEXT()                                                        \
+  do {                                                                         \
+    if (unlikely(++PC == PCEnd)) {                                             \
+      goto Done;                                                               \
+    }                                                                          \
+    DISPATCH();                                                                \
+  } while (0)
+#define DISPATCH_RESULT(...)                                                   \
+  do {                                                                         \
+    if (auto Res = (__VA_ARGS__); unlikely(!Res)) {                            \
+      Err = Res.error();                                                       \
+      goto Trap;                                                               \
+    }                                                                          \
+    DISPATCH_NEXT();                                                           \
+  } while (0)
+#define TRAP(CODE)                                                             \
+  do {                                                                         \
+    Err = (CODE);                                                              \
+    goto Trap;                                                                 \
+  } while (0)
+
+  if (PC == PCEnd) {
+    return {};
+  }
+  DISPATCH();
+
+#if !SSVM_THREADED_DISPATCH
+Dispatch:
+#endif
+  switch (PC->getOpCode()) {
+  /// Control instructions.
+  CASE(Unreachable):
+    LOG(ERROR) << ErrCode::Unreachable;
+    LOG(ERROR) << ErrInfo::InfoInstruction(PC->getOpCode(),
+                                           PC->getOffset());
+    TRAP(ErrCode::Unreachable);
+  CASE(Nop):
+    DISPATCH_NEXT();
+  CASE(Block):
+  CASE(Loop):
+    DISPATCH_NEXT();
+  CASE(If):
+    DISPATCH_RESULT(runIfElseOp(*PC, PC));
+  CASE(Else):
+    if constexpr (Gas) {
+      /// Reach here means end of if-statement.
+      if (unlikely(!Stat->subInstrCost(PC->getOpCode()))) {
+        TRAP(ErrCode::CostLimitExceeded);
+      }
+      if (unlikely(!Stat->addInstrCost(OpCode::End))) {
+        TRAP(ErrCode::CostLimitExceeded);
       }
-      return {};
-    }
-    case OpCode::Ref__func: {
-      const auto *ModInst = *StoreMgr.getModule(StackMgr.getModuleAddr());
-      const uint32_t FuncAddr = *ModInst->getFuncAddr(Instr.getTargetIndex());
-      StackMgr.push(genFuncRef(FuncAddr));
-      return {};
     }
+    /// Skip the else-statement and the End instruction.
+    PC += PC->getJumpEnd();
+    DISPATCH_NEXT();
+  CASE(End):
+    /// End of function body leaves the frame.
+    if (PC->isLast()) {
+      leaveFunctionProfile();
+      PC = StackMgr.popFrame();
+      updateInstanceContext(StoreMgr);
+    }
+    DISPATCH_NEXT();
+  CASE(Br):
+    DISPATCH_RESULT(runBrOp(StoreMgr, *PC, PC));
+  CASE(Br_if):
+    DISPATCH_RESULT(runBrIfOp(StoreMgr, *PC, PC));
+  CASE(Br_table):
+    DISPATCH_RESULT(runBrTableOp(StoreMgr, *PC, PC));
+  CASE(Return):
+    DISPATCH_RESULT(runReturnOp(StoreMgr, PC));
+  CASE(Call):
+    DISPATCH_RESULT(runCallOp(StoreMgr, *PC, PC));
+  CASE(Call_indirect):
+    DISPATCH_RESULT(runCallIndirectOp(StoreMgr, *PC, PC));
+  CASE(Return_call):
+    DISPATCH_RESULT(runCallOp(StoreMgr, *PC, PC, true));
+  CASE(Return_call_indirect):
+    DISPATCH_RESULT(runCallIndirectOp(StoreMgr, *PC, PC, true));
 
-    /// Parametric Instructions
-    case OpCode::Drop:
-      StackMgr.pop();
-      return {};
-    case OpCode::Select:
-    case OpCode::Select_t: {
-      /// Pop the i32 value and select values from stack.
-      ValVariant CondVal = StackMgr.pop();
-      ValVariant Val2 = StackMgr.pop();
-      ValVariant Val1 = StackMgr.pop();
+  /// Reference Instructions
+  CASE(Ref__null):
+    StackMgr.push(genNullRef(PC->getReferenceType()));
+    DISPATCH_NEXT();
+  CASE(Ref__is_null): {
+    ValVariant &Val = StackMgr.getTop();
+    if (isNullRef(Val)) {
+      retrieveValue<uint32_t>(Val) = 1;
+    } else {
+      retrieveValue<uint32_t>(Val) = 0;
+    }
+    DISPATCH_NEXT();
+  }
+  CASE(Ref__func): {
+    const uint32_t FuncAddr =
+        *InstCtx.ModInst->getFuncAddr(PC->getTargetIndex());
+    StackMgr.push(genFuncRef(FuncAddr));
+    DISPATCH_NEXT();
+  }
 
-      /// Select the value.
-      if (retrieveValue<uint32_t>(CondVal) == 0) {
-        StackMgr.push(Val2);
-      } else {
-        StackMgr.push(Val1);
-      }
-      return {};
+  /// Parametric Instructions
+  CASE(Drop):
+    StackMgr.pop();
+    DISPATCH_NEXT();
+  CASE(Select):
+  CASE(Select_t): {
+    /// Pop the i32 value and select values from stack.
+    const uint32_t Cond = StackMgr.popAs<uint32_t>();
+    ValVariant Val2 = StackMgr.pop();
+
+    /// Select the value. The first value is kept in place when selected.
+    if (Cond == 0) {
+      StackMgr.getTop() = Val2;
     }
+    DISPATCH_NEXT();
+  }
 
-    /// Variable Instructions
-    case OpCode::Local__get:
-      return runLocalGetOp(Instr.getTargetIndex());
-    case OpCode::Local__set:
-      return runLocalSetOp(Instr.getTargetIndex());
-    case OpCode::Local__tee:
-      return runLocalTeeOp(Instr.getTargetIndex());
-    case OpCode::Global__get:
-      return runGlobalGetOp(StoreMgr, Instr.getTargetIndex());
-    case OpCode::Global__set:
-      return runGlobalSetOp(StoreMgr, Instr.getTargetIndex());
+  /// Variable Instructions
+  CASE(Local__get):
+    DISPATCH_RESULT(runLocalGetOp(PC->getTargetIndex()));
+  CASE(Local__set):
+    DISPATCH_RESULT(runLocalSetOp(PC->getTargetIndex()));
+  CASE(Local__tee):
+    DISPATCH_RESULT(runLocalTeeOp(PC->getTargetIndex()));
+  CASE(Global__get):
+    DISPATCH_RESULT(runGlobalGetOp(PC->getTargetIndex()));
+  CASE(Global__set):
+    DISPATCH_RESULT(runGlobalSetOp(PC->getTargetIndex()));
 
-    /// Table Instructions
-    case OpCode::Table__get:
-      return runTableGetOp(*getTabInstByIdx(StoreMgr, Instr.getTargetIndex()),
-                           Instr);
-    case OpCode::Table__set:
-      return runTableSetOp(*getTabInstByIdx(StoreMgr, Instr.getTargetIndex()),
-                           Instr);
-    case OpCode::Table__init:
-      return runTableInitOp(*getTabInstByIdx(StoreMgr, Instr.getTargetIndex()),
-                            *getElemInstByIdx(StoreMgr, Instr.getSourceIndex()),
-                            Instr);
-    case OpCode::Elem__drop:
-      return runElemDropOp(*getElemInstByIdx(StoreMgr, Instr.getTargetIndex()));
-    case OpCode::Table__copy:
-      return runTableCopyOp(*getTabInstByIdx(StoreMgr, Instr.getTargetIndex()),
-                            *getTabInstByIdx(StoreMgr, Instr.getSourceIndex()),
-                            Instr);
-    case OpCode::Table__grow:
-      return runTableGrowOp(*getTabInstByIdx(StoreMgr, Instr.getTargetIndex()));
-    case OpCode::Table__size:
-      return runTableSizeOp(*getTabInstByIdx(StoreMgr, Instr.getTargetIndex()));
-    case OpCode::Table__fill:
-      return runTableFillOp(*getTabInstByIdx(StoreMgr, Instr.getTargetIndex()),
-                            Instr);
+  /// Table Instructions
+  CASE(Table__get):
+    DISPATCH_RESULT(
+        runTableGetOp(*InstCtx.Tables[PC->getTargetIndex()], *PC));
+  CASE(Table__set):
+    DISPATCH_RESULT(
+        runTableSetOp(*InstCtx.Tables[PC->getTargetIndex()], *PC));
+  CASE(Table__init):
+    DISPATCH_RESULT(
+        runTableInitOp(*InstCtx.Tables[PC->getTargetIndex()],
+                       *getElemInstByIdx(StoreMgr, PC->getSourceIndex()), *PC));
+  CASE(Elem__drop):
+    DISPATCH_RESULT(
+        runElemDropOp(*getElemInstByIdx(StoreMgr, PC->getTargetIndex())));
+  CASE(Table__copy):
+    DISPATCH_RESULT(
+        runTableCopyOp(*InstCtx.Tables[PC->getTargetIndex()],
+                       *InstCtx.Tables[PC->getSourceIndex()], *PC));
+  CASE(Table__grow):
+    DISPATCH_RESULT(
+        runTableGrowOp(*InstCtx.Tables[PC->getTargetIndex()]));
+  CASE(Table__size):
+    DISPATCH_RESULT(
+        runTableSizeOp(*InstCtx.Tables[PC->getTargetIndex()]));
+  CASE(Table__fill):
+    DISPATCH_RESULT(
+        runTableFillOp(*InstCtx.Tables[PC->getTargetIndex()], *PC));
 
-    /// Memory Instructions
-    case OpCode::I32__load:
-      return runLoadOp<uint32_t>(*getMemInstByIdx(StoreMgr, 0), Instr);
-    case OpCode::I64__load:
-      return runLoadOp<uint64_t>(*getMemInstByIdx(StoreMgr, 0), Instr);
-    case OpCode::F32__load:
-      return runLoadOp<float>(*getMemInstByIdx(StoreMgr, 0), Instr);
-    case OpCode::F64__load:
-      return runLoadOp<double>(*getMemInstByIdx(StoreMgr, 0), Instr);
-    case OpCode::I32__load8_s:
-      return runLoadOp<int32_t>(*getMemInstByIdx(StoreMgr, 0), Instr, 8);
-    case OpCode::I32__load8_u:
-      return runLoadOp<uint32_t>(*getMemInstByIdx(StoreMgr, 0), Instr, 8);
-    case OpCode::I32__load16_s:
-      return runLoadOp<int32_t>(*getMemInstByIdx(StoreMgr, 0), Instr, 16);
-    case OpCode::I32__load16_u:
-      return runLoadOp<uint32_t>(*getMemInstByIdx(StoreMgr, 0), Instr, 16);
-    case OpCode::I64__load8_s:
-      return runLoadOp<int64_t>(*getMemInstByIdx(StoreMgr, 0), Instr, 8);
-    case OpCode::I64__load8_u:
-      return runLoadOp<uint64_t>(*getMemInstByIdx(StoreMgr, 0), Instr, 8);
-    case OpCode::I64__load16_s:
-      return runLoadOp<int64_t>(*getMemInstByIdx(StoreMgr, 0), Instr, 16);
-    case OpCode::I64__load16_u:
-      return runLoadOp<uint64_t>(*getMemInstByIdx(StoreMgr, 0), Instr, 16);
-    case OpCode::I64__load32_s:
-      return runLoadOp<int64_t>(*getMemInstByIdx(StoreMgr, 0), Instr, 32);
-    case OpCode::I64__load32_u:
-      return runLoadOp<uint64_t>(*getMemInstByIdx(StoreMgr, 0), Instr, 32);
-    case OpCode::I32__store:
-      return runStoreOp<uint32_t>(*getMemInstByIdx(StoreMgr, 0), Instr);
-    case OpCode::I64__store:
-      return runStoreOp<uint64_t>(*getMemInstByIdx(StoreMgr, 0), Instr);
-    case OpCode::F32__store:
-      return runStoreOp<float>(*getMemInstByIdx(StoreMgr, 0), Instr);
-    case OpCode::F64__store:
-      return runStoreOp<double>(*getMemInstByIdx(StoreMgr, 0), Instr);
-    case OpCode::I32__store8:
-      return runStoreOp<uint32_t>(*getMemInstByIdx(StoreMgr, 0), Instr, 8);
-    case OpCode::I32__store16:
-      return runStoreOp<uint32_t>(*getMemInstByIdx(StoreMgr, 0), Instr, 16);
-    case OpCode::I64__store8:
-      return runStoreOp<uint64_t>(*getMemInstByIdx(StoreMgr, 0), Instr, 8);
-    case OpCode::I64__store16:
-      return runStoreOp<uint64_t>(*getMemInstByIdx(StoreMgr, 0), Instr, 16);
-    case OpCode::I64__store32:
-      return runStoreOp<uint64_t>(*getMemInstByIdx(StoreMgr, 0), Instr, 32);
-    case OpCode::Memory__grow:
-      return runMemoryGrowOp(*getMemInstByIdx(StoreMgr, 0));
-    case OpCode::Memory__size:
-      return runMemorySizeOp(*getMemInstByIdx(StoreMgr, 0));
-    case OpCode::Memory__init:
-      return runMemoryInitOp(
-          *getMemInstByIdx(StoreMgr, 0),
-          *getDataInstByIdx(StoreMgr, Instr.getSourceIndex()), Instr);
-    case OpCode::Data__drop:
-      return runDataDropOp(*getDataInstByIdx(StoreMgr, Instr.getTargetIndex()));
-    case OpCode::Memory__copy:
-      return runMemoryCopyOp(*getMemInstByIdx(StoreMgr, 0), Instr);
-    case OpCode::Memory__fill:
-      return runMemoryFillOp(*getMemInstByIdx(StoreMgr, 0), Instr);
+  /// Memory Instructions
+  CASE(I32__load):
+    DISPATCH_RESULT(runLoadOp<uint32_t, GuardedMemory>(*InstCtx.MemInst, *PC));
+  CASE(I64__load):
+    DISPATCH_RESULT(runLoadOp<uint64_t, GuardedMemory>(*InstCtx.MemInst, *PC));
+  CASE(F32__load):
+    DISPATCH_RESULT(runLoadOp<float, GuardedMemory>(*InstCtx.MemInst, *PC));
+  CASE(F64__load):
+    DISPATCH_RESULT(runLoadOp<double, GuardedMemory>(*InstCtx.MemInst, *PC));
+  CASE(I32__load8_s):
+    DISPATCH_RESULT(
+        runLoadOp<int32_t, GuardedMemory>(*InstCtx.MemInst, *PC, 8));
+  CASE(I32__load8_u):
+    DISPATCH_RESULT(
+        runLoadOp<uint32_t, GuardedMemory>(*InstCtx.MemInst, *PC, 8));
+  CASE(I32__load16_s):
+    DISPATCH_RESULT(
+        runLoadOp<int32_t, GuardedMemory>(*InstCtx.MemInst, *PC, 16));
+  CASE(I32__load16_u):
+    DISPATCH_RESULT(
+        runLoadOp<uint32_t, GuardedMemory>(*InstCtx.MemInst, *PC, 16));
+  CASE(I64__load8_s):
+    DISPATCH_RESULT(
+        runLoadOp<int64_t, GuardedMemory>(*InstCtx.MemInst, *PC, 8));
+  CASE(I64__load8_u):
+    DISPATCH_RESULT(
+        runLoadOp<uint64_t, GuardedMemory>(*InstCtx.MemInst, *PC, 8));
+  CASE(I64__load16_s):
+    DISPATCH_RESULT(
+        runLoadOp<int64_t, GuardedMemory>(*InstCtx.MemInst, *PC, 16));
+  CASE(I64__load16_u):
+    DISPATCH_RESULT(
+        runLoadOp<uint64_t, GuardedMemory>(*InstCtx.MemInst, *PC, 16));
+  CASE(I64__load32_s):
+    DISPATCH_RESULT(
+        runLoadOp<int64_t, GuardedMemory>(*InstCtx.MemInst, *PC, 32));
+  CASE(I64__load32_u):
+    DISPATCH_RESULT(
+        runLoadOp<uint64_t, GuardedMemory>(*InstCtx.MemInst, *PC, 32));
+  CASE(I32__store):
+    DISPATCH_RESULT(runStoreOp<uint32_t, GuardedMemory>(*InstCtx.MemInst, *PC));
+  CASE(I64__store):
+    DISPATCH_RESULT(runStoreOp<uint64_t, GuardedMemory>(*InstCtx.MemInst, *PC));
+  CASE(F32__store):
+    DISPATCH_RESULT(runStoreOp<float, GuardedMemory>(*InstCtx.MemInst, *PC));
+  CASE(F64__store):
+    DISPATCH_RESULT(runStoreOp<double, GuardedMemory>(*InstCtx.MemInst, *PC));
+  CASE(I32__store8):
+    DISPATCH_RESULT(
+        runStoreOp<uint32_t, GuardedMemory>(*InstCtx.MemInst, *PC, 8));
+  CASE(I32__store16):
+    DISPATCH_RESULT(
+        runStoreOp<uint32_t, GuardedMemory>(*InstCtx.MemInst, *PC, 16));
+  CASE(I64__store8):
+    DISPATCH_RESULT(
+        runStoreOp<uint64_t, GuardedMemory>(*InstCtx.MemInst, *PC, 8));
+  CASE(I64__store16):
+    DISPATCH_RESULT(
+        runStoreOp<uint64_t, GuardedMemory>(*InstCtx.MemInst, *PC, 16));
+  CASE(I64__store32):
+    DISPATCH_RESULT(
+        runStoreOp<uint64_t, GuardedMemory>(*InstCtx.MemInst, *PC, 32));
+  CASE(Memory__grow):
+    DISPATCH_RESULT(runMemoryGrowOp(*InstCtx.MemInst));
+  CASE(Memory__size):
+    DISPATCH_RESULT(runMemorySizeOp(*InstCtx.MemInst));
+  CASE(Memory__init):
+    DISPATCH_RESULT(
+        runMemoryInitOp(*InstCtx.MemInst,
+                        *getDataInstByIdx(StoreMgr, PC->getSourceIndex()),
+                        *PC));
+  CASE(Data__drop):
+    DISPATCH_RESULT(
+        runDataDropOp(*getDataInstByIdx(StoreMgr, PC->getTargetIndex())));
+  CASE(Memory__copy):
+    DISPATCH_RESULT(runMemoryCopyOp(*InstCtx.MemInst, *PC));
+  CASE(Memory__fill):
+    DISPATCH_RESULT(runMemoryFillOp(*InstCtx.MemInst, *PC));
 
-    /// Const numeric instructions
-    case OpCode::I32__const:
-    case OpCode::I64__const:
-    case OpCode::F32__const:
-    case OpCode::F64__const:
-      StackMgr.push(Instr.getNum());
-      return {};
+  /// Const numeric instructions
+  CASE(I32__const):
+  CASE(I64__const):
+  CASE(F32__const):
+  CASE(F64__const):
+    StackMgr.push(PC->getNum());
+    DISPATCH_NEXT();
 
-    /// Unary numeric instructions
-    case OpCode::I32__eqz:
-      return runEqzOp<uint32_t>(StackMgr.getTop());
-    case OpCode::I64__eqz:
-      return runEqzOp<uint64_t>(StackMgr.getTop());
-    case OpCode::I32__clz:
-      return runClzOp<uint32_t>(StackMgr.getTop());
-    case OpCode::I32__ctz:
-      return runCtzOp<uint32_t>(StackMgr.getTop());
-    case OpCode::I32__popcnt:
-      return runPopcntOp<uint32_t>(StackMgr.getTop());
-    case OpCode::I64__clz:
-      return runClzOp<uint64_t>(StackMgr.getTop());
-    case OpCode::I64__ctz:
-      return runCtzOp<uint64_t>(StackMgr.getTop());
-    case OpCode::I64__popcnt:
-      return runPopcntOp<uint64_t>(StackMgr.getTop());
-    case OpCode::F32__abs:
-      return runAbsOp<float>(StackMgr.getTop());
-    case OpCode::F32__neg:
-      return runNegOp<float>(StackMgr.getTop());
-    case OpCode::F32__ceil:
-      return runCeilOp<float>(StackMgr.getTop());
-    case OpCode::F32__floor:
-      return runFloorOp<float>(StackMgr.getTop());
-    case OpCode::F32__trunc:
-      return runTruncOp<float>(StackMgr.getTop());
-    case OpCode::F32__nearest:
-      return runNearestOp<float>(StackMgr.getTop());
-    case OpCode::F32__sqrt:
-      return runSqrtOp<float>(StackMgr.getTop());
-    case OpCode::F64__abs:
-      return runAbsOp<double>(StackMgr.getTop());
-    case OpCode::F64__neg:
-      return runNegOp<double>(StackMgr.getTop());
-    case OpCode::F64__ceil:
-      return runCeilOp<double>(StackMgr.getTop());
-    case OpCode::F64__floor:
-      return runFloorOp<double>(StackMgr.getTop());
-    case OpCode::F64__trunc:
-      return runTruncOp<double>(StackMgr.getTop());
-    case OpCode::F64__nearest:
-      return runNearestOp<double>(StackMgr.getTop());
-    case OpCode::F64__sqrt:
-      return runSqrtOp<double>(StackMgr.getTop());
-    case OpCode::I32__wrap_i64:
-      return runWrapOp<uint64_t, uint32_t>(StackMgr.getTop());
-    case OpCode::I32__trunc_f32_s:
-      return runTruncateOp<float, int32_t>(Instr, StackMgr.getTop());
-    case OpCode::I32__trunc_f32_u:
-      return runTruncateOp<float, uint32_t>(Instr, StackMgr.getTop());
-    case OpCode::I32__trunc_f64_s:
-      return runTruncateOp<double, int32_t>(Instr, StackMgr.getTop());
-    case OpCode::I32__trunc_f64_u:
-      return runTruncateOp<double, uint32_t>(Instr, StackMgr.getTop());
-    case OpCode::I64__extend_i32_s:
-      return runExtendOp<int32_t, uint64_t>(StackMgr.getTop());
-    case OpCode::I64__extend_i32_u:
-      return runExtendOp<uint32_t, uint64_t>(StackMgr.getTop());
-    case OpCode::I64__trunc_f32_s:
-      return runTruncateOp<float, int64_t>(Instr, StackMgr.getTop());
-    case OpCode::I64__trunc_f32_u:
-      return runTruncateOp<float, uint64_t>(Instr, StackMgr.getTop());
-    case OpCode::I64__trunc_f64_s:
-      return runTruncateOp<double, int64_t>(Instr, StackMgr.getTop());
-    case OpCode::I64__trunc_f64_u:
-      return runTruncateOp<double, uint64_t>(Instr, StackMgr.getTop());
-    case OpCode::F32__convert_i32_s:
-      return runConvertOp<int32_t, float>(StackMgr.getTop());
-    case OpCode::F32__convert_i32_u:
-      return runConvertOp<uint32_t, float>(StackMgr.getTop());
-    case OpCode::F32__convert_i64_s:
-      return runConvertOp<int64_t, float>(StackMgr.getTop());
-    case OpCode::F32__convert_i64_u:
-      return runConvertOp<uint64_t, float>(StackMgr.getTop());
-    case OpCode::F32__demote_f64:
-      return runDemoteOp<double, float>(StackMgr.getTop());
-    case OpCode::F64__convert_i32_s:
-      return runConvertOp<int32_t, double>(StackMgr.getTop());
-    case OpCode::F64__convert_i32_u:
-      return runConvertOp<uint32_t, double>(StackMgr.getTop());
-    case OpCode::F64__convert_i64_s:
-      return runConvertOp<int64_t, double>(StackMgr.getTop());
-    case OpCode::F64__convert_i64_u:
-      return runConvertOp<uint64_t, double>(StackMgr.getTop());
-    case OpCode::F64__promote_f32:
-      return runPromoteOp<float, double>(StackMgr.getTop());
-    case OpCode::I32__reinterpret_f32:
-      return runReinterpretOp<float, uint32_t>(StackMgr.getTop());
-    case OpCode::I64__reinterpret_f64:
-      return runReinterpretOp<double, uint64_t>(StackMgr.getTop());
-    case OpCode::F32__reinterpret_i32:
-      return runReinterpretOp<uint32_t, float>(StackMgr.getTop());
-    case OpCode::F64__reinterpret_i64:
-      return runReinterpretOp<uint64_t, double>(StackMgr.getTop());
-    case OpCode::I32__extend8_s:
-      return runExtendOp<int32_t, uint32_t, 8>(StackMgr.getTop());
-    case OpCode::I32__extend16_s:
-      return runExtendOp<int32_t, uint32_t, 16>(StackMgr.getTop());
-    case OpCode::I64__extend8_s:
-      return runExtendOp<int64_t, uint64_t, 8>(StackMgr.getTop());
-    case OpCode::I64__extend16_s:
-      return runExtendOp<int64_t, uint64_t, 16>(StackMgr.getTop());
-    case OpCode::I64__extend32_s:
-      return runExtendOp<int64_t, uint64_t, 32>(StackMgr.getTop());
-    case OpCode::I32__trunc_sat_f32_s:
-      return runTruncateSatOp<float, int32_t>(StackMgr.getTop());
-    case OpCode::I32__trunc_sat_f32_u:
-      return runTruncateSatOp<float, uint32_t>(StackMgr.getTop());
-    case OpCode::I32__trunc_sat_f64_s:
-      return runTruncateSatOp<double, int32_t>(StackMgr.getTop());
-    case OpCode::I32__trunc_sat_f64_u:
-      return runTruncateSatOp<double, uint32_t>(StackMgr.getTop());
-    case OpCode::I64__trunc_sat_f32_s:
-      return runTruncateSatOp<float, int64_t>(StackMgr.getTop());
-    case OpCode::I64__trunc_sat_f32_u:
-      return runTruncateSatOp<float, uint64_t>(StackMgr.getTop());
-    case OpCode::I64__trunc_sat_f64_s:
-      return runTruncateSatOp<double, int64_t>(StackMgr.getTop());
-    case OpCode::I64__trunc_sat_f64_u:
-      return runTruncateSatOp<double, uint64_t>(StackMgr.getTop());
+  /// Unary numeric instructions
+  CASE(I32__eqz):
+    DISPATCH_RESULT(runEqzOp<uint32_t>(StackMgr.getTop()));
+  CASE(I64__eqz):
+    DISPATCH_RESULT(runEqzOp<uint64_t>(StackMgr.getTop()));
+  CASE(I32__clz):
+    DISPATCH_RESULT(runClzOp<uint32_t>(StackMgr.getTop()));
+  CASE(I32__ctz):
+    DISPATCH_RESULT(runCtzOp<uint32_t>(StackMgr.getTop()));
+  CASE(I32__popcnt):
+    DISPATCH_RESULT(runPopcntOp<uint32_t>(StackMgr.getTop()));
+  CASE(I64__clz):
+    DISPATCH_RESULT(runClzOp<uint64_t>(StackMgr.getTop()));
+  CASE(I64__ctz):
+    DISPATCH_RESULT(runCtzOp<uint64_t>(StackMgr.getTop()));
+  CASE(I64__popcnt):
+    DISPATCH_RESULT(runPopcntOp<uint64_t>(StackMgr.getTop()));
+  CASE(F32__abs):
+    DISPATCH_RESULT(runAbsOp<float>(StackMgr.getTop()));
+  CASE(F32__neg):
+    DISPATCH_RESULT(runNegOp<float>(StackMgr.getTop()));
+  CASE(F32__ceil):
+    DISPATCH_RESULT(runCeilOp<float>(StackMgr.getTop()));
+  CASE(F32__floor):
+    DISPATCH_RESULT(runFloorOp<float>(StackMgr.getTop()));
+  CASE(F32__trunc):
+    DISPATCH_RESULT(runTruncOp<float>(StackMgr.getTop()));
+  CASE(F32__nearest):
+    DISPATCH_RESULT(runNearestOp<float>(StackMgr.getTop()));
+  CASE(F32__sqrt):
+    DISPATCH_RESULT(runSqrtOp<float>(StackMgr.getTop()));
+  CASE(F64__abs):
+    DISPATCH_RESULT(runAbsOp<double>(StackMgr.getTop()));
+  CASE(F64__neg):
+    DISPATCH_RESULT(runNegOp<double>(StackMgr.getTop()));
+  CASE(F64__ceil):
+    DISPATCH_RESULT(runCeilOp<double>(StackMgr.getTop()));
+  CASE(F64__floor):
+    DISPATCH_RESULT(runFloorOp<double>(StackMgr.getTop()));
+  CASE(F64__trunc):
+    DISPATCH_RESULT(runTruncOp<double>(StackMgr.getTop()));
+  CASE(F64__nearest):
+    DISPATCH_RESULT(runNearestOp<double>(StackMgr.getTop()));
+  CASE(F64__sqrt):
+    DISPATCH_RESULT(runSqrtOp<double>(StackMgr.getTop()));
+  CASE(I32__wrap_i64):
+    DISPATCH_RESULT(runWrapOp<uint64_t, uint32_t>(StackMgr.getTop()));
+  CASE(I32__trunc_f32_s):
+    DISPATCH_RESULT(runTruncateOp<float, int32_t>(*PC, StackMgr.getTop()));
+  CASE(I32__trunc_f32_u):
+    DISPATCH_RESULT(runTruncateOp<float, uint32_t>(*PC, StackMgr.getTop()));
+  CASE(I32__trunc_f64_s):
+    DISPATCH_RESULT(runTruncateOp<double, int32_t>(*PC, StackMgr.getTop()));
+  CASE(I32__trunc_f64_u):
+    DISPATCH_RESULT(runTruncateOp<double, uint32_t>(*PC, StackMgr.getTop()));
+  CASE(I64__extend_i32_s):
+    DISPATCH_RESULT(runExtendOp<int32_t, uint64_t>(StackMgr.getTop()));
+  CASE(I64__extend_i32_u):
+    DISPATCH_RESULT(runExtendOp<uint32_t, uint64_t>(StackMgr.getTop()));
+  CASE(I64__trunc_f32_s):
+    DISPATCH_RESULT(runTruncateOp<float, int64_t>(*PC, StackMgr.getTop()));
+  CASE(I64__trunc_f32_u):
+    DISPATCH_RESULT(runTruncateOp<float, uint64_t>(*PC, StackMgr.getTop()));
+  CASE(I64__trunc_f64_s):
+    DISPATCH_RESULT(runTruncateOp<double, int64_t>(*PC, StackMgr.getTop()));
+  CASE(I64__trunc_f64_u):
+    DISPATCH_RESULT(runTruncateOp<double, uint64_t>(*PC, StackMgr.getTop()));
+  CASE(F32__convert_i32_s):
+    DISPATCH_RESULT(runConvertOp<int32_t, float>(StackMgr.getTop()));
+  CASE(F32__convert_i32_u):
+    DISPATCH_RESULT(runConvertOp<uint32_t, float>(StackMgr.getTop()));
+  CASE(F32__convert_i64_s):
+    DISPATCH_RESULT(runConvertOp<int64_t, float>(StackMgr.getTop()));
+  CASE(F32__convert_i64_u):
+    DISPATCH_RESULT(runConvertOp<uint64_t, float>(StackMgr.getTop()));
+  CASE(F32__demote_f64):
+    DISPATCH_RESULT(runDemoteOp<double, float>(StackMgr.getTop()));
+  CASE(F64__convert_i32_s):
+    DISPATCH_RESULT(runConvertOp<int32_t, double>(StackMgr.getTop()));
+  CASE(F64__convert_i32_u):
+    DISPATCH_RESULT(runConvertOp<uint32_t, double>(StackMgr.getTop()));
+  CASE(F64__convert_i64_s):
+    DISPATCH_RESULT(runConvertOp<int64_t, double>(StackMgr.getTop()));
+  CASE(F64__convert_i64_u):
+    DISPATCH_RESULT(runConvertOp<uint64_t, double>(StackMgr.getTop()));
+  CASE(F64__promote_f32):
+    DISPATCH_RESULT(runPromoteOp<float, double>(StackMgr.getTop()));
+  CASE(I32__reinterpret_f32):
+    DISPATCH_RESULT(runReinterpretOp<float, uint32_t>(StackMgr.getTop()));
+  CASE(I64__reinterpret_f64):
+    DISPATCH_RESULT(runReinterpretOp<double, uint64_t>(StackMgr.getTop()));
+  CASE(F32__reinterpret_i32):
+    DISPATCH_RESULT(runReinterpretOp<uint32_t, float>(StackMgr.getTop()));
+  CASE(F64__reinterpret_i64):
+    DISPATCH_RESULT(runReinterpretOp<uint64_t, double>(StackMgr.getTop()));
+  CASE(I32__extend8_s):
+    DISPATCH_RESULT(runExtendOp<int32_t, uint32_t, 8>(StackMgr.getTop()));
+  CASE(I32__extend16_s):
+    DISPATCH_RESULT(runExtendOp<int32_t, uint32_t, 16>(StackMgr.getTop()));
+  CASE(I64__extend8_s):
+    DISPATCH_RESULT(runExtendOp<int64_t, uint64_t, 8>(StackMgr.getTop()));
+  CASE(I64__extend16_s):
+    DISPATCH_RESULT(runExtendOp<int64_t, uint64_t, 16>(StackMgr.getTop()));
+  CASE(I64__extend32_s):
+    DISPATCH_RESULT(runExtendOp<int64_t, uint64_t, 32>(StackMgr.getTop()));
+  CASE(I32__trunc_sat_f32_s):
+    DISPATCH_RESULT(runTruncateSatOp<float, int32_t>(StackMgr.getTop()));
+  CASE(I32__trunc_sat_f32_u):
+    DISPATCH_RESULT(runTruncateSatOp<float, uint32_t>(StackMgr.getTop()));
+  CASE(I32__trunc_sat_f64_s):
+    DISPATCH_RESULT(runTruncateSatOp<double, int32_t>(StackMgr.getTop()));
+  CASE(I32__trunc_sat_f64_u):
+    DISPATCH_RESULT(runTruncateSatOp<double, uint32_t>(StackMgr.getTop()));
+  CASE(I64__trunc_sat_f32_s):
+    DISPATCH_RESULT(runTruncateSatOp<float, int64_t>(StackMgr.getTop()));
+  CASE(I64__trunc_sat_f32_u):
+    DISPATCH_RESULT(runTruncateSatOp<float, uint64_t>(StackMgr.getTop()));
+  CASE(I64__trunc_sat_f64_s):
+    DISPATCH_RESULT(runTruncateSatOp<double, int64_t>(StackMgr.getTop()));
+  CASE(I64__trunc_sat_f64_u):
+    DISPATCH_RESULT(runTruncateSatOp<double, uint64_t>(StackMgr.getTop()));
 
-      /// Binary numeric instructions
-    case OpCode::I32__eq: {
-      ValVariant Rhs = StackMgr.pop();
-      return runEqOp<uint32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32__ne: {
-      ValVariant Rhs = StackMgr.pop();
-      return runNeOp<uint32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32__lt_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runLtOp<int32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32__lt_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runLtOp<uint32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32__gt_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runGtOp<int32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32__gt_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runGtOp<uint32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32__le_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runLeOp<int32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32__le_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runLeOp<uint32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32__ge_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runGeOp<int32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32__ge_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runGeOp<uint32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I64__eq: {
-      ValVariant Rhs = StackMgr.pop();
-      return runEqOp<uint64_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I64__ne: {
-      ValVariant Rhs = StackMgr.pop();
-      return runNeOp<uint64_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I64__lt_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runLtOp<int64_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I64__lt_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runLtOp<uint64_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I64__gt_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runGtOp<int64_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I64__gt_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runGtOp<uint64_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I64__le_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runLeOp<int64_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I64__le_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runLeOp<uint64_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I64__ge_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runGeOp<int64_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I64__ge_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runGeOp<uint64_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F32__eq: {
-      ValVariant Rhs = StackMgr.pop();
-      return runEqOp<float>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F32__ne: {
-      ValVariant Rhs = StackMgr.pop();
-      return runNeOp<float>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F32__lt: {
-      ValVariant Rhs = StackMgr.pop();
-      return runLtOp<float>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F32__gt: {
-      ValVariant Rhs = StackMgr.pop();
-      return runGtOp<float>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F32__le: {
-      ValVariant Rhs = StackMgr.pop();
-      return runLeOp<float>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F32__ge: {
-      ValVariant Rhs = StackMgr.pop();
-      return runGeOp<float>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F64__eq: {
-      ValVariant Rhs = StackMgr.pop();
-      return runEqOp<double>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F64__ne: {
-      ValVariant Rhs = StackMgr.pop();
-      return runNeOp<double>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F64__lt: {
-      ValVariant Rhs = StackMgr.pop();
-      return runLtOp<double>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F64__gt: {
-      ValVariant Rhs = StackMgr.pop();
-      return runGtOp<double>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F64__le: {
-      ValVariant Rhs = StackMgr.pop();
-      return runLeOp<double>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F64__ge: {
-      ValVariant Rhs = StackMgr.pop();
-      return runGeOp<double>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32__add: {
-      ValVariant Rhs = StackMgr.pop();
-      return runAddOp<uint32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32__sub: {
-      ValVariant Rhs = StackMgr.pop();
-      return runSubOp<uint32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32__mul: {
-      ValVariant Rhs = StackMgr.pop();
-      return runMulOp<uint32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32__div_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runDivOp<int32_t>(Instr, StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32__div_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runDivOp<uint32_t>(Instr, StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32__rem_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runRemOp<int32_t>(Instr, StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32__rem_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runRemOp<uint32_t>(Instr, StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32__and: {
-      ValVariant Rhs = StackMgr.pop();
-      return runAndOp<uint32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32__or: {
-      ValVariant Rhs = StackMgr.pop();
-      return runOrOp<uint32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32__xor: {
-      ValVariant Rhs = StackMgr.pop();
-      return runXorOp<uint32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32__shl: {
-      ValVariant Rhs = StackMgr.pop();
-      return runShlOp<uint32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32__shr_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runShrOp<int32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32__shr_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runShrOp<uint32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32__rotl: {
-      ValVariant Rhs = StackMgr.pop();
-      return runRotlOp<uint32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32__rotr: {
-      ValVariant Rhs = StackMgr.pop();
-      return runRotrOp<uint32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I64__add: {
-      ValVariant Rhs = StackMgr.pop();
-      return runAddOp<uint64_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I64__sub: {
-      ValVariant Rhs = StackMgr.pop();
-      return runSubOp<uint64_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I64__mul: {
-      ValVariant Rhs = StackMgr.pop();
-      return runMulOp<uint64_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I64__div_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runDivOp<int64_t>(Instr, StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I64__div_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runDivOp<uint64_t>(Instr, StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I64__rem_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runRemOp<int64_t>(Instr, StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I64__rem_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runRemOp<uint64_t>(Instr, StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I64__and: {
-      ValVariant Rhs = StackMgr.pop();
-      return runAndOp<uint64_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I64__or: {
-      ValVariant Rhs = StackMgr.pop();
-      return runOrOp<uint64_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I64__xor: {
-      ValVariant Rhs = StackMgr.pop();
-      return runXorOp<uint64_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I64__shl: {
-      ValVariant Rhs = StackMgr.pop();
-      return runShlOp<uint64_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I64__shr_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runShrOp<int64_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I64__shr_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runShrOp<uint64_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I64__rotl: {
-      ValVariant Rhs = StackMgr.pop();
-      return runRotlOp<uint64_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I64__rotr: {
-      ValVariant Rhs = StackMgr.pop();
-      return runRotrOp<uint64_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F32__add: {
-      ValVariant Rhs = StackMgr.pop();
-      return runAddOp<float>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F32__sub: {
-      ValVariant Rhs = StackMgr.pop();
-      return runSubOp<float>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F32__mul: {
-      ValVariant Rhs = StackMgr.pop();
-      return runMulOp<float>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F32__div: {
-      ValVariant Rhs = StackMgr.pop();
-      return runDivOp<float>(Instr, StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F32__min: {
-      ValVariant Rhs = StackMgr.pop();
-      return runMinOp<float>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F32__max: {
-      ValVariant Rhs = StackMgr.pop();
-      return runMaxOp<float>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F32__copysign: {
-      ValVariant Rhs = StackMgr.pop();
-      return runCopysignOp<float>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F64__add: {
-      ValVariant Rhs = StackMgr.pop();
-      return runAddOp<double>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F64__sub: {
-      ValVariant Rhs = StackMgr.pop();
-      return runSubOp<double>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F64__mul: {
-      ValVariant Rhs = StackMgr.pop();
-      return runMulOp<double>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F64__div: {
-      ValVariant Rhs = StackMgr.pop();
-      return runDivOp<double>(Instr, StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F64__min: {
-      ValVariant Rhs = StackMgr.pop();
-      return runMinOp<double>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F64__max: {
-      ValVariant Rhs = StackMgr.pop();
-      return runMaxOp<double>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F64__copysign: {
-      ValVariant Rhs = StackMgr.pop();
-      return runCopysignOp<double>(StackMgr.getTop(), Rhs);
-    }
+    /// Binary numeric instructions
+  CASE(I32__eq): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runEqOp<uint32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32__ne): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runNeOp<uint32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32__lt_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runLtOp<int32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32__lt_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runLtOp<uint32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32__gt_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runGtOp<int32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32__gt_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runGtOp<uint32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32__le_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runLeOp<int32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32__le_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runLeOp<uint32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32__ge_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runGeOp<int32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32__ge_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runGeOp<uint32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I64__eq): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runEqOp<uint64_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I64__ne): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runNeOp<uint64_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I64__lt_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runLtOp<int64_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I64__lt_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runLtOp<uint64_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I64__gt_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runGtOp<int64_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I64__gt_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runGtOp<uint64_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I64__le_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runLeOp<int64_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I64__le_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runLeOp<uint64_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I64__ge_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runGeOp<int64_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I64__ge_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runGeOp<uint64_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F32__eq): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runEqOp<float>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F32__ne): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runNeOp<float>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F32__lt): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runLtOp<float>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F32__gt): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runGtOp<float>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F32__le): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runLeOp<float>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F32__ge): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runGeOp<float>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F64__eq): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runEqOp<double>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F64__ne): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runNeOp<double>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F64__lt): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runLtOp<double>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F64__gt): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runGtOp<double>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F64__le): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runLeOp<double>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F64__ge): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runGeOp<double>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32__add): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runAddOp<uint32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32__sub): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runSubOp<uint32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32__mul): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runMulOp<uint32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32__div_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runDivOp<int32_t>(*PC, StackMgr.getTop(), Rhs));
+  }
+  CASE(I32__div_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runDivOp<uint32_t>(*PC, StackMgr.getTop(), Rhs));
+  }
+  CASE(I32__rem_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runRemOp<int32_t>(*PC, StackMgr.getTop(), Rhs));
+  }
+  CASE(I32__rem_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runRemOp<uint32_t>(*PC, StackMgr.getTop(), Rhs));
+  }
+  CASE(I32__and): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runAndOp<uint32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32__or): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runOrOp<uint32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32__xor): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runXorOp<uint32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32__shl): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runShlOp<uint32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32__shr_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runShrOp<int32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32__shr_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runShrOp<uint32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32__rotl): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runRotlOp<uint32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32__rotr): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runRotrOp<uint32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I64__add): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runAddOp<uint64_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I64__sub): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runSubOp<uint64_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I64__mul): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runMulOp<uint64_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I64__div_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runDivOp<int64_t>(*PC, StackMgr.getTop(), Rhs));
+  }
+  CASE(I64__div_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runDivOp<uint64_t>(*PC, StackMgr.getTop(), Rhs));
+  }
+  CASE(I64__rem_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runRemOp<int64_t>(*PC, StackMgr.getTop(), Rhs));
+  }
+  CASE(I64__rem_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runRemOp<uint64_t>(*PC, StackMgr.getTop(), Rhs));
+  }
+  CASE(I64__and): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runAndOp<uint64_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I64__or): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runOrOp<uint64_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I64__xor): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runXorOp<uint64_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I64__shl): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runShlOp<uint64_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I64__shr_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runShrOp<int64_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I64__shr_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runShrOp<uint64_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I64__rotl): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runRotlOp<uint64_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I64__rotr): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runRotrOp<uint64_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F32__add): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runAddOp<float>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F32__sub): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runSubOp<float>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F32__mul): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runMulOp<float>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F32__div): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runDivOp<float>(*PC, StackMgr.getTop(), Rhs));
+  }
+  CASE(F32__min): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runMinOp<float>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F32__max): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runMaxOp<float>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F32__copysign): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runCopysignOp<float>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F64__add): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runAddOp<double>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F64__sub): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runSubOp<double>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F64__mul): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runMulOp<double>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F64__div): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runDivOp<double>(*PC, StackMgr.getTop(), Rhs));
+  }
+  CASE(F64__min): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runMinOp<double>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F64__max): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runMaxOp<double>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F64__copysign): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runCopysignOp<double>(StackMgr.getTop(), Rhs));
+  }
 
-    /// SIMD Memory Instructions
-    case OpCode::V128__load:
-      return runLoadOp<uint128_t>(*getMemInstByIdx(StoreMgr, 0), Instr);
-    case OpCode::I16x8__load8x8_s:
-      return runLoadExpandOp<int8_t, int16_t>(*getMemInstByIdx(StoreMgr, 0),
-                                              Instr);
-    case OpCode::I16x8__load8x8_u:
-      return runLoadExpandOp<uint8_t, uint16_t>(*getMemInstByIdx(StoreMgr, 0),
-                                                Instr);
-    case OpCode::I32x4__load16x4_s:
-      return runLoadExpandOp<int16_t, int32_t>(*getMemInstByIdx(StoreMgr, 0),
-                                               Instr);
-    case OpCode::I32x4__load16x4_u:
-      return runLoadExpandOp<uint16_t, uint32_t>(*getMemInstByIdx(StoreMgr, 0),
-                                                 Instr);
-    case OpCode::I64x2__load32x2_s:
-      return runLoadExpandOp<int32_t, int64_t>(*getMemInstByIdx(StoreMgr, 0),
-                                               Instr);
-    case OpCode::I64x2__load32x2_u:
-      return runLoadExpandOp<uint32_t, uint64_t>(*getMemInstByIdx(StoreMgr, 0),
-                                                 Instr);
-    case OpCode::I8x16__load_splat:
-      return runLoadSplatOp<uint8_t>(*getMemInstByIdx(StoreMgr, 0), Instr);
-    case OpCode::I16x8__load_splat:
-      return runLoadSplatOp<uint16_t>(*getMemInstByIdx(StoreMgr, 0), Instr);
-    case OpCode::I32x4__load_splat:
-      return runLoadSplatOp<uint32_t>(*getMemInstByIdx(StoreMgr, 0), Instr);
-    case OpCode::I64x2__load_splat:
-      return runLoadSplatOp<uint64_t>(*getMemInstByIdx(StoreMgr, 0), Instr);
-    case OpCode::V128__load32_zero:
-      return runLoadOp<uint128_t>(*getMemInstByIdx(StoreMgr, 0), Instr, 32);
-    case OpCode::V128__load64_zero:
-      return runLoadOp<uint128_t>(*getMemInstByIdx(StoreMgr, 0), Instr, 64);
-    case OpCode::V128__store:
-      return runStoreOp<uint128_t>(*getMemInstByIdx(StoreMgr, 0), Instr);
+  /// SIMD Memory Instructions
+  CASE(V128__load):
+    DISPATCH_RESULT(runLoadOp<uint128_t, GuardedMemory>(*InstCtx.MemInst, *PC));
+  CASE(I16x8__load8x8_s):
+    DISPATCH_RESULT(
+        runLoadExpandOp<int8_t, int16_t>(*InstCtx.MemInst, *PC));
+  CASE(I16x8__load8x8_u):
+    DISPATCH_RESULT(
+        runLoadExpandOp<uint8_t, uint16_t>(*InstCtx.MemInst, *PC));
+  CASE(I32x4__load16x4_s):
+    DISPATCH_RESULT(
+        runLoadExpandOp<int16_t, int32_t>(*InstCtx.MemInst, *PC));
+  CASE(I32x4__load16x4_u):
+    DISPATCH_RESULT(
+        runLoadExpandOp<uint16_t, uint32_t>(*InstCtx.MemInst,
+                                            *PC));
+  CASE(I64x2__load32x2_s):
+    DISPATCH_RESULT(
+        runLoadExpandOp<int32_t, int64_t>(*InstCtx.MemInst, *PC));
+  CASE(I64x2__load32x2_u):
+    DISPATCH_RESULT(
+        runLoadExpandOp<uint32_t, uint64_t>(*InstCtx.MemInst,
+                                            *PC));
+  CASE(I8x16__load_splat):
+    DISPATCH_RESULT(
+        runLoadSplatOp<uint8_t>(*InstCtx.MemInst, *PC));
+  CASE(I16x8__load_splat):
+    DISPATCH_RESULT(
+        runLoadSplatOp<uint16_t>(*InstCtx.MemInst, *PC));
+  CASE(I32x4__load_splat):
+    DISPATCH_RESULT(
+        runLoadSplatOp<uint32_t>(*InstCtx.MemInst, *PC));
+  CASE(I64x2__load_splat):
+    DISPATCH_RESULT(
+        runLoadSplatOp<uint64_t>(*InstCtx.MemInst, *PC));
+  CASE(V128__load32_zero):
+    DISPATCH_RESULT(
+        runLoadOp<uint128_t, GuardedMemory>(*InstCtx.MemInst, *PC, 32));
+  CASE(V128__load64_zero):
+    DISPATCH_RESULT(
+        runLoadOp<uint128_t, GuardedMemory>(*InstCtx.MemInst, *PC, 64));
+  CASE(V128__store):
+    DISPATCH_RESULT(
+        runStoreOp<uint128_t, GuardedMemory>(*InstCtx.MemInst, *PC));
 
-    /// SIMD Const Instructions
-    case OpCode::V128__const:
-      StackMgr.push(Instr.getNum());
-      return {};
+  /// SIMD Const Instructions
+  CASE(V128__const):
+    StackMgr.push(PC->getNum());
+    DISPATCH_NEXT();
 
-    /// SIMD Shuffle Instructions
-    case OpCode::I8x16__shuffle: {
-      ValVariant Val2 = StackMgr.pop();
-      ValVariant &Val1 = StackMgr.getTop();
-      std::array<uint8_t, 32> Data;
-      std::array<uint8_t, 16> Result;
-      std::memcpy(&Data[0], &Val1, 16);
-      std::memcpy(&Data[16], &Val2, 16);
-      const auto V3 = retrieveValue<uint128_t>(Instr.getNum());
-      for (size_t I = 0; I < 16; ++I) {
-        const uint8_t Index = static_cast<uint8_t>(V3 >> (I * 8));
-        Result[I] = Data[Index];
-      }
-      std::memcpy(&Val1, &Result[0], 16);
-      return {};
-    }
+  /// SIMD Shuffle Instructions
+  CASE(I8x16__shuffle): {
+    ValVariant Val2 = StackMgr.pop();
+    ValVariant &Val1 = StackMgr.getTop();
+    std::array<uint8_t, 32> Data;
+    std::array<uint8_t, 16> Result;
+    std::memcpy(&Data[0], &Val1, 16);
+    std::memcpy(&Data[16], &Val2, 16);
+    const auto V3 = retrieveValue<uint128_t>(PC->getNum());
+    for (size_t I = 0; I < 16; ++I) {
+      const uint8_t Index = static_cast<uint8_t>(V3 >> (I * 8));
+      Result[I] = Data[Index];
+    }
+    std::memcpy(&Val1, &Result[0], 16);
+    DISPATCH_NEXT();
+  }
 
-    /// SIMD Lane Instructions
-    case OpCode::I8x16__extract_lane_s:
-      return runExtractLaneOp<int8_t, int32_t>(StackMgr.getTop(),
-                                               Instr.getTargetIndex());
-    case OpCode::I8x16__extract_lane_u:
-      return runExtractLaneOp<uint8_t, uint32_t>(StackMgr.getTop(),
-                                                 Instr.getTargetIndex());
-    case OpCode::I16x8__extract_lane_s:
-      return runExtractLaneOp<int16_t, int32_t>(StackMgr.getTop(),
-                                                Instr.getTargetIndex());
-    case OpCode::I16x8__extract_lane_u:
-      return runExtractLaneOp<uint16_t, uint32_t>(StackMgr.getTop(),
-                                                  Instr.getTargetIndex());
-    case OpCode::I32x4__extract_lane:
-      return runExtractLaneOp<uint32_t>(StackMgr.getTop(),
-                                        Instr.getTargetIndex());
-    case OpCode::I64x2__extract_lane:
-      return runExtractLaneOp<uint64_t>(StackMgr.getTop(),
-                                        Instr.getTargetIndex());
-    case OpCode::F32x4__extract_lane:
-      return runExtractLaneOp<float>(StackMgr.getTop(), Instr.getTargetIndex());
-    case OpCode::F64x2__extract_lane:
-      return runExtractLaneOp<double>(StackMgr.getTop(),
-                                      Instr.getTargetIndex());
-    case OpCode::I8x16__replace_lane: {
-      ValVariant Rhs = StackMgr.pop();
-      return runReplaceLaneOp<uint32_t, uint8_t>(StackMgr.getTop(), Rhs,
-                                                 Instr.getTargetIndex());
-    }
-    case OpCode::I16x8__replace_lane: {
-      ValVariant Rhs = StackMgr.pop();
-      return runReplaceLaneOp<uint32_t, uint16_t>(StackMgr.getTop(), Rhs,
-                                                  Instr.getTargetIndex());
-    }
-    case OpCode::I32x4__replace_lane: {
-      ValVariant Rhs = StackMgr.pop();
-      return runReplaceLaneOp<uint32_t>(StackMgr.getTop(), Rhs,
-                                        Instr.getTargetIndex());
-    }
-    case OpCode::I64x2__replace_lane: {
-      ValVariant Rhs = StackMgr.pop();
-      return runReplaceLaneOp<uint64_t>(StackMgr.getTop(), Rhs,
-                                        Instr.getTargetIndex());
-    }
-    case OpCode::F32x4__replace_lane: {
-      ValVariant Rhs = StackMgr.pop();
-      return runReplaceLaneOp<float>(StackMgr.getTop(), Rhs,
-                                     Instr.getTargetIndex());
-    }
-    case OpCode::F64x2__replace_lane: {
-      ValVariant Rhs = StackMgr.pop();
-      return runReplaceLaneOp<double>(StackMgr.getTop(), Rhs,
-                                      Instr.getTargetIndex());
-    }
+  /// SIMD Lane Instructions
+  CASE(I8x16__extract_lane_s):
+    DISPATCH_RESULT(runExtractLaneOp<int8_t, int32_t>(StackMgr.getTop(),
+                                                      PC->getTargetIndex()));
+  CASE(I8x16__extract_lane_u):
+    DISPATCH_RESULT(runExtractLaneOp<uint8_t, uint32_t>(StackMgr.getTop(),
+                                                        PC->getTargetIndex()));
+  CASE(I16x8__extract_lane_s):
+    DISPATCH_RESULT(runExtractLaneOp<int16_t, int32_t>(StackMgr.getTop(),
+                                                       PC->getTargetIndex()));
+  CASE(I16x8__extract_lane_u):
+    DISPATCH_RESULT(runExtractLaneOp<uint16_t, uint32_t>(StackMgr.getTop(),
+                                                         PC->getTargetIndex()));
+  CASE(I32x4__extract_lane):
+    DISPATCH_RESULT(
+        runExtractLaneOp<uint32_t>(StackMgr.getTop(), PC->getTargetIndex()));
+  CASE(I64x2__extract_lane):
+    DISPATCH_RESULT(
+        runExtractLaneOp<uint64_t>(StackMgr.getTop(), PC->getTargetIndex()));
+  CASE(F32x4__extract_lane):
+    DISPATCH_RESULT(
+        runExtractLaneOp<float>(StackMgr.getTop(), PC->getTargetIndex()));
+  CASE(F64x2__extract_lane):
+    DISPATCH_RESULT(
+        runExtractLaneOp<double>(StackMgr.getTop(), PC->getTargetIndex()));
+  CASE(I8x16__replace_lane): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runReplaceLaneOp<uint32_t, uint8_t>(StackMgr.getTop(), Rhs,
+                                                        PC->getTargetIndex()));
+  }
+  CASE(I16x8__replace_lane): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runReplaceLaneOp<uint32_t, uint16_t>(StackMgr.getTop(), Rhs,
+                                                         PC->getTargetIndex()));
+  }
+  CASE(I32x4__replace_lane): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runReplaceLaneOp<uint32_t>(StackMgr.getTop(), Rhs,
+                                               PC->getTargetIndex()));
+  }
+  CASE(I64x2__replace_lane): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runReplaceLaneOp<uint64_t>(StackMgr.getTop(), Rhs,
+                                               PC->getTargetIndex()));
+  }
+  CASE(F32x4__replace_lane): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(
+        runReplaceLaneOp<float>(StackMgr.getTop(), Rhs, PC->getTargetIndex()));
+  }
+  CASE(F64x2__replace_lane): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(
+        runReplaceLaneOp<double>(StackMgr.getTop(), Rhs, PC->getTargetIndex()));
+  }
 
-      /// SIMD Numeric Instructions
-    case OpCode::I8x16__swizzle: {
-      const ValVariant Val2 = StackMgr.pop();
-      ValVariant &Val1 = StackMgr.getTop();
-      const uint8x16_t &Index = retrieveValue<uint8x16_t>(Val2);
-      uint8x16_t &Vector = retrieveValue<uint8x16_t>(Val1);
-      const uint8x16_t Limit = {16, 16, 16, 16, 16, 16, 16, 16,
-                                16, 16, 16, 16, 16, 16, 16, 16};
-      const uint8x16_t Zero = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
-      const uint8x16_t Exceed = (Index >= Limit);
+    /// SIMD Numeric Instructions
+  CASE(I8x16__swizzle): {
+    const ValVariant Val2 = StackMgr.pop();
+    ValVariant &Val1 = StackMgr.getTop();
+    const uint8x16_t &Index = retrieveValue<uint8x16_t>(Val2);
+    uint8x16_t &Vector = retrieveValue<uint8x16_t>(Val1);
+    const uint8x16_t Limit = {16, 16, 16, 16, 16, 16, 16, 16,
+                              16, 16, 16, 16, 16, 16, 16, 16};
+    const uint8x16_t Zero = {0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    const uint8x16_t Exceed = (Index >= Limit);
 #ifdef __clang__
-      uint8x16_t Result = {
-          Vector[Index[0]],  Vector[Index[1]],  Vector[Index[2]],
-          Vector[Index[3]],  Vector[Index[4]],  Vector[Index[5]],
-          Vector[Index[6]],  Vector[Index[7]],  Vector[Index[8]],
-          Vector[Index[9]],  Vector[Index[10]], Vector[Index[11]],
-          Vector[Index[12]], Vector[Index[13]], Vector[Index[14]],
-          Vector[Index[15]]};
+    uint8x16_t Result = {
+        Vector[Index[0]],  Vector[Index[1]],  Vector[Index[2]],
+        Vector[Index[3]],  Vector[Index[4]],  Vector[Index[5]],
+        Vector[Index[6]],  Vector[Index[7]],  Vector[Index[8]],
+        Vector[Index[9]],  Vector[Index[10]], Vector[Index[11]],
+        Vector[Index[12]], Vector[Index[13]], Vector[Index[14]],
+        Vector[Index[15]]};
 #else
-      uint8x16_t Result = __builtin_shuffle(Vector, Index);
+    uint8x16_t Result = __builtin_shuffle(Vector, Index);
 #endif
-      Vector = Exceed ? Zero : Result;
-      return {};
-    }
-    case OpCode::I8x16__splat:
-      return runSplatOp<uint32_t, uint8_t>(StackMgr.getTop());
-    case OpCode::I16x8__splat:
-      return runSplatOp<uint32_t, uint16_t>(StackMgr.getTop());
-    case OpCode::I32x4__splat:
-      return runSplatOp<uint32_t>(StackMgr.getTop());
-    case OpCode::I64x2__splat:
-      return runSplatOp<uint64_t>(StackMgr.getTop());
-    case OpCode::F32x4__splat:
-      return runSplatOp<float>(StackMgr.getTop());
-    case OpCode::F64x2__splat:
-      return runSplatOp<double>(StackMgr.getTop());
-    case OpCode::I8x16__eq: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorEqOp<uint8_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I8x16__ne: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorNeOp<uint8_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I8x16__lt_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorLtOp<int8_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I8x16__lt_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorLtOp<uint8_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I8x16__gt_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorGtOp<int8_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I8x16__gt_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorGtOp<uint8_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I8x16__le_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorLeOp<int8_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I8x16__le_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorLeOp<uint8_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I8x16__ge_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorGeOp<int8_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I8x16__ge_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorGeOp<uint8_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I16x8__eq: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorEqOp<uint16_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I16x8__ne: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorNeOp<uint16_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I16x8__lt_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorLtOp<int16_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I16x8__lt_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorLtOp<uint16_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I16x8__gt_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorGtOp<int16_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I16x8__gt_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorGtOp<uint16_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I16x8__le_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorLeOp<int16_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I16x8__le_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorLeOp<uint16_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I16x8__ge_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorGeOp<int16_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I16x8__ge_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorGeOp<uint16_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32x4__eq: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorEqOp<uint32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32x4__ne: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorNeOp<uint32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32x4__lt_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorLtOp<int32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32x4__lt_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorLtOp<uint32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32x4__gt_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorGtOp<int32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32x4__gt_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorGtOp<uint32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32x4__le_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorLeOp<int32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32x4__le_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorLeOp<uint32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32x4__ge_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorGeOp<int32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32x4__ge_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorGeOp<uint32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F32x4__eq: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorEqOp<float>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F32x4__ne: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorNeOp<float>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F32x4__lt: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorLtOp<float>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F32x4__gt: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorGtOp<float>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F32x4__le: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorLeOp<float>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F32x4__ge: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorGeOp<float>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F64x2__eq: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorEqOp<double>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F64x2__ne: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorNeOp<double>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F64x2__lt: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorLtOp<double>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F64x2__gt: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorGtOp<double>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F64x2__le: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorLeOp<double>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F64x2__ge: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorGeOp<double>(StackMgr.getTop(), Rhs);
-    }
+    Vector = Exceed ? Zero : Result;
+    DISPATCH_NEXT();
+  }
+  CASE(I8x16__splat):
+    DISPATCH_RESULT(runSplatOp<uint32_t, uint8_t>(StackMgr.getTop()));
+  CASE(I16x8__splat):
+    DISPATCH_RESULT(runSplatOp<uint32_t, uint16_t>(StackMgr.getTop()));
+  CASE(I32x4__splat):
+    DISPATCH_RESULT(runSplatOp<uint32_t>(StackMgr.getTop()));
+  CASE(I64x2__splat):
+    DISPATCH_RESULT(runSplatOp<uint64_t>(StackMgr.getTop()));
+  CASE(F32x4__splat):
+    DISPATCH_RESULT(runSplatOp<float>(StackMgr.getTop()));
+  CASE(F64x2__splat):
+    DISPATCH_RESULT(runSplatOp<double>(StackMgr.getTop()));
+  CASE(I8x16__eq): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorEqOp<uint8_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I8x16__ne): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorNeOp<uint8_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I8x16__lt_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorLtOp<int8_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I8x16__lt_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorLtOp<uint8_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I8x16__gt_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorGtOp<int8_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I8x16__gt_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorGtOp<uint8_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I8x16__le_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorLeOp<int8_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I8x16__le_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorLeOp<uint8_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I8x16__ge_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorGeOp<int8_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I8x16__ge_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorGeOp<uint8_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I16x8__eq): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorEqOp<uint16_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I16x8__ne): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorNeOp<uint16_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I16x8__lt_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorLtOp<int16_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I16x8__lt_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorLtOp<uint16_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I16x8__gt_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorGtOp<int16_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I16x8__gt_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorGtOp<uint16_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I16x8__le_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorLeOp<int16_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I16x8__le_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorLeOp<uint16_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I16x8__ge_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorGeOp<int16_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I16x8__ge_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorGeOp<uint16_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32x4__eq): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorEqOp<uint32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32x4__ne): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorNeOp<uint32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32x4__lt_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorLtOp<int32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32x4__lt_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorLtOp<uint32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32x4__gt_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorGtOp<int32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32x4__gt_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorGtOp<uint32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32x4__le_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorLeOp<int32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32x4__le_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorLeOp<uint32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32x4__ge_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorGeOp<int32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32x4__ge_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorGeOp<uint32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F32x4__eq): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorEqOp<float>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F32x4__ne): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorNeOp<float>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F32x4__lt): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorLtOp<float>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F32x4__gt): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorGtOp<float>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F32x4__le): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorLeOp<float>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F32x4__ge): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorGeOp<float>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F64x2__eq): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorEqOp<double>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F64x2__ne): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorNeOp<double>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F64x2__lt): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorLtOp<double>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F64x2__gt): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorGtOp<double>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F64x2__le): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorLeOp<double>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F64x2__ge): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorGeOp<double>(StackMgr.getTop(), Rhs));
+  }
 
-    case OpCode::V128__not: {
-      ValVariant &Val = StackMgr.getTop();
-      Val = ~retrieveValue<uint64x2_t>(Val);
-      return {};
-    }
-    case OpCode::V128__and: {
-      const ValVariant Val2 = StackMgr.pop();
-      ValVariant &Val1 = StackMgr.getTop();
-      retrieveValue<uint64x2_t>(Val1) &= retrieveValue<uint64x2_t>(Val2);
-      return {};
-    }
-    case OpCode::V128__andnot: {
-      const ValVariant Val2 = StackMgr.pop();
-      ValVariant &Val1 = StackMgr.getTop();
-      retrieveValue<uint64x2_t>(Val1) &= ~retrieveValue<uint64x2_t>(Val2);
-      return {};
-    }
-    case OpCode::V128__or: {
-      const ValVariant Val2 = StackMgr.pop();
-      ValVariant &Val1 = StackMgr.getTop();
-      retrieveValue<uint64x2_t>(Val1) |= retrieveValue<uint64x2_t>(Val2);
-      return {};
-    }
-    case OpCode::V128__xor: {
-      const ValVariant Val2 = StackMgr.pop();
-      ValVariant &Val1 = StackMgr.getTop();
-      retrieveValue<uint64x2_t>(Val1) ^= retrieveValue<uint64x2_t>(Val2);
-      return {};
-    }
-    case OpCode::V128__bitselect: {
-      const uint64x2_t C = retrieveValue<uint64x2_t>(StackMgr.pop());
-      const uint64x2_t Val2 = retrieveValue<uint64x2_t>(StackMgr.pop());
-      uint64x2_t &Val1 = retrieveValue<uint64x2_t>(StackMgr.getTop());
-      Val1 = (Val1 & C) | (Val2 & ~C);
-      return {};
-    }
+  CASE(V128__not): {
+    ValVariant &Val = StackMgr.getTop();
+    Val = ~retrieveValue<uint64x2_t>(Val);
+    DISPATCH_NEXT();
+  }
+  CASE(V128__and): {
+    const ValVariant Val2 = StackMgr.pop();
+    ValVariant &Val1 = StackMgr.getTop();
+    retrieveValue<uint64x2_t>(Val1) &= retrieveValue<uint64x2_t>(Val2);
+    DISPATCH_NEXT();
+  }
+  CASE(V128__andnot): {
+    const ValVariant Val2 = StackMgr.pop();
+    ValVariant &Val1 = StackMgr.getTop();
+    retrieveValue<uint64x2_t>(Val1) &= ~retrieveValue<uint64x2_t>(Val2);
+    DISPATCH_NEXT();
+  }
+  CASE(V128__or): {
+    const ValVariant Val2 = StackMgr.pop();
+    ValVariant &Val1 = StackMgr.getTop();
+    retrieveValue<uint64x2_t>(Val1) |= retrieveValue<uint64x2_t>(Val2);
+    DISPATCH_NEXT();
+  }
+  CASE(V128__xor): {
+    const ValVariant Val2 = StackMgr.pop();
+    ValVariant &Val1 = StackMgr.getTop();
+    retrieveValue<uint64x2_t>(Val1) ^= retrieveValue<uint64x2_t>(Val2);
+    DISPATCH_NEXT();
+  }
+  CASE(V128__bitselect): {
+    const uint64x2_t C = StackMgr.popAs<uint64x2_t>();
+    const uint64x2_t Val2 = StackMgr.popAs<uint64x2_t>();
+    uint64x2_t &Val1 = StackMgr.getTopAs<uint64x2_t>();
+    Val1 = (Val1 & C) | (Val2 & ~C);
+    DISPATCH_NEXT();
+  }
 
-    case OpCode::I8x16__abs:
-      return runVectorAbsOp<int8_t>(StackMgr.getTop());
-    case OpCode::I8x16__neg:
-      return runVectorNegOp<int8_t>(StackMgr.getTop());
-    case OpCode::I8x16__any_true:
-      return runVectorAnyTrueOp<uint8_t>(StackMgr.getTop());
-    case OpCode::I8x16__all_true:
-      return runVectorAllTrueOp<uint8_t>(StackMgr.getTop());
-    case OpCode::I8x16__bitmask:
-      return runVectorBitMaskOp<uint8_t>(StackMgr.getTop());
-    case OpCode::I8x16__narrow_i16x8_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorNarrowOp<int16_t, int8_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I8x16__narrow_i16x8_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorNarrowOp<int16_t, uint8_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I8x16__shl: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorShlOp<uint8_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I8x16__shr_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorShrOp<int8_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I8x16__shr_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorShrOp<uint8_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I8x16__add: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorAddOp<uint8_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I8x16__add_sat_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorAddSatOp<int8_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I8x16__add_sat_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorAddSatOp<uint8_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I8x16__sub: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorSubOp<uint8_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I8x16__sub_sat_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorSubSatOp<int8_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I8x16__sub_sat_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorSubSatOp<uint8_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I8x16__min_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorMinOp<int8_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I8x16__min_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorMinOp<uint8_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I8x16__max_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorMaxOp<int8_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I8x16__max_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorMaxOp<uint8_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I8x16__avgr_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorAvgrOp<uint8_t, uint16_t>(StackMgr.getTop(), Rhs);
-    }
+  CASE(I8x16__abs):
+    DISPATCH_RESULT(runVectorAbsOp<int8_t>(StackMgr.getTop()));
+  CASE(I8x16__neg):
+    DISPATCH_RESULT(runVectorNegOp<int8_t>(StackMgr.getTop()));
+  CASE(I8x16__any_true):
+    DISPATCH_RESULT(runVectorAnyTrueOp<uint8_t>(StackMgr.getTop()));
+  CASE(I8x16__all_true):
+    DISPATCH_RESULT(runVectorAllTrueOp<uint8_t>(StackMgr.getTop()));
+  CASE(I8x16__bitmask):
+    DISPATCH_RESULT(runVectorBitMaskOp<uint8_t>(StackMgr.getTop()));
+  CASE(I8x16__narrow_i16x8_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorNarrowOp<int16_t, int8_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I8x16__narrow_i16x8_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(
+        runVectorNarrowOp<int16_t, uint8_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I8x16__shl): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorShlOp<uint8_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I8x16__shr_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorShrOp<int8_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I8x16__shr_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorShrOp<uint8_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I8x16__add): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorAddOp<uint8_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I8x16__add_sat_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorAddSatOp<int8_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I8x16__add_sat_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorAddSatOp<uint8_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I8x16__sub): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorSubOp<uint8_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I8x16__sub_sat_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorSubSatOp<int8_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I8x16__sub_sat_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorSubSatOp<uint8_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I8x16__min_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorMinOp<int8_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I8x16__min_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorMinOp<uint8_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I8x16__max_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorMaxOp<int8_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I8x16__max_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorMaxOp<uint8_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I8x16__avgr_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorAvgrOp<uint8_t, uint16_t>(StackMgr.getTop(), Rhs));
+  }
 
-    case OpCode::I16x8__abs:
-      return runVectorAbsOp<int16_t>(StackMgr.getTop());
-    case OpCode::I16x8__neg:
-      return runVectorNegOp<int16_t>(StackMgr.getTop());
-    case OpCode::I16x8__any_true:
-      return runVectorAnyTrueOp<uint16_t>(StackMgr.getTop());
-    case OpCode::I16x8__all_true:
-      return runVectorAllTrueOp<uint16_t>(StackMgr.getTop());
-    case OpCode::I16x8__bitmask:
-      return runVectorBitMaskOp<uint16_t>(StackMgr.getTop());
-    case OpCode::I16x8__narrow_i32x4_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorNarrowOp<int32_t, int16_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I16x8__narrow_i32x4_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorNarrowOp<int32_t, uint16_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I16x8__widen_low_i8x16_s:
-      return runVectorWidenLowOp<int8_t, int16_t>(StackMgr.getTop());
-    case OpCode::I16x8__widen_high_i8x16_s:
-      return runVectorWidenHighOp<int8_t, int16_t>(StackMgr.getTop());
-    case OpCode::I16x8__widen_low_i8x16_u:
-      return runVectorWidenLowOp<uint8_t, uint16_t>(StackMgr.getTop());
-    case OpCode::I16x8__widen_high_i8x16_u:
-      return runVectorWidenHighOp<uint8_t, uint16_t>(StackMgr.getTop());
-    case OpCode::I16x8__shl: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorShlOp<uint16_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I16x8__shr_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorShrOp<int16_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I16x8__shr_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorShrOp<uint16_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I16x8__add: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorAddOp<uint16_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I16x8__add_sat_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorAddSatOp<int16_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I16x8__add_sat_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorAddSatOp<uint16_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I16x8__sub: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorSubOp<uint16_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I16x8__sub_sat_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorSubSatOp<int16_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I16x8__sub_sat_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorSubSatOp<uint16_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I16x8__mul: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorMulOp<uint16_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I16x8__min_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorMinOp<int16_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I16x8__min_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorMinOp<uint16_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I16x8__max_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorMaxOp<int16_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I16x8__max_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorMaxOp<uint16_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I16x8__avgr_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorAvgrOp<uint16_t, uint32_t>(StackMgr.getTop(), Rhs);
-    }
+  CASE(I16x8__abs):
+    DISPATCH_RESULT(runVectorAbsOp<int16_t>(StackMgr.getTop()));
+  CASE(I16x8__neg):
+    DISPATCH_RESULT(runVectorNegOp<int16_t>(StackMgr.getTop()));
+  CASE(I16x8__any_true):
+    DISPATCH_RESULT(runVectorAnyTrueOp<uint16_t>(StackMgr.getTop()));
+  CASE(I16x8__all_true):
+    DISPATCH_RESULT(runVectorAllTrueOp<uint16_t>(StackMgr.getTop()));
+  CASE(I16x8__bitmask):
+    DISPATCH_RESULT(runVectorBitMaskOp<uint16_t>(StackMgr.getTop()));
+  CASE(I16x8__narrow_i32x4_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(
+        runVectorNarrowOp<int32_t, int16_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I16x8__narrow_i32x4_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(
+        runVectorNarrowOp<int32_t, uint16_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I16x8__widen_low_i8x16_s):
+    DISPATCH_RESULT(runVectorWidenLowOp<int8_t, int16_t>(StackMgr.getTop()));
+  CASE(I16x8__widen_high_i8x16_s):
+    DISPATCH_RESULT(runVectorWidenHighOp<int8_t, int16_t>(StackMgr.getTop()));
+  CASE(I16x8__widen_low_i8x16_u):
+    DISPATCH_RESULT(runVectorWidenLowOp<uint8_t, uint16_t>(StackMgr.getTop()));
+  CASE(I16x8__widen_high_i8x16_u):
+    DISPATCH_RESULT(runVectorWidenHighOp<uint8_t, uint16_t>(StackMgr.getTop()));
+  CASE(I16x8__shl): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorShlOp<uint16_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I16x8__shr_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorShrOp<int16_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I16x8__shr_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorShrOp<uint16_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I16x8__add): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorAddOp<uint16_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I16x8__add_sat_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorAddSatOp<int16_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I16x8__add_sat_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorAddSatOp<uint16_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I16x8__sub): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorSubOp<uint16_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I16x8__sub_sat_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorSubSatOp<int16_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I16x8__sub_sat_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorSubSatOp<uint16_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I16x8__mul): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorMulOp<uint16_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I16x8__min_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorMinOp<int16_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I16x8__min_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorMinOp<uint16_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I16x8__max_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorMaxOp<int16_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I16x8__max_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorMaxOp<uint16_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I16x8__avgr_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(
+        runVectorAvgrOp<uint16_t, uint32_t>(StackMgr.getTop(), Rhs));
+  }
 
-    case OpCode::I32x4__abs:
-      return runVectorAbsOp<int32_t>(StackMgr.getTop());
-    case OpCode::I32x4__neg:
-      return runVectorNegOp<int32_t>(StackMgr.getTop());
-    case OpCode::I32x4__any_true:
-      return runVectorAnyTrueOp<uint32_t>(StackMgr.getTop());
-    case OpCode::I32x4__all_true:
-      return runVectorAllTrueOp<uint32_t>(StackMgr.getTop());
-    case OpCode::I32x4__bitmask:
-      return runVectorBitMaskOp<uint32_t>(StackMgr.getTop());
-    case OpCode::I32x4__widen_low_i16x8_s:
-      return runVectorWidenLowOp<int16_t, int32_t>(StackMgr.getTop());
-    case OpCode::I32x4__widen_high_i16x8_s:
-      return runVectorWidenHighOp<int16_t, int32_t>(StackMgr.getTop());
-    case OpCode::I32x4__widen_low_i16x8_u:
-      return runVectorWidenLowOp<uint16_t, uint32_t>(StackMgr.getTop());
-    case OpCode::I32x4__widen_high_i16x8_u:
-      return runVectorWidenHighOp<uint16_t, uint32_t>(StackMgr.getTop());
-    case OpCode::I32x4__shl: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorShlOp<uint32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32x4__shr_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorShrOp<int32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32x4__shr_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorShrOp<uint32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32x4__add: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorAddOp<uint32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32x4__sub: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorSubOp<uint32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32x4__mul: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorMulOp<uint32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32x4__min_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorMinOp<int32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32x4__min_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorMinOp<uint32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32x4__max_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorMaxOp<int32_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32x4__max_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorMaxOp<uint32_t>(StackMgr.getTop(), Rhs);
-    }
+  CASE(I32x4__abs):
+    DISPATCH_RESULT(runVectorAbsOp<int32_t>(StackMgr.getTop()));
+  CASE(I32x4__neg):
+    DISPATCH_RESULT(runVectorNegOp<int32_t>(StackMgr.getTop()));
+  CASE(I32x4__any_true):
+    DISPATCH_RESULT(runVectorAnyTrueOp<uint32_t>(StackMgr.getTop()));
+  CASE(I32x4__all_true):
+    DISPATCH_RESULT(runVectorAllTrueOp<uint32_t>(StackMgr.getTop()));
+  CASE(I32x4__bitmask):
+    DISPATCH_RESULT(runVectorBitMaskOp<uint32_t>(StackMgr.getTop()));
+  CASE(I32x4__widen_low_i16x8_s):
+    DISPATCH_RESULT(runVectorWidenLowOp<int16_t, int32_t>(StackMgr.getTop()));
+  CASE(I32x4__widen_high_i16x8_s):
+    DISPATCH_RESULT(runVectorWidenHighOp<int16_t, int32_t>(StackMgr.getTop()));
+  CASE(I32x4__widen_low_i16x8_u):
+    DISPATCH_RESULT(runVectorWidenLowOp<uint16_t, uint32_t>(StackMgr.getTop()));
+  CASE(I32x4__widen_high_i16x8_u):
+    DISPATCH_RESULT(
+        runVectorWidenHighOp<uint16_t, uint32_t>(StackMgr.getTop()));
+  CASE(I32x4__shl): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorShlOp<uint32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32x4__shr_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorShrOp<int32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32x4__shr_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorShrOp<uint32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32x4__add): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorAddOp<uint32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32x4__sub): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorSubOp<uint32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32x4__mul): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorMulOp<uint32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32x4__min_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorMinOp<int32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32x4__min_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorMinOp<uint32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32x4__max_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorMaxOp<int32_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32x4__max_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorMaxOp<uint32_t>(StackMgr.getTop(), Rhs));
+  }
 
-    case OpCode::I64x2__neg:
-      return runVectorNegOp<int64_t>(StackMgr.getTop());
-    case OpCode::I64x2__shl: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorShlOp<uint64_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I64x2__shr_s: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorShrOp<int64_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I64x2__shr_u: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorShrOp<uint64_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I64x2__add: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorAddOp<uint64_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I64x2__sub: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorSubOp<uint64_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I64x2__mul: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorMulOp<uint64_t>(StackMgr.getTop(), Rhs);
-    }
+  CASE(I64x2__neg):
+    DISPATCH_RESULT(runVectorNegOp<int64_t>(StackMgr.getTop()));
+  CASE(I64x2__shl): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorShlOp<uint64_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I64x2__shr_s): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorShrOp<int64_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I64x2__shr_u): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorShrOp<uint64_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I64x2__add): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorAddOp<uint64_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I64x2__sub): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorSubOp<uint64_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I64x2__mul): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorMulOp<uint64_t>(StackMgr.getTop(), Rhs));
+  }
 
-    case OpCode::F32x4__abs:
-      return runVectorAbsOp<float>(StackMgr.getTop());
-    case OpCode::F32x4__neg:
-      return runVectorNegOp<float>(StackMgr.getTop());
-    case OpCode::F32x4__sqrt:
-      return runVectorSqrtOp<float>(StackMgr.getTop());
-    case OpCode::F32x4__add: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorAddOp<float>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F32x4__sub: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorSubOp<float>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F32x4__mul: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorMulOp<float>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F32x4__div: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorDivOp<float>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F32x4__min: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorFMinOp<float>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F32x4__max: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorFMaxOp<float>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F32x4__pmin: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorMinOp<float>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F32x4__pmax: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorMaxOp<float>(StackMgr.getTop(), Rhs);
-    }
+  CASE(F32x4__abs):
+    DISPATCH_RESULT(runVectorAbsOp<float>(StackMgr.getTop()));
+  CASE(F32x4__neg):
+    DISPATCH_RESULT(runVectorNegOp<float>(StackMgr.getTop()));
+  CASE(F32x4__sqrt):
+    DISPATCH_RESULT(runVectorSqrtOp<float>(StackMgr.getTop()));
+  CASE(F32x4__add): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorAddOp<float>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F32x4__sub): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorSubOp<float>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F32x4__mul): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorMulOp<float>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F32x4__div): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorDivOp<float>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F32x4__min): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorFMinOp<float>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F32x4__max): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorFMaxOp<float>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F32x4__pmin): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorMinOp<float>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F32x4__pmax): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorMaxOp<float>(StackMgr.getTop(), Rhs));
+  }
 
-    case OpCode::F64x2__abs:
-      return runVectorAbsOp<double>(StackMgr.getTop());
-    case OpCode::F64x2__neg:
-      return runVectorNegOp<double>(StackMgr.getTop());
-    case OpCode::F64x2__sqrt:
-      return runVectorSqrtOp<double>(StackMgr.getTop());
-    case OpCode::F64x2__add: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorAddOp<double>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F64x2__sub: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorSubOp<double>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F64x2__mul: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorMulOp<double>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F64x2__div: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorDivOp<double>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F64x2__min: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorFMinOp<double>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F64x2__max: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorFMaxOp<double>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F64x2__pmin: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorMinOp<double>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::F64x2__pmax: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorMaxOp<double>(StackMgr.getTop(), Rhs);
-    }
+  CASE(F64x2__abs):
+    DISPATCH_RESULT(runVectorAbsOp<double>(StackMgr.getTop()));
+  CASE(F64x2__neg):
+    DISPATCH_RESULT(runVectorNegOp<double>(StackMgr.getTop()));
+  CASE(F64x2__sqrt):
+    DISPATCH_RESULT(runVectorSqrtOp<double>(StackMgr.getTop()));
+  CASE(F64x2__add): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorAddOp<double>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F64x2__sub): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorSubOp<double>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F64x2__mul): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorMulOp<double>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F64x2__div): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorDivOp<double>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F64x2__min): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorFMinOp<double>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F64x2__max): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorFMaxOp<double>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F64x2__pmin): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorMinOp<double>(StackMgr.getTop(), Rhs));
+  }
+  CASE(F64x2__pmax): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorMaxOp<double>(StackMgr.getTop(), Rhs));
+  }
 
-    case OpCode::I32x4__trunc_sat_f32x4_s:
-      return runVectorTruncSatOp<float, int32_t>(StackMgr.getTop());
-    case OpCode::I32x4__trunc_sat_f32x4_u:
-      return runVectorTruncSatOp<float, uint32_t>(StackMgr.getTop());
-    case OpCode::F32x4__convert_i32x4_s:
-      return runVectorConvertOp<int32_t, float>(StackMgr.getTop());
-    case OpCode::F32x4__convert_i32x4_u:
-      return runVectorConvertOp<uint32_t, float>(StackMgr.getTop());
+  CASE(I32x4__trunc_sat_f32x4_s):
+    DISPATCH_RESULT(runVectorTruncSatOp<float, int32_t>(StackMgr.getTop()));
+  CASE(I32x4__trunc_sat_f32x4_u):
+    DISPATCH_RESULT(runVectorTruncSatOp<float, uint32_t>(StackMgr.getTop()));
+  CASE(F32x4__convert_i32x4_s):
+    DISPATCH_RESULT(runVectorConvertOp<int32_t, float>(StackMgr.getTop()));
+  CASE(F32x4__convert_i32x4_u):
+    DISPATCH_RESULT(runVectorConvertOp<uint32_t, float>(StackMgr.getTop()));
 
-    case OpCode::I8x16__mul: {
-      ValVariant Rhs = StackMgr.pop();
-      return runVectorMulOp<uint8_t>(StackMgr.getTop(), Rhs);
-    }
-    case OpCode::I32x4__dot_i16x8_s: {
-      using int32x8_t [[gnu::vector_size(32)]] = int32_t;
-      const ValVariant Val2 = StackMgr.pop();
-      ValVariant &Val1 = StackMgr.getTop();
+  CASE(I8x16__mul): {
+    ValVariant Rhs = StackMgr.pop();
+    DISPATCH_RESULT(runVectorMulOp<uint8_t>(StackMgr.getTop(), Rhs));
+  }
+  CASE(I32x4__dot_i16x8_s): {
+    using int32x8_t [[gnu::vector_size(32)]] = int32_t;
+    const ValVariant Val2 = StackMgr.pop();
+    ValVariant &Val1 = StackMgr.getTop();
 
-      auto &V2 = retrieveValue<int16x8_t>(Val2);
-      auto &V1 = retrieveValue<int16x8_t>(Val1);
-      auto &Result = retrieveValue<int32x4_t>(Val1);
-      const auto M = __builtin_convertvector(V1, int32x8_t) *
-                     __builtin_convertvector(V2, int32x8_t);
-      const int32x4_t L = {M[0], M[2], M[4], M[6]};
-      const int32x4_t R = {M[1], M[3], M[5], M[7]};
-      Result = L + R;
+    auto &V2 = retrieveValue<int16x8_t>(Val2);
+    auto &V1 = retrieveValue<int16x8_t>(Val1);
+    auto &Result = retrieveValue<int32x4_t>(Val1);
+    const auto M = __builtin_convertvector(V1, int32x8_t) *
+                   __builtin_convertvector(V2, int32x8_t);
+    const int32x4_t L = {M[0], M[2], M[4], M[6]};
+    const int32x4_t R = {M[1], M[3], M[5], M[7]};
+    Result = L + R;
 
-      return {};
-    }
-    case OpCode::I64x2__any_true:
-      return runVectorAnyTrueOp<uint64_t>(StackMgr.getTop());
-    case OpCode::I64x2__all_true:
-      return runVectorAllTrueOp<uint64_t>(StackMgr.getTop());
-    case OpCode::F32x4__qfma:
-    case OpCode::F32x4__qfms:
-    case OpCode::F64x2__qfma:
-    case OpCode::F64x2__qfms:
-      /// XXX: Not in testsuite yet
-      return Unexpect(ErrCode::InvalidOpCode);
-    case OpCode::F32x4__ceil:
-      return runVectorCeilOp<float>(StackMgr.getTop());
-    case OpCode::F32x4__floor:
-      return runVectorFloorOp<float>(StackMgr.getTop());
-    case OpCode::F32x4__trunc:
-      return runVectorTruncOp<float>(StackMgr.getTop());
-    case OpCode::F32x4__nearest:
-      return runVectorNearestOp<float>(StackMgr.getTop());
-    case OpCode::F64x2__ceil:
-      return runVectorCeilOp<double>(StackMgr.getTop());
-    case OpCode::F64x2__floor:
-      return runVectorFloorOp<double>(StackMgr.getTop());
-    case OpCode::F64x2__trunc:
-      return runVectorTruncOp<double>(StackMgr.getTop());
-    case OpCode::F64x2__nearest:
-      return runVectorNearestOp<double>(StackMgr.getTop());
-    case OpCode::I64x2__trunc_sat_f64x2_s:
-      return runVectorTruncSatOp<double, int64_t>(StackMgr.getTop());
-    case OpCode::I64x2__trunc_sat_f64x2_u:
-      return runVectorTruncSatOp<double, uint64_t>(StackMgr.getTop());
-    case OpCode::F64x2__convert_i64x2_s:
-      return runVectorConvertOp<int64_t, double>(StackMgr.getTop());
-    case OpCode::F64x2__convert_i64x2_u:
-      return runVectorConvertOp<uint64_t, double>(StackMgr.getTop());
+    DISPATCH_NEXT();
+  }
+  CASE(I64x2__any_true):
+    DISPATCH_RESULT(runVectorAnyTrueOp<uint64_t>(StackMgr.getTop()));
+  CASE(I64x2__all_true):
+    DISPATCH_RESULT(runVectorAllTrueOp<uint64_t>(StackMgr.getTop()));
+  CASE(F32x4__qfma):
+  CASE(F32x4__qfms):
+  CASE(F64x2__qfma):
+  CASE(F64x2__qfms):
+    /// XXX: Not in testsuite yet
+    TRAP(ErrCode::InvalidOpCode);
+  CASE(F32x4__ceil):
+    DISPATCH_RESULT(runVectorCeilOp<float>(StackMgr.getTop()));
+  CASE(F32x4__floor):
+    DISPATCH_RESULT(runVectorFloorOp<float>(StackMgr.getTop()));
+  CASE(F32x4__trunc):
+    DISPATCH_RESULT(runVectorTruncOp<float>(StackMgr.getTop()));
+  CASE(F32x4__nearest):
+    DISPATCH_RESULT(runVectorNearestOp<float>(StackMgr.getTop()));
+  CASE(F64x2__ceil):
+    DISPATCH_RESULT(runVectorCeilOp<double>(StackMgr.getTop()));
+  CASE(F64x2__floor):
+    DISPATCH_RESULT(runVectorFloorOp<double>(StackMgr.getTop()));
+  CASE(F64x2__trunc):
+    DISPATCH_RESULT(runVectorTruncOp<double>(StackMgr.getTop()));
+  CASE(F64x2__nearest):
+    DISPATCH_RESULT(runVectorNearestOp<double>(StackMgr.getTop()));
+  CASE(I64x2__trunc_sat_f64x2_s):
+    DISPATCH_RESULT(runVectorTruncSatOp<double, int64_t>(StackMgr.getTop()));
+  CASE(I64x2__trunc_sat_f64x2_u):
+    DISPATCH_RESULT(runVectorTruncSatOp<double, uint64_t>(StackMgr.getTop()));
+  CASE(F64x2__convert_i64x2_s):
+    DISPATCH_RESULT(runVectorConvertOp<int64_t, double>(StackMgr.getTop()));
+  CASE(F64x2__convert_i64x2_u):
+    DISPATCH_RESULT(runVectorConvertOp<uint64_t, double>(StackMgr.getTop()));
 
-    default:
-      return {};
-    }
-  };
+  default:
+#if SSVM_THREADED_DISPATCH
+  Handler_Default:
+#endif
+    DISPATCH_NEXT();
+  }
 
-  while (PC != PCEnd) {
-    OpCode Code = PC->getOpCode();
-    if (Stat) {
-      Stat->incInstrCount();
-      /// Add cost. Note: if-else case should be processed additionally.
-      if (unlikely(!Stat->addInstrCost(Code))) {
-        return Unexpect(ErrCode::CostLimitExceeded);
-      }
-    }
-    if (auto Res = Dispatch(); !Res) {
-      return Unexpect(Res);
-    }
-    PC++;
+#if SSVM_THREADED_DISPATCH
+/// Superinstructions. The first instruction is counted in DISPATCH(), and the
+/// covered ones are counted before running the fused body. The covered ones
+/// are never block entries, so their costs are charged with the block.
+#define CHARGE_COVERED(N)                                                      \
+  do {                                                                         \
+    if constexpr (Count) {                                                     \
+      for (uint32_t I = 1; I < (N); ++I) {                                     \
+        Stat->incInstrCount();                                                 \
+        if (Stat->isProfiling()) {                                             \
+          Stat->incOpCount(PC[I].getOpCode());                                 \
+        }                                                                      \
+      }                                                                        \
+    }                                                                          \
+  } while (0)
+Fused_LocalGet_I32Const_I32Add_LocalSet: {
+  CHARGE_COVERED(4);
+  ValVariant Val =
+      StackMgr.getBottomN(StackMgr.getOffset(PC->getTargetIndex()));
+  retrieveValue<uint32_t>(Val) += retrieveValue<uint32_t>(PC[1].getNum());
+  StackMgr.getBottomN(StackMgr.getOffset(PC[3].getTargetIndex())) = Val;
+  PC += 3;
+  DISPATCH_NEXT();
+}
+Fused_LocalGet_LocalGet_I32Add: {
+  CHARGE_COVERED(3);
+  StackMgr.push(StackMgr.getBottomN(StackMgr.getOffset(PC->getTargetIndex())));
+  retrieveValue<uint32_t>(StackMgr.getTop()) += retrieveValue<uint32_t>(
+      StackMgr.getBottomN(StackMgr.getOffset(PC[1].getTargetIndex())));
+  PC += 2;
+  DISPATCH_NEXT();
+}
+Fused_LocalGet_I32Load: {
+  CHARGE_COVERED(2);
+  StackMgr.push(StackMgr.getBottomN(StackMgr.getOffset(PC->getTargetIndex())));
+  ++PC;
+  DISPATCH_RESULT(runLoadOp<uint32_t, GuardedMemory>(*InstCtx.MemInst, *PC));
+}
+Fused_I32Const_I32And: {
+  CHARGE_COVERED(2);
+  retrieveValue<uint32_t>(StackMgr.getTop()) &=
+      retrieveValue<uint32_t>(PC->getNum());
+  ++PC;
+  DISPATCH_NEXT();
+}
+Fused_I32Eqz_BrIf: {
+  CHARGE_COVERED(2);
+  ++PC;
+  if (StackMgr.popAs<uint32_t>() == 0) {
+    DISPATCH_RESULT(runBrOp(StoreMgr, *PC, PC));
   }
+  DISPATCH_NEXT();
+}
+#undef CHARGE_COVERED
+#endif
+
+#undef TRAP
+#undef DISPATCH_RESULT
+#undef DISPATCH_NEXT
+#undef DISPATCH
+#undef DISPATCH_JUMP
+#undef CASE
+#undef SSVM_THREADED_DISPATCH
+
+Trap:
+  return Unexpect(Err);
+Done:
   return {};
 }
 
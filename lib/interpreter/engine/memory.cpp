@@ -16,7 +16,7 @@ Interpreter::runMemorySizeOp(Runtime::Instance::MemoryInstance &MemInst) {
 Expect<void>
 Interpreter::runMemoryGrowOp(Runtime::Instance::MemoryInstance &MemInst) {
   /// Pop N for growing page size.
-  uint32_t &N = retrieveValue<uint32_t>(StackMgr.getTop());
+  uint32_t &N = StackMgr.getTopAs<uint32_t>();
 
   /// Grow page and push result.
   const uint32_t CurrPageSize = MemInst.getDataPageSize();
@@ -25,6 +25,14 @@ Interpreter::runMemoryGrowOp(Runtime::Instance::MemoryInstance &MemInst) {
   } else {
     N = -1;
   }
+
+  /// Reload the memory of the instance context, which may be moved.
+  if (&MemInst == InstCtx.MemInst) {
+    InstCtx.MemData = MemInst.getDataPtr();
+    InstCtx.MemSize =
+        static_cast<uint64_t>(MemInst.getDataPageSize()) *
+        Runtime::Instance::MemoryInstance::kPageSize;
+  }
   return {};
 }
 
@@ -33,9 +41,9 @@ Interpreter::runMemoryInitOp(Runtime::Instance::MemoryInstance &MemInst,
                              Runtime::Instance::DataInstance &DataInst,
                              const AST::Instruction &Instr) {
   /// Pop the length, source, and destination from stack.
-  uint32_t Len = retrieveValue<uint32_t>(StackMgr.pop());
-  uint32_t Src = retrieveValue<uint32_t>(StackMgr.pop());
-  uint32_t Dst = retrieveValue<uint32_t>(StackMgr.pop());
+  uint32_t Len = StackMgr.popAs<uint32_t>();
+  uint32_t Src = StackMgr.popAs<uint32_t>();
+  uint32_t Dst = StackMgr.popAs<uint32_t>();
 
   /// Replace mem[Dst : Dst + Len] with data[Src : Src + Len].
   if (auto Res = MemInst.setBytes(DataInst.getData(), Dst, Src, Len)) {
@@ -58,9 +66,9 @@ Expect<void>
 Interpreter::runMemoryCopyOp(Runtime::Instance::MemoryInstance &MemInst,
                              const AST::Instruction &Instr) {
   /// Pop the length, source, and destination from stack.
-  uint32_t Len = retrieveValue<uint32_t>(StackMgr.pop());
-  uint32_t Src = retrieveValue<uint32_t>(StackMgr.pop());
-  uint32_t Dst = retrieveValue<uint32_t>(StackMgr.pop());
+  uint32_t Len = StackMgr.popAs<uint32_t>();
+  uint32_t Src = StackMgr.popAs<uint32_t>();
+  uint32_t Dst = StackMgr.popAs<uint32_t>();
 
   /// Replace mem[Dst : Dst + Len] with mem[Src : Src + Len].
   if (auto Data = MemInst.getBytes(Src, Len)) {
@@ -82,9 +90,9 @@ Expect<void>
 Interpreter::runMemoryFillOp(Runtime::Instance::MemoryInstance &MemInst,
                              const AST::Instruction &Instr) {
   /// Pop the length, value, and offset from stack.
-  uint32_t Len = retrieveValue<uint32_t>(StackMgr.pop());
-  uint8_t Val = static_cast<uint8_t>(retrieveValue<uint32_t>(StackMgr.pop()));
-  uint32_t Off = retrieveValue<uint32_t>(StackMgr.pop());
+  uint32_t Len = StackMgr.popAs<uint32_t>();
+  uint8_t Val = static_cast<uint8_t>(StackMgr.popAs<uint32_t>());
+  uint32_t Off = StackMgr.popAs<uint32_t>();
 
   /// Fill data with Val.
   if (auto Res = MemInst.fillBytes(Val, Off, Len)) {
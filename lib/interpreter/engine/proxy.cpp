@@ -14,8 +14,10 @@ struct Interpreter::ProxyHelper<Expect<RetT> (Interpreter::*)(
                                               ArgsT...) noexcept>
   static RetT proxy(ArgsT... Args) noexcept {
     Interpreter::SignalDisabler Disabler;
-    if (auto Res = (This->*Func)(*This->CurrentStore, Args...);
-        unlikely(!Res)) {
+    auto Res = (This->*Func)(*This->CurrentStore, Args...);
+    /// The memory may be moved by growing.
+    This->updateExecutionMemory();
+    if (unlikely(!Res)) {
       siglongjmp(*TrapJump, uint8_t(Res.error()));
     } else if constexpr (!std::is_void_v<RetT>) {
       return *Res;
@@ -39,6 +41,7 @@ AST::Module::IntrinsicsTable intrinsics = {
     ENTRY(kTrap, trap),
     ENTRY(kCall, call),
     ENTRY(kCallIndirect, callIndirect),
+    ENTRY(kCallIndirectCode, callIndirectCode),
     ENTRY(kMemCopy, memCopy),
     ENTRY(kMemFill, memFill),
     ENTRY(kMemGrow, memGrow),
@@ -55,6 +58,10 @@ AST::Module::IntrinsicsTable intrinsics = {
     ENTRY(kElemDrop, elemDrop),
     ENTRY(kRefFunc, refFunc),
 #undef ENTRY
+    [uint8_t(AST::Module::Intrinsics::kProfileEnter)] =
+        reinterpret_cast<void *>(&Interpreter::profileEnter),
+    [uint8_t(AST::Module::Intrinsics::kProfileLeave)] =
+        reinterpret_cast<void *>(&Interpreter::profileLeave),
 };
 }
 
@@ -79,6 +86,32 @@ void Interpreter::signalHandler(int Signal, siginfo_t *Siginfo,
   siglongjmp(*This->TrapJump, Status);
 }
 
+void Interpreter::guardSignalHandler(int Signal, siginfo_t *Siginfo,
+                                     void *) noexcept {
+  assert(Signal == SIGSEGV);
+  const auto *Base = This->InstCtx.MemData;
+  const auto *Addr = reinterpret_cast<const uint8_t *>(Siginfo->si_addr);
+  if (likely(Base != nullptr && Addr >= Base &&
+             static_cast<uint64_t>(Addr - Base) <
+                 Runtime::Instance::MemoryInstance::kGuardWindow)) {
+    siglongjmp(*This->TrapJump, uint8_t(ErrCode::MemoryOutOfBounds));
+  }
+  /// Not a fault in the guard region. Fault again with the default action.
+  std::signal(SIGSEGV, SIG_DFL);
+}
+
+void Interpreter::profileEnter(const uint32_t FuncIndex) noexcept {
+  auto *Stat = This->Stat;
+  if (Stat && Stat->isProfiling()) {
+    /// Compiled functions run in the frame of the module entered.
+    const auto *ModInst =
+        *This->CurrentStore->getModule(This->StackMgr.getModuleAddr());
+    Stat->enterFunction(*ModInst->getFuncAddr(FuncIndex));
+  }
+}
+
+void Interpreter::profileLeave() noexcept { This->leaveFunctionProfile(); }
+
 void Interpreter::signalEnable() noexcept {
   struct sigaction Action {};
   Action.sa_sigaction = &signalHandler;
@@ -113,7 +146,8 @@ Expect<void> Interpreter::call(Runtime::StoreManager &StoreMgr,
 
   auto Instrs = FuncInst->getInstrs();
   AST::InstrView::iterator StartIt;
-  if (auto Res = enterFunction(StoreMgr, *FuncInst, Instrs.end() - 1)) {
+  if (auto Res =
+          enterFunction(StoreMgr, FuncAddr, *FuncInst, Instrs.end() - 1)) {
     StartIt = *Res;
   } else {
     return Unexpect(Res);
@@ -135,25 +169,15 @@ Expect<void> Interpreter::callIndirect(Runtime::StoreManager &StoreMgr,
                                        const uint32_t FuncIndex,
                                        const ValVariant *Args,
                                        ValVariant *Rets) noexcept {
-  const auto *TabInst = getTabInstByIdx(StoreMgr, TableIndex);
-
-  if (unlikely(FuncIndex >= TabInst->getSize())) {
-    return Unexpect(ErrCode::UndefinedElement);
-  }
-
-  ValVariant Ref = *TabInst->getRefAddr(FuncIndex);
-  if (unlikely(isNullRef(Ref))) {
-    return Unexpect(ErrCode::UninitializedElement);
+  uint32_t FuncAddr;
+  if (auto Res = getIndirectFuncAddr(StoreMgr, TableIndex, FuncTypeIndex,
+                                     FuncIndex)) {
+    FuncAddr = *Res;
+  } else {
+    return Unexpect(Res);
   }
-  const auto FuncAddr = retrieveFuncIdx(Ref);
-
-  const auto *ModInst = *StoreMgr.getModule(StackMgr.getModuleAddr());
-  const auto *TargetFuncType = *ModInst->getFuncType(FuncTypeIndex);
   const auto *FuncInst = *StoreMgr.getFunction(FuncAddr);
   const auto &FuncType = FuncInst->getFuncType();
-  if (unlikely(*TargetFuncType != FuncType)) {
-    return Unexpect(ErrCode::IndirectCallTypeMismatch);
-  }
 
   const unsigned ParamsSize = FuncType.Params.size();
   const unsigned ReturnsSize = FuncType.Returns.size();
@@ -164,7 +188,8 @@ Expect<void> Interpreter::callIndirect(Runtime::StoreManager &StoreMgr,
 
   auto Instrs = FuncInst->getInstrs();
   AST::InstrView::iterator StartIt;
-  if (auto Res = enterFunction(StoreMgr, *FuncInst, Instrs.end() - 1)) {
+  if (auto Res =
+          enterFunction(StoreMgr, FuncAddr, *FuncInst, Instrs.end() - 1)) {
     StartIt = *Res;
   } else {
     return Unexpect(Res);
@@ -180,6 +205,34 @@ Expect<void> Interpreter::callIndirect(Runtime::StoreManager &StoreMgr,
   return {};
 }
 
+Expect<void *>
+Interpreter::callIndirectCode(Runtime::StoreManager &StoreMgr,
+                              const uint32_t TableIndex,
+                              const uint32_t FuncTypeIndex,
+                              const uint32_t FuncIndex) noexcept {
+  uint32_t FuncAddr;
+  if (auto Res = getIndirectFuncAddr(StoreMgr, TableIndex, FuncTypeIndex,
+                                     FuncIndex)) {
+    FuncAddr = *Res;
+  } else {
+    return Unexpect(Res);
+  }
+
+  /// Only the compiled functions of the same module run on the execution
+  /// context of the caller. The others are called by callIndirect.
+  const auto *FuncInst = *StoreMgr.getFunction(FuncAddr);
+  if (FuncInst->getModuleAddr() != StackMgr.getModuleAddr()) {
+    return nullptr;
+  }
+  if (FuncInst->isCompiledFunction()) {
+    return FuncInst->getSymbol().get();
+  }
+  if (FuncInst->isTiered()) {
+    return FuncInst->getTieredCode().get();
+  }
+  return nullptr;
+}
+
 Expect<uint32_t> Interpreter::memGrow(Runtime::StoreManager &StoreMgr,
                                       const uint32_t NewSize) noexcept {
   auto &MemInst = *getMemInstByIdx(StoreMgr, 0);
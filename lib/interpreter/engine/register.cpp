@@ -0,0 +1,685 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "common/log.h"
+#include "common/value.h"
+#include "interpreter/interpreter.h"
+#include "interpreter/regir.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+
+namespace SSVM {
+namespace Interpreter {
+
+namespace {
+
+/// Load value from memory at the address in register.
+template <typename T>
+Expect<void> loadRegister(Runtime::Instance::MemoryInstance &MemInst,
+                          const AST::Instruction &Instr, ValVariant &Val,
+                          const uint32_t Offset,
+                          const uint32_t BitWidth = sizeof(T) * 8) {
+  /// Calculate EA
+  const uint32_t Addr = retrieveValue<uint32_t>(Val);
+  if (Addr > std::numeric_limits<uint32_t>::max() - Offset) {
+    LOG(ERROR) << ErrCode::MemoryOutOfBounds;
+    LOG(ERROR) << ErrInfo::InfoBoundary(Addr + static_cast<uint64_t>(Offset),
+                                        BitWidth / 8, MemInst.getBoundIdx());
+    LOG(ERROR) << ErrInfo::InfoInstruction(Instr.getOpCode(),
+                                           Instr.getOffset());
+    return Unexpect(ErrCode::MemoryOutOfBounds);
+  }
+
+  /// Value = Mem.Data[EA : N / 8]
+  if (auto Res = MemInst.loadValue(retrieveValue<T>(Val), Addr + Offset,
+                                   BitWidth / 8);
+      !Res) {
+    LOG(ERROR) << ErrInfo::InfoInstruction(Instr.getOpCode(),
+                                           Instr.getOffset());
+    return Unexpect(Res);
+  }
+  return {};
+}
+
+/// Store value in register to memory at the address in register.
+template <typename T>
+Expect<void> storeRegister(Runtime::Instance::MemoryInstance &MemInst,
+                           const AST::Instruction &Instr,
+                           const ValVariant &AddrVal, const ValVariant &Val,
+                           const uint32_t Offset,
+                           const uint32_t BitWidth = sizeof(T) * 8) {
+  /// Calculate EA = i + offset
+  const uint32_t Addr = retrieveValue<uint32_t>(AddrVal);
+  if (Addr > std::numeric_limits<uint32_t>::max() - Offset) {
+    LOG(ERROR) << ErrCode::MemoryOutOfBounds;
+    LOG(ERROR) << ErrInfo::InfoBoundary(Addr + static_cast<uint64_t>(Offset),
+                                        BitWidth / 8, MemInst.getBoundIdx());
+    LOG(ERROR) << ErrInfo::InfoInstruction(Instr.getOpCode(),
+                                           Instr.getOffset());
+    return Unexpect(ErrCode::MemoryOutOfBounds);
+  }
+
+  /// Store value to bytes.
+  if (auto Res = MemInst.storeValue(retrieveValue<T>(Val), Addr + Offset,
+                                    BitWidth / 8);
+      !Res) {
+    LOG(ERROR) << ErrInfo::InfoInstruction(Instr.getOpCode(),
+                                           Instr.getOffset());
+    return Unexpect(Res);
+  }
+  return {};
+}
+
+} // namespace
+
+Expect<void>
+Interpreter::runRegFunction(Runtime::StoreManager &StoreMgr,
+                            const uint32_t FuncAddr,
+                            const Runtime::Instance::FunctionInstance &Func,
+                            const RegFunction &RegFunc) {
+  const size_t CallDepth = RegCallStack.size();
+  const RegFunction *RF = nullptr;
+  const RegInstr *PC = nullptr;
+  ValVariant *Regs = nullptr;
+  Runtime::Instance::MemoryInstance *MemInst = nullptr;
+  const Runtime::Instance::FunctionInstance *Callee = nullptr;
+  uint32_t CalleeAddr = 0;
+  ErrCode Err = ErrCode::Success;
+
+  /// Push frame with the arguments on top of stack and reserve registers.
+  auto EnterFrame = [&](const Runtime::Instance::FunctionInstance &F,
+                        const uint32_t Addr, const RegFunction &NewRF) {
+    /// Frames of the same module share the memory instance.
+    const bool SameModule =
+        RF != nullptr && F.getModuleAddr() == StackMgr.getModuleAddr();
+    RF = &NewRF;
+    StackMgr.pushFrame(F.getModuleAddr(), RF->ParamNum, RF->ReturnNum, {},
+                       Addr);
+    const uint32_t Base = StackMgr.getOffset(0);
+    StackMgr.resize(Base + RF->RegNum);
+    Regs = &StackMgr.getBottomN(Base);
+    std::copy(RF->Init.begin(), RF->Init.end(), Regs + RF->ParamNum);
+    if (!SameModule) {
+      MemInst = getMemInstByIdx(StoreMgr, 0);
+    }
+    PC = RF->Instrs.data();
+  };
+  /// Restore registers of current frame after the value stack changed.
+  auto ReloadFrame = [&]() {
+    const uint32_t Base = StackMgr.getOffset(0);
+    StackMgr.resize(Base + RF->RegNum);
+    Regs = &StackMgr.getBottomN(Base);
+  };
+
+#define REG_NEXT()                                                             \
+  {                                                                            \
+    ++PC;                                                                      \
+    continue;                                                                  \
+  }
+#define REG_JUMP(TARGET)                                                       \
+  {                                                                            \
+    PC = RF->Instrs.data() + (TARGET);                                         \
+    continue;                                                                  \
+  }
+#define REG_CHECK(...)                                                         \
+  if (auto Res = (__VA_ARGS__); unlikely(!Res)) {                              \
+    Err = Res.error();                                                         \
+    goto Trap;                                                                 \
+  }
+#define REG_UNARY(...)                                                         \
+  {                                                                            \
+    ValVariant Val = Regs[PC->A];                                              \
+    REG_CHECK(__VA_ARGS__(Val));                                               \
+    Regs[PC->Dst] = Val;                                                       \
+    REG_NEXT();                                                                \
+  }
+#define REG_UNARY_INSTR(...)                                                   \
+  {                                                                            \
+    ValVariant Val = Regs[PC->A];                                              \
+    REG_CHECK(__VA_ARGS__(RF->Source[PC->SrcIdx], Val));                       \
+    Regs[PC->Dst] = Val;                                                       \
+    REG_NEXT();                                                                \
+  }
+#define REG_BINARY(...)                                                        \
+  {                                                                            \
+    ValVariant Val = Regs[PC->A];                                              \
+    REG_CHECK(__VA_ARGS__(Val, Regs[PC->B]));                                  \
+    Regs[PC->Dst] = Val;                                                       \
+    REG_NEXT();                                                                \
+  }
+#define REG_BINARY_INSTR(...)                                                  \
+  {                                                                            \
+    ValVariant Val = Regs[PC->A];                                              \
+    REG_CHECK(__VA_ARGS__(RF->Source[PC->SrcIdx], Val, Regs[PC->B]));          \
+    Regs[PC->Dst] = Val;                                                       \
+    REG_NEXT();                                                                \
+  }
+#define REG_LOAD(T, ...)                                                       \
+  {                                                                            \
+    ValVariant Val = Regs[PC->A];                                              \
+    REG_CHECK(loadRegister<T>(*MemInst, RF->Source[PC->SrcIdx], Val,           \
+                              PC->Imm __VA_ARGS__));                           \
+    Regs[PC->Dst] = Val;                                                       \
+    REG_NEXT();                                                                \
+  }
+#define REG_STORE(T, ...)                                                      \
+  {                                                                            \
+    REG_CHECK(storeRegister<T>(*MemInst, RF->Source[PC->SrcIdx],               \
+                               Regs[PC->A], Regs[PC->B],                       \
+                               PC->Imm __VA_ARGS__));                          \
+    REG_NEXT();                                                                \
+  }
+#define CASE(NAME) case OpCode::NAME
+
+  const bool Charging = CountInstr || MeasureCost;
+  EnterFrame(Func, FuncAddr, RegFunc);
+  for (;;) {
+    if (Charging && PC->ChargeCnt) {
+      /// Charge the Wasm instructions translated into this one.
+      for (uint32_t I = 0; I < PC->ChargeCnt; ++I) {
+        const OpCode Code = RF->Charges[PC->ChargeBegin + I];
+        if (CountInstr) {
+          Stat->incInstrCount();
+          if (Stat->isProfiling()) {
+            Stat->incOpCount(Code);
+          }
+        }
+        if (MeasureCost && unlikely(!Stat->addInstrCost(Code))) {
+          Err = ErrCode::CostLimitExceeded;
+          goto Trap;
+        }
+      }
+    }
+
+    switch (PC->Code) {
+    /// Control instructions.
+    CASE(Unreachable) : {
+      const auto &Instr = RF->Source[PC->SrcIdx];
+      LOG(ERROR) << ErrCode::Unreachable;
+      LOG(ERROR) << ErrInfo::InfoInstruction(Instr.getOpCode(),
+                                             Instr.getOffset());
+      Err = ErrCode::Unreachable;
+      goto Trap;
+    }
+    CASE(Nop) : REG_NEXT();
+    CASE(Br) : REG_JUMP(PC->Imm);
+    CASE(Br_if) : {
+      if (retrieveValue<uint32_t>(Regs[PC->A]) != 0) {
+        REG_JUMP(PC->Imm);
+      }
+      REG_NEXT();
+    }
+    CASE(If) : {
+      if (retrieveValue<uint32_t>(Regs[PC->A]) == 0) {
+        REG_JUMP(PC->Imm);
+      }
+      REG_NEXT();
+    }
+    CASE(Br_table) : {
+      const uint32_t Idx =
+          std::min(retrieveValue<uint32_t>(Regs[PC->A]), PC->B);
+      REG_JUMP(RF->JumpTable[PC->Imm + Idx]);
+    }
+    CASE(Return) : {
+      /// Move results to the frame base and leave the frame.
+      std::copy(Regs + PC->A, Regs + PC->A + PC->B, Regs);
+      StackMgr.resize(StackMgr.getOffset(0) + PC->B);
+      leaveFunctionProfile();
+      StackMgr.popFrame();
+      if (RegCallStack.size() == CallDepth) {
+        return {};
+      }
+      RF = RegCallStack.back().Func;
+      PC = RegCallStack.back().PC;
+      MemInst = RegCallStack.back().MemInst;
+      RegCallStack.pop_back();
+      ReloadFrame();
+      REG_NEXT();
+    }
+    CASE(Call) : {
+      CalleeAddr = PC->Imm;
+      Callee = *StoreMgr.getFunction(CalleeAddr);
+      break;
+    }
+    CASE(Call_indirect) : {
+      const auto &Instr = RF->Source[PC->SrcIdx];
+      const auto *TabInst = getTabInstByIdx(StoreMgr, PC->C);
+      const auto *ModInst = *StoreMgr.getModule(StackMgr.getModuleAddr());
+      const auto *TargetFuncType = *ModInst->getFuncType(PC->Imm);
+      const uint32_t Idx = retrieveValue<uint32_t>(Regs[PC->A]);
+
+      /// If idx not small than tab.elem, trap.
+      if (Idx >= TabInst->getSize()) {
+        LOG(ERROR) << ErrCode::UndefinedElement;
+        LOG(ERROR) << ErrInfo::InfoInstruction(Instr.getOpCode(),
+                                               Instr.getOffset(), {Idx},
+                                               {ValTypeFromType<uint32_t>()});
+        Err = ErrCode::UndefinedElement;
+        goto Trap;
+      }
+
+      /// Get function address.
+      ValVariant Ref = *TabInst->getRefAddr(Idx);
+      if (isNullRef(Ref)) {
+        LOG(ERROR) << ErrInfo::InfoInstruction(Instr.getOpCode(),
+                                               Instr.getOffset(), {Idx},
+                                               {ValTypeFromType<uint32_t>()});
+        LOG(ERROR) << ErrCode::UninitializedElement;
+        Err = ErrCode::UninitializedElement;
+        goto Trap;
+      }
+
+      /// Check function type.
+      CalleeAddr = retrieveFuncIdx(Ref);
+      Callee = *StoreMgr.getFunction(CalleeAddr);
+      const auto &FuncType = Callee->getFuncType();
+      if (TargetFuncType->TypeID != Callee->getTypeID()) {
+        LOG(ERROR) << ErrCode::IndirectCallTypeMismatch;
+        LOG(ERROR) << ErrInfo::InfoInstruction(Instr.getOpCode(),
+                                               Instr.getOffset(), {Idx},
+                                               {ValTypeFromType<uint32_t>()});
+        LOG(ERROR) << ErrInfo::InfoMismatch(
+            TargetFuncType->Params, TargetFuncType->Returns, FuncType.Params,
+            FuncType.Returns);
+        Err = ErrCode::IndirectCallTypeMismatch;
+        goto Trap;
+      }
+      break;
+    }
+
+    /// Parametric Instructions
+    CASE(Select) : {
+      const ValVariant Val = retrieveValue<uint32_t>(Regs[PC->C]) != 0
+                                 ? Regs[PC->A]
+                                 : Regs[PC->B];
+      Regs[PC->Dst] = Val;
+      REG_NEXT();
+    }
+
+    /// Variable Instructions
+    CASE(Local__set) : {
+      Regs[PC->Dst] = Regs[PC->A];
+      REG_NEXT();
+    }
+    CASE(Global__get) : {
+      Regs[PC->Dst] = (*StoreMgr.getGlobal(PC->Imm))->getValue();
+      REG_NEXT();
+    }
+    CASE(Global__set) : {
+      (*StoreMgr.getGlobal(PC->Imm))->getValue() = Regs[PC->A];
+      REG_NEXT();
+    }
+
+    /// Memory Instructions
+    CASE(I32__load) : REG_LOAD(uint32_t);
+    CASE(I64__load) : REG_LOAD(uint64_t);
+    CASE(F32__load) : REG_LOAD(float);
+    CASE(F64__load) : REG_LOAD(double);
+    CASE(I32__load8_s) : REG_LOAD(int32_t, , 8);
+    CASE(I32__load8_u) : REG_LOAD(uint32_t, , 8);
+    CASE(I32__load16_s) : REG_LOAD(int32_t, , 16);
+    CASE(I32__load16_u) : REG_LOAD(uint32_t, , 16);
+    CASE(I64__load8_s) : REG_LOAD(int64_t, , 8);
+    CASE(I64__load8_u) : REG_LOAD(uint64_t, , 8);
+    CASE(I64__load16_s) : REG_LOAD(int64_t, , 16);
+    CASE(I64__load16_u) : REG_LOAD(uint64_t, , 16);
+    CASE(I64__load32_s) : REG_LOAD(int64_t, , 32);
+    CASE(I64__load32_u) : REG_LOAD(uint64_t, , 32);
+    CASE(I32__store) : REG_STORE(uint32_t);
+    CASE(I64__store) : REG_STORE(uint64_t);
+    CASE(F32__store) : REG_STORE(float);
+    CASE(F64__store) : REG_STORE(double);
+    CASE(I32__store8) : REG_STORE(uint32_t, , 8);
+    CASE(I32__store16) : REG_STORE(uint32_t, , 16);
+    CASE(I64__store8) : REG_STORE(uint64_t, , 8);
+    CASE(I64__store16) : REG_STORE(uint64_t, , 16);
+    CASE(I64__store32) : REG_STORE(uint64_t, , 32);
+    CASE(Memory__size) : {
+      Regs[PC->Dst] = MemInst->getDataPageSize();
+      REG_NEXT();
+    }
+    CASE(Memory__grow) : {
+      /// Grow page and write result.
+      const uint32_t N = retrieveValue<uint32_t>(Regs[PC->A]);
+      const uint32_t CurrPageSize = MemInst->getDataPageSize();
+      Regs[PC->Dst] = MemInst->growPage(N) ? CurrPageSize : uint32_t(-1);
+      REG_NEXT();
+    }
+
+    /// Numeric Instructions
+  CASE(I32__eqz):
+    REG_UNARY(runEqzOp<uint32_t>);
+  CASE(I64__eqz):
+    REG_UNARY(runEqzOp<uint64_t>);
+  CASE(I32__clz):
+    REG_UNARY(runClzOp<uint32_t>);
+  CASE(I32__ctz):
+    REG_UNARY(runCtzOp<uint32_t>);
+  CASE(I32__popcnt):
+    REG_UNARY(runPopcntOp<uint32_t>);
+  CASE(I64__clz):
+    REG_UNARY(runClzOp<uint64_t>);
+  CASE(I64__ctz):
+    REG_UNARY(runCtzOp<uint64_t>);
+  CASE(I64__popcnt):
+    REG_UNARY(runPopcntOp<uint64_t>);
+  CASE(F32__abs):
+    REG_UNARY(runAbsOp<float>);
+  CASE(F32__neg):
+    REG_UNARY(runNegOp<float>);
+  CASE(F32__ceil):
+    REG_UNARY(runCeilOp<float>);
+  CASE(F32__floor):
+    REG_UNARY(runFloorOp<float>);
+  CASE(F32__trunc):
+    REG_UNARY(runTruncOp<float>);
+  CASE(F32__nearest):
+    REG_UNARY(runNearestOp<float>);
+  CASE(F32__sqrt):
+    REG_UNARY(runSqrtOp<float>);
+  CASE(F64__abs):
+    REG_UNARY(runAbsOp<double>);
+  CASE(F64__neg):
+    REG_UNARY(runNegOp<double>);
+  CASE(F64__ceil):
+    REG_UNARY(runCeilOp<double>);
+  CASE(F64__floor):
+    REG_UNARY(runFloorOp<double>);
+  CASE(F64__trunc):
+    REG_UNARY(runTruncOp<double>);
+  CASE(F64__nearest):
+    REG_UNARY(runNearestOp<double>);
+  CASE(F64__sqrt):
+    REG_UNARY(runSqrtOp<double>);
+  CASE(I32__wrap_i64):
+    REG_UNARY(runWrapOp<uint64_t, uint32_t>);
+  CASE(I32__trunc_f32_s):
+    REG_UNARY_INSTR(runTruncateOp<float, int32_t>);
+  CASE(I32__trunc_f32_u):
+    REG_UNARY_INSTR(runTruncateOp<float, uint32_t>);
+  CASE(I32__trunc_f64_s):
+    REG_UNARY_INSTR(runTruncateOp<double, int32_t>);
+  CASE(I32__trunc_f64_u):
+    REG_UNARY_INSTR(runTruncateOp<double, uint32_t>);
+  CASE(I64__extend_i32_s):
+    REG_UNARY(runExtendOp<int32_t, uint64_t>);
+  CASE(I64__extend_i32_u):
+    REG_UNARY(runExtendOp<uint32_t, uint64_t>);
+  CASE(I64__trunc_f32_s):
+    REG_UNARY_INSTR(runTruncateOp<float, int64_t>);
+  CASE(I64__trunc_f32_u):
+    REG_UNARY_INSTR(runTruncateOp<float, uint64_t>);
+  CASE(I64__trunc_f64_s):
+    REG_UNARY_INSTR(runTruncateOp<double, int64_t>);
+  CASE(I64__trunc_f64_u):
+    REG_UNARY_INSTR(runTruncateOp<double, uint64_t>);
+  CASE(F32__convert_i32_s):
+    REG_UNARY(runConvertOp<int32_t, float>);
+  CASE(F32__convert_i32_u):
+    REG_UNARY(runConvertOp<uint32_t, float>);
+  CASE(F32__convert_i64_s):
+    REG_UNARY(runConvertOp<int64_t, float>);
+  CASE(F32__convert_i64_u):
+    REG_UNARY(runConvertOp<uint64_t, float>);
+  CASE(F32__demote_f64):
+    REG_UNARY(runDemoteOp<double, float>);
+  CASE(F64__convert_i32_s):
+    REG_UNARY(runConvertOp<int32_t, double>);
+  CASE(F64__convert_i32_u):
+    REG_UNARY(runConvertOp<uint32_t, double>);
+  CASE(F64__convert_i64_s):
+    REG_UNARY(runConvertOp<int64_t, double>);
+  CASE(F64__convert_i64_u):
+    REG_UNARY(runConvertOp<uint64_t, double>);
+  CASE(F64__promote_f32):
+    REG_UNARY(runPromoteOp<float, double>);
+  CASE(I32__reinterpret_f32):
+    REG_UNARY(runReinterpretOp<float, uint32_t>);
+  CASE(I64__reinterpret_f64):
+    REG_UNARY(runReinterpretOp<double, uint64_t>);
+  CASE(F32__reinterpret_i32):
+    REG_UNARY(runReinterpretOp<uint32_t, float>);
+  CASE(F64__reinterpret_i64):
+    REG_UNARY(runReinterpretOp<uint64_t, double>);
+  CASE(I32__extend8_s):
+    REG_UNARY(runExtendOp<int32_t, uint32_t, 8>);
+  CASE(I32__extend16_s):
+    REG_UNARY(runExtendOp<int32_t, uint32_t, 16>);
+  CASE(I64__extend8_s):
+    REG_UNARY(runExtendOp<int64_t, uint64_t, 8>);
+  CASE(I64__extend16_s):
+    REG_UNARY(runExtendOp<int64_t, uint64_t, 16>);
+  CASE(I64__extend32_s):
+    REG_UNARY(runExtendOp<int64_t, uint64_t, 32>);
+  CASE(I32__trunc_sat_f32_s):
+    REG_UNARY(runTruncateSatOp<float, int32_t>);
+  CASE(I32__trunc_sat_f32_u):
+    REG_UNARY(runTruncateSatOp<float, uint32_t>);
+  CASE(I32__trunc_sat_f64_s):
+    REG_UNARY(runTruncateSatOp<double, int32_t>);
+  CASE(I32__trunc_sat_f64_u):
+    REG_UNARY(runTruncateSatOp<double, uint32_t>);
+  CASE(I64__trunc_sat_f32_s):
+    REG_UNARY(runTruncateSatOp<float, int64_t>);
+  CASE(I64__trunc_sat_f32_u):
+    REG_UNARY(runTruncateSatOp<float, uint64_t>);
+  CASE(I64__trunc_sat_f64_s):
+    REG_UNARY(runTruncateSatOp<double, int64_t>);
+  CASE(I64__trunc_sat_f64_u):
+    REG_UNARY(runTruncateSatOp<double, uint64_t>);
+  CASE(I32__eq):
+    REG_BINARY(runEqOp<uint32_t>);
+  CASE(I32__ne):
+    REG_BINARY(runNeOp<uint32_t>);
+  CASE(I32__lt_s):
+    REG_BINARY(runLtOp<int32_t>);
+  CASE(I32__lt_u):
+    REG_BINARY(runLtOp<uint32_t>);
+  CASE(I32__gt_s):
+    REG_BINARY(runGtOp<int32_t>);
+  CASE(I32__gt_u):
+    REG_BINARY(runGtOp<uint32_t>);
+  CASE(I32__le_s):
+    REG_BINARY(runLeOp<int32_t>);
+  CASE(I32__le_u):
+    REG_BINARY(runLeOp<uint32_t>);
+  CASE(I32__ge_s):
+    REG_BINARY(runGeOp<int32_t>);
+  CASE(I32__ge_u):
+    REG_BINARY(runGeOp<uint32_t>);
+  CASE(I64__eq):
+    REG_BINARY(runEqOp<uint64_t>);
+  CASE(I64__ne):
+    REG_BINARY(runNeOp<uint64_t>);
+  CASE(I64__lt_s):
+    REG_BINARY(runLtOp<int64_t>);
+  CASE(I64__lt_u):
+    REG_BINARY(runLtOp<uint64_t>);
+  CASE(I64__gt_s):
+    REG_BINARY(runGtOp<int64_t>);
+  CASE(I64__gt_u):
+    REG_BINARY(runGtOp<uint64_t>);
+  CASE(I64__le_s):
+    REG_BINARY(runLeOp<int64_t>);
+  CASE(I64__le_u):
+    REG_BINARY(runLeOp<uint64_t>);
+  CASE(I64__ge_s):
+    REG_BINARY(runGeOp<int64_t>);
+  CASE(I64__ge_u):
+    REG_BINARY(runGeOp<uint64_t>);
+  CASE(F32__eq):
+    REG_BINARY(runEqOp<float>);
+  CASE(F32__ne):
+    REG_BINARY(runNeOp<float>);
+  CASE(F32__lt):
+    REG_BINARY(runLtOp<float>);
+  CASE(F32__gt):
+    REG_BINARY(runGtOp<float>);
+  CASE(F32__le):
+    REG_BINARY(runLeOp<float>);
+  CASE(F32__ge):
+    REG_BINARY(runGeOp<float>);
+  CASE(F64__eq):
+    REG_BINARY(runEqOp<double>);
+  CASE(F64__ne):
+    REG_BINARY(runNeOp<double>);
+  CASE(F64__lt):
+    REG_BINARY(runLtOp<double>);
+  CASE(F64__gt):
+    REG_BINARY(runGtOp<double>);
+  CASE(F64__le):
+    REG_BINARY(runLeOp<double>);
+  CASE(F64__ge):
+    REG_BINARY(runGeOp<double>);
+  CASE(I32__add):
+    REG_BINARY(runAddOp<uint32_t>);
+  CASE(I32__sub):
+    REG_BINARY(runSubOp<uint32_t>);
+  CASE(I32__mul):
+    REG_BINARY(runMulOp<uint32_t>);
+  CASE(I32__div_s):
+    REG_BINARY_INSTR(runDivOp<int32_t>);
+  CASE(I32__div_u):
+    REG_BINARY_INSTR(runDivOp<uint32_t>);
+  CASE(I32__rem_s):
+    REG_BINARY_INSTR(runRemOp<int32_t>);
+  CASE(I32__rem_u):
+    REG_BINARY_INSTR(runRemOp<uint32_t>);
+  CASE(I32__and):
+    REG_BINARY(runAndOp<uint32_t>);
+  CASE(I32__or):
+    REG_BINARY(runOrOp<uint32_t>);
+  CASE(I32__xor):
+    REG_BINARY(runXorOp<uint32_t>);
+  CASE(I32__shl):
+    REG_BINARY(runShlOp<uint32_t>);
+  CASE(I32__shr_s):
+    REG_BINARY(runShrOp<int32_t>);
+  CASE(I32__shr_u):
+    REG_BINARY(runShrOp<uint32_t>);
+  CASE(I32__rotl):
+    REG_BINARY(runRotlOp<uint32_t>);
+  CASE(I32__rotr):
+    REG_BINARY(runRotrOp<uint32_t>);
+  CASE(I64__add):
+    REG_BINARY(runAddOp<uint64_t>);
+  CASE(I64__sub):
+    REG_BINARY(runSubOp<uint64_t>);
+  CASE(I64__mul):
+    REG_BINARY(runMulOp<uint64_t>);
+  CASE(I64__div_s):
+    REG_BINARY_INSTR(runDivOp<int64_t>);
+  CASE(I64__div_u):
+    REG_BINARY_INSTR(runDivOp<uint64_t>);
+  CASE(I64__rem_s):
+    REG_BINARY_INSTR(runRemOp<int64_t>);
+  CASE(I64__rem_u):
+    REG_BINARY_INSTR(runRemOp<uint64_t>);
+  CASE(I64__and):
+    REG_BINARY(runAndOp<uint64_t>);
+  CASE(I64__or):
+    REG_BINARY(runOrOp<uint64_t>);
+  CASE(I64__xor):
+    REG_BINARY(runXorOp<uint64_t>);
+  CASE(I64__shl):
+    REG_BINARY(runShlOp<uint64_t>);
+  CASE(I64__shr_s):
+    REG_BINARY(runShrOp<int64_t>);
+  CASE(I64__shr_u):
+    REG_BINARY(runShrOp<uint64_t>);
+  CASE(I64__rotl):
+    REG_BINARY(runRotlOp<uint64_t>);
+  CASE(I64__rotr):
+    REG_BINARY(runRotrOp<uint64_t>);
+  CASE(F32__add):
+    REG_BINARY(runAddOp<float>);
+  CASE(F32__sub):
+    REG_BINARY(runSubOp<float>);
+  CASE(F32__mul):
+    REG_BINARY(runMulOp<float>);
+  CASE(F32__div):
+    REG_BINARY_INSTR(runDivOp<float>);
+  CASE(F32__min):
+    REG_BINARY(runMinOp<float>);
+  CASE(F32__max):
+    REG_BINARY(runMaxOp<float>);
+  CASE(F32__copysign):
+    REG_BINARY(runCopysignOp<float>);
+  CASE(F64__add):
+    REG_BINARY(runAddOp<double>);
+  CASE(F64__sub):
+    REG_BINARY(runSubOp<double>);
+  CASE(F64__mul):
+    REG_BINARY(runMulOp<double>);
+  CASE(F64__div):
+    REG_BINARY_INSTR(runDivOp<double>);
+  CASE(F64__min):
+    REG_BINARY(runMinOp<double>);
+  CASE(F64__max):
+    REG_BINARY(runMaxOp<double>);
+  CASE(F64__copysign):
+    REG_BINARY(runCopysignOp<double>);
+    default:
+      /// The translator only emits the instructions above.
+      assert(false);
+      REG_NEXT();
+    }
+
+    /// Reach here means calling the function in Callee. The callee frame
+    /// starts at the first argument register.
+    const uint32_t ArgBase = StackMgr.getOffset(0) + PC->Dst;
+    StackMgr.resize(ArgBase + Callee->getFuncType().Params.size());
+    if (const auto *CalleeRF =
+            prepareRegFunction(StoreMgr, CalleeAddr, *Callee)) {
+      if (unlikely(!StackMgr.hasCapacity(CalleeRF->RegNum -
+                                         CalleeRF->ParamNum))) {
+        Err = ErrCode::CallStackExhausted;
+        LOG(ERROR) << Err;
+        goto Trap;
+      }
+      if (Stat && Stat->isProfiling()) {
+        Stat->enterFunction(CalleeAddr);
+      }
+      RegCallStack.push_back({RF, PC, MemInst});
+      EnterFrame(*Callee, CalleeAddr, *CalleeRF);
+      continue;
+    }
+    if (Callee->isWasmFunction()) {
+      /// Function not in register IR is executed by the stack-based engine.
+      const auto Instrs = Callee->getInstrs();
+      AST::InstrView::iterator StartIt;
+      if (auto Res = enterFunction(StoreMgr, CalleeAddr, *Callee,
+                                   Instrs.end() - 1)) {
+        StartIt = *Res;
+      } else {
+        Err = Res.error();
+        goto Trap;
+      }
+      REG_CHECK(execute(StoreMgr, StartIt, Instrs.end()));
+    } else {
+      /// Host and compiled functions.
+      REG_CHECK(enterFunction(StoreMgr, CalleeAddr, *Callee,
+                              RF->Source.begin() + PC->SrcIdx));
+    }
+    ReloadFrame();
+    REG_NEXT();
+  }
+
+#undef CASE
+#undef REG_STORE
+#undef REG_LOAD
+#undef REG_BINARY_INSTR
+#undef REG_BINARY
+#undef REG_UNARY_INSTR
+#undef REG_UNARY
+#undef REG_CHECK
+#undef REG_JUMP
+#undef REG_NEXT
+
+Trap:
+  RegCallStack.resize(CallDepth);
+  return Unexpect(Err);
+}
+
+} // namespace Interpreter
+} // namespace SSVM
@@ -10,7 +10,7 @@ Expect<void>
 Interpreter::runTableGetOp(Runtime::Instance::TableInstance &TabInst,
                            const AST::Instruction &Instr) {
   /// Pop Idx from Stack.
-  uint32_t Idx = retrieveValue<uint32_t>(StackMgr.pop());
+  uint32_t Idx = StackMgr.popAs<uint32_t>();
 
   /// Get table[Idx] and push to Stack.
   if (auto Res = TabInst.getRefAddr(Idx)) {
@@ -28,10 +28,10 @@ Expect<void>
 Interpreter::runTableSetOp(Runtime::Instance::TableInstance &TabInst,
                            const AST::Instruction &Instr) {
   /// Pop Ref from Stack.
-  RefVariant Ref = retrieveValue<uint64_t>(StackMgr.pop());
+  RefVariant Ref = StackMgr.popAs<uint64_t>();
 
   /// Pop Idx from Stack.
-  uint32_t Idx = retrieveValue<uint32_t>(StackMgr.pop());
+  uint32_t Idx = StackMgr.popAs<uint32_t>();
 
   /// Set table[Idx] with Ref.
   if (auto Res = TabInst.setRefAddr(Idx, Ref); !Res) {
@@ -48,9 +48,9 @@ Interpreter::runTableInitOp(Runtime::Instance::TableInstance &TabInst,
                             Runtime::Instance::ElementInstance &ElemInst,
                             const AST::Instruction &Instr) {
   /// Pop the length, source, and destination from stack.
-  uint32_t Len = retrieveValue<uint32_t>(StackMgr.pop());
-  uint32_t Src = retrieveValue<uint32_t>(StackMgr.pop());
-  uint32_t Dst = retrieveValue<uint32_t>(StackMgr.pop());
+  uint32_t Len = StackMgr.popAs<uint32_t>();
+  uint32_t Src = StackMgr.popAs<uint32_t>();
+  uint32_t Dst = StackMgr.popAs<uint32_t>();
 
   /// Replace tab[Dst : Dst + Len] with elem[Src : Src + Len].
   if (auto Res = TabInst.setRefs(ElemInst.getRefs(), Dst, Src, Len)) {
@@ -75,9 +75,9 @@ Interpreter::runTableCopyOp(Runtime::Instance::TableInstance &TabInstDst,
                             Runtime::Instance::TableInstance &TabInstSrc,
                             const AST::Instruction &Instr) {
   /// Pop the length, source, and destination from stack.
-  uint32_t Len = retrieveValue<uint32_t>(StackMgr.pop());
-  uint32_t Src = retrieveValue<uint32_t>(StackMgr.pop());
-  uint32_t Dst = retrieveValue<uint32_t>(StackMgr.pop());
+  uint32_t Len = StackMgr.popAs<uint32_t>();
+  uint32_t Src = StackMgr.popAs<uint32_t>();
+  uint32_t Dst = StackMgr.popAs<uint32_t>();
 
   /// Replace tab_dst[Dst : Dst + Len] with tab_src[Src : Src + Len].
   if (auto Refs = TabInstSrc.getRefs(Src, Len)) {
@@ -99,7 +99,7 @@ Interpreter::runTableCopyOp(Runtime::Instance::TableInstance &TabInstDst,
 Expect<void>
 Interpreter::runTableGrowOp(Runtime::Instance::TableInstance &TabInst) {
   /// Pop N for growing size, Val for init ref value.
-  uint32_t N = retrieveValue<uint32_t>(StackMgr.pop());
+  uint32_t N = StackMgr.popAs<uint32_t>();
   ValVariant &Val = StackMgr.getTop();
 
   /// Grow size and push result.
@@ -124,9 +124,9 @@ Expect<void>
 Interpreter::runTableFillOp(Runtime::Instance::TableInstance &TabInst,
                             const AST::Instruction &Instr) {
   /// Pop the length, ref_value, and offset from stack.
-  uint32_t Len = retrieveValue<uint32_t>(StackMgr.pop());
-  RefVariant Val = retrieveValue<uint64_t>(StackMgr.pop());
-  uint32_t Off = retrieveValue<uint32_t>(StackMgr.pop());
+  uint32_t Len = StackMgr.popAs<uint32_t>();
+  RefVariant Val = StackMgr.popAs<uint64_t>();
+  uint32_t Off = StackMgr.popAs<uint32_t>();
 
   /// Fill refs with ref_value.
   if (auto Res = TabInst.fillRefs(Val, Off, Len)) {
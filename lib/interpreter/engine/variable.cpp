@@ -27,16 +27,14 @@ Expect<void> Interpreter::runLocalTeeOp(const uint32_t Idx) {
   return {};
 }
 
-Expect<void> Interpreter::runGlobalGetOp(Runtime::StoreManager &StoreMgr,
-                                         const uint32_t Idx) {
-  auto *GlobInst = getGlobInstByIdx(StoreMgr, Idx);
+Expect<void> Interpreter::runGlobalGetOp(const uint32_t Idx) {
+  auto *GlobInst = InstCtx.Globals[Idx];
   StackMgr.push(GlobInst->getValue());
   return {};
 }
 
-Expect<void> Interpreter::runGlobalSetOp(Runtime::StoreManager &StoreMgr,
-                                         const uint32_t Idx) {
-  auto *GlobInst = getGlobInstByIdx(StoreMgr, Idx);
+Expect<void> Interpreter::runGlobalSetOp(const uint32_t Idx) {
+  auto *GlobInst = InstCtx.Globals[Idx];
   GlobInst->getValue() = StackMgr.pop();
   return {};
 }
@@ -5,16 +5,37 @@
 #include "common/value.h"
 #include "interpreter/interpreter.h"
 
+#include <algorithm>
+
 namespace SSVM {
 namespace Interpreter {
 
 Expect<AST::InstrView::iterator>
 Interpreter::enterFunction(Runtime::StoreManager &StoreMgr,
+                           const uint32_t FuncAddr,
                            const Runtime::Instance::FunctionInstance &Func,
                            const AST::InstrView::iterator From) {
   /// Get function type
   const auto &FuncType = Func.getFuncType();
 
+  /// Hot functions run the compiled code switched to by the tiering.
+  const bool Compiled = Func.isCompiledFunction() ||
+                        (Tier && tierUpFunction(FuncAddr, Func));
+
+  /// Check the stack room of the new frame. The returns of host and compiled
+  /// functions are pushed over the arguments.
+  if (unlikely(!StackMgr.hasCapacity(Func.isHostFunction() || Compiled
+                                         ? FuncType.Returns.size()
+                                         : Func.getStackSize()))) {
+    LOG(ERROR) << ErrCode::CallStackExhausted;
+    return Unexpect(ErrCode::CallStackExhausted);
+  }
+
+  /// Compiled functions record their profiles by themselves.
+  if (Stat && Stat->isProfiling() && !Compiled) {
+    Stat->enterFunction(FuncAddr);
+  }
+
   if (Func.isHostFunction()) {
     /// Host function case: Push args and call function.
     auto &HostFunc = Func.getHostFunc();
@@ -22,35 +43,34 @@ Interpreter::enterFunction(Runtime::StoreManager &StoreMgr,
     /// Get memory instance from current frame.
     /// It'll be nullptr if current frame is dummy frame or no memory instance
     /// in current module.
-    auto *MemoryInst = getMemInstByIdx(StoreMgr, 0);
+    auto *MemoryInst = InstCtx.MemInst;
 
-    if (Stat) {
-      /// Check host function cost.
-      if (unlikely(!Stat->addCost(HostFunc.getCost()))) {
-        LOG(ERROR) << ErrCode::CostLimitExceeded;
-        return Unexpect(ErrCode::CostLimitExceeded);
-      }
+    /// Check host function cost.
+    if (MeasureCost && unlikely(!Stat->addCost(HostFunc.getCost()))) {
+      LOG(ERROR) << ErrCode::CostLimitExceeded;
+      return Unexpect(ErrCode::CostLimitExceeded);
+    }
+    if (MeasureTime) {
       /// Start recording time of running host function.
       Stat->stopRecordWasm();
       Stat->startRecordHost();
     }
 
-    /// Run host function.
+    /// Run host function on the argument slots, which are extended in place
+    /// to hold the returns. The returns are left on the top of stack.
     const size_t ArgsN = FuncType.Params.size();
     const size_t RetsN = FuncType.Returns.size();
-    Span<ValVariant> Args = StackMgr.getTopSpan(ArgsN);
-    std::vector<ValVariant> Rets(RetsN);
-    auto Ret = HostFunc.run(MemoryInst, std::move(Args), Rets);
+    const size_t Base = StackMgr.size() - ArgsN;
+    StackMgr.resize(Base + std::max(ArgsN, RetsN));
+    auto Ret = HostFunc.runInPlace(
+        MemoryInst, StackMgr.getTopSpan(std::max(ArgsN, RetsN)).data());
+    StackMgr.resize(Base + RetsN);
+    leaveFunctionProfile();
 
-    /// Push returns back to stack.
-    for (size_t I = 0; I < ArgsN; ++I) {
-      ValVariant Val [[maybe_unused]] = StackMgr.pop();
-    }
-    for (auto &R : Rets) {
-      StackMgr.push(std::move(R));
-    }
+    /// Host function may grow the memory.
+    updateInstanceContext(StoreMgr);
 
-    if (Stat) {
+    if (MeasureTime) {
       /// Stop recording time of running host function.
       Stat->stopRecordHost();
       Stat->startRecordWasm();
@@ -64,38 +84,55 @@ Interpreter::enterFunction(Runtime::StoreManager &StoreMgr,
     }
     /// For host function case, the continuation will be the next.
     return From + 1;
-  } else if (Func.isCompiledFunction()) {
-    auto Wrapper = Func.getFuncType().getSymbol();
+  } else if (Compiled) {
+    auto Wrapper = Func.isCompiledFunction() ? Func.getFuncType().getSymbol()
+                                             : Func.getTieredWrapper();
+    auto Code = Func.isCompiledFunction() ? Func.getSymbol()
+                                          : Func.getTieredCode();
     /// Compiled function case: Push frame with locals and args.
     const size_t ArgsN = FuncType.Params.size();
     const size_t RetsN = FuncType.Returns.size();
 
     StackMgr.pushFrame(Func.getModuleAddr(), /// Module address
                        ArgsN,                /// No Arguments in stack
-                       RetsN                 /// Returns num
+                       RetsN,                /// Returns num
+                       {},                   /// No continuation
+                       FuncAddr              /// Function address
     );
 
     Span<ValVariant> Args = StackMgr.getTopSpan(ArgsN);
     std::vector<ValVariant> Rets(RetsN);
 
+    Runtime::Instance::MemoryInstance *OldMemory;
     {
       CurrentStore = &StoreMgr;
       const auto &ModInst = **StoreMgr.getModule(Func.getModuleAddr());
-      ExecutionContext.Memory = ModInst.MemoryPtr;
       ExecutionContext.Globals = ModInst.GlobalsPtr.data();
+      /// Compiled functions check the gas by the limit.
+      ExecutionContext.CostLimit =
+          MeasureCost ? Stat->getCostLimit() : UINT64_MAX;
+      /// The memory of the caller, which may be compiled functions of another
+      /// module, is restored after the call.
+      OldMemory = std::exchange(ExecutionMemory, ModInst.MemoryInst);
+      updateExecutionMemory();
     }
 
     sigjmp_buf JumpBuffer;
     auto OldTrapJump = std::exchange(TrapJump, &JumpBuffer);
 
-    const int Status = sigsetjmp(*TrapJump, true);
-    if (Status == 0) {
+    int Status;
+    {
+      /// Restore the previous handlers also when returning by a trap.
       SignalEnabler Enabler;
-      Wrapper(&ExecutionContext, Func.getSymbol().get(), Args.data(),
-              Rets.data());
+      Status = sigsetjmp(*TrapJump, true);
+      if (Status == 0) {
+        Wrapper(&ExecutionContext, Code.get(), Args.data(), Rets.data());
+      }
     }
 
     TrapJump = std::move(OldTrapJump);
+    ExecutionMemory = OldMemory;
+    updateExecutionMemory();
 
     if (Status != 0) {
       ErrCode Code = static_cast<ErrCode>(Status);
@@ -110,14 +147,29 @@ Interpreter::enterFunction(Runtime::StoreManager &StoreMgr,
     }
 
     StackMgr.popFrame();
+    updateInstanceContext(StoreMgr);
     /// For compiled function case, the continuation will be the next.
     return From + 1;
+  } else if (const auto *RegFunc =
+                 Conf.isRegisterTier()
+                     ? prepareRegFunction(StoreMgr, FuncAddr, Func)
+                     : nullptr) {
+    /// Register tier case: Run the translated function to the end.
+    if (auto Res = runRegFunction(StoreMgr, FuncAddr, Func, *RegFunc); !Res) {
+      return Unexpect(Res);
+    }
+    updateInstanceContext(StoreMgr);
+    /// The continuation will be the next as the function has returned.
+    return From + 1;
   } else {
     /// Native function case: Push frame with locals and args.
-    StackMgr.pushFrame(Func.getModuleAddr(),   /// Module address
-                       FuncType.Params.size(), /// Arguments num
-                       FuncType.Returns.size() /// Returns num
+    StackMgr.pushFrame(Func.getModuleAddr(),    /// Module address
+                       FuncType.Params.size(),  /// Arguments num
+                       FuncType.Returns.size(), /// Returns num
+                       From,                    /// Continuation
+                       FuncAddr                 /// Function address
     );
+    updateInstanceContext(StoreMgr);
 
     /// Push local variables to stack.
     for (auto &Def : Func.getLocals()) {
@@ -126,51 +178,150 @@ Interpreter::enterFunction(Runtime::StoreManager &StoreMgr,
       }
     }
 
-    /// Enter function block []->[returns] with label{none}.
-    StackMgr.pushLabel(0, FuncType.Returns.size(), From);
     /// For native function case, the continuation will be the start of
     /// function body.
     return Func.getInstrs().begin();
   }
 }
 
-std::pair<uint32_t, uint32_t>
-Interpreter::getBlockArity(Runtime::StoreManager &StoreMgr,
-                           const BlockType &BType) {
-  uint32_t Locals = 0, Arity = 0;
-  if (std::holds_alternative<ValType>(BType)) {
-    Arity = (std::get<ValType>(BType) == ValType::None) ? 0 : 1;
+bool Interpreter::tierUpFunction(
+    const uint32_t FuncAddr, const Runtime::Instance::FunctionInstance &Func) {
+  if (!Func.isWasmFunction()) {
+    return false;
+  }
+  if (Func.isTiered()) {
+    return true;
+  }
+  if (Func.addHotness(1) < Tier->getThreshold()) {
+    return false;
+  }
+  return Tier->tierUp(FuncAddr, Func);
+}
+
+Expect<void>
+Interpreter::branchToLabel(Runtime::StoreManager &StoreMgr,
+                           const AST::Instruction::JumpDescriptor &Jump,
+                           AST::InstrView::iterator &PC) {
+  /// Drop the values between the label arity and the label height.
+  StackMgr.stackErase(Jump.StackEraseBegin, Jump.StackEraseEnd);
+
+  /// Move PC to the End of block or the Loop instruction.
+  PC += Jump.PCOffset;
+
+  /// Loop back edges count to the hotness of the function. The running frame
+  /// keeps interpreting, and the next call runs the compiled code.
+  if (Tier && Jump.PCOffset < 0) {
+    const uint32_t FuncAddr = StackMgr.getFrames().back().FuncAddr;
+    if (FuncAddr != Runtime::StackManager::kNoFunction) {
+      tierUpFunction(FuncAddr, **StoreMgr.getFunction(FuncAddr));
+    }
+  }
+
+  /// Branching to the function label is the same as returning.
+  if (PC->isLast()) {
+    leaveFunctionProfile();
+    PC = StackMgr.popFrame();
+    updateInstanceContext(StoreMgr);
+  }
+  return {};
+}
+
+void Interpreter::updateInstanceContext(Runtime::StoreManager &StoreMgr) {
+  /// When top frame is dummy frame, there is no instance.
+  if (StackMgr.isTopDummyFrame()) {
+    resetInstanceContext();
+    return;
+  }
+  const uint32_t ModAddr = StackMgr.getModuleAddr();
+  if (ModAddr != InstCtx.ModAddr) {
+    InstCtx.ModAddr = ModAddr;
+    InstCtx.ModInst = *StoreMgr.getModule(ModAddr);
+    InstCtx.MemInst = nullptr;
+    if (auto Res = InstCtx.ModInst->getMemAddr(0)) {
+      InstCtx.MemInst = *StoreMgr.getMemory(*Res);
+    }
+  }
+  /// The instances are resolved once per module instance, and the ones added
+  /// since during the instantiation are appended.
+  const auto &ModInst = *InstCtx.ModInst;
+  auto &ModCtx = ModContexts[ModAddr];
+  for (uint32_t I = ModCtx.Globals.size(); I < ModInst.getGlobalNum(); ++I) {
+    ModCtx.Globals.push_back(*StoreMgr.getGlobal(*ModInst.getGlobalAddr(I)));
+  }
+  for (uint32_t I = ModCtx.Tables.size(); I < ModInst.getTableNum(); ++I) {
+    ModCtx.Tables.push_back(*StoreMgr.getTable(*ModInst.getTableAddr(I)));
+  }
+  InstCtx.Globals = ModCtx.Globals.data();
+  InstCtx.Tables = ModCtx.Tables.data();
+  /// The memory may be grown since the last update.
+  if (InstCtx.MemInst) {
+    InstCtx.MemData = InstCtx.MemInst->getDataPtr();
+    InstCtx.MemSize =
+        static_cast<uint64_t>(InstCtx.MemInst->getDataPageSize()) *
+        Runtime::Instance::MemoryInstance::kPageSize;
   } else {
-    /// Get function type at index x.
-    const auto *ModInst = *StoreMgr.getModule(StackMgr.getModuleAddr());
-    const auto *FuncType = *ModInst->getFuncType(std::get<uint32_t>(BType));
-    Locals = FuncType->Params.size();
-    Arity = FuncType->Returns.size();
+    InstCtx.MemData = nullptr;
+    InstCtx.MemSize = 0;
   }
-  return {Locals, Arity};
 }
 
-Expect<void> Interpreter::branchToLabel(Runtime::StoreManager &StoreMgr,
-                                        const uint32_t Cnt,
-                                        AST::InstrView::iterator &PC) {
-  /// Get the L-th label from top of stack and the continuation instruction.
-  const auto ContIt = StackMgr.getLabelWithCount(Cnt).Cont;
+void Interpreter::updateExecutionMemory() noexcept {
+  if (ExecutionMemory) {
+    ExecutionContext.Memory = ExecutionMemory->getDataPtr();
+    ExecutionContext.MemorySize =
+        static_cast<uint64_t>(ExecutionMemory->getDataPageSize()) *
+        Runtime::Instance::MemoryInstance::kPageSize;
+  } else {
+    ExecutionContext.Memory = nullptr;
+    ExecutionContext.MemorySize = 0;
+  }
+}
 
-  /// Pop L + 1 labels and jump back.
-  PC = StackMgr.popLabel(Cnt + 1);
+void Interpreter::resetInstanceContext() {
+  InstCtx.ModAddr = UINT32_MAX;
+  InstCtx.ModInst = nullptr;
+  InstCtx.MemInst = nullptr;
+  InstCtx.MemData = nullptr;
+  InstCtx.MemSize = 0;
+  InstCtx.Globals = nullptr;
+  InstCtx.Tables = nullptr;
+}
 
-  /// Jump to the continuation of Label if is a loop.
-  if (ContIt) {
-    /// Get result type for arity.
-    auto BlockSig = getBlockArity(StoreMgr, (*ContIt)->getBlockType());
+void Interpreter::pruneModuleContexts(const Runtime::StoreManager &StoreMgr) {
+  const uint32_t ModNum = StoreMgr.getModules().size();
+  for (auto It = ModContexts.begin(); It != ModContexts.end();) {
+    if (It->first >= ModNum) {
+      It = ModContexts.erase(It);
+    } else {
+      ++It;
+    }
+  }
+}
 
-    /// Create Label{ loop-instruction } and push.
-    StackMgr.pushLabel(BlockSig.first, BlockSig.first, PC, *ContIt);
+Expect<uint32_t>
+Interpreter::getIndirectFuncAddr(Runtime::StoreManager &StoreMgr,
+                                 const uint32_t TableIndex,
+                                 const uint32_t FuncTypeIndex,
+                                 const uint32_t FuncIndex) {
+  const auto *TabInst = getTabInstByIdx(StoreMgr, TableIndex);
 
-    /// Move PC to loop start.
-    PC = *ContIt;
+  if (unlikely(FuncIndex >= TabInst->getSize())) {
+    return Unexpect(ErrCode::UndefinedElement);
   }
-  return {};
+
+  ValVariant Ref = *TabInst->getRefAddr(FuncIndex);
+  if (unlikely(isNullRef(Ref))) {
+    return Unexpect(ErrCode::UninitializedElement);
+  }
+  const auto FuncAddr = retrieveFuncIdx(Ref);
+
+  const auto *ModInst = *StoreMgr.getModule(StackMgr.getModuleAddr());
+  const auto *TargetFuncType = *ModInst->getFuncType(FuncTypeIndex);
+  const auto *FuncInst = *StoreMgr.getFunction(FuncAddr);
+  if (unlikely(TargetFuncType->TypeID != FuncInst->getTypeID())) {
+    return Unexpect(ErrCode::IndirectCallTypeMismatch);
+  }
+  return FuncAddr;
 }
 
 Runtime::Instance::TableInstance *
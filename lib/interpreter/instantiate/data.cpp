@@ -25,7 +25,7 @@ Interpreter::instantiate(Runtime::StoreManager &StoreMgr,
         LOG(ERROR) << ErrInfo::InfoAST(DataSeg.NodeAttr);
         return Unexpect(Res);
       }
-      Offset = retrieveValue<uint32_t>(StackMgr.pop());
+      Offset = StackMgr.popAs<uint32_t>();
 
       /// Check boundary unless ReferenceTypes or BulkMemoryOperations proposal
       /// enabled.
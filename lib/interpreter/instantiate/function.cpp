@@ -26,20 +26,23 @@ Expect<void> Interpreter::instantiate(
         NewFuncInstAddr =
             StoreMgr.pushFunction(ModInst.Addr, *FuncType, std::move(Symbol));
       } else {
-        NewFuncInstAddr = StoreMgr.pushFunction(ModInst.Addr, *FuncType,
-                                                CodeSegs[I].getLocals(),
-                                                CodeSegs[I].getInstrs());
+        NewFuncInstAddr = StoreMgr.pushFunction(
+            ModInst.Addr, *FuncType, CodeSegs[I].getLocals(),
+            CodeSegs[I].getInstrs(), CodeSegs[I].getMaxStackHeight());
       }
     } else {
       if (auto Symbol = CodeSegs[I].getSymbol()) {
         NewFuncInstAddr =
             StoreMgr.importFunction(ModInst.Addr, *FuncType, std::move(Symbol));
       } else {
-        NewFuncInstAddr = StoreMgr.importFunction(ModInst.Addr, *FuncType,
-                                                  CodeSegs[I].getLocals(),
-                                                  CodeSegs[I].getInstrs());
+        NewFuncInstAddr = StoreMgr.importFunction(
+            ModInst.Addr, *FuncType, CodeSegs[I].getLocals(),
+            CodeSegs[I].getInstrs(), CodeSegs[I].getMaxStackHeight());
       }
     }
+    /// Mark the basic blocks on the instructions owned by the instance.
+    auto *FuncInst = *StoreMgr.getFunction(NewFuncInstAddr);
+    markBasicBlocks(FuncInst->getMutableInstrs());
     ModInst.addFuncAddr(NewFuncInstAddr);
   }
   return {};
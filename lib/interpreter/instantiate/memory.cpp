@@ -11,17 +11,18 @@ namespace Interpreter {
 Expect<void>
 Interpreter::instantiate(Runtime::StoreManager &StoreMgr,
                          Runtime::Instance::ModuleInstance &ModInst,
-                         const AST::MemorySection &MemSec) {
+                         const AST::MemorySection &MemSec,
+                         const bool Guard) {
   /// Iterate and istantiate memory types.
   for (const auto &MemType : MemSec.getContent()) {
     /// Insert memory instance to store manager.
     uint32_t NewMemInstAddr;
     if (InsMode == InstantiateMode::Instantiate) {
-      NewMemInstAddr =
-          StoreMgr.pushMemory(MemType.getLimit(), Conf.getMaxMemoryPage());
+      NewMemInstAddr = StoreMgr.pushMemory(MemType.getLimit(),
+                                           Conf.getMaxMemoryPage(), Guard);
     } else {
-      NewMemInstAddr =
-          StoreMgr.importMemory(MemType.getLimit(), Conf.getMaxMemoryPage());
+      NewMemInstAddr = StoreMgr.importMemory(MemType.getLimit(),
+                                             Conf.getMaxMemoryPage(), Guard);
     }
     ModInst.addMemAddr(NewMemInstAddr);
   }
@@ -11,10 +11,20 @@ namespace Interpreter {
 /// Instantiate module instance. See "include/executor/Interpreter.h".
 Expect<void> Interpreter::instantiate(Runtime::StoreManager &StoreMgr,
                                       const AST::Module &Mod,
-                                      std::string_view Name) {
+                                      std::string_view Name,
+                                      const Runtime::Snapshot *Snap) {
+  /// The stacks may be failed to reserve.
+  if (unlikely(!StackMgr.isReserved())) {
+    LOG(ERROR) << ErrCode::CallStackExhausted;
+    return Unexpect(ErrCode::CallStackExhausted);
+  }
+
   /// Reset store manager and stack manager.
   StoreMgr.reset();
   StackMgr.reset();
+  resetInstanceContext();
+  pruneModuleContexts(StoreMgr);
+  pruneRegFunctions(StoreMgr);
 
   /// Check is module name duplicated.
   if (auto Res = StoreMgr.findModule(Name)) {
@@ -39,6 +49,9 @@ Expect<void> Interpreter::instantiate(Runtime::StoreManager &StoreMgr,
                          FuncType.getSymbol());
   }
 
+  /// Copy the function names for profiling.
+  ModInst->setFuncNames(Mod.getFunctionNames());
+
   /// Instantiate ImportSection and do import matching. (ImportSec)
   const AST::ImportSection &ImportSec = Mod.getImportSection();
   if (auto Res = instantiate(StoreMgr, *ModInst, ImportSec); !Res) {
@@ -47,6 +60,16 @@ Expect<void> Interpreter::instantiate(Runtime::StoreManager &StoreMgr,
     return Unexpect(Res);
   }
 
+  /// Compiled functions without the bounds checks rely on the guard region of
+  /// the imported memory.
+  if (Mod.needsGuardRegion() && ModInst->getMemImportNum() > 0 &&
+      !(*StoreMgr.getMemory(*ModInst->getMemAddr(0)))->hasGuardRegion()) {
+    LOG(ERROR) << ErrCode::IncompatibleImportType;
+    LOG(ERROR) << ErrInfo::InfoAST(ImportSec.NodeAttr);
+    LOG(ERROR) << ErrInfo::InfoAST(Mod.NodeAttr);
+    return Unexpect(ErrCode::IncompatibleImportType);
+  }
+
   /// Instantiate Functions in module. (FunctionSec, CodeSec)
   const AST::FunctionSection &FuncSec = Mod.getFunctionSection();
   const AST::CodeSection &CodeSec = Mod.getCodeSection();
@@ -64,14 +87,30 @@ Expect<void> Interpreter::instantiate(Runtime::StoreManager &StoreMgr,
     return Unexpect(Res);
   }
 
-  /// Instantiate MemorySection (MemorySec)
+  /// Instantiate MemorySection (MemorySec), or map the pages of the snapshot.
   const AST::MemorySection &MemSec = Mod.getMemorySection();
-  if (auto Res = instantiate(StoreMgr, *ModInst, MemSec); !Res) {
+  if (auto Res = Snap ? restoreMemory(StoreMgr, *ModInst, MemSec, *Snap,
+                                      Mod.needsGuardRegion())
+                      : instantiate(StoreMgr, *ModInst, MemSec,
+                                    Conf.isGuardPageCheck() ||
+                                        Mod.needsGuardRegion());
+      !Res) {
     LOG(ERROR) << ErrInfo::InfoAST(MemSec.NodeAttr);
     LOG(ERROR) << ErrInfo::InfoAST(Mod.NodeAttr);
     return Unexpect(Res);
   }
 
+  /// The defined memory is mapped without the guard region when the address
+  /// space is exhausted, which the compiled functions cannot run with.
+  if (const uint32_t ImpNum = ModInst->getMemImportNum();
+      Mod.needsGuardRegion() && ModInst->getMemNum() > ImpNum &&
+      !(*StoreMgr.getMemory(*ModInst->getMemAddr(ImpNum)))->hasGuardRegion()) {
+    LOG(ERROR) << ErrCode::MemoryOutOfBounds;
+    LOG(ERROR) << ErrInfo::InfoAST(MemSec.NodeAttr);
+    LOG(ERROR) << ErrInfo::InfoAST(Mod.NodeAttr);
+    return Unexpect(ErrCode::MemoryOutOfBounds);
+  }
+
   /// Add a temp module to Store with only imported globals for initialization.
   uint32_t TmpModInstAddr = StoreMgr.pushModule("");
   auto *TmpModInst = *StoreMgr.getModule(TmpModInstAddr);
@@ -96,8 +135,10 @@ Expect<void> Interpreter::instantiate(Runtime::StoreManager &StoreMgr,
   /// Pop frame with temp. module.
   StackMgr.popFrame();
 
-  /// Pop the added temp. module.
+  /// Pop the added temp. module. Its address will be reused.
   StoreMgr.popModule();
+  resetInstanceContext();
+  pruneModuleContexts(StoreMgr);
 
   /// Instantiate ExportSection (ExportSec)
   const AST::ExportSection &ExportSec = Mod.getExportSection();
@@ -107,6 +148,20 @@ Expect<void> Interpreter::instantiate(Runtime::StoreManager &StoreMgr,
     return Unexpect(Res);
   }
 
+  /// Prepare pointers for compiled functions
+  ModInst->MemoryInst =
+      ModInst->getMemAddr(0)
+          .and_then([&StoreMgr](uint32_t MemAddr) {
+            return StoreMgr.getMemory(MemAddr);
+          })
+          .value_or(nullptr);
+
+  ModInst->GlobalsPtr.reserve(ModInst->getGlobalNum());
+  for (size_t I = 0; I < ModInst->getGlobalNum(); ++I) {
+    ModInst->GlobalsPtr.push_back(
+        &(*StoreMgr.getGlobal(*ModInst->getGlobalAddr(I)))->getValue());
+  }
+
   /// Push a new frame {ModInst, locals:none}
   StackMgr.pushFrame(ModInst->Addr, 0, 0);
 
@@ -126,6 +181,16 @@ Expect<void> Interpreter::instantiate(Runtime::StoreManager &StoreMgr,
     return Unexpect(Res);
   }
 
+  /// The snapshot is taken after the initializations and the start function.
+  if (Snap) {
+    StackMgr.popFrame();
+    if (auto Res = restore(StoreMgr, *ModInst, *Snap); !Res) {
+      LOG(ERROR) << ErrInfo::InfoAST(Mod.NodeAttr);
+      return Unexpect(Res);
+    }
+    return {};
+  }
+
   /// Initialize table instances
   if (auto Res = initTable(StoreMgr, *ModInst, ElemSec); !Res) {
     LOG(ERROR) << ErrInfo::InfoAST(ElemSec.NodeAttr);
@@ -140,23 +205,6 @@ Expect<void> Interpreter::instantiate(Runtime::StoreManager &StoreMgr,
     return Unexpect(Res);
   }
 
-  /// Prepare pointers for compiled functions
-  ModInst->MemoryPtr =
-      ModInst->getMemAddr(0)
-          .and_then([&StoreMgr](uint32_t MemAddr) {
-            return StoreMgr.getMemory(MemAddr);
-          })
-          .map([](const Runtime::Instance::MemoryInstance *MemInst) {
-            return MemInst->getDataPtr();
-          })
-          .value_or(nullptr);
-
-  ModInst->GlobalsPtr.reserve(ModInst->getGlobalNum());
-  for (size_t I = 0; I < ModInst->getGlobalNum(); ++I) {
-    ModInst->GlobalsPtr.push_back(
-        &(*StoreMgr.getGlobal(*ModInst->getGlobalAddr(I)))->getValue());
-  }
-
   /// Instantiate StartSection (StartSec)
   const AST::StartSection &StartSec = Mod.getStartSection();
   if (StartSec.getContent()) {
@@ -170,13 +218,18 @@ Expect<void> Interpreter::instantiate(Runtime::StoreManager &StoreMgr,
     /// Execute instruction: call start.func
     auto Instrs = FuncInst->getInstrs();
     AST::InstrView::iterator StartIt;
-    if (auto Res = enterFunction(StoreMgr, *FuncInst, Instrs.end() - 1)) {
+    if (auto Res =
+            enterFunction(StoreMgr, Addr, *FuncInst, Instrs.end() - 1)) {
       StartIt = *Res;
     } else {
       LOG(ERROR) << ErrInfo::InfoAST(Mod.NodeAttr);
       return Unexpect(Res);
     }
     if (auto Res = execute(StoreMgr, StartIt, Instrs.end()); unlikely(!Res)) {
+      if (Stat && Stat->isProfiling()) {
+        /// Leave the frames unwound by the trap.
+        Stat->leaveAllFunctions();
+      }
       LOG(ERROR) << ErrInfo::InfoAST(Mod.NodeAttr);
       return Unexpect(Res);
     }
@@ -0,0 +1,251 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "runtime/snapshot.h"
+#include "ast/section.h"
+#include "common/log.h"
+#include "interpreter/interpreter.h"
+#include "runtime/instance/module.h"
+
+#include <algorithm>
+#include <unordered_map>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace SSVM {
+namespace Interpreter {
+
+namespace {
+
+/// Size of the pages skipped when all zeros, so the holes of the snapshot file
+/// take no space.
+constexpr uint64_t kFilePageSize = 4096;
+
+/// Translate the non-null function reference between the store addresses and
+/// the function indices. Fail on the functions not in the module.
+Expect<uint32_t>
+translateFunc(const ValVariant &Ref,
+              const std::unordered_map<uint32_t, uint32_t> &Map) {
+  if (auto It = Map.find(retrieveFuncIdx(Ref)); It != Map.end()) {
+    return It->second;
+  }
+  LOG(ERROR) << ErrCode::WrongInstanceAddress;
+  return Unexpect(ErrCode::WrongInstanceAddress);
+}
+
+/// Translate the references of the table. The values are untagged, so only
+/// the tables of the function references are translated.
+Expect<void> translateRefs(Span<const RefVariant> Refs, const RefType Type,
+                           const std::unordered_map<uint32_t, uint32_t> &Map,
+                           std::vector<RefVariant> &Result) {
+  Result.reserve(Refs.size());
+  for (const auto &Ref : Refs) {
+    if (Type != RefType::FuncRef || isNullRef(Ref)) {
+      Result.push_back(Ref);
+    } else if (auto Res = translateFunc(Ref, Map)) {
+      Result.push_back(genFuncRef(*Res));
+    } else {
+      return Unexpect(Res);
+    }
+  }
+  return {};
+}
+
+/// Translate the value of the global.
+Expect<ValVariant>
+translateValue(const ValVariant &Val, const ValType Type,
+               const std::unordered_map<uint32_t, uint32_t> &Map) {
+  if (Type != ValType::FuncRef || isNullRef(Val)) {
+    return Val;
+  }
+  if (auto Res = translateFunc(Val, Map)) {
+    return ValVariant(genFuncRef(*Res));
+  } else {
+    return Unexpect(Res);
+  }
+}
+
+/// Write the pages into a memory file. The zero pages are left as the holes.
+Expect<int> writeMemory(const Runtime::Instance::MemoryInstance &MemInst) {
+  const uint64_t Size = MemInst.getDataPageSize() *
+                        Runtime::Instance::MemoryInstance::kPageSize;
+  const int Fd = memfd_create("ssvm-snapshot", MFD_CLOEXEC);
+  if (Fd < 0 || ftruncate(Fd, Size) != 0) {
+    LOG(ERROR) << "memfd_create failed";
+    if (Fd >= 0) {
+      close(Fd);
+    }
+    return Unexpect(ErrCode::MemoryOutOfBounds);
+  }
+  const uint8_t *Data = MemInst.getDataPtr();
+  for (uint64_t Off = 0; Off < Size; Off += kFilePageSize) {
+    if (std::all_of(Data + Off, Data + Off + kFilePageSize,
+                    [](uint8_t B) { return B == 0; })) {
+      continue;
+    }
+    for (uint64_t Done = 0; Done < kFilePageSize;) {
+      const ssize_t Res =
+          pwrite(Fd, Data + Off + Done, kFilePageSize - Done, Off + Done);
+      if (Res <= 0) {
+        LOG(ERROR) << "pwrite failed";
+        close(Fd);
+        return Unexpect(ErrCode::MemoryOutOfBounds);
+      }
+      Done += Res;
+    }
+  }
+  return Fd;
+}
+
+} // namespace
+
+/// Take the snapshot of the active module. See
+/// "include/interpreter/interpreter.h".
+Expect<std::unique_ptr<Runtime::Snapshot>>
+Interpreter::snapshotModule(Runtime::StoreManager &StoreMgr) {
+  auto Mod = StoreMgr.getActiveModule();
+  if (!Mod) {
+    LOG(ERROR) << ErrCode::WrongInstanceAddress;
+    return Unexpect(Mod);
+  }
+  const auto &ModInst = **Mod;
+
+  /// The imported tables and memories are not owned by the instance.
+  if (ModInst.getTableImportNum() > 0 || ModInst.getMemImportNum() > 0) {
+    LOG(ERROR) << ErrCode::WrongInstanceAddress;
+    return Unexpect(ErrCode::WrongInstanceAddress);
+  }
+
+  std::unordered_map<uint32_t, uint32_t> FuncIdx;
+  for (uint32_t I = 0; I < ModInst.getFuncNum(); ++I) {
+    FuncIdx.emplace(*ModInst.getFuncAddr(I), I);
+  }
+
+  auto Snap = std::make_unique<Runtime::Snapshot>();
+  if (ModInst.getMemNum() > 0) {
+    const auto *MemInst = *StoreMgr.getMemory(*ModInst.getMemAddr(0));
+    if (auto Res = writeMemory(*MemInst)) {
+      Snap->MemoryFd = *Res;
+    } else {
+      return Unexpect(Res);
+    }
+    Snap->MemoryPages = MemInst->getDataPageSize();
+  }
+
+  for (uint32_t I = ModInst.getGlobalImportNum(); I < ModInst.getGlobalNum();
+       ++I) {
+    const auto *GlobInst = *StoreMgr.getGlobal(*ModInst.getGlobalAddr(I));
+    if (auto Res = translateValue(GlobInst->getValue(),
+                                  GlobInst->getValType(), FuncIdx)) {
+      Snap->Globals.push_back(*Res);
+    } else {
+      return Unexpect(Res);
+    }
+  }
+
+  for (uint32_t I = 0; I < ModInst.getTableNum(); ++I) {
+    const auto *TabInst = *StoreMgr.getTable(*ModInst.getTableAddr(I));
+    if (auto Res = translateRefs(*TabInst->getRefs(0, TabInst->getSize()),
+                                 TabInst->getReferenceType(), FuncIdx,
+                                 Snap->Tables.emplace_back());
+        !Res) {
+      return Unexpect(Res);
+    }
+  }
+
+  /// The segments are only dropped after instantiated, and clearing the empty
+  /// ones again makes no difference.
+  for (uint32_t I = 0; I < ModInst.getElemNum(); ++I) {
+    const auto *ElemInst = *StoreMgr.getElement(*ModInst.getElemAddr(I));
+    Snap->DroppedElements.push_back(ElemInst->getRefs().empty());
+  }
+  for (uint32_t I = 0; I < ModInst.getDataNum(); ++I) {
+    const auto *DataInst = *StoreMgr.getData(*ModInst.getDataAddr(I));
+    Snap->DroppedData.push_back(DataInst->getData().empty());
+  }
+  return Snap;
+}
+
+/// Instantiate memory instance from snapshot. See
+/// "include/interpreter/interpreter.h".
+Expect<void> Interpreter::restoreMemory(
+    Runtime::StoreManager &StoreMgr, Runtime::Instance::ModuleInstance &ModInst,
+    const AST::MemorySection &MemSec, const Runtime::Snapshot &Snap,
+    const bool RequireGuard) {
+  for (const auto &MemType : MemSec.getContent()) {
+    const uint32_t NewMemInstAddr = StoreMgr.pushMemory(
+        MemType.getLimit(), Snap.MemoryPages, Snap.MemoryFd,
+        Conf.getMaxMemoryPage(), RequireGuard);
+    const auto *MemInst = *StoreMgr.getMemory(NewMemInstAddr);
+    if ((MemInst->getDataPageSize() > 0 && MemInst->getDataPtr() == nullptr) ||
+        (RequireGuard && !MemInst->hasGuardRegion())) {
+      LOG(ERROR) << ErrCode::MemoryOutOfBounds;
+      return Unexpect(ErrCode::MemoryOutOfBounds);
+    }
+    ModInst.addMemAddr(NewMemInstAddr);
+  }
+  return {};
+}
+
+/// Restore tables, globals, and segments from snapshot. See
+/// "include/interpreter/interpreter.h".
+Expect<void> Interpreter::restore(Runtime::StoreManager &StoreMgr,
+                                  Runtime::Instance::ModuleInstance &ModInst,
+                                  const Runtime::Snapshot &Snap) {
+  if (Snap.Tables.size() != ModInst.getTableNum() ||
+      Snap.Globals.size() !=
+          ModInst.getGlobalNum() - ModInst.getGlobalImportNum() ||
+      Snap.DroppedElements.size() != ModInst.getElemNum() ||
+      Snap.DroppedData.size() != ModInst.getDataNum()) {
+    LOG(ERROR) << ErrCode::WrongInstanceIndex;
+    return Unexpect(ErrCode::WrongInstanceIndex);
+  }
+
+  std::unordered_map<uint32_t, uint32_t> FuncAddr;
+  for (uint32_t I = 0; I < ModInst.getFuncNum(); ++I) {
+    FuncAddr.emplace(I, *ModInst.getFuncAddr(I));
+  }
+
+  for (uint32_t I = 0; I < Snap.Tables.size(); ++I) {
+    auto *TabInst = *StoreMgr.getTable(*ModInst.getTableAddr(I));
+    std::vector<RefVariant> Table;
+    if (auto Res = translateRefs(Snap.Tables[I], TabInst->getReferenceType(),
+                                 FuncAddr, Table);
+        !Res) {
+      return Unexpect(Res);
+    }
+    if (Table.size() > TabInst->getSize() &&
+        !TabInst->growTable(Table.size() - TabInst->getSize())) {
+      LOG(ERROR) << ErrCode::TableOutOfBounds;
+      return Unexpect(ErrCode::TableOutOfBounds);
+    }
+    if (auto Res = TabInst->setRefs(Table, 0, 0, Table.size()); !Res) {
+      return Unexpect(Res);
+    }
+  }
+
+  for (uint32_t I = 0; I < Snap.Globals.size(); ++I) {
+    auto *GlobInst = *StoreMgr.getGlobal(
+        *ModInst.getGlobalAddr(ModInst.getGlobalImportNum() + I));
+    if (auto Res = translateValue(Snap.Globals[I], GlobInst->getValType(),
+                                  FuncAddr)) {
+      GlobInst->getValue() = *Res;
+    } else {
+      return Unexpect(Res);
+    }
+  }
+
+  for (uint32_t I = 0; I < Snap.DroppedElements.size(); ++I) {
+    if (Snap.DroppedElements[I]) {
+      (*StoreMgr.getElement(*ModInst.getElemAddr(I)))->clear();
+    }
+  }
+  for (uint32_t I = 0; I < Snap.DroppedData.size(); ++I) {
+    if (Snap.DroppedData[I]) {
+      (*StoreMgr.getData(*ModInst.getDataAddr(I)))->clear();
+    }
+  }
+  return {};
+}
+
+} // namespace Interpreter
+} // namespace SSVM
@@ -18,10 +18,23 @@ Expect<void> Interpreter::instantiateModule(Runtime::StoreManager &StoreMgr,
   return {};
 }
 
+/// Instantiate module from snapshot. See "include/interpreter/interpreter.h".
+Expect<void> Interpreter::instantiateModule(Runtime::StoreManager &StoreMgr,
+                                            const AST::Module &Mod,
+                                            const Runtime::Snapshot &Snap) {
+  InsMode = InstantiateMode::Instantiate;
+  if (auto Res = instantiate(StoreMgr, Mod, "", &Snap); !Res) {
+    return Unexpect(Res);
+  }
+  return {};
+}
+
 /// Register host module. See "include/interpreter/interpreter.h".
 Expect<void> Interpreter::registerModule(Runtime::StoreManager &StoreMgr,
                                          const Runtime::ImportObject &Obj) {
   StoreMgr.reset();
+  pruneModuleContexts(StoreMgr);
+  pruneRegFunctions(StoreMgr);
   /// Check is module name duplicated.
   if (auto Res = StoreMgr.findModule(Obj.getModuleName())) {
     LOG(ERROR) << ErrCode::ModuleNameConflict;
@@ -101,7 +114,7 @@ Interpreter::invoke(Runtime::StoreManager &StoreMgr, const uint32_t FuncAddr,
   }
 
   /// Call runFunction.
-  if (auto Res = runFunction(StoreMgr, *FuncInst, Params); !Res) {
+  if (auto Res = runFunction(StoreMgr, FuncAddr, *FuncInst, Params); !Res) {
     return Unexpect(Res);
   }
 
@@ -0,0 +1,762 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "interpreter/regir.h"
+#include "common/log.h"
+#include "interpreter/interpreter.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <utility>
+#include <vector>
+
+namespace SSVM {
+namespace Interpreter {
+
+namespace {
+
+/// Classification of the instructions computing values only from registers.
+enum class NumericKind : uint8_t { None, Unary, Binary };
+
+/// Get the operand count of numeric instructions. Instructions out of the
+/// MVP numeric range, sign-extension, and saturating truncation are not
+/// supported by the register tier.
+NumericKind getNumericKind(const OpCode Code) {
+  const uint16_t Val = static_cast<uint16_t>(Code);
+  if ((Val >= 0xFC00U && Val <= 0xFC07U) || (Val >= 0xA7U && Val <= 0xC4U)) {
+    /// Conversions, sign-extension, and saturating truncation.
+    return NumericKind::Unary;
+  }
+  if (Val < 0x45U || Val > 0xA6U) {
+    return NumericKind::None;
+  }
+  switch (Code) {
+  case OpCode::I32__eqz:
+  case OpCode::I64__eqz:
+  case OpCode::I32__clz:
+  case OpCode::I32__ctz:
+  case OpCode::I32__popcnt:
+  case OpCode::I64__clz:
+  case OpCode::I64__ctz:
+  case OpCode::I64__popcnt:
+    return NumericKind::Unary;
+  default:
+    break;
+  }
+  if ((Val >= 0x8BU && Val <= 0x91U) || (Val >= 0x99U && Val <= 0x9FU)) {
+    /// Floating-point unary instructions.
+    return NumericKind::Unary;
+  }
+  return NumericKind::Binary;
+}
+
+/// Check the numeric instruction may trap.
+bool isTrappingNumeric(const OpCode Code) {
+  switch (Code) {
+  case OpCode::I32__div_s:
+  case OpCode::I32__div_u:
+  case OpCode::I32__rem_s:
+  case OpCode::I32__rem_u:
+  case OpCode::I64__div_s:
+  case OpCode::I64__div_u:
+  case OpCode::I64__rem_s:
+  case OpCode::I64__rem_u:
+  case OpCode::I32__trunc_f32_s:
+  case OpCode::I32__trunc_f32_u:
+  case OpCode::I32__trunc_f64_s:
+  case OpCode::I32__trunc_f64_u:
+  case OpCode::I64__trunc_f32_s:
+  case OpCode::I64__trunc_f32_u:
+  case OpCode::I64__trunc_f64_s:
+  case OpCode::I64__trunc_f64_u:
+    return true;
+  default:
+    return false;
+  }
+}
+
+/// Translator from validated Wasm instructions into register IR.
+///
+/// The operand stack is tracked at translation time. An entry records the
+/// register holding its value, which is its own slot register or, for
+/// `local.get` and constants, the local or constant register read lazily.
+/// Lazy entries are written back to their slots before a local is
+/// overwritten, before entering a block, and wherever control flow merges.
+class RegTranslator {
+public:
+  RegTranslator(Runtime::StoreManager &StoreMgr,
+                const Runtime::Instance::ModuleInstance &ModInst,
+                const Runtime::Instance::FunctionInstance &Func)
+      : StoreMgr(StoreMgr), ModInst(ModInst), Func(Func) {}
+
+  /// Translate the function body. Return nullptr if any instruction is not
+  /// supported by the register tier.
+  std::unique_ptr<RegFunction> translate();
+
+private:
+  static inline constexpr const uint32_t NoIndex =
+      std::numeric_limits<uint32_t>::max();
+  /// Flag of patch entries which refer to RegFunction::JumpTable.
+  static inline constexpr const uint32_t TablePatch = 0x80000000U;
+
+  /// Control frame of block, loop, if, and the function body.
+  struct CtrlFrame {
+    CtrlFrame(const OpCode C, const uint32_t H, const uint32_t P,
+              const uint32_t R, const uint32_t A = NoIndex)
+        : Code(C), Height(H), ParamNum(P), ResultNum(R), Anchor(A) {}
+    OpCode Code;
+    /// Operand stack height without the params.
+    uint32_t Height;
+    uint32_t ParamNum;
+    uint32_t ResultNum;
+    /// Start of loop, or the conditional jump of if.
+    uint32_t Anchor;
+    bool HasElse = false;
+    bool Unreachable = false;
+    /// Jumps to be patched to the end of this frame.
+    std::vector<uint32_t> Patches;
+  };
+
+  bool translateInstr(const AST::Instruction &Instr);
+  bool translateEnd();
+  void translateElse();
+
+  std::pair<uint32_t, uint32_t> getBlockArity(const BlockType &BType) const;
+  uint32_t getSlot(const uint32_t Depth) const { return SlotBase + Depth; }
+  bool isFunctionFrame(const CtrlFrame &Frame) const {
+    return &Frame == &Ctrls.front();
+  }
+  CtrlFrame &getCtrl(const uint32_t Depth) {
+    return Ctrls[Ctrls.size() - 1 - Depth];
+  }
+  uint32_t getBranchArity(const CtrlFrame &Frame) const {
+    return Frame.Code == OpCode::Loop ? Frame.ParamNum : Frame.ResultNum;
+  }
+
+  /// \name Operand stack helpers.
+  /// @{
+  uint32_t pop() {
+    const uint32_t Reg = Stack.back();
+    Stack.pop_back();
+    return Reg;
+  }
+  void pushLazy(const uint32_t Reg) {
+    Stack.push_back(Reg);
+    MaxDepth = std::max(MaxDepth, static_cast<uint32_t>(Stack.size()));
+  }
+  uint32_t push() {
+    const uint32_t Reg = getSlot(Stack.size());
+    pushLazy(Reg);
+    return Reg;
+  }
+  void materialize(const uint32_t Depth) {
+    emitMove(getSlot(Depth), Stack[Depth]);
+    Stack[Depth] = getSlot(Depth);
+  }
+  void materializeTop(const uint32_t Cnt) {
+    for (uint32_t D = Stack.size() - Cnt; D < Stack.size(); ++D) {
+      materialize(D);
+    }
+  }
+  void materializeLocals() {
+    for (uint32_t D = 0; D < Stack.size(); ++D) {
+      if (Stack[D] < LocalNum) {
+        materialize(D);
+      }
+    }
+  }
+  void releaseLocal(const uint32_t Idx) {
+    for (uint32_t D = 0; D < Stack.size(); ++D) {
+      if (Stack[D] == Idx) {
+        materialize(D);
+      }
+    }
+  }
+  /// @}
+
+  /// \name Emitting helpers.
+  /// @{
+  void charge(const OpCode Code) {
+    if (Pending.size() == std::numeric_limits<uint16_t>::max()) {
+      emit(OpCode::Nop);
+    }
+    Pending.push_back(Code);
+  }
+  uint32_t emit(const OpCode Code, const uint32_t Dst = 0,
+                const uint32_t A = 0, const uint32_t B = 0,
+                const uint32_t C = 0, const uint32_t Imm = 0) {
+    RegInstr Instr;
+    Instr.Code = Code;
+    Instr.ChargeCnt = static_cast<uint16_t>(Pending.size());
+    Instr.ChargeBegin = static_cast<uint32_t>(Out->Charges.size());
+    Instr.Dst = Dst;
+    Instr.A = A;
+    Instr.B = B;
+    Instr.C = C;
+    Instr.Imm = Imm;
+    Instr.SrcIdx = SrcIdx;
+    Out->Charges.insert(Out->Charges.end(), Pending.begin(), Pending.end());
+    Pending.clear();
+    Out->Instrs.push_back(Instr);
+    LastProducer = NoIndex;
+    return static_cast<uint32_t>(Out->Instrs.size() - 1);
+  }
+  void emitMove(const uint32_t Dst, const uint32_t Src) {
+    if (Dst != Src) {
+      emit(OpCode::Local__set, Dst, Src);
+    }
+  }
+  /// Mark the last emitted instruction as a producer of the top entry whose
+  /// destination can be redirected by a following `local.set`.
+  void markProducer() {
+    LastProducer = static_cast<uint32_t>(Out->Instrs.size() - 1);
+  }
+  /// Get the position of a jump target. The pending charges belong to the
+  /// fall-through path only, so they are flushed before the label.
+  uint32_t label() {
+    if (!Pending.empty()) {
+      emit(OpCode::Nop);
+    }
+    LastProducer = NoIndex;
+    return static_cast<uint32_t>(Out->Instrs.size());
+  }
+  void patch(const uint32_t Site, const uint32_t Target) {
+    if (Site & TablePatch) {
+      Out->JumpTable[Site & ~TablePatch] = Target;
+    } else {
+      Out->Instrs[Site].Imm = Target;
+    }
+  }
+  bool needMoves(const CtrlFrame &Frame) const {
+    const uint32_t Arity = getBranchArity(Frame);
+    for (uint32_t I = 0; I < Arity; ++I) {
+      if (Stack[Stack.size() - Arity + I] != getSlot(Frame.Height + I)) {
+        return true;
+      }
+    }
+    return false;
+  }
+  void emitReturn();
+  void emitBranch(const uint32_t Depth);
+  /// @}
+
+  Runtime::StoreManager &StoreMgr;
+  const Runtime::Instance::ModuleInstance &ModInst;
+  const Runtime::Instance::FunctionInstance &Func;
+  std::unique_ptr<RegFunction> Out;
+  /// Count of params and locals, and the first slot register.
+  uint32_t LocalNum = 0;
+  uint32_t SlotBase = 0;
+  uint32_t MaxDepth = 0;
+  /// Index of the current source instruction.
+  uint32_t SrcIdx = 0;
+  /// Nesting depth of skipped blocks in unreachable code.
+  uint32_t SkipDepth = 0;
+  uint32_t LastProducer = NoIndex;
+  std::vector<uint32_t> Stack;
+  std::vector<CtrlFrame> Ctrls;
+  std::vector<OpCode> Pending;
+};
+
+std::unique_ptr<RegFunction> RegTranslator::translate() {
+  Out = std::make_unique<RegFunction>();
+  const auto &FuncType = Func.getFuncType();
+  Out->Source = Func.getInstrs();
+  Out->ParamNum = static_cast<uint32_t>(FuncType.Params.size());
+  Out->ReturnNum = static_cast<uint32_t>(FuncType.Returns.size());
+
+  /// Registers of locals.
+  LocalNum = Out->ParamNum;
+  for (const auto &Def : Func.getLocals()) {
+    Out->Init.insert(Out->Init.end(), Def.first, ValueFromType(Def.second));
+    LocalNum += Def.first;
+  }
+
+  /// Registers of constants, which are deduplicated by their bits.
+  std::map<std::pair<uint64_t, uint64_t>, uint32_t> ConstRegs;
+  std::vector<uint32_t> InstrConsts(Out->Source.size(), NoIndex);
+  for (uint32_t I = 0; I < Out->Source.size(); ++I) {
+    switch (Out->Source[I].getOpCode()) {
+    case OpCode::I32__const:
+    case OpCode::I64__const:
+    case OpCode::F32__const:
+    case OpCode::F64__const: {
+      const ValVariant Val = Out->Source[I].getNum();
+      std::pair<uint64_t, uint64_t> Key;
+      std::memcpy(&Key.first, &Val, sizeof(uint64_t));
+      std::memcpy(&Key.second, reinterpret_cast<const uint8_t *>(&Val) + 8,
+                  sizeof(uint64_t));
+      auto [It, Added] = ConstRegs.try_emplace(
+          Key, LocalNum + static_cast<uint32_t>(ConstRegs.size()));
+      if (Added) {
+        Out->Init.push_back(Val);
+      }
+      InstrConsts[I] = It->second;
+      break;
+    }
+    default:
+      break;
+    }
+  }
+  SlotBase = LocalNum + static_cast<uint32_t>(ConstRegs.size());
+
+  /// The function body is the outermost block.
+  Ctrls.emplace_back(OpCode::Block, 0, 0, Out->ReturnNum);
+  for (SrcIdx = 0; SrcIdx < Out->Source.size(); ++SrcIdx) {
+    const auto &Instr = Out->Source[SrcIdx];
+    if (InstrConsts[SrcIdx] != NoIndex) {
+      if (!Ctrls.back().Unreachable) {
+        charge(Instr.getOpCode());
+        pushLazy(InstrConsts[SrcIdx]);
+      }
+      continue;
+    }
+    if (!translateInstr(Instr)) {
+      return nullptr;
+    }
+    if (Ctrls.empty()) {
+      break;
+    }
+  }
+
+  Out->RegNum = std::max(SlotBase + MaxDepth, Out->ReturnNum);
+  return std::move(Out);
+}
+
+std::pair<uint32_t, uint32_t>
+RegTranslator::getBlockArity(const BlockType &BType) const {
+  if (std::holds_alternative<ValType>(BType)) {
+    return {0, (std::get<ValType>(BType) == ValType::None) ? 0 : 1};
+  }
+  const auto *FuncType = *ModInst.getFuncType(std::get<uint32_t>(BType));
+  return {static_cast<uint32_t>(FuncType->Params.size()),
+          static_cast<uint32_t>(FuncType->Returns.size())};
+}
+
+void RegTranslator::emitReturn() {
+  const uint32_t Cnt = Out->ReturnNum;
+  if (Cnt <= 1) {
+    emit(OpCode::Return, 0, Cnt ? Stack.back() : 0, Cnt);
+    return;
+  }
+  /// Results are copied to the frame base in order, so they are gathered in
+  /// their slots first to avoid overwriting a param read by a later result.
+  materializeTop(Cnt);
+  emit(OpCode::Return, 0, getSlot(Stack.size() - Cnt), Cnt);
+}
+
+void RegTranslator::emitBranch(const uint32_t Depth) {
+  CtrlFrame &Target = getCtrl(Depth);
+  if (isFunctionFrame(Target)) {
+    emitReturn();
+    return;
+  }
+  /// Move the branch values to the slots of the target. Each value comes from
+  /// a slot not lower than its destination, so moving in order is safe.
+  const uint32_t Arity = getBranchArity(Target);
+  for (uint32_t I = 0; I < Arity; ++I) {
+    emitMove(getSlot(Target.Height + I), Stack[Stack.size() - Arity + I]);
+  }
+  if (Target.Code == OpCode::Loop) {
+    emit(OpCode::Br, 0, 0, 0, 0, Target.Anchor);
+  } else {
+    Target.Patches.push_back(emit(OpCode::Br));
+  }
+}
+
+void RegTranslator::translateElse() {
+  CtrlFrame &Frame = Ctrls.back();
+  if (!Frame.Unreachable) {
+    /// End of the if-statement jumps over the else-statement. It is charged
+    /// as an end instruction.
+    charge(OpCode::End);
+    materializeTop(Frame.ResultNum);
+    Frame.Patches.push_back(emit(OpCode::Br));
+  }
+  Stack.resize(Frame.Height);
+  for (uint32_t I = 0; I < Frame.ParamNum; ++I) {
+    push();
+  }
+  Frame.Unreachable = false;
+  Frame.HasElse = true;
+  patch(Frame.Anchor, label());
+  charge(OpCode::Else);
+}
+
+bool RegTranslator::translateEnd() {
+  CtrlFrame &Frame = Ctrls.back();
+  if (isFunctionFrame(Frame)) {
+    if (!Frame.Unreachable) {
+      charge(OpCode::End);
+      emitReturn();
+    }
+    Ctrls.pop_back();
+    return true;
+  }
+
+  if (Frame.Code == OpCode::If && !Frame.HasElse) {
+    /// Without else-statement, the false condition jumps to the end
+    /// instruction with the params as results.
+    if (!Frame.Unreachable) {
+      materializeTop(Frame.ResultNum);
+    }
+    patch(Frame.Anchor, label());
+    charge(OpCode::End);
+  } else if (!Frame.Unreachable) {
+    charge(OpCode::End);
+    materializeTop(Frame.ResultNum);
+  }
+
+  /// Branches to this block skip the end instruction.
+  if (!Frame.Patches.empty()) {
+    const uint32_t Target = label();
+    for (const uint32_t Site : Frame.Patches) {
+      patch(Site, Target);
+    }
+  }
+
+  Stack.resize(Frame.Height);
+  const uint32_t ResultNum = Frame.ResultNum;
+  Ctrls.pop_back();
+  for (uint32_t I = 0; I < ResultNum; ++I) {
+    push();
+  }
+  return true;
+}
+
+bool RegTranslator::translateInstr(const AST::Instruction &Instr) {
+  const OpCode Code = Instr.getOpCode();
+
+  /// Skip the unreachable instructions until the end of current block.
+  if (Ctrls.back().Unreachable) {
+    switch (Code) {
+    case OpCode::Block:
+    case OpCode::Loop:
+    case OpCode::If:
+      ++SkipDepth;
+      return true;
+    case OpCode::Else:
+      if (SkipDepth == 0) {
+        translateElse();
+      }
+      return true;
+    case OpCode::End:
+      if (SkipDepth > 0) {
+        --SkipDepth;
+        return true;
+      }
+      return translateEnd();
+    default:
+      return true;
+    }
+  }
+
+  switch (NumericKind Kind = getNumericKind(Code)) {
+  case NumericKind::Unary: {
+    charge(Code);
+    const uint32_t A = pop();
+    emit(Code, push(), A);
+    if (!isTrappingNumeric(Code)) {
+      markProducer();
+    }
+    return true;
+  }
+  case NumericKind::Binary: {
+    charge(Code);
+    const uint32_t B = pop();
+    const uint32_t A = pop();
+    emit(Code, push(), A, B);
+    if (!isTrappingNumeric(Code)) {
+      markProducer();
+    }
+    return true;
+  }
+  default:
+    static_cast<void>(Kind);
+    break;
+  }
+
+  switch (Code) {
+  /// Control instructions.
+  case OpCode::Unreachable:
+    charge(Code);
+    emit(Code);
+    Ctrls.back().Unreachable = true;
+    return true;
+  case OpCode::Nop:
+    charge(Code);
+    return true;
+  case OpCode::Block: {
+    const auto [ParamNum, ResultNum] = getBlockArity(Instr.getBlockType());
+    charge(Code);
+    materializeLocals();
+    Ctrls.emplace_back(Code, Stack.size() - ParamNum, ParamNum, ResultNum);
+    return true;
+  }
+  case OpCode::Loop: {
+    const auto [ParamNum, ResultNum] = getBlockArity(Instr.getBlockType());
+    charge(Code);
+    materializeLocals();
+    materializeTop(ParamNum);
+    Ctrls.emplace_back(Code, Stack.size() - ParamNum, ParamNum, ResultNum,
+                       label());
+    return true;
+  }
+  case OpCode::If: {
+    const auto [ParamNum, ResultNum] = getBlockArity(Instr.getBlockType());
+    charge(Code);
+    const uint32_t Cond = pop();
+    materializeLocals();
+    materializeTop(ParamNum);
+    Ctrls.emplace_back(Code, Stack.size() - ParamNum, ParamNum, ResultNum,
+                       emit(OpCode::If, 0, Cond));
+    return true;
+  }
+  case OpCode::Else:
+    translateElse();
+    return true;
+  case OpCode::End:
+    return translateEnd();
+  case OpCode::Br:
+    charge(Code);
+    emitBranch(Instr.getTargetIndex());
+    Ctrls.back().Unreachable = true;
+    return true;
+  case OpCode::Br_if: {
+    charge(Code);
+    const uint32_t Cond = pop();
+    CtrlFrame &Target = getCtrl(Instr.getTargetIndex());
+    if (isFunctionFrame(Target) || needMoves(Target)) {
+      /// Moves of the branch values are only done when taking the branch.
+      const uint32_t Skip = emit(OpCode::If, 0, Cond);
+      emitBranch(Instr.getTargetIndex());
+      patch(Skip, label());
+    } else if (Target.Code == OpCode::Loop) {
+      emit(OpCode::Br_if, 0, Cond, 0, 0, Target.Anchor);
+    } else {
+      Target.Patches.push_back(emit(OpCode::Br_if, 0, Cond));
+    }
+    return true;
+  }
+  case OpCode::Br_table: {
+    charge(Code);
+    const uint32_t Idx = pop();
+    const auto LabelList = Instr.getLabelList();
+    const uint32_t LabelNum = static_cast<uint32_t>(LabelList.size()) - 1;
+    const uint32_t TableBase = static_cast<uint32_t>(Out->JumpTable.size());
+    Out->JumpTable.resize(TableBase + LabelNum + 1, 0);
+    emit(Code, 0, Idx, LabelNum, 0, TableBase);
+    for (uint32_t I = 0; I <= LabelNum; ++I) {
+      const uint32_t Depth = LabelList[I].TargetIndex;
+      CtrlFrame &Target = getCtrl(Depth);
+      if (isFunctionFrame(Target) || needMoves(Target)) {
+        /// Branches with moves jump to a trampoline doing the moves.
+        Out->JumpTable[TableBase + I] = label();
+        emitBranch(Depth);
+      } else if (Target.Code == OpCode::Loop) {
+        Out->JumpTable[TableBase + I] = Target.Anchor;
+      } else {
+        Target.Patches.push_back(TablePatch | (TableBase + I));
+      }
+    }
+    Ctrls.back().Unreachable = true;
+    return true;
+  }
+  case OpCode::Return:
+    charge(Code);
+    emitReturn();
+    Ctrls.back().Unreachable = true;
+    return true;
+  case OpCode::Call: {
+    charge(Code);
+    const uint32_t FuncAddr = *ModInst.getFuncAddr(Instr.getTargetIndex());
+    const auto *FuncInst = *StoreMgr.getFunction(FuncAddr);
+    const auto &FuncType = FuncInst->getFuncType();
+    const uint32_t ParamNum = static_cast<uint32_t>(FuncType.Params.size());
+    materializeTop(ParamNum);
+    const uint32_t Height = static_cast<uint32_t>(Stack.size()) - ParamNum;
+    emit(Code, getSlot(Height), 0, 0, 0, FuncAddr);
+    Stack.resize(Height);
+    for (uint32_t I = 0; I < FuncType.Returns.size(); ++I) {
+      push();
+    }
+    return true;
+  }
+  case OpCode::Call_indirect: {
+    charge(Code);
+    const uint32_t Idx = pop();
+    const auto *FuncType = *ModInst.getFuncType(Instr.getTargetIndex());
+    const uint32_t ParamNum = static_cast<uint32_t>(FuncType->Params.size());
+    materializeTop(ParamNum);
+    const uint32_t Height = static_cast<uint32_t>(Stack.size()) - ParamNum;
+    emit(Code, getSlot(Height), Idx, 0, Instr.getSourceIndex(),
+         Instr.getTargetIndex());
+    Stack.resize(Height);
+    for (uint32_t I = 0; I < FuncType->Returns.size(); ++I) {
+      push();
+    }
+    return true;
+  }
+
+  /// Parametric instructions.
+  case OpCode::Drop:
+    charge(Code);
+    pop();
+    return true;
+  case OpCode::Select:
+  case OpCode::Select_t: {
+    charge(Code);
+    const uint32_t Cond = pop();
+    const uint32_t B = pop();
+    const uint32_t A = pop();
+    emit(OpCode::Select, push(), A, B, Cond);
+    markProducer();
+    return true;
+  }
+
+  /// Variable instructions.
+  case OpCode::Local__get:
+    charge(Code);
+    pushLazy(Instr.getTargetIndex());
+    return true;
+  case OpCode::Local__set:
+  case OpCode::Local__tee: {
+    const uint32_t Idx = Instr.getTargetIndex();
+    const uint32_t Src = Stack.back();
+    if (Src == Idx) {
+      /// Writing a local with its own value.
+      charge(Code);
+      if (Code == OpCode::Local__set) {
+        pop();
+      }
+      return true;
+    }
+    const bool Referred =
+        std::find(Stack.begin(), Stack.end() - 1, Idx) != Stack.end() - 1;
+    if (!Referred && Pending.empty() &&
+        LastProducer + 1 == Out->Instrs.size() &&
+        Out->Instrs.back().Dst == Src &&
+        Out->Instrs.back().ChargeCnt < std::numeric_limits<uint16_t>::max()) {
+      /// Redirect the result of the producer to the local directly.
+      auto &Producer = Out->Instrs.back();
+      Producer.Dst = Idx;
+      Out->Charges.push_back(Code);
+      ++Producer.ChargeCnt;
+      LastProducer = NoIndex;
+      pop();
+      if (Code == OpCode::Local__tee) {
+        pushLazy(Idx);
+      }
+      return true;
+    }
+    charge(Code);
+    releaseLocal(Idx);
+    emit(OpCode::Local__set, Idx, Src);
+    if (Code == OpCode::Local__set) {
+      pop();
+    }
+    return true;
+  }
+  case OpCode::Global__get:
+    charge(Code);
+    emit(Code, push(), 0, 0, 0, *ModInst.getGlobalAddr(Instr.getTargetIndex()));
+    markProducer();
+    return true;
+  case OpCode::Global__set:
+    charge(Code);
+    emit(Code, 0, pop(), 0, 0, *ModInst.getGlobalAddr(Instr.getTargetIndex()));
+    return true;
+
+  /// Memory instructions.
+  case OpCode::I32__load:
+  case OpCode::I64__load:
+  case OpCode::F32__load:
+  case OpCode::F64__load:
+  case OpCode::I32__load8_s:
+  case OpCode::I32__load8_u:
+  case OpCode::I32__load16_s:
+  case OpCode::I32__load16_u:
+  case OpCode::I64__load8_s:
+  case OpCode::I64__load8_u:
+  case OpCode::I64__load16_s:
+  case OpCode::I64__load16_u:
+  case OpCode::I64__load32_s:
+  case OpCode::I64__load32_u: {
+    charge(Code);
+    const uint32_t A = pop();
+    emit(Code, push(), A, 0, 0, Instr.getMemoryOffset());
+    return true;
+  }
+  case OpCode::I32__store:
+  case OpCode::I64__store:
+  case OpCode::F32__store:
+  case OpCode::F64__store:
+  case OpCode::I32__store8:
+  case OpCode::I32__store16:
+  case OpCode::I64__store8:
+  case OpCode::I64__store16:
+  case OpCode::I64__store32: {
+    charge(Code);
+    const uint32_t B = pop();
+    const uint32_t A = pop();
+    emit(Code, 0, A, B, 0, Instr.getMemoryOffset());
+    return true;
+  }
+  case OpCode::Memory__size:
+    charge(Code);
+    emit(Code, push());
+    markProducer();
+    return true;
+  case OpCode::Memory__grow: {
+    charge(Code);
+    const uint32_t A = pop();
+    emit(Code, push(), A);
+    return true;
+  }
+
+  default:
+    /// Reference, table, bulk memory, and SIMD instructions are left to the
+    /// stack-based interpreter.
+    return false;
+  }
+}
+
+} // namespace
+
+const RegFunction *Interpreter::prepareRegFunction(
+    Runtime::StoreManager &StoreMgr, const uint32_t FuncAddr,
+    const Runtime::Instance::FunctionInstance &Func) {
+  {
+    std::shared_lock Lock(RegFuncsMutex);
+    if (auto It = RegFuncs.find(FuncAddr); It != RegFuncs.end()) {
+      return It->second.get();
+    }
+  }
+  /// Translate under the exclusive lock, so each function is translated once.
+  std::unique_lock Lock(RegFuncsMutex);
+  auto [It, Inserted] = RegFuncs.try_emplace(FuncAddr);
+  if (Inserted && Func.isWasmFunction()) {
+    const auto *ModInst = *StoreMgr.getModule(Func.getModuleAddr());
+    RegTranslator Translator(StoreMgr, *ModInst, Func);
+    It->second = Translator.translate();
+  }
+  return It->second.get();
+}
+
+void Interpreter::pruneRegFunctions(const Runtime::StoreManager &StoreMgr) {
+  const uint32_t FuncNum = StoreMgr.getFunctions().size();
+  std::unique_lock Lock(RegFuncsMutex);
+  for (auto It = RegFuncs.begin(); It != RegFuncs.end();) {
+    if (It->first >= FuncNum) {
+      It = RegFuncs.erase(It);
+    } else {
+      ++It;
+    }
+  }
+}
+
+} // namespace Interpreter
+} // namespace SSVM
@@ -0,0 +1,193 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "interpreter/sampler.h"
+
+#include <algorithm>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+/// Older C libraries do not name the thread ID of the signal event.
+#if SSVM_OS_LINUX && !defined(sigev_notify_thread_id)
+#define sigev_notify_thread_id _sigev_un._tid
+#endif
+
+namespace SSVM {
+namespace Interpreter {
+
+Sampler *Sampler::Active = nullptr;
+
+namespace {
+
+/// Round up to the power of two.
+uint32_t roundUpPow2(uint32_t N) {
+  uint32_t P = 1;
+  while (P < N) {
+    P <<= 1;
+  }
+  return P;
+}
+
+} // namespace
+
+Sampler::Sampler(const uint32_t Hz, const uint32_t MaxStacks,
+                 const uint32_t MaxFrames)
+    : Interval(std::max(UINT32_C(1), UINT32_C(1000000) / std::max(Hz, 1U))),
+      Table(roundUpPow2(std::max(MaxStacks, 1U)), Entry{0, 0, 0, 0}),
+      Frames(MaxFrames) {}
+
+bool Sampler::start(const Runtime::StackManager &StackMgr) noexcept {
+  if (Active != nullptr) {
+    return false;
+  }
+  Stack = &StackMgr;
+  Active = this;
+
+  struct sigaction Action {};
+  Action.sa_handler = &signalHandler;
+  Action.sa_flags = SA_RESTART;
+  sigemptyset(&Action.sa_mask);
+  sigaction(SIGPROF, &Action, &OldAction);
+
+#if SSVM_OS_LINUX
+  /// The process-wide profiling timer would signal any thread, including the
+  /// ones not running the stack manager, so the timer of the thread CPU time
+  /// signals this thread only.
+  struct sigevent Event {};
+  Event.sigev_notify = SIGEV_THREAD_ID;
+  Event.sigev_signo = SIGPROF;
+  Event.sigev_notify_thread_id = static_cast<pid_t>(syscall(SYS_gettid));
+  if (timer_create(CLOCK_THREAD_CPUTIME_ID, &Event, &Timer) != 0) {
+    sigaction(SIGPROF, &OldAction, nullptr);
+    Active = nullptr;
+    return false;
+  }
+  struct itimerspec Spec {};
+  Spec.it_interval.tv_sec = Interval / 1000000;
+  Spec.it_interval.tv_nsec = Interval % 1000000 * 1000;
+  Spec.it_value = Spec.it_interval;
+  timer_settime(Timer, 0, &Spec, nullptr);
+#else
+  struct itimerval Timer {};
+  Timer.it_interval.tv_sec = Interval / 1000000;
+  Timer.it_interval.tv_usec = Interval % 1000000;
+  Timer.it_value = Timer.it_interval;
+  setitimer(ITIMER_PROF, &Timer, nullptr);
+#endif
+  return true;
+}
+
+void Sampler::stop() noexcept {
+  if (Active != this) {
+    return;
+  }
+#if SSVM_OS_LINUX
+  timer_delete(Timer);
+#else
+  struct itimerval Timer {};
+  setitimer(ITIMER_PROF, &Timer, nullptr);
+#endif
+
+  /// The default action of SIGPROF terminates the process, so a signal still
+  /// pending is discarded by ignoring it instead.
+  if (OldAction.sa_handler == SIG_DFL &&
+      !(OldAction.sa_flags & SA_SIGINFO)) {
+    std::signal(SIGPROF, SIG_IGN);
+  } else {
+    sigaction(SIGPROF, &OldAction, nullptr);
+  }
+  Active = nullptr;
+}
+
+void Sampler::signalHandler(int) noexcept {
+  if (Sampler *S = Active) {
+    S->record();
+  }
+}
+
+void Sampler::record() noexcept {
+  /// Collect the function frames from the innermost one.
+  const auto StackFrames = Stack->getFrames();
+  uint32_t Buf[kMaxDepth];
+  uint32_t Depth = 0;
+  for (size_t I = StackFrames.size(); I > 0 && Depth < kMaxDepth; --I) {
+    const uint32_t Addr = StackFrames[I - 1].FuncAddr;
+    if (Addr != Runtime::StackManager::kNoFunction) {
+      Buf[Depth++] = Addr;
+    }
+  }
+  if (Depth == 0) {
+    /// Not in a Wasm function.
+    return;
+  }
+  ++SampleCnt;
+  std::reverse(Buf, Buf + Depth);
+
+  /// FNV-1a hash of the stack.
+  uint64_t Hash = UINT64_C(14695981039346656037);
+  for (uint32_t I = 0; I < Depth; ++I) {
+    Hash = (Hash ^ Buf[I]) * UINT64_C(1099511628211);
+  }
+
+  const size_t Mask = Table.size() - 1;
+  for (size_t Probe = 0; Probe < Table.size(); ++Probe) {
+    Entry &E = Table[(Hash + Probe) & Mask];
+    if (E.Count == 0) {
+      /// New stack.
+      if (Frames.size() - FrameUsed < Depth) {
+        break;
+      }
+      std::copy(Buf, Buf + Depth, Frames.begin() + FrameUsed);
+      E.Hash = Hash;
+      E.Offset = FrameUsed;
+      E.Depth = Depth;
+      E.Count = 1;
+      FrameUsed += Depth;
+      return;
+    }
+    if (E.Hash == Hash && E.Depth == Depth &&
+        std::equal(Buf, Buf + Depth, Frames.begin() + E.Offset)) {
+      ++E.Count;
+      return;
+    }
+  }
+  ++DroppedCnt;
+}
+
+void Sampler::dumpFolded(std::ostream &OS,
+                         Span<const std::string> FuncNames) const {
+  auto Name = [&FuncNames](uint32_t Addr) -> std::string {
+    std::string Str;
+    if (Addr < FuncNames.size() && !FuncNames[Addr].empty()) {
+      Str = FuncNames[Addr];
+      /// Semicolons separate the frames.
+      std::replace(Str.begin(), Str.end(), ';', ':');
+    } else {
+      Str = "addr[" + std::to_string(Addr) + "]";
+    }
+    return Str;
+  };
+
+  std::vector<std::string> Lines;
+  for (const auto &E : Table) {
+    if (E.Count == 0) {
+      continue;
+    }
+    std::string Line;
+    for (uint32_t I = 0; I < E.Depth; ++I) {
+      if (I > 0) {
+        Line += ';';
+      }
+      Line += Name(Frames[E.Offset + I]);
+    }
+    Line += ' ';
+    Line += std::to_string(E.Count);
+    Lines.push_back(std::move(Line));
+  }
+  std::sort(Lines.begin(), Lines.end());
+  for (const auto &Line : Lines) {
+    OS << Line << '\n';
+  }
+}
+
+} // namespace Interpreter
+} // namespace SSVM
@@ -0,0 +1,103 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "interpreter/tiering.h"
+#include "aot/version.h"
+#include "common/log.h"
+
+#include <cstdlib>
+#include <string>
+#include <unistd.h>
+
+namespace SSVM {
+namespace Interpreter {
+
+void Tiering::attach(const AST::Module &Mod,
+                     const Runtime::Instance::ModuleInstance &ModInst) {
+  Entries.clear();
+  const auto FuncTypes = Mod.getFunctionSection().getContent();
+  const uint32_t ImportNum = ModInst.getFuncImportNum();
+  for (uint32_t I = 0; I < FuncTypes.size(); ++I) {
+    if (auto Addr = ModInst.getFuncAddr(ImportNum + I)) {
+      Entries.emplace(*Addr, std::make_pair(I, FuncTypes[I]));
+    }
+  }
+}
+
+bool Tiering::tierUp(const uint32_t FuncAddr,
+                     const Runtime::Instance::FunctionInstance &Func) {
+  switch (State.load(std::memory_order_acquire)) {
+  case StateType::Idle:
+    if (!Entries.empty()) {
+      State.store(StateType::Compiling, std::memory_order_relaxed);
+      Worker = std::thread(&Tiering::run, this);
+    }
+    return false;
+  case StateType::Compiled:
+    break;
+  default:
+    return false;
+  }
+
+  /// The functions of the other modules keep running in the interpreter.
+  const auto It = Entries.find(FuncAddr);
+  if (It == Entries.end()) {
+    return false;
+  }
+  const auto [CodeIdx, TypeIdx] = It->second;
+  Func.setTieredCode(Types.index(TypeIdx).deref(),
+                     Codes.index(CodeIdx).deref());
+  return true;
+}
+
+void Tiering::wait() noexcept {
+  if (Worker.joinable()) {
+    Worker.join();
+  }
+}
+
+void Tiering::run() noexcept {
+  /// The library is created in a private directory, so no other user can
+  /// replace it before loading. Both are removed after loading, as the library
+  /// stays mapped.
+  std::error_code Error;
+  std::string Dir =
+      (std::filesystem::temp_directory_path(Error) / "ssvm-tiering-XXXXXX")
+          .string();
+  if (Error || ::mkdtemp(Dir.data()) == nullptr) {
+    LOG(ERROR) << ErrCode::InvalidPath;
+    State.store(StateType::Failed, std::memory_order_release);
+    return;
+  }
+  const std::filesystem::path Path = std::filesystem::path(Dir) / "module.so";
+  auto Res = [&]() -> Expect<void> {
+    if (auto Res = Compile(Path); !Res) {
+      return Unexpect(Res);
+    }
+    if (auto Res = Library.setPath(Path); !Res) {
+      return Unexpect(Res);
+    }
+    if (auto Res = Library.getVersion(); !Res) {
+      return Unexpect(Res);
+    } else if (*Res != AOT::kBinaryVersion) {
+      LOG(ERROR) << ErrInfo::InfoMismatch(AOT::kBinaryVersion, *Res);
+      return Unexpect(ErrCode::InvalidVersion);
+    }
+    Codes = Library.getSymbol<void *[]>("codes");
+    Types = Library.getSymbol<AST::FunctionType::Wrapper *[]>("types");
+    if (!Codes || !Types) {
+      return Unexpect(ErrCode::InvalidGrammar);
+    }
+    return {};
+  }();
+  std::filesystem::remove(Path, Error);
+  std::filesystem::remove(Dir, Error);
+
+  if (!Res) {
+    /// The functions keep running in the interpreter.
+    LOG(ERROR) << Res.error();
+  }
+  State.store(Res ? StateType::Compiled : StateType::Failed,
+              std::memory_order_release);
+}
+
+} // namespace Interpreter
+} // namespace SSVM
@@ -0,0 +1,33 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "runtime/instance/type.h"
+
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace SSVM {
+namespace Runtime {
+namespace Instance {
+
+/// Intern the function signature. See "include/runtime/instance/type.h".
+uint32_t getCanonicalTypeID(Span<const ValType> P, Span<const ValType> R) {
+  /// The table is local to be ready for the types of the static instances.
+  static std::mutex Mutex;
+  static std::unordered_map<std::string, uint32_t> TypeIDs;
+  /// Value types are non-zero bytes, so a zero byte separates the lists.
+  std::string Key;
+  Key.reserve(P.size() + R.size() + 1);
+  for (const auto Type : P) {
+    Key.push_back(static_cast<char>(Type));
+  }
+  Key.push_back('\0');
+  for (const auto Type : R) {
+    Key.push_back(static_cast<char>(Type));
+  }
+  std::lock_guard<std::mutex> Lock(Mutex);
+  return TypeIDs.try_emplace(std::move(Key), TypeIDs.size()).first->second;
+}
+
+} // namespace Instance
+} // namespace Runtime
+} // namespace SSVM
@@ -2,6 +2,8 @@
 #include "validator/formchecker.h"
 #include "ast/module.h"
 
+#include <algorithm>
+
 namespace {
 template <typename... Ts> struct overloaded : Ts... {
   using Ts::operator()...;
@@ -14,9 +16,11 @@ namespace Validator {
 
 void FormChecker::reset(bool CleanGlobal) {
   ValStack.clear();
+  MaxHeight = 0;
   CtrlStack.clear();
   Locals.clear();
   Returns.clear();
+  Jumps.clear();
 
   if (CleanGlobal) {
     Types.clear();
@@ -173,9 +177,22 @@ ValType FormChecker::VTypeToAST(const VType &V) {
   }
 }
 
+void FormChecker::writeJumps(Span<AST::Instruction> Instrs) const {
+  for (const auto &J : Jumps) {
+    auto &Instr = Instrs[J.InstrIdx];
+    if (Instr.getOpCode() == OpCode::Br_table) {
+      Instr.getLabelList()[J.LabelIdx] = J.Jump;
+    } else {
+      Instr.getJump() = J.Jump;
+    }
+  }
+}
+
 Expect<void> FormChecker::checkExpr(AST::InstrView Instrs) {
-  /// Push ctrl frame ([] -> [Returns])
-  pushCtrl({}, Returns);
+  ExprBegin = Instrs.data();
+  /// Push ctrl frame ([] -> [Returns]) with the last End as the branch target.
+  pushCtrl({}, Returns,
+           Instrs.size() > 0 ? &Instrs[Instrs.size() - 1] : nullptr);
   return checkInstrs(Instrs);
 }
 
@@ -299,7 +316,11 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
       return Unexpect(Res);
     }
     /// Push ctrl frame ([t1*], [t2*])
-    pushCtrl(T1, T2, Instr.getOpCode());
+    const AST::Instruction *Jump = &Instr;
+    if (Instr.getOpCode() != OpCode::Loop) {
+      Jump += Instr.getJumpEnd();
+    }
+    pushCtrl(T1, T2, Jump, Instr.getOpCode());
     if (Instr.getOpCode() == OpCode::If &&
         Instr.getJumpElse() == Instr.getJumpEnd()) {
       /// No else case in if-else statement.
@@ -312,7 +333,8 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
 
   case OpCode::Else:
     if (auto Res = popCtrl()) {
-      pushCtrl((*Res).StartTypes, (*Res).EndTypes, Instr.getOpCode());
+      pushCtrl((*Res).StartTypes, (*Res).EndTypes, (*Res).Jump,
+               Instr.getOpCode());
     } else {
       return Unexpect(Res);
     }
@@ -328,6 +350,7 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
   case OpCode::Br:
     if (auto D = checkCtrlStackDepth(Instr.getTargetIndex())) {
       /// D is the last D element of control stack.
+      addJump(Instr, 0, Instr.getTargetIndex(), CtrlStack[*D]);
       if (auto Res = popTypes(getLabelTypes(CtrlStack[*D]))) {
         return unreachable();
       } else {
@@ -342,6 +365,7 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
       if (auto Res = popType(VType::I32); !Res) {
         return Unexpect(Res);
       }
+      addJump(Instr, 0, Instr.getTargetIndex(), CtrlStack[*D]);
       if (auto Res = popTypes(getLabelTypes(CtrlStack[*D]))) {
         pushTypes(getLabelTypes(CtrlStack[*D]));
         return {};
@@ -354,8 +378,8 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
   case OpCode::Br_table:
     if (auto M = checkCtrlStackDepth(Instr.getTargetIndex())) {
       /// M is the last M element of control stack.
-      for (const uint32_t &L : Instr.getLabelList()) {
-        if (auto N = checkCtrlStackDepth(L)) {
+      for (const auto &L : Instr.getLabelList()) {
+        if (auto N = checkCtrlStackDepth(L.TargetIndex)) {
           /// N is the last N element of control stack.
           if (auto Res = checkTypesMatching(getLabelTypes(CtrlStack[*M]),
                                             getLabelTypes(CtrlStack[*N]));
@@ -369,6 +393,11 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
       if (auto Res = popType(VType::I32); !Res) {
         return Unexpect(Res);
       }
+      const auto Labels = Instr.getLabelList();
+      for (uint32_t I = 0; I < Labels.size(); ++I) {
+        const uint32_t Target = Labels[I].TargetIndex;
+        addJump(Instr, I, Target, CtrlStack[CtrlStack.size() - 1 - Target]);
+      }
       if (auto Res = popTypes(getLabelTypes(CtrlStack[*M])); !Res) {
         return Unexpect(Res);
       }
@@ -383,7 +412,8 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
     }
     return unreachable();
 
-  case OpCode::Call: {
+  case OpCode::Call:
+  case OpCode::Return_call: {
     auto N = Instr.getTargetIndex();
     if (Funcs.size() <= N) {
       /// Call function index out of range
@@ -392,9 +422,13 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
                                              N, Funcs.size());
       return Unexpect(ErrCode::InvalidFuncIdx);
     }
+    if (Instr.getOpCode() == OpCode::Return_call) {
+      return checkTailCall(Types[Funcs[N]].first, Types[Funcs[N]].second);
+    }
     return StackTrans(Types[Funcs[N]].first, Types[Funcs[N]].second);
   }
-  case OpCode::Call_indirect: {
+  case OpCode::Call_indirect:
+  case OpCode::Return_call_indirect: {
     auto N = Instr.getTargetIndex();
     auto T = Instr.getSourceIndex();
     /// Check source table index.
@@ -418,6 +452,9 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
     if (auto Res = popType(VType::I32); !Res) {
       return Unexpect(Res);
     }
+    if (Instr.getOpCode() == OpCode::Return_call_indirect) {
+      return checkTailCall(Types[N].first, Types[N].second);
+    }
     return StackTrans(Types[N].first, Types[N].second);
   }
 
@@ -1179,7 +1216,10 @@ Expect<void> FormChecker::checkInstr(const AST::Instruction &Instr) {
   }
 }
 
-void FormChecker::pushType(VType V) { ValStack.emplace_back(V); }
+void FormChecker::pushType(VType V) {
+  ValStack.emplace_back(V);
+  MaxHeight = std::max(MaxHeight, ValStack.size());
+}
 
 void FormChecker::pushTypes(Span<const VType> Input) {
   for (auto Val : Input) {
@@ -1232,8 +1272,8 @@ Expect<void> FormChecker::popTypes(Span<const VType> Input) {
 }
 
 void FormChecker::pushCtrl(Span<const VType> In, Span<const VType> Out,
-                           OpCode Code) {
-  CtrlStack.emplace_back(In, Out, ValStack.size(), Code);
+                           const AST::Instruction *Jump, OpCode Code) {
+  CtrlStack.emplace_back(In, Out, Jump, ValStack.size(), Code);
   pushTypes(In);
 }
 
@@ -1265,6 +1305,17 @@ Span<const VType> FormChecker::getLabelTypes(const FormChecker::CtrlFrame &F) {
   return F.EndTypes;
 }
 
+void FormChecker::addJump(const AST::Instruction &Instr,
+                          const uint32_t LabelIdx, const uint32_t TargetIndex,
+                          const CtrlFrame &F) {
+  /// Keep the label values and erase the others above the frame height.
+  const auto Arity = static_cast<uint32_t>(getLabelTypes(F).size());
+  Jumps.push_back({static_cast<uint32_t>(&Instr - ExprBegin), LabelIdx,
+                   {TargetIndex,
+                    static_cast<uint32_t>(ValStack.size() - F.Height), Arity,
+                    static_cast<int32_t>(F.Jump - &Instr)}});
+}
+
 Expect<void> FormChecker::unreachable() {
   while (ValStack.size() > CtrlStack.back().Height) {
     if (auto Res = popType(); !Res) {
@@ -1284,6 +1335,19 @@ Expect<void> FormChecker::StackTrans(Span<const VType> Take,
   return {};
 }
 
+Expect<void> FormChecker::checkTailCall(Span<const VType> Take,
+                                        Span<const VType> Put) {
+  /// The results of the callee are returned from the current function.
+  if (!std::equal(Put.begin(), Put.end(), Returns.cbegin(), Returns.cend())) {
+    LOG(ERROR) << ErrCode::TypeCheckFailed;
+    return Unexpect(ErrCode::TypeCheckFailed);
+  }
+  if (auto Res = popTypes(Take); !Res) {
+    return Unexpect(Res);
+  }
+  return unreachable();
+}
+
 Expect<std::pair<Span<const VType>, Span<const VType>>>
 FormChecker::resolveBlockType(std::vector<VType> &Buffer, BlockType Type) {
   using ReturnType = std::pair<Span<const VType>, Span<const VType>>;
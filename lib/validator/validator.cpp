@@ -10,7 +10,7 @@ namespace SSVM {
 namespace Validator {
 
 /// Validate Module. See "include/validator/validator.h".
-Expect<void> Validator::validate(const AST::Module &Mod) {
+Expect<void> Validator::validate(AST::Module &Mod) {
   /// https://webassembly.github.io/spec/core/valid/modules.html
   Checker.reset(true);
 
@@ -196,7 +196,7 @@ Expect<void> Validator::validate(const AST::ElementSegment &ElemSeg) {
 }
 
 /// Validate Code segment. See "include/validator/validator.h".
-Expect<void> Validator::validate(const AST::CodeSegment &CodeSeg,
+Expect<void> Validator::validate(AST::CodeSegment &CodeSeg,
                                  const uint32_t TypeIdx) {
   /// Reset stack in FormChecker.
   Checker.reset();
@@ -217,6 +217,12 @@ Expect<void> Validator::validate(const AST::CodeSegment &CodeSeg,
     LOG(ERROR) << ErrInfo::InfoAST(ASTNodeAttr::Expression);
     return Unexpect(Res);
   }
+  /// Annotate the branches with the targets resolved in validation.
+  Checker.writeJumps(CodeSeg.getInstrs());
+  /// Fuse the superinstructions once for all instances of the module.
+  AST::fuseSuperInstructions(CodeSeg.getInstrs());
+  /// Record the value stack usage for the frame size at runtime.
+  CodeSeg.setMaxStackHeight(Checker.getMaxStackHeight());
   return {};
 }
 
@@ -416,8 +422,8 @@ Expect<void> Validator::validate(const AST::ElementSection &ElemSec) {
 }
 
 /// Validate Code section. See "include/validator/validator.h".
-Expect<void> Validator::validate(const AST::CodeSection &CodeSec) {
-  const auto &CodeVec = CodeSec.getContent();
+Expect<void> Validator::validate(AST::CodeSection &CodeSec) {
+  auto &CodeVec = CodeSec.getContent();
   const auto &FuncVec = Checker.getFunctions();
 
   /// Validate function body.
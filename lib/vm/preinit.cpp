@@ -0,0 +1,393 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "vm/preinit.h"
+#include "ast/module.h"
+#include "ast/section.h"
+#include "common/log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <utility>
+
+#include <sys/mman.h>
+
+namespace SSVM {
+namespace VM {
+
+namespace {
+
+/// Zero bytes between two non-zero runs shorter than the gap are kept in one
+/// data segment, so the memory is not split into too many segments.
+constexpr uint64_t kMaxSegmentGap = 64;
+
+void writeU32(std::vector<Byte> &Out, uint32_t Val) {
+  do {
+    Byte B = Val & 0x7F;
+    Val >>= 7;
+    if (Val != 0) {
+      B |= 0x80;
+    }
+    Out.push_back(B);
+  } while (Val != 0);
+}
+
+void writeS64(std::vector<Byte> &Out, int64_t Val) {
+  while (true) {
+    Byte B = Val & 0x7F;
+    Val >>= 7;
+    if ((Val == 0 && !(B & 0x40)) || (Val == -1 && (B & 0x40))) {
+      Out.push_back(B);
+      return;
+    }
+    Out.push_back(B | 0x80);
+  }
+}
+
+void writeBytes(std::vector<Byte> &Out, const void *Data, const size_t Size) {
+  const auto *Ptr = static_cast<const Byte *>(Data);
+  Out.insert(Out.end(), Ptr, Ptr + Size);
+}
+
+Expect<uint32_t> readU32(Span<const Byte> Code, size_t &Off) {
+  uint32_t Val = 0;
+  for (uint32_t Shift = 0; Shift < 35 && Off < Code.size(); Shift += 7) {
+    const Byte B = Code[Off++];
+    Val |= static_cast<uint32_t>(B & 0x7F) << Shift;
+    if (!(B & 0x80)) {
+      return Val;
+    }
+  }
+  LOG(ERROR) << ErrCode::InvalidGrammar;
+  return Unexpect(ErrCode::InvalidGrammar);
+}
+
+using SectionList = std::vector<std::pair<Byte, std::vector<Byte>>>;
+
+/// Split the sections of the binary after the header.
+Expect<SectionList> splitSections(Span<const Byte> Code) {
+  if (Code.size() < 8) {
+    LOG(ERROR) << ErrCode::InvalidMagic;
+    return Unexpect(ErrCode::InvalidMagic);
+  }
+  SectionList Sections;
+  for (size_t Off = 8; Off < Code.size();) {
+    const Byte Id = Code[Off++];
+    auto Size = readU32(Code, Off);
+    if (!Size || Off + *Size > Code.size()) {
+      LOG(ERROR) << ErrCode::SectionSizeMismatch;
+      return Unexpect(ErrCode::SectionSizeMismatch);
+    }
+    Sections.emplace_back(
+        Id, std::vector<Byte>(Code.begin() + Off, Code.begin() + Off + *Size));
+    Off += *Size;
+  }
+  return Sections;
+}
+
+/// Write the header of the binary and the sections.
+std::vector<Byte> joinSections(Span<const Byte> Code,
+                               const SectionList &Sections) {
+  std::vector<Byte> Out(Code.begin(), Code.begin() + 8);
+  for (const auto &[Id, Content] : Sections) {
+    Out.push_back(Id);
+    writeU32(Out, Content.size());
+    Out.insert(Out.end(), Content.begin(), Content.end());
+  }
+  return Out;
+}
+
+/// Constant expression of the global value.
+Expect<void> writeConst(std::vector<Byte> &Out, const ValType Type,
+                        const ValVariant &Val) {
+  switch (Type) {
+  case ValType::I32:
+    Out.push_back(0x41);
+    writeS64(Out, static_cast<int32_t>(std::get<uint32_t>(Val)));
+    break;
+  case ValType::I64:
+    Out.push_back(0x42);
+    writeS64(Out, static_cast<int64_t>(std::get<uint64_t>(Val)));
+    break;
+  case ValType::F32:
+    Out.push_back(0x43);
+    writeBytes(Out, &Val, 4);
+    break;
+  case ValType::F64:
+    Out.push_back(0x44);
+    writeBytes(Out, &Val, 8);
+    break;
+  case ValType::V128:
+    Out.push_back(0xFD);
+    writeU32(Out, 0x0C);
+    writeBytes(Out, &Val, 16);
+    break;
+  case ValType::FuncRef:
+  case ValType::ExternRef:
+    if (isNullRef(Val)) {
+      Out.push_back(0xD0);
+      Out.push_back(static_cast<Byte>(Type));
+    } else if (Type == ValType::FuncRef) {
+      Out.push_back(0xD2);
+      writeU32(Out, retrieveFuncIdx(Val));
+    } else {
+      /// The host references cannot be written.
+      LOG(ERROR) << ErrCode::InvalidRefType;
+      return Unexpect(ErrCode::InvalidRefType);
+    }
+    break;
+  default:
+    LOG(ERROR) << ErrCode::InvalidGrammar;
+    return Unexpect(ErrCode::InvalidGrammar);
+  }
+  Out.push_back(0x0B);
+  return {};
+}
+
+std::vector<Byte> writeMemorySection(const AST::Module &Mod,
+                                     const Runtime::Snapshot &Snap) {
+  std::vector<Byte> Out;
+  const auto Mems = Mod.getMemorySection().getContent();
+  writeU32(Out, Mems.size());
+  for (const auto &MemType : Mems) {
+    const auto &Lim = MemType.getLimit();
+    Out.push_back(Lim.hasMax() ? 0x01 : 0x00);
+    writeU32(Out, Snap.MemoryPages);
+    if (Lim.hasMax()) {
+      writeU32(Out, Lim.getMax());
+    }
+  }
+  return Out;
+}
+
+Expect<std::vector<Byte>> writeGlobalSection(const AST::Module &Mod,
+                                             const Runtime::Snapshot &Snap) {
+  std::vector<Byte> Out;
+  const auto Globs = Mod.getGlobalSection().getContent();
+  writeU32(Out, Globs.size());
+  for (uint32_t I = 0; I < Globs.size(); ++I) {
+    const auto &GlobType = Globs[I].getGlobalType();
+    Out.push_back(static_cast<Byte>(GlobType.getValueType()));
+    Out.push_back(static_cast<Byte>(GlobType.getValueMutation()));
+    if (auto Res = writeConst(Out, GlobType.getValueType(), Snap.Globals[I]);
+        !Res) {
+      return Unexpect(Res);
+    }
+  }
+  return Out;
+}
+
+/// Copy the exports except the initializer.
+Expect<std::vector<Byte>> writeExportSection(Span<const Byte> Content,
+                                             std::string_view InitFunc) {
+  std::vector<Byte> Entries;
+  uint32_t Count = 0;
+  size_t Off = 0;
+  auto Num = readU32(Content, Off);
+  if (!Num) {
+    return Unexpect(Num);
+  }
+  for (uint32_t I = 0; I < *Num; ++I) {
+    const size_t Start = Off;
+    auto Len = readU32(Content, Off);
+    if (!Len || Off + *Len >= Content.size()) {
+      LOG(ERROR) << ErrCode::InvalidGrammar;
+      return Unexpect(ErrCode::InvalidGrammar);
+    }
+    const std::string_view Name(reinterpret_cast<const char *>(&Content[Off]),
+                                *Len);
+    Off += *Len;
+    const Byte Kind = Content[Off++];
+    if (auto Idx = readU32(Content, Off); !Idx) {
+      return Unexpect(Idx);
+    }
+    if (Kind == 0x00 && Name == InitFunc) {
+      continue;
+    }
+    Entries.insert(Entries.end(), Content.begin() + Start,
+                   Content.begin() + Off);
+    ++Count;
+  }
+  std::vector<Byte> Out;
+  writeU32(Out, Count);
+  Out.insert(Out.end(), Entries.begin(), Entries.end());
+  return Out;
+}
+
+/// Write the non-zero runs of the memory as the active data segments. If the
+/// indices of the segments are kept, the passive segments are placed first,
+/// and the dropped or active ones are left empty.
+std::pair<uint32_t, std::vector<Byte>>
+writeDataSection(const AST::Module &Mod, const Runtime::Snapshot &Snap,
+                 Span<const Byte> Memory, const bool KeepIndices) {
+  uint32_t Count = 0;
+  std::vector<Byte> Segs;
+  if (KeepIndices) {
+    const auto Datas = Mod.getDataSection().getContent();
+    for (uint32_t I = 0; I < Datas.size(); ++I) {
+      Segs.push_back(0x01);
+      if (Datas[I].getMode() == AST::DataSegment::DataMode::Passive &&
+          !Snap.DroppedData[I]) {
+        const auto Data = Datas[I].getData();
+        writeU32(Segs, Data.size());
+        Segs.insert(Segs.end(), Data.begin(), Data.end());
+      } else {
+        writeU32(Segs, 0);
+      }
+      ++Count;
+    }
+  }
+
+  uint64_t I = 0;
+  while (I < Memory.size()) {
+    while (I < Memory.size() && Memory[I] == 0) {
+      ++I;
+    }
+    if (I == Memory.size()) {
+      break;
+    }
+    const uint64_t Start = I;
+    uint64_t End = I;
+    while (I < Memory.size()) {
+      if (Memory[I] != 0) {
+        End = ++I;
+      } else if (I - End >= kMaxSegmentGap) {
+        break;
+      } else {
+        ++I;
+      }
+    }
+    Segs.push_back(0x00);
+    Segs.push_back(0x41);
+    writeS64(Segs, static_cast<int32_t>(Start));
+    Segs.push_back(0x0B);
+    writeU32(Segs, End - Start);
+    Segs.insert(Segs.end(), Memory.begin() + Start, Memory.begin() + End);
+    ++Count;
+  }
+
+  std::vector<Byte> Out;
+  writeU32(Out, Count);
+  Out.insert(Out.end(), Segs.begin(), Segs.end());
+  return {Count, std::move(Out)};
+}
+
+bool isSameTables(const Runtime::Snapshot &Base,
+                  const Runtime::Snapshot &Snap) {
+  if (Base.Tables.size() != Snap.Tables.size()) {
+    return false;
+  }
+  for (uint32_t I = 0; I < Base.Tables.size(); ++I) {
+    const auto &A = Base.Tables[I];
+    const auto &B = Snap.Tables[I];
+    if (A.size() != B.size() ||
+        std::memcmp(A.data(), B.data(), A.size() * sizeof(RefVariant)) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+} // namespace
+
+Expect<std::vector<Byte>> preinitialize(Span<const Byte> Code,
+                                        const Runtime::Snapshot &Base,
+                                        const Runtime::Snapshot &Snap,
+                                        std::string_view InitFunc) {
+  const auto &Mod = *Snap.Module;
+  if (!isSameTables(Base, Snap) ||
+      Base.DroppedElements != Snap.DroppedElements) {
+    LOG(ERROR) << "Tables changed by the start function or the initializer "
+                  "are not supported.";
+    return Unexpect(ErrCode::WrongInstanceAddress);
+  }
+
+  auto Sections = splitSections(Code);
+  if (!Sections) {
+    return Unexpect(Sections);
+  }
+  bool HasDataCount = false;
+  for (const auto &Sec : *Sections) {
+    HasDataCount |= Sec.first == 12;
+  }
+
+  /// Read the memory from the file of the snapshot.
+  const uint64_t MemSize = Snap.MemoryPages * UINT64_C(65536);
+  const Byte *Memory = nullptr;
+  if (MemSize > 0) {
+    void *Ptr =
+        mmap(nullptr, MemSize, PROT_READ, MAP_PRIVATE, Snap.MemoryFd, 0);
+    if (Ptr == MAP_FAILED) {
+      LOG(ERROR) << "mmap failed";
+      return Unexpect(ErrCode::MemoryOutOfBounds);
+    }
+    Memory = static_cast<const Byte *>(Ptr);
+  }
+  auto [DataCount, DataSec] = writeDataSection(
+      Mod, Snap, Span<const Byte>(Memory, MemSize), HasDataCount);
+  if (Memory) {
+    munmap(const_cast<Byte *>(Memory), MemSize);
+  }
+
+  bool HasData = false;
+  for (auto It = Sections->begin(); It != Sections->end();) {
+    auto &[Id, Content] = *It;
+    switch (Id) {
+    case 5:
+      Content = writeMemorySection(Mod, Snap);
+      break;
+    case 6:
+      if (auto Res = writeGlobalSection(Mod, Snap)) {
+        Content = std::move(*Res);
+      } else {
+        return Unexpect(Res);
+      }
+      break;
+    case 7:
+      if (auto Res = writeExportSection(Content, InitFunc)) {
+        Content = std::move(*Res);
+      } else {
+        return Unexpect(Res);
+      }
+      break;
+    case 8:
+      /// The start function has run already.
+      It = Sections->erase(It);
+      continue;
+    case 11:
+      Content = DataSec;
+      HasData = true;
+      break;
+    case 12:
+      Content.clear();
+      writeU32(Content, DataCount);
+      break;
+    default:
+      break;
+    }
+    ++It;
+  }
+  if (!HasData && DataCount > 0) {
+    /// The data section is the last one except the custom sections.
+    auto It = Sections->end();
+    while (It != Sections->begin() && std::prev(It)->first == 0) {
+      --It;
+    }
+    Sections->emplace(It, 11, std::move(DataSec));
+  }
+  return joinSections(Code, *Sections);
+}
+
+Expect<std::vector<Byte>> removeStart(Span<const Byte> Code) {
+  auto Sections = splitSections(Code);
+  if (!Sections) {
+    return Unexpect(Sections);
+  }
+  const auto IsStart = [](const auto &Sec) { return Sec.first == 8; };
+  Sections->erase(
+      std::remove_if(Sections->begin(), Sections->end(), IsStart),
+      Sections->end());
+  return joinSections(Code, *Sections);
+}
+
+} // namespace VM
+} // namespace SSVM
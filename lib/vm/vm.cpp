@@ -3,6 +3,10 @@
 #include "common/log.h"
 #include "host/ssvm_process/processmodule.h"
 #include "host/wasi/wasimodule.h"
+#if SSVM_ENABLE_AOT
+#include "aot/cache.h"
+#include "aot/compiler.h"
+#endif
 
 namespace SSVM {
 namespace VM {
@@ -36,6 +40,64 @@ void VM::initVM() {
   }
 }
 
+Expect<void> VM::compileJIT(AST::Module &Module) {
+  /// The modules loaded from the shared libraries are compiled already.
+  if (const auto &CodeSegs = Module.getCodeSection().getContent();
+      !CodeSegs.empty() && CodeSegs[0].getSymbol()) {
+    return {};
+  }
+#if SSVM_ENABLE_AOT
+  AOT::Compiler Compiler;
+  Compiler.setInstructionCounting(Conf.isInstructionCounting() ||
+                                  Stat.isProfiling());
+  Compiler.setGasMeasuring(Conf.isCostMeasuring() || Stat.isCostMetered());
+  return Compiler.compileJIT(Module, Conf.isLazyJIT());
+#else
+  LOG(ERROR) << "JIT is not built, the module is interpreted.";
+  return {};
+#endif
+}
+
+Expect<std::unique_ptr<AST::Module>>
+VM::parseModule(const std::filesystem::path &Path) {
+  using namespace std::literals;
+  if (Conf.getAOTCache().empty() || Path.extension() == ".so"sv) {
+    return LoaderEngine.parseModule(Path);
+  }
+  if (auto Code = LoaderEngine.loadFile(Path)) {
+    return parseModule(*Code);
+  } else {
+    return Unexpect(Code);
+  }
+}
+
+Expect<std::unique_ptr<AST::Module>> VM::parseModule(Span<const Byte> Code) {
+  auto Res = LoaderEngine.parseModule(Code);
+  if (!Res || Conf.getAOTCache().empty()) {
+    return Res;
+  }
+#if SSVM_ENABLE_AOT
+  /// The invalid modules are left to fail in the validation.
+  if (!ValidatorEngine.validate(**Res)) {
+    return Res;
+  }
+  AOT::Compiler Compiler;
+  Compiler.setInstructionCounting(Conf.isInstructionCounting() ||
+                                  Stat.isProfiling());
+  Compiler.setGasMeasuring(Conf.isCostMeasuring() || Stat.isCostMetered());
+  AOT::Cache Cache(Conf.getAOTCache(), Conf.getAOTCacheSize());
+  if (auto Path = Cache.get(Code, **Res, Conf, Compiler)) {
+    if (auto Compiled = LoaderEngine.parseModule(*Path)) {
+      return Compiled;
+    }
+  }
+  LOG(ERROR) << "AOT cache failed, the module is interpreted.";
+#else
+  LOG(ERROR) << "AOT is not built, the module is interpreted.";
+#endif
+  return Res;
+}
+
 Expect<void> VM::registerModule(std::string_view Name,
                                 const std::filesystem::path &Path) {
   if (Stage == VMStage::Instantiated) {
@@ -44,8 +106,8 @@ Expect<void> VM::registerModule(std::string_view Name,
     Stage = VMStage::Validated;
   }
   /// Load module.
-  if (auto Res = LoaderEngine.parseModule(Path)) {
-    return registerModule(Name, *(*Res).get());
+  if (auto Res = parseModule(Path)) {
+    return registerModuleImpl(Name, **Res);
   } else {
     return Unexpect(Res);
   }
@@ -58,8 +120,8 @@ Expect<void> VM::registerModule(std::string_view Name, Span<const Byte> Code) {
     Stage = VMStage::Validated;
   }
   /// Load module.
-  if (auto Res = LoaderEngine.parseModule(Code)) {
-    return registerModule(Name, *(*Res).get());
+  if (auto Res = parseModule(Code)) {
+    return registerModuleImpl(Name, **Res);
   } else {
     return Unexpect(Res);
   }
@@ -81,10 +143,22 @@ Expect<void> VM::registerModule(std::string_view Name,
     /// Therefore the instantiation should restart.
     Stage = VMStage::Validated;
   }
+  /// The validation annotates the copy of the module.
+  AST::Module Copy(Module);
+  return registerModuleImpl(Name, Copy);
+}
+
+Expect<void> VM::registerModuleImpl(std::string_view Name,
+                                    AST::Module &Module) {
   /// Validate module.
   if (auto Res = ValidatorEngine.validate(Module); !Res) {
     return Unexpect(Res);
   }
+  if (Conf.isJIT()) {
+    if (auto Res = compileJIT(Module); !Res) {
+      return Unexpect(Res);
+    }
+  }
   return InterpreterEngine.registerModule(StoreRef, Module, Name);
 }
 
@@ -97,8 +171,8 @@ VM::runWasmFile(const std::filesystem::path &Path, std::string_view Func,
     Stage = VMStage::Validated;
   }
   /// Load module.
-  if (auto Res = LoaderEngine.parseModule(Path)) {
-    return runWasmFile(*(*Res).get(), Func, Params);
+  if (auto Res = parseModule(Path)) {
+    return runWasmFileImpl(**Res, Func, Params);
   } else {
     return Unexpect(Res);
   }
@@ -113,8 +187,8 @@ Expect<std::vector<ValVariant>> VM::runWasmFile(Span<const Byte> Code,
     Stage = VMStage::Validated;
   }
   /// Load module.
-  if (auto Res = LoaderEngine.parseModule(Code)) {
-    return runWasmFile(*(*Res).get(), Func, Params);
+  if (auto Res = parseModule(Code)) {
+    return runWasmFileImpl(**Res, Func, Params);
   } else {
     return Unexpect(Res);
   }
@@ -128,12 +202,29 @@ Expect<std::vector<ValVariant>> VM::runWasmFile(const AST::Module &Module,
     /// Therefore the instantiation should restart.
     Stage = VMStage::Validated;
   }
+  /// The validation annotates the copy of the module.
+  AST::Module Copy(Module);
+  return runWasmFileImpl(Copy, Func, Params);
+}
+
+Expect<std::vector<ValVariant>>
+VM::runWasmFileImpl(AST::Module &Module, std::string_view Func,
+                    Span<const ValVariant> Params) {
   if (auto Res = ValidatorEngine.validate(Module); !Res) {
     return Unexpect(Res);
   }
-  if (auto Res = InterpreterEngine.instantiateModule(StoreRef, Module); !Res) {
+  if (Conf.isJIT()) {
+    if (auto Res = compileJIT(Module); !Res) {
+      return Unexpect(Res);
+    }
+  }
+  if (auto Res = InterpreterEngine.instantiateModule(StoreRef, Module);
+      !Res) {
     return Unexpect(Res);
   }
+  if (Tier) {
+    Tier->attach(Module, **StoreRef.getActiveModule());
+  }
   const auto FuncExp = StoreRef.getFuncExports();
   if (FuncExp.find(Func) == FuncExp.cend()) {
     LOG(ERROR) << ErrCode::FuncNotFound;
@@ -150,7 +241,7 @@ Expect<std::vector<ValVariant>> VM::runWasmFile(const AST::Module &Module,
 
 Expect<void> VM::loadWasm(const std::filesystem::path &Path) {
   /// If not load successfully, the previous status will be reserved.
-  if (auto Res = LoaderEngine.parseModule(Path)) {
+  if (auto Res = parseModule(Path)) {
     Mod = std::move(*Res);
     Stage = VMStage::Loaded;
   } else {
@@ -161,7 +252,7 @@ Expect<void> VM::loadWasm(const std::filesystem::path &Path) {
 
 Expect<void> VM::loadWasm(Span<const Byte> Code) {
   /// If not load successfully, the previous status will be reserved.
-  if (auto Res = LoaderEngine.parseModule(Code)) {
+  if (auto Res = parseModule(Code)) {
     Mod = std::move(*Res);
     Stage = VMStage::Loaded;
   } else {
@@ -183,6 +274,11 @@ Expect<void> VM::validate() {
     return Unexpect(ErrCode::WrongVMWorkflow);
   }
   if (auto Res = ValidatorEngine.validate(*Mod.get())) {
+    if (Conf.isJIT()) {
+      if (auto Res = compileJIT(*Mod.get()); !Res) {
+        return Unexpect(Res);
+      }
+    }
     Stage = VMStage::Validated;
     return {};
   } else {
@@ -198,12 +294,43 @@ Expect<void> VM::instantiate() {
   }
   if (auto Res = InterpreterEngine.instantiateModule(StoreRef, *Mod.get())) {
     Stage = VMStage::Instantiated;
+    if (Tier) {
+      Tier->attach(*Mod, **StoreRef.getActiveModule());
+    }
+    return {};
+  } else {
+    return Unexpect(Res);
+  }
+}
+
+Expect<void> VM::instantiate(const Runtime::Snapshot &Snap) {
+  Mod = Snap.Module;
+  Stage = VMStage::Validated;
+  if (auto Res = InterpreterEngine.instantiateModule(StoreRef, *Mod, Snap)) {
+    Stage = VMStage::Instantiated;
+    if (Tier) {
+      Tier->attach(*Mod, **StoreRef.getActiveModule());
+    }
     return {};
   } else {
     return Unexpect(Res);
   }
 }
 
+Expect<std::shared_ptr<const Runtime::Snapshot>> VM::snapshot() {
+  if (Stage < VMStage::Instantiated) {
+    /// When module is not instantiated, not snapshot.
+    LOG(ERROR) << ErrCode::WrongVMWorkflow;
+    return Unexpect(ErrCode::WrongVMWorkflow);
+  }
+  if (auto Res = InterpreterEngine.snapshotModule(StoreRef)) {
+    (*Res)->Module = Mod;
+    return std::shared_ptr<const Runtime::Snapshot>(std::move(*Res));
+  } else {
+    return Unexpect(Res);
+  }
+}
+
 Expect<std::vector<ValVariant>> VM::execute(std::string_view Func,
                                             Span<const ValVariant> Params) {
   /// Check exports for finding function address.
@@ -0,0 +1,79 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "aot/compiler.h"
+#include "common/configure.h"
+#include "common/filesystem.h"
+#include "common/value.h"
+#include "loader/loader.h"
+#include "validator/validator.h"
+#include "vm/vm.h"
+
+#include "gtest/gtest.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+/// Module of a memory with one page:
+///   load(addr): i32.load addr
+///   grow(n): memory.grow n
+std::array<SSVM::Byte, 61> MemoryWasm = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x03, 0x03, 0x02, 0x00, 0x00, 0x05, 0x03, 0x01,
+    0x00, 0x01, 0x07, 0x0f, 0x02, 0x04, 0x6c, 0x6f, 0x61, 0x64, 0x00, 0x00,
+    0x04, 0x67, 0x72, 0x6f, 0x77, 0x00, 0x01, 0x0a, 0x10, 0x02, 0x07, 0x00,
+    0x20, 0x00, 0x28, 0x02, 0x00, 0x0b, 0x06, 0x00, 0x20, 0x00, 0x40, 0x00,
+    0x0b,
+};
+
+TEST(AOTBoundsTest, VM__BoundsChecking) {
+  const auto Path =
+      std::filesystem::temp_directory_path() /
+      ("ssvm-aot-bounds-test-" + std::to_string(::getpid()) + ".so");
+  SSVM::Configure Conf;
+  {
+    SSVM::Loader::Loader Loader(Conf);
+    auto Mod = Loader.parseModule(MemoryWasm);
+    ASSERT_TRUE(Mod);
+    SSVM::Validator::Validator Validator(Conf);
+    ASSERT_TRUE(Validator.validate(**Mod));
+    SSVM::AOT::Compiler Compiler;
+    Compiler.setBoundsChecking();
+    ASSERT_TRUE(Compiler.compile(MemoryWasm, **Mod, Path));
+  }
+
+  SSVM::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(Path));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  /// The memory is allocated at its actual size without the guard region.
+  auto &StoreMgr = VM.getStoreManager();
+  const auto *ModInst = *StoreMgr.getActiveModule();
+  const auto *MemInst = *StoreMgr.getMemory(*ModInst->getMemAddr(0));
+  EXPECT_FALSE(MemInst->hasGuardRegion());
+
+  std::vector<SSVM::ValVariant> Last = {UINT32_C(65532)};
+  std::vector<SSVM::ValVariant> Over = {UINT32_C(65533)};
+  std::vector<SSVM::ValVariant> One = {UINT32_C(1)};
+  EXPECT_TRUE(VM.execute("load", Last));
+  EXPECT_FALSE(VM.execute("load", Over));
+
+  /// The bounds are reloaded after the memory grows.
+  auto Res = VM.execute("grow", One);
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(std::get<uint32_t>((*Res)[0]), 1U);
+  EXPECT_TRUE(VM.execute("load", Over));
+  std::filesystem::remove(Path);
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  SSVM::Log::setErrorLoggingLevel();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
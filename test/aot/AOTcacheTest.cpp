@@ -0,0 +1,105 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "aot/cache.h"
+#include "common/configure.h"
+#include "common/filesystem.h"
+#include "common/value.h"
+#include "loader/loader.h"
+#include "validator/validator.h"
+#include "vm/vm.h"
+
+#include "gtest/gtest.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+/// Module of recursive functions:
+///   depth(n): n == 0 ? 0 : depth(n - 1) + 1
+///   forever(): call forever()
+std::array<SSVM::Byte, 75> RecursionWasm = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x09, 0x02, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x60, 0x00, 0x00, 0x03, 0x03, 0x02, 0x00, 0x01,
+    0x07, 0x13, 0x02, 0x05, 0x64, 0x65, 0x70, 0x74, 0x68, 0x00, 0x00, 0x07,
+    0x66, 0x6f, 0x72, 0x65, 0x76, 0x65, 0x72, 0x00, 0x01, 0x0a, 0x1c, 0x02,
+    0x15, 0x00, 0x20, 0x00, 0x45, 0x04, 0x7f, 0x41, 0x00, 0x05, 0x20, 0x00,
+    0x41, 0x01, 0x6b, 0x10, 0x00, 0x41, 0x01, 0x6a, 0x0b, 0x0b, 0x04, 0x00,
+    0x10, 0x01, 0x0b,
+};
+
+std::filesystem::path getCacheDir() {
+  return std::filesystem::temp_directory_path() /
+         ("ssvm-aot-cache-test-" + std::to_string(::getpid()));
+}
+
+uint32_t countLibraries(const std::filesystem::path &Dir) {
+  uint32_t Count = 0;
+  for (const auto &Entry : std::filesystem::directory_iterator(Dir)) {
+    Count += Entry.path().extension() == ".so";
+  }
+  return Count;
+}
+
+TEST(AOTCacheTest, VM__Cached) {
+  const auto Dir = getCacheDir();
+  SSVM::Configure Conf;
+  Conf.setAOTCache(Dir);
+  std::vector<SSVM::ValVariant> Args = {UINT32_C(5)};
+
+  /// The first load compiles into the cache, and the second one loads it.
+  for (uint32_t I = 0; I < 2; ++I) {
+    SSVM::VM::VM VM(Conf);
+    ASSERT_TRUE(VM.loadWasm(RecursionWasm));
+    ASSERT_TRUE(VM.validate());
+    ASSERT_TRUE(VM.instantiate());
+    auto Res = VM.execute("depth", Args);
+    ASSERT_TRUE(Res);
+    EXPECT_EQ(std::get<uint32_t>((*Res)[0]), 5U);
+    EXPECT_EQ(countLibraries(Dir), 1U);
+  }
+
+  /// The compiler options are in the key.
+  Conf.setInstructionCounting(true);
+  {
+    SSVM::VM::VM VM(Conf);
+    ASSERT_TRUE(VM.loadWasm(RecursionWasm));
+    EXPECT_EQ(countLibraries(Dir), 2U);
+  }
+  std::filesystem::remove_all(Dir);
+}
+
+TEST(AOTCacheTest, Cache__Evict) {
+  const auto Dir = getCacheDir();
+  SSVM::Configure Conf;
+  SSVM::AOT::Compiler Compiler;
+  Compiler.setOptimizationLevel(SSVM::AOT::Compiler::OptimizationLevel::O0);
+
+  /// Only the last compiled library is kept under the size.
+  SSVM::AOT::Cache Cache(Dir, 1);
+  SSVM::Loader::Loader Loader(Conf);
+  auto Mod = Loader.parseModule(RecursionWasm);
+  ASSERT_TRUE(Mod);
+  SSVM::Validator::Validator Validator(Conf);
+  ASSERT_TRUE(Validator.validate(**Mod));
+  auto Path1 = Cache.get(RecursionWasm, **Mod, Conf, Compiler);
+  ASSERT_TRUE(Path1);
+  Compiler.setGasMeasuring();
+  auto Path2 = Cache.get(RecursionWasm, **Mod, Conf, Compiler);
+  ASSERT_TRUE(Path2);
+  EXPECT_NE(*Path1, *Path2);
+  EXPECT_FALSE(std::filesystem::exists(*Path1));
+  EXPECT_TRUE(std::filesystem::exists(*Path2));
+  EXPECT_EQ(countLibraries(Dir), 1U);
+  std::filesystem::remove_all(Dir);
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  SSVM::Log::setErrorLoggingLevel();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
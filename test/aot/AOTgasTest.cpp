@@ -0,0 +1,119 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "aot/compiler.h"
+#include "common/configure.h"
+#include "common/filesystem.h"
+#include "common/value.h"
+#include "loader/loader.h"
+#include "validator/validator.h"
+#include "vm/vm.h"
+
+#include "gtest/gtest.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+/// Module of the branching functions:
+///   collatz(n): count the steps of the Collatz sequence by if/else in a loop
+///   classify(n): nested if/else with an early return for 7
+std::array<SSVM::Byte, 152> BranchWasm = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x06, 0x01, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x03, 0x03, 0x02, 0x00, 0x00, 0x07, 0x16, 0x02,
+    0x07, 0x63, 0x6f, 0x6c, 0x6c, 0x61, 0x74, 0x7a, 0x00, 0x00, 0x08, 0x63,
+    0x6c, 0x61, 0x73, 0x73, 0x69, 0x66, 0x79, 0x00, 0x01, 0x0a, 0x69, 0x02,
+    0x34, 0x01, 0x01, 0x7f, 0x02, 0x40, 0x03, 0x40, 0x20, 0x00, 0x41, 0x01,
+    0x4d, 0x0d, 0x01, 0x20, 0x00, 0x41, 0x01, 0x71, 0x04, 0x7f, 0x20, 0x00,
+    0x41, 0x03, 0x6c, 0x41, 0x01, 0x6a, 0x05, 0x20, 0x00, 0x41, 0x01, 0x76,
+    0x0b, 0x21, 0x00, 0x20, 0x01, 0x41, 0x01, 0x6a, 0x21, 0x01, 0x0c, 0x00,
+    0x0b, 0x0b, 0x20, 0x01, 0x0b, 0x32, 0x00, 0x20, 0x00, 0x41, 0x07, 0x46,
+    0x04, 0x40, 0x41, 0x07, 0x0f, 0x0b, 0x20, 0x00, 0x41, 0x0a, 0x49, 0x04,
+    0x7f, 0x20, 0x00, 0x45, 0x04, 0x7f, 0x41, 0xe4, 0x00, 0x05, 0x41, 0xc8,
+    0x01, 0x0b, 0x05, 0x20, 0x00, 0x41, 0x02, 0x70, 0x04, 0x7f, 0x41, 0xac,
+    0x02, 0x05, 0x41, 0x90, 0x03, 0x0b, 0x0b, 0x0b,
+};
+
+/// Inputs covering every arm of the branches.
+std::array<uint32_t, 9> Inputs = {0, 1, 2, 3, 7, 8, 9, 27, 100};
+
+/// Cost table with different costs for the opcodes, so the costs charged by
+/// the wrong blocks are not summed to the same totals.
+std::vector<uint64_t> costTable() {
+  std::vector<uint64_t> Table(UINT16_MAX + 1);
+  for (uint32_t I = 0; I < Table.size(); ++I) {
+    Table[I] = I % 7 + 1;
+  }
+  return Table;
+}
+
+/// Run the functions on the inputs and collect the total costs.
+std::vector<uint64_t> runCosts(SSVM::VM::VM &VM) {
+  std::vector<uint64_t> Costs;
+  VM.getStatistics().setCostTable(costTable());
+  for (const auto Func : {"collatz", "classify"}) {
+    for (const auto Input : Inputs) {
+      VM.getStatistics().clear();
+      std::vector<SSVM::ValVariant> Args = {Input};
+      EXPECT_TRUE(VM.execute(Func, Args));
+      Costs.push_back(VM.getStatistics().getTotalCost());
+    }
+  }
+  return Costs;
+}
+
+TEST(AOTGasTest, VM__CostsMatchInterpreter) {
+  const auto Path =
+      std::filesystem::temp_directory_path() /
+      ("ssvm-aot-gas-test-" + std::to_string(::getpid()) + ".so");
+  SSVM::Configure Conf;
+  Conf.setCostMeasuring(true);
+  {
+    SSVM::Loader::Loader Loader(Conf);
+    auto Mod = Loader.parseModule(BranchWasm);
+    ASSERT_TRUE(Mod);
+    SSVM::Validator::Validator Validator(Conf);
+    ASSERT_TRUE(Validator.validate(**Mod));
+    SSVM::AOT::Compiler Compiler;
+    Compiler.setGasMeasuring();
+    ASSERT_TRUE(Compiler.compile(BranchWasm, **Mod, Path));
+  }
+
+  std::vector<uint64_t> Interpreted;
+  {
+    SSVM::VM::VM VM(Conf);
+    ASSERT_TRUE(VM.loadWasm(BranchWasm));
+    ASSERT_TRUE(VM.validate());
+    ASSERT_TRUE(VM.instantiate());
+    Interpreted = runCosts(VM);
+  }
+
+  SSVM::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(Path));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  EXPECT_EQ(runCosts(VM), Interpreted);
+
+  /// The compiled code stops at the same limit as the interpreter.
+  const uint64_t Total = Interpreted[Inputs.size() - 1];
+  std::vector<SSVM::ValVariant> Args = {Inputs.back()};
+  VM.getStatistics().clear();
+  VM.getStatistics().setCostLimit(Total);
+  EXPECT_TRUE(VM.execute("collatz", Args));
+  VM.getStatistics().clear();
+  VM.getStatistics().setCostLimit(Total - 1);
+  auto Res = VM.execute("collatz", Args);
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), SSVM::ErrCode::CostLimitExceeded);
+  std::filesystem::remove(Path);
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  SSVM::Log::setErrorLoggingLevel();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,89 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "common/configure.h"
+#include "common/value.h"
+#include "vm/vm.h"
+
+#include "gtest/gtest.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+/// Module of calls, indirect calls, and traps:
+///   fib(n): n < 2 ? n : fib(n - 1) + fib(n - 2)
+///   dispatch(i, n): call_indirect table[i](n), where the table is
+///                   [double, square, trap]
+///   trap(): unreachable
+std::array<SSVM::Byte, 139> JITWasm = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x0f, 0x03, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x60, 0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x60, 0x00,
+    0x00, 0x03, 0x06, 0x05, 0x00, 0x00, 0x00, 0x01, 0x02, 0x04, 0x04, 0x01,
+    0x70, 0x00, 0x03, 0x07, 0x19, 0x03, 0x03, 0x66, 0x69, 0x62, 0x00, 0x00,
+    0x08, 0x64, 0x69, 0x73, 0x70, 0x61, 0x74, 0x63, 0x68, 0x00, 0x03, 0x04,
+    0x74, 0x72, 0x61, 0x70, 0x00, 0x04, 0x09, 0x09, 0x01, 0x00, 0x41, 0x00,
+    0x0b, 0x03, 0x01, 0x02, 0x04, 0x0a, 0x3c, 0x05, 0x1c, 0x00, 0x20, 0x00,
+    0x41, 0x02, 0x48, 0x04, 0x7f, 0x20, 0x00, 0x05, 0x20, 0x00, 0x41, 0x01,
+    0x6b, 0x10, 0x00, 0x20, 0x00, 0x41, 0x02, 0x6b, 0x10, 0x00, 0x6a, 0x0b,
+    0x0b, 0x07, 0x00, 0x20, 0x00, 0x41, 0x02, 0x6c, 0x0b, 0x07, 0x00, 0x20,
+    0x00, 0x20, 0x00, 0x6c, 0x0b, 0x09, 0x00, 0x20, 0x01, 0x20, 0x00, 0x11,
+    0x00, 0x00, 0x0b, 0x03, 0x00, 0x00, 0x0b,
+};
+
+uint32_t call(SSVM::VM::VM &VM, std::string_view Func,
+              std::vector<SSVM::ValVariant> Args) {
+  auto Res = VM.execute(Func, Args);
+  EXPECT_TRUE(Res);
+  return Res && !Res->empty() ? std::get<uint32_t>((*Res)[0]) : 0;
+}
+
+/// The parameter is whether the functions are compiled lazily.
+class JITTest : public testing::TestWithParam<bool> {};
+
+TEST_P(JITTest, VM__Run) {
+  SSVM::Configure Conf;
+  Conf.setJIT(true);
+  Conf.setLazyJIT(GetParam());
+  SSVM::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(JITWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  /// The functions are compiled instead of interpreted.
+  auto &StoreMgr = VM.getStoreManager();
+  const auto *ModInst = *StoreMgr.getActiveModule();
+  for (uint32_t I = 0; I < ModInst->getFuncNum(); ++I) {
+    const auto *FuncInst = *StoreMgr.getFunction(*ModInst->getFuncAddr(I));
+    EXPECT_TRUE(FuncInst->isCompiledFunction());
+  }
+
+  EXPECT_EQ(call(VM, "fib", {UINT32_C(20)}), 6765U);
+  EXPECT_EQ(call(VM, "dispatch", {UINT32_C(0), UINT32_C(21)}), 42U);
+  EXPECT_EQ(call(VM, "dispatch", {UINT32_C(1), UINT32_C(7)}), 49U);
+
+  std::vector<SSVM::ValVariant> Mismatch = {UINT32_C(2), UINT32_C(1)};
+  auto Res = VM.execute("dispatch", Mismatch);
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), SSVM::ErrCode::IndirectCallTypeMismatch);
+  std::vector<SSVM::ValVariant> Undefined = {UINT32_C(3), UINT32_C(1)};
+  Res = VM.execute("dispatch", Undefined);
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), SSVM::ErrCode::UndefinedElement);
+  Res = VM.execute("trap");
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), SSVM::ErrCode::Unreachable);
+
+  /// The functions still run after the traps.
+  EXPECT_EQ(call(VM, "fib", {UINT32_C(10)}), 55U);
+}
+
+INSTANTIATE_TEST_SUITE_P(AOTJITTest, JITTest, testing::Bool());
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  SSVM::Log::setErrorLoggingLevel();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
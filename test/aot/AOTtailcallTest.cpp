@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "aot/compiler.h"
+#include "common/configure.h"
+#include "common/filesystem.h"
+#include "common/value.h"
+#include "loader/loader.h"
+#include "validator/validator.h"
+#include "vm/vm.h"
+
+#include "gtest/gtest.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+/// Module of the interpreted function called through the table:
+///   offset(n, x): n + 100
+std::array<SSVM::Byte, 45> EnvWasm = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x07, 0x01, 0x60,
+    0x02, 0x7f, 0x7e, 0x01, 0x7f, 0x03, 0x02, 0x01, 0x00, 0x07, 0x0a, 0x01,
+    0x06, 0x6f, 0x66, 0x66, 0x73, 0x65, 0x74, 0x00, 0x00, 0x0a, 0x0a, 0x01,
+    0x08, 0x00, 0x20, 0x00, 0x41, 0xe4, 0x00, 0x6a, 0x0b,
+};
+
+/// Module of the tail calls between the different prototypes:
+///   ping(n): 0 if n == 0, else return_call_indirect pong(n - 1, n)
+///   pong(n, x): 1 if n == 0, else return_call_indirect ping(n - 1)
+///   countdown(n): 0 if n == 0, else return_call countup(n - 1, n)
+///   countup(n, x): 1 if n == 0, else return_call countdown(n - 1)
+///   mismatch(n): return_call_indirect ping as (i32, i64) -> i32
+///   imported(n): return_call_indirect env.offset(n, 0)
+std::array<SSVM::Byte, 223> TailCallWasm = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x0c, 0x02, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x60, 0x02, 0x7f, 0x7e, 0x01, 0x7f, 0x02, 0x0e,
+    0x01, 0x03, 0x65, 0x6e, 0x76, 0x06, 0x6f, 0x66, 0x66, 0x73, 0x65, 0x74,
+    0x00, 0x01, 0x03, 0x07, 0x06, 0x00, 0x01, 0x00, 0x01, 0x00, 0x00, 0x04,
+    0x04, 0x01, 0x70, 0x00, 0x03, 0x07, 0x2a, 0x04, 0x04, 0x70, 0x69, 0x6e,
+    0x67, 0x00, 0x01, 0x09, 0x63, 0x6f, 0x75, 0x6e, 0x74, 0x64, 0x6f, 0x77,
+    0x6e, 0x00, 0x03, 0x08, 0x6d, 0x69, 0x73, 0x6d, 0x61, 0x74, 0x63, 0x68,
+    0x00, 0x05, 0x08, 0x69, 0x6d, 0x70, 0x6f, 0x72, 0x74, 0x65, 0x64, 0x00,
+    0x06, 0x09, 0x09, 0x01, 0x00, 0x41, 0x00, 0x0b, 0x03, 0x01, 0x02, 0x00,
+    0x0a, 0x71, 0x06, 0x18, 0x00, 0x20, 0x00, 0x45, 0x04, 0x7f, 0x41, 0x00,
+    0x05, 0x20, 0x00, 0x41, 0x01, 0x6b, 0x20, 0x00, 0xad, 0x41, 0x01, 0x13,
+    0x01, 0x00, 0x0b, 0x0b, 0x15, 0x00, 0x20, 0x00, 0x45, 0x04, 0x7f, 0x41,
+    0x01, 0x05, 0x20, 0x00, 0x41, 0x01, 0x6b, 0x41, 0x00, 0x13, 0x00, 0x00,
+    0x0b, 0x0b, 0x15, 0x00, 0x20, 0x00, 0x45, 0x04, 0x7f, 0x41, 0x00, 0x05,
+    0x20, 0x00, 0x41, 0x01, 0x6b, 0x20, 0x00, 0xad, 0x12, 0x04, 0x0b, 0x0b,
+    0x12, 0x00, 0x20, 0x00, 0x45, 0x04, 0x7f, 0x41, 0x01, 0x05, 0x20, 0x00,
+    0x41, 0x01, 0x6b, 0x12, 0x03, 0x0b, 0x0b, 0x0b, 0x00, 0x20, 0x00, 0x42,
+    0x00, 0x41, 0x00, 0x13, 0x01, 0x00, 0x0b, 0x0b, 0x00, 0x20, 0x00, 0x42,
+    0x00, 0x41, 0x02, 0x13, 0x01, 0x00, 0x0b,
+};
+
+/// Number of the tail calls, which overflow the native stack if each call
+/// keeps its frame.
+constexpr uint32_t kCalls = 2000001;
+
+uint32_t call(SSVM::VM::VM &VM, std::string_view Func, uint32_t N) {
+  std::vector<SSVM::ValVariant> Args = {N};
+  auto Res = VM.execute(Func, Args);
+  EXPECT_TRUE(Res);
+  return Res && !Res->empty() ? std::get<uint32_t>((*Res)[0]) : UINT32_MAX;
+}
+
+TEST(AOTTailCallTest, VM__TailCalls) {
+  const auto Path =
+      std::filesystem::temp_directory_path() /
+      ("ssvm-aot-tailcall-test-" + std::to_string(::getpid()) + ".so");
+  SSVM::Configure Conf;
+  Conf.addProposal(SSVM::Proposal::TailCall);
+  {
+    SSVM::Loader::Loader Loader(Conf);
+    auto Mod = Loader.parseModule(TailCallWasm);
+    ASSERT_TRUE(Mod);
+    SSVM::Validator::Validator Validator(Conf);
+    ASSERT_TRUE(Validator.validate(**Mod));
+    SSVM::AOT::Compiler Compiler;
+    ASSERT_TRUE(Compiler.compile(TailCallWasm, **Mod, Path));
+  }
+
+  SSVM::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.registerModule("env", EnvWasm));
+  ASSERT_TRUE(VM.loadWasm(Path));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  /// The indirect and direct tail calls run in constant stack, and end in
+  /// the function by the parity of the calls.
+  EXPECT_EQ(call(VM, "ping", kCalls), 1U);
+  EXPECT_EQ(call(VM, "ping", kCalls - 1), 0U);
+  EXPECT_EQ(call(VM, "countdown", kCalls), 1U);
+  EXPECT_EQ(call(VM, "countdown", kCalls - 1), 0U);
+
+  /// The function of the other module is called through the runtime, which
+  /// also checks the types of the callees.
+  EXPECT_EQ(call(VM, "imported", 5), 105U);
+  std::vector<SSVM::ValVariant> Args = {UINT32_C(0)};
+  auto Res = VM.execute("mismatch", Args);
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), SSVM::ErrCode::IndirectCallTypeMismatch);
+  std::filesystem::remove(Path);
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  SSVM::Log::setErrorLoggingLevel();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
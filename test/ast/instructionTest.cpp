@@ -260,6 +260,16 @@ TEST(InstructionTest, LoadBrTableControlInstruction) {
   Mgr.setCode(Vec3);
   SSVM::AST::Instruction Ins3(Op);
   EXPECT_TRUE(Ins3.loadBinary(Mgr, Conf) && Mgr.getRemainSize() == 0);
+  EXPECT_EQ(Ins3.getLabelList().size(), 4U);
+  EXPECT_EQ(Ins3.getLabelList()[3].TargetIndex, 0xFFFFFFFFU);
+  EXPECT_EQ(Ins3.getTargetIndex(), 0xFFFFFFFFU);
+
+  /// Copied instruction owns its own label list.
+  SSVM::AST::Instruction Ins4(Ins3);
+  EXPECT_NE(Ins4.getLabelList().data(), Ins3.getLabelList().data());
+  EXPECT_EQ(Ins4.getLabelList()[0].TargetIndex, 0xFFFFFFF1U);
+  EXPECT_EQ(Ins4.getLabelList()[2].TargetIndex, 0xFFFFFFF3U);
+  EXPECT_EQ(Ins4.getTargetIndex(), 0xFFFFFFFFU);
 }
 
 TEST(InstructionTest, LoadCallControlInstruction) {
@@ -0,0 +1,145 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "common/configure.h"
+#include "common/value.h"
+#include "runtime/hostfunc.h"
+#include "runtime/importobj.h"
+#include "vm/vm.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+/// Module importing the host functions "host.add" (i32, i32) -> i32,
+/// "host.get" () -> i32, and "host.nop" () -> (). The exported functions
+/// "add_loop", "get_loop", and "nop_loop" take a count N and call the host
+/// function N times in a loop:
+///   add_loop: for (i = 0; i < N; ++i) acc = add(acc, i); return acc;
+///   get_loop: for (i = 0; i < N; ++i) acc = acc + get(); return acc;
+///   nop_loop: for (i = 0; i < N; ++i) nop(); return 0;
+std::array<SSVM::Byte, 217> HostCallWasm = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x13, 0x04, 0x60,
+    0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x60, 0x00, 0x01, 0x7f, 0x60, 0x00, 0x00,
+    0x60, 0x01, 0x7f, 0x01, 0x7f, 0x02, 0x22, 0x03, 0x04, 0x68, 0x6f, 0x73,
+    0x74, 0x03, 0x61, 0x64, 0x64, 0x00, 0x00, 0x04, 0x68, 0x6f, 0x73, 0x74,
+    0x03, 0x67, 0x65, 0x74, 0x00, 0x01, 0x04, 0x68, 0x6f, 0x73, 0x74, 0x03,
+    0x6e, 0x6f, 0x70, 0x00, 0x02, 0x03, 0x04, 0x03, 0x03, 0x03, 0x03, 0x07,
+    0x22, 0x03, 0x08, 0x61, 0x64, 0x64, 0x5f, 0x6c, 0x6f, 0x6f, 0x70, 0x00,
+    0x03, 0x08, 0x67, 0x65, 0x74, 0x5f, 0x6c, 0x6f, 0x6f, 0x70, 0x00, 0x04,
+    0x08, 0x6e, 0x6f, 0x70, 0x5f, 0x6c, 0x6f, 0x6f, 0x70, 0x00, 0x05, 0x0a,
+    0x6c, 0x03, 0x25, 0x01, 0x02, 0x7f, 0x02, 0x40, 0x03, 0x40, 0x20, 0x01,
+    0x20, 0x00, 0x49, 0x45, 0x0d, 0x01, 0x20, 0x02, 0x20, 0x01, 0x10, 0x00,
+    0x21, 0x02, 0x20, 0x01, 0x41, 0x01, 0x6a, 0x21, 0x01, 0x0c, 0x00, 0x0b,
+    0x0b, 0x20, 0x02, 0x0b, 0x24, 0x01, 0x02, 0x7f, 0x02, 0x40, 0x03, 0x40,
+    0x20, 0x01, 0x20, 0x00, 0x49, 0x45, 0x0d, 0x01, 0x20, 0x02, 0x10, 0x01,
+    0x6a, 0x21, 0x02, 0x20, 0x01, 0x41, 0x01, 0x6a, 0x21, 0x01, 0x0c, 0x00,
+    0x0b, 0x0b, 0x20, 0x02, 0x0b, 0x1f, 0x01, 0x02, 0x7f, 0x02, 0x40, 0x03,
+    0x40, 0x20, 0x01, 0x20, 0x00, 0x49, 0x45, 0x0d, 0x01, 0x10, 0x02, 0x20,
+    0x01, 0x41, 0x01, 0x6a, 0x21, 0x01, 0x0c, 0x00, 0x0b, 0x0b, 0x20, 0x02,
+    0x0b,
+};
+
+class HostAdd : public SSVM::Runtime::HostFunction<HostAdd> {
+public:
+  SSVM::Expect<uint32_t> body(SSVM::Runtime::Instance::MemoryInstance *,
+                              uint32_t A, uint32_t B) {
+    return A + B;
+  }
+};
+
+class HostGet : public SSVM::Runtime::HostFunction<HostGet> {
+public:
+  SSVM::Expect<uint32_t> body(SSVM::Runtime::Instance::MemoryInstance *) {
+    return 7U;
+  }
+};
+
+class HostNop : public SSVM::Runtime::HostFunction<HostNop> {
+public:
+  SSVM::Expect<void> body(SSVM::Runtime::Instance::MemoryInstance *) {
+    return {};
+  }
+};
+
+/// Host function called through the default runInPlace(), which copies the
+/// arguments and runs the body through run().
+template <typename T> class Copying : public T {
+public:
+  SSVM::Expect<void>
+  runInPlace(SSVM::Runtime::Instance::MemoryInstance *MemInst,
+             SSVM::ValVariant *Slots) override {
+    return SSVM::Runtime::HostFunctionBase::runInPlace(MemInst, Slots);
+  }
+};
+
+class HostModule : public SSVM::Runtime::ImportObject {
+public:
+  HostModule(const bool InPlace) : ImportObject("host") {
+    if (InPlace) {
+      addHostFunc("add", std::make_unique<HostAdd>());
+      addHostFunc("get", std::make_unique<HostGet>());
+      addHostFunc("nop", std::make_unique<HostNop>());
+    } else {
+      addHostFunc("add", std::make_unique<Copying<HostAdd>>());
+      addHostFunc("get", std::make_unique<Copying<HostGet>>());
+      addHostFunc("nop", std::make_unique<Copying<HostNop>>());
+    }
+  }
+};
+
+/// Run the loop of Count host calls, and return the nanoseconds per call.
+double measure(const bool InPlace, const std::string &Func,
+               const uint32_t Count) {
+  SSVM::Configure Conf;
+  SSVM::VM::VM VM(Conf);
+  HostModule Mod(InPlace);
+  if (!VM.registerModule(Mod) || !VM.loadWasm(HostCallWasm) ||
+      !VM.validate() || !VM.instantiate()) {
+    std::cerr << "failed to instantiate the module\n";
+    std::exit(EXIT_FAILURE);
+  }
+
+  /// Warm up the caches before timing.
+  std::vector<SSVM::ValVariant> Args = {Count / 10 + 1};
+  VM.execute(Func, Args);
+  Args[0] = Count;
+  const auto Start = std::chrono::steady_clock::now();
+  if (!VM.execute(Func, Args)) {
+    std::cerr << "failed to run " << Func << "\n";
+    std::exit(EXIT_FAILURE);
+  }
+  const std::chrono::duration<double, std::nano> Elapsed =
+      std::chrono::steady_clock::now() - Start;
+  return Elapsed.count() / Count;
+}
+
+} // namespace
+
+/// Measure the time per host call of the interpreter through the value stack
+/// slots in place, and through the copying run() as before.
+///   Usage: ssvmHostFuncBench [CALL_COUNT]
+int main(int Argc, const char *Argv[]) {
+  SSVM::Log::setErrorLoggingLevel();
+  const uint32_t Count =
+      Argc > 1 ? static_cast<uint32_t>(std::stoul(Argv[1])) : 10000000U;
+
+  /// The times include the interpreted loop around the calls, which is the
+  /// same in both ways.
+  std::cout << "host call     copying   in place  (ns/call, " << Count
+            << " calls)\n";
+  for (const std::string Func : {"add", "get", "nop"}) {
+    const double Copied = measure(false, Func + "_loop", Count);
+    const double InPlace = measure(true, Func + "_loop", Count);
+    std::cout << std::left << std::setw(10) << Func << std::right
+              << std::fixed << std::setprecision(2) << std::setw(10) << Copied
+              << std::setw(11) << InPlace << "\n";
+  }
+  return EXIT_SUCCESS;
+}
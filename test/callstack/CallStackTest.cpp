@@ -0,0 +1,117 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "common/configure.h"
+#include "common/errcode.h"
+#include "common/value.h"
+#include "runtime/stackmgr.h"
+#include "vm/vm.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+#include <sys/resource.h>
+
+namespace {
+
+/// Module of recursive functions:
+///   depth(n): n == 0 ? 0 : depth(n - 1) + 1
+///   forever(): call forever()
+std::array<SSVM::Byte, 75> RecursionWasm = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x09, 0x02, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x60, 0x00, 0x00, 0x03, 0x03, 0x02, 0x00, 0x01,
+    0x07, 0x13, 0x02, 0x05, 0x64, 0x65, 0x70, 0x74, 0x68, 0x00, 0x00, 0x07,
+    0x66, 0x6f, 0x72, 0x65, 0x76, 0x65, 0x72, 0x00, 0x01, 0x0a, 0x1c, 0x02,
+    0x15, 0x00, 0x20, 0x00, 0x45, 0x04, 0x7f, 0x41, 0x00, 0x05, 0x20, 0x00,
+    0x41, 0x01, 0x6b, 0x10, 0x00, 0x41, 0x01, 0x6a, 0x0b, 0x0b, 0x04, 0x00,
+    0x10, 0x01, 0x0b,
+};
+
+TEST(CallStackTest, Call__DepthLimit) {
+  SSVM::Configure Conf;
+  Conf.setMaxCallDepth(100);
+  SSVM::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(RecursionWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  /// depth(n) enters n + 1 frames.
+  std::vector<SSVM::ValVariant> Args1 = {UINT32_C(99)};
+  auto Res1 = VM.execute("depth", Args1);
+  ASSERT_TRUE(Res1);
+  EXPECT_EQ(std::get<uint32_t>((*Res1)[0]), 99U);
+
+  std::vector<SSVM::ValVariant> Args2 = {UINT32_C(100)};
+  auto Res2 = VM.execute("depth", Args2);
+  ASSERT_FALSE(Res2);
+  EXPECT_EQ(Res2.error(), SSVM::ErrCode::CallStackExhausted);
+
+  /// The stacks are usable again after the trap.
+  auto Res3 = VM.execute("depth", Args1);
+  ASSERT_TRUE(Res3);
+  EXPECT_EQ(std::get<uint32_t>((*Res3)[0]), 99U);
+}
+
+TEST(CallStackTest, Call__InfiniteRecursion) {
+  SSVM::Configure Conf;
+  SSVM::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(RecursionWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  auto Res = VM.execute("forever");
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), SSVM::ErrCode::CallStackExhausted);
+}
+
+TEST(CallStackTest, Call__ValueStackSize) {
+  /// Each frame of depth() holds its argument, so the value stack runs out
+  /// before the call depth limit.
+  SSVM::Configure Conf;
+  Conf.setValueStackSize(1024);
+  SSVM::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(RecursionWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  std::vector<SSVM::ValVariant> Args = {UINT32_C(2000)};
+  auto Res = VM.execute("depth", Args);
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), SSVM::ErrCode::CallStackExhausted);
+}
+
+TEST(CallStackTest, Reserve__Failure) {
+  /// Limit the address space below the stacks of the most values, so the
+  /// region fails to map.
+  rlimit Old;
+  ASSERT_EQ(getrlimit(RLIMIT_AS, &Old), 0);
+  rlimit New = Old;
+  New.rlim_cur = std::min<rlim_t>(Old.rlim_cur, UINT64_C(16) << 30);
+  ASSERT_EQ(setrlimit(RLIMIT_AS, &New), 0);
+  {
+    SSVM::Runtime::StackManager StackMgr(UINT32_MAX, UINT32_MAX);
+    EXPECT_FALSE(StackMgr.isReserved());
+    EXPECT_FALSE(StackMgr.hasCapacity(0));
+  }
+  {
+    SSVM::Configure Conf;
+    Conf.setValueStackSize(UINT32_MAX);
+    SSVM::VM::VM VM(Conf);
+    ASSERT_TRUE(VM.loadWasm(RecursionWasm));
+    ASSERT_TRUE(VM.validate());
+    auto Res = VM.instantiate();
+    ASSERT_FALSE(Res);
+    EXPECT_EQ(Res.error(), SSVM::ErrCode::CallStackExhausted);
+  }
+  ASSERT_EQ(setrlimit(RLIMIT_AS, &Old), 0);
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  SSVM::Log::setErrorLoggingLevel();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,238 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "common/configure.h"
+#include "common/value.h"
+#include "runtime/hostfunc.h"
+#include "runtime/importobj.h"
+#include "vm/vm.h"
+
+#include "gtest/gtest.h"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+/// Module importing the host functions "host.add" (i32, i32) -> i32,
+/// "host.get" () -> i32, and "host.nop" () -> (). The exported functions
+/// "add_loop", "get_loop", and "nop_loop" take a count N and call the host
+/// function N times in a loop:
+///   add_loop: for (i = 0; i < N; ++i) acc = add(acc, i); return acc;
+///   get_loop: for (i = 0; i < N; ++i) acc = acc + get(); return acc;
+///   nop_loop: for (i = 0; i < N; ++i) nop(); return 0;
+std::array<SSVM::Byte, 217> HostCallWasm = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x13, 0x04, 0x60,
+    0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x60, 0x00, 0x01, 0x7f, 0x60, 0x00, 0x00,
+    0x60, 0x01, 0x7f, 0x01, 0x7f, 0x02, 0x22, 0x03, 0x04, 0x68, 0x6f, 0x73,
+    0x74, 0x03, 0x61, 0x64, 0x64, 0x00, 0x00, 0x04, 0x68, 0x6f, 0x73, 0x74,
+    0x03, 0x67, 0x65, 0x74, 0x00, 0x01, 0x04, 0x68, 0x6f, 0x73, 0x74, 0x03,
+    0x6e, 0x6f, 0x70, 0x00, 0x02, 0x03, 0x04, 0x03, 0x03, 0x03, 0x03, 0x07,
+    0x22, 0x03, 0x08, 0x61, 0x64, 0x64, 0x5f, 0x6c, 0x6f, 0x6f, 0x70, 0x00,
+    0x03, 0x08, 0x67, 0x65, 0x74, 0x5f, 0x6c, 0x6f, 0x6f, 0x70, 0x00, 0x04,
+    0x08, 0x6e, 0x6f, 0x70, 0x5f, 0x6c, 0x6f, 0x6f, 0x70, 0x00, 0x05, 0x0a,
+    0x6c, 0x03, 0x25, 0x01, 0x02, 0x7f, 0x02, 0x40, 0x03, 0x40, 0x20, 0x01,
+    0x20, 0x00, 0x49, 0x45, 0x0d, 0x01, 0x20, 0x02, 0x20, 0x01, 0x10, 0x00,
+    0x21, 0x02, 0x20, 0x01, 0x41, 0x01, 0x6a, 0x21, 0x01, 0x0c, 0x00, 0x0b,
+    0x0b, 0x20, 0x02, 0x0b, 0x24, 0x01, 0x02, 0x7f, 0x02, 0x40, 0x03, 0x40,
+    0x20, 0x01, 0x20, 0x00, 0x49, 0x45, 0x0d, 0x01, 0x20, 0x02, 0x10, 0x01,
+    0x6a, 0x21, 0x02, 0x20, 0x01, 0x41, 0x01, 0x6a, 0x21, 0x01, 0x0c, 0x00,
+    0x0b, 0x0b, 0x20, 0x02, 0x0b, 0x1f, 0x01, 0x02, 0x7f, 0x02, 0x40, 0x03,
+    0x40, 0x20, 0x01, 0x20, 0x00, 0x49, 0x45, 0x0d, 0x01, 0x10, 0x02, 0x20,
+    0x01, 0x41, 0x01, 0x6a, 0x21, 0x01, 0x0c, 0x00, 0x0b, 0x0b, 0x20, 0x02,
+    0x0b,
+};
+
+class HostAdd : public SSVM::Runtime::HostFunction<HostAdd> {
+public:
+  SSVM::Expect<uint32_t> body(SSVM::Runtime::Instance::MemoryInstance *,
+                              uint32_t A, uint32_t B) {
+    return A + B;
+  }
+};
+
+class HostGet : public SSVM::Runtime::HostFunction<HostGet> {
+public:
+  SSVM::Expect<uint32_t> body(SSVM::Runtime::Instance::MemoryInstance *) {
+    return 7U;
+  }
+};
+
+class HostNop : public SSVM::Runtime::HostFunction<HostNop> {
+public:
+  SSVM::Expect<void> body(SSVM::Runtime::Instance::MemoryInstance *) {
+    return {};
+  }
+};
+
+class HostModule : public SSVM::Runtime::ImportObject {
+public:
+  HostModule() : ImportObject("host") {
+    addHostFunc("add", std::make_unique<HostAdd>());
+    addHostFunc("get", std::make_unique<HostGet>());
+    addHostFunc("nop", std::make_unique<HostNop>());
+  }
+};
+
+TEST(HostFuncTest, Call__Results) {
+  SSVM::Configure Conf;
+  SSVM::VM::VM VM(Conf);
+  HostModule Mod;
+  ASSERT_TRUE(VM.registerModule(Mod));
+  ASSERT_TRUE(VM.loadWasm(HostCallWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  std::vector<SSVM::ValVariant> Args = {UINT32_C(100)};
+  auto Res1 = VM.execute("add_loop", Args);
+  ASSERT_TRUE(Res1);
+  ASSERT_EQ((*Res1).size(), 1U);
+  EXPECT_EQ(std::get<uint32_t>((*Res1)[0]), 4950U);
+
+  auto Res2 = VM.execute("get_loop", Args);
+  ASSERT_TRUE(Res2);
+  ASSERT_EQ((*Res2).size(), 1U);
+  EXPECT_EQ(std::get<uint32_t>((*Res2)[0]), 700U);
+
+  auto Res3 = VM.execute("nop_loop", Args);
+  ASSERT_TRUE(Res3);
+  ASSERT_EQ((*Res3).size(), 1U);
+  EXPECT_EQ(std::get<uint32_t>((*Res3)[0]), 0U);
+}
+
+/// Module importing the multi-value host functions of "multi", where every
+/// call has a value below its arguments:
+///   rotate(a: i32, b: i64, c: f64): 99, multi.rotate(a, b, c)
+///   split(x: i64): 77, multi.split(x)
+///   sum3(a, b, c): 55 after multi.sum3(a, b, c)
+std::array<SSVM::Byte, 176> MultiCallWasm = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x30, 0x06, 0x60,
+    0x03, 0x7f, 0x7e, 0x7c, 0x03, 0x7c, 0x7f, 0x7e, 0x60, 0x01, 0x7e, 0x03,
+    0x7f, 0x7f, 0x7f, 0x60, 0x03, 0x7f, 0x7f, 0x7f, 0x00, 0x60, 0x03, 0x7f,
+    0x7e, 0x7c, 0x04, 0x7f, 0x7c, 0x7f, 0x7e, 0x60, 0x01, 0x7e, 0x04, 0x7f,
+    0x7f, 0x7f, 0x7f, 0x60, 0x03, 0x7f, 0x7f, 0x7f, 0x01, 0x7f, 0x02, 0x2b,
+    0x03, 0x05, 0x6d, 0x75, 0x6c, 0x74, 0x69, 0x06, 0x72, 0x6f, 0x74, 0x61,
+    0x74, 0x65, 0x00, 0x00, 0x05, 0x6d, 0x75, 0x6c, 0x74, 0x69, 0x05, 0x73,
+    0x70, 0x6c, 0x69, 0x74, 0x00, 0x01, 0x05, 0x6d, 0x75, 0x6c, 0x74, 0x69,
+    0x04, 0x73, 0x75, 0x6d, 0x33, 0x00, 0x02, 0x03, 0x04, 0x03, 0x03, 0x04,
+    0x05, 0x07, 0x19, 0x03, 0x06, 0x72, 0x6f, 0x74, 0x61, 0x74, 0x65, 0x00,
+    0x03, 0x05, 0x73, 0x70, 0x6c, 0x69, 0x74, 0x00, 0x04, 0x04, 0x73, 0x75,
+    0x6d, 0x33, 0x00, 0x05, 0x0a, 0x26, 0x03, 0x0d, 0x00, 0x41, 0xe3, 0x00,
+    0x20, 0x00, 0x20, 0x01, 0x20, 0x02, 0x10, 0x00, 0x0b, 0x09, 0x00, 0x41,
+    0xcd, 0x00, 0x20, 0x00, 0x10, 0x01, 0x0b, 0x0c, 0x00, 0x41, 0x37, 0x20,
+    0x00, 0x20, 0x01, 0x20, 0x02, 0x10, 0x02, 0x0b,
+};
+
+/// Host function counting the calls through the copying run().
+template <typename T>
+class TracedFunction : public SSVM::Runtime::HostFunction<T> {
+public:
+  TracedFunction(uint32_t &Copied) : Copied(Copied) {}
+  SSVM::Expect<void> run(SSVM::Runtime::Instance::MemoryInstance *MemInst,
+                         SSVM::Span<const SSVM::ValVariant> Args,
+                         SSVM::Span<SSVM::ValVariant> Rets) override {
+    ++Copied;
+    return SSVM::Runtime::HostFunction<T>::run(MemInst, Args, Rets);
+  }
+
+private:
+  uint32_t &Copied;
+};
+
+/// (i32, i64, f64) -> (f64, i32, i64), whose returns overwrite the arguments
+/// of the other types.
+class HostRotate : public TracedFunction<HostRotate> {
+public:
+  using TracedFunction::TracedFunction;
+  SSVM::Expect<std::tuple<double, uint32_t, uint64_t>>
+  body(SSVM::Runtime::Instance::MemoryInstance *, uint32_t A, uint64_t B,
+       double C) {
+    return std::make_tuple(C, A, B);
+  }
+};
+
+/// (i64) -> (i32, i32, i32), whose returns extend past the argument.
+class HostSplit : public TracedFunction<HostSplit> {
+public:
+  using TracedFunction::TracedFunction;
+  SSVM::Expect<std::tuple<uint32_t, uint32_t, uint32_t>>
+  body(SSVM::Runtime::Instance::MemoryInstance *, uint64_t X) {
+    return std::make_tuple(static_cast<uint32_t>(X & 0xFFFFU),
+                           static_cast<uint32_t>((X >> 16) & 0xFFFFU),
+                           static_cast<uint32_t>(X >> 32));
+  }
+};
+
+/// (i32, i32, i32) -> (), which records the sum of the arguments.
+class HostSum3 : public TracedFunction<HostSum3> {
+public:
+  HostSum3(uint32_t &Copied, uint32_t &Sum)
+      : TracedFunction(Copied), Sum(Sum) {}
+  SSVM::Expect<void> body(SSVM::Runtime::Instance::MemoryInstance *,
+                          uint32_t A, uint32_t B, uint32_t C) {
+    Sum = A + B + C;
+    return {};
+  }
+
+private:
+  uint32_t &Sum;
+};
+
+class MultiModule : public SSVM::Runtime::ImportObject {
+public:
+  MultiModule() : ImportObject("multi") {
+    addHostFunc("rotate", std::make_unique<HostRotate>(Copied));
+    addHostFunc("split", std::make_unique<HostSplit>(Copied));
+    addHostFunc("sum3", std::make_unique<HostSum3>(Copied, Sum));
+  }
+  uint32_t Copied = 0;
+  uint32_t Sum = 0;
+};
+
+TEST(HostFuncTest, Call__ValueStackSlots) {
+  SSVM::Configure Conf;
+  SSVM::VM::VM VM(Conf);
+  MultiModule Mod;
+  ASSERT_TRUE(VM.registerModule(Mod));
+  ASSERT_TRUE(VM.loadWasm(MultiCallWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  /// The returns replace the arguments in order, and the value below the
+  /// arguments is kept.
+  auto Res = VM.execute("rotate", std::vector<SSVM::ValVariant>{
+                                      7U, UINT64_C(0x100000000), 2.5});
+  ASSERT_TRUE(Res);
+  ASSERT_EQ(Res->size(), 4U);
+  EXPECT_EQ(std::get<uint32_t>((*Res)[0]), 99U);
+  EXPECT_EQ(std::get<double>((*Res)[1]), 2.5);
+  EXPECT_EQ(std::get<uint32_t>((*Res)[2]), 7U);
+  EXPECT_EQ(std::get<uint64_t>((*Res)[3]), UINT64_C(0x100000000));
+
+  Res = VM.execute("split",
+                   std::vector<SSVM::ValVariant>{UINT64_C(0x0000000512345678)});
+  ASSERT_TRUE(Res);
+  ASSERT_EQ(Res->size(), 4U);
+  EXPECT_EQ(std::get<uint32_t>((*Res)[0]), 77U);
+  EXPECT_EQ(std::get<uint32_t>((*Res)[1]), 0x5678U);
+  EXPECT_EQ(std::get<uint32_t>((*Res)[2]), 0x1234U);
+  EXPECT_EQ(std::get<uint32_t>((*Res)[3]), 5U);
+
+  Res = VM.execute("sum3", std::vector<SSVM::ValVariant>{1U, 20U, 300U});
+  ASSERT_TRUE(Res);
+  ASSERT_EQ(Res->size(), 1U);
+  EXPECT_EQ(std::get<uint32_t>((*Res)[0]), 55U);
+  EXPECT_EQ(Mod.Sum, 321U);
+
+  /// The calls run on the value stack slots instead of the copying run().
+  EXPECT_EQ(Mod.Copied, 0U);
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  SSVM::Log::setErrorLoggingLevel();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
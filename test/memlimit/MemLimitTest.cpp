@@ -35,6 +35,25 @@ TEST(MemLimitTest, Limit__Pages) {
   ASSERT_TRUE(Inst5.growPage(127));
 }
 
+TEST(MemLimitTest, Unreserved__Grow) {
+  using MemInst = SSVM::Runtime::Instance::MemoryInstance;
+  SSVM::AST::Limit Lim(0);
+  MemInst Inst(Lim, 65536, false);
+  ASSERT_FALSE(Inst.hasGuardRegion());
+  ASSERT_TRUE(Inst.getDataPtr() == nullptr);
+
+  /// The pages keep the contents when moved by growing.
+  ASSERT_TRUE(Inst.growPage(1));
+  ASSERT_FALSE(Inst.getDataPtr() == nullptr);
+  ASSERT_TRUE(Inst.storeValue(UINT32_C(0x12345678), 65532, 4));
+  ASSERT_TRUE(Inst.growPage(255));
+  uint32_t Value = 0;
+  ASSERT_TRUE(Inst.loadValue(Value, 65532, 4));
+  EXPECT_EQ(Value, UINT32_C(0x12345678));
+  EXPECT_TRUE(Inst.checkAccessBound(256 * MemInst::kPageSize - 4, 4));
+  EXPECT_FALSE(Inst.checkAccessBound(256 * MemInst::kPageSize - 3, 4));
+}
+
 } // namespace
 
 GTEST_API_ int main(int argc, char **argv) {
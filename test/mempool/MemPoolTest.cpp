@@ -0,0 +1,65 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "runtime/instance/memory.h"
+#include "runtime/mempool.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdint>
+
+namespace {
+
+TEST(MemPoolTest, Pool__Recycle) {
+  SSVM::Runtime::MemoryPool Pool(UINT64_C(0x100000), 4);
+  uint8_t *Slot1 = Pool.acquire();
+  uint8_t *Slot2 = Pool.acquire();
+  ASSERT_NE(Slot1, nullptr);
+  ASSERT_NE(Slot2, nullptr);
+  EXPECT_EQ(Slot2 - Slot1, 0x100000);
+  EXPECT_EQ(Pool.getSlotNum(), 4U);
+
+  /// The released slot is reused with the pages zero-filled.
+  ASSERT_EQ(mprotect(Slot2, 4096, PROT_READ | PROT_WRITE), 0);
+  Slot2[0] = 1;
+  Pool.release(Slot2, 4096);
+  uint8_t *Slot3 = Pool.acquire();
+  ASSERT_EQ(Slot3, Slot2);
+  ASSERT_EQ(mprotect(Slot3, 4096, PROT_READ | PROT_WRITE), 0);
+  EXPECT_EQ(Slot3[0], 0);
+  Pool.release(Slot3, 4096);
+  Pool.release(Slot1, 0);
+
+  /// A new region is reserved only after the slots are exhausted.
+  for (uint32_t I = 0; I < 5; ++I) {
+    ASSERT_NE(Pool.acquire(), nullptr);
+  }
+  EXPECT_EQ(Pool.getSlotNum(), 8U);
+}
+
+TEST(MemPoolTest, Memory__Recycle) {
+  using MemInst = SSVM::Runtime::Instance::MemoryInstance;
+  SSVM::AST::Limit Lim(1);
+  uint8_t *DataPtr;
+  {
+    MemInst Inst(Lim);
+    ASSERT_TRUE(Inst.hasGuardRegion());
+    DataPtr = Inst.getDataPtr();
+    ASSERT_TRUE(Inst.storeValue(UINT32_C(0x12345678), 0, 4));
+  }
+
+  /// The memory takes the guard window of the destroyed one, with the
+  /// contents dropped.
+  MemInst Inst(Lim);
+  ASSERT_TRUE(Inst.hasGuardRegion());
+  EXPECT_EQ(Inst.getDataPtr(), DataPtr);
+  uint32_t Value = 1;
+  ASSERT_TRUE(Inst.loadValue(Value, 0, 4));
+  EXPECT_EQ(Value, 0U);
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  SSVM::Log::setErrorLoggingLevel();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
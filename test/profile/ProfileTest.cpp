@@ -0,0 +1,321 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "common/configure.h"
+#include "common/errcode.h"
+#include "common/statistics.h"
+#include "common/value.h"
+#include "interpreter/sampler.h"
+#include "runtime/stackmgr.h"
+#include "vm/vm.h"
+
+#include "gtest/gtest.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+/// Module of recursive functions:
+///   depth(n): n == 0 ? 0 : depth(n - 1) + 1
+///   forever(): call forever()
+std::array<SSVM::Byte, 75> RecursionWasm = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x09, 0x02, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x60, 0x00, 0x00, 0x03, 0x03, 0x02, 0x00, 0x01,
+    0x07, 0x13, 0x02, 0x05, 0x64, 0x65, 0x70, 0x74, 0x68, 0x00, 0x00, 0x07,
+    0x66, 0x6f, 0x72, 0x65, 0x76, 0x65, 0x72, 0x00, 0x01, 0x0a, 0x1c, 0x02,
+    0x15, 0x00, 0x20, 0x00, 0x45, 0x04, 0x7f, 0x41, 0x00, 0x05, 0x20, 0x00,
+    0x41, 0x01, 0x6b, 0x10, 0x00, 0x41, 0x01, 0x6a, 0x0b, 0x0b, 0x04, 0x00,
+    0x10, 0x01, 0x0b,
+};
+
+/// Module of a loop with the name section:
+///   outer(n): call in;ner(n), exported as spin
+///   in;ner(n): loop n times
+std::array<SSVM::Byte, 80> LoopWasm = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x05, 0x01, 0x60,
+    0x01, 0x7f, 0x00, 0x03, 0x03, 0x02, 0x00, 0x00, 0x07, 0x08, 0x01, 0x04,
+    0x73, 0x70, 0x69, 0x6e, 0x00, 0x00, 0x0a, 0x17, 0x02, 0x06, 0x00, 0x20,
+    0x00, 0x10, 0x01, 0x0b, 0x0e, 0x00, 0x03, 0x40, 0x20, 0x00, 0x41, 0x01,
+    0x6b, 0x22, 0x00, 0x0d, 0x00, 0x0b, 0x0b, 0x00, 0x17, 0x04, 0x6e, 0x61,
+    0x6d, 0x65, 0x01, 0x10, 0x02, 0x00, 0x05, 0x6f, 0x75, 0x74, 0x65, 0x72,
+    0x01, 0x06, 0x69, 0x6e, 0x3b, 0x6e, 0x65, 0x72,
+};
+
+/// Module of the constant expressions, a global of i32.const 7 and a data
+/// segment at i32.const 0.
+std::array<SSVM::Byte, 59> ConstWasm = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x05, 0x01, 0x60,
+    0x00, 0x01, 0x7f, 0x03, 0x02, 0x01, 0x00, 0x05, 0x03, 0x01, 0x00, 0x01,
+    0x06, 0x06, 0x01, 0x7f, 0x00, 0x41, 0x07, 0x0b, 0x07, 0x07, 0x01, 0x03,
+    0x67, 0x65, 0x74, 0x00, 0x00, 0x0a, 0x06, 0x01, 0x04, 0x00, 0x23, 0x00,
+    0x0b, 0x0b, 0x08, 0x01, 0x00, 0x41, 0x00, 0x0b, 0x02, 0x61, 0x62,
+};
+
+uint32_t getFuncAddr(SSVM::VM::VM &VM, std::string_view Name) {
+  const auto *ModInst = *VM.getStoreManager().getActiveModule();
+  return ModInst->getFuncExports().find(Name)->second;
+}
+
+TEST(ProfileTest, Interpreter__Counts) {
+  SSVM::Configure Conf;
+  SSVM::VM::VM VM(Conf);
+  VM.getStatistics().setProfiling(true);
+  ASSERT_TRUE(VM.loadWasm(RecursionWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  std::vector<SSVM::ValVariant> Args = {UINT32_C(5)};
+  ASSERT_TRUE(VM.execute("depth", Args));
+
+  const auto &Stat = VM.getStatistics();
+  const auto OpCounts = Stat.getOpCounts();
+  EXPECT_EQ(OpCounts[uint16_t(SSVM::OpCode::Call)], 5U);
+  EXPECT_EQ(OpCounts[uint16_t(SSVM::OpCode::I32__eqz)], 6U);
+
+  /// All instructions run in the frames of depth().
+  const auto &Prof = Stat.getFunctionProfiles()[getFuncAddr(VM, "depth")];
+  EXPECT_EQ(Prof.CallCnt, 6U);
+  EXPECT_EQ(Prof.InstrCnt, Stat.getInstrCount());
+}
+
+TEST(ProfileTest, Interpreter__Trap) {
+  SSVM::Configure Conf;
+  Conf.setMaxCallDepth(10);
+  SSVM::VM::VM VM(Conf);
+  VM.getStatistics().setProfiling(true);
+  ASSERT_TRUE(VM.loadWasm(RecursionWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  /// The frames unwound by the trap are left, so the next call is charged to
+  /// depth() only.
+  ASSERT_FALSE(VM.execute("forever"));
+  const auto &Stat = VM.getStatistics();
+  const uint64_t Before = Stat.getInstrCount();
+  std::vector<SSVM::ValVariant> Args = {UINT32_C(0)};
+  ASSERT_TRUE(VM.execute("depth", Args));
+  EXPECT_EQ(Stat.getFunctionProfiles()[getFuncAddr(VM, "forever")].CallCnt,
+            10U);
+  EXPECT_EQ(Stat.getFunctionProfiles()[getFuncAddr(VM, "depth")].InstrCnt,
+            Stat.getInstrCount() - Before);
+}
+
+TEST(ProfileTest, Dump__Formats) {
+  SSVM::Configure Conf;
+  SSVM::VM::VM VM(Conf);
+  VM.getStatistics().setProfiling(true);
+  ASSERT_TRUE(VM.loadWasm(RecursionWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  std::vector<SSVM::ValVariant> Args = {UINT32_C(5)};
+  ASSERT_TRUE(VM.execute("depth", Args));
+
+  std::vector<std::string> Names(getFuncAddr(VM, "depth") + 1);
+  Names.back() = "depth";
+  std::ostringstream JSON, CSV;
+  VM.getStatistics().dumpProfile(JSON, SSVM::Statistics::ProfileFormat::JSON,
+                                 Names);
+  VM.getStatistics().dumpProfile(CSV, SSVM::Statistics::ProfileFormat::CSV,
+                                 Names);
+  EXPECT_NE(JSON.str().find("{\"opcode\": \"call\", \"count\": 5}"),
+            std::string::npos);
+  EXPECT_NE(JSON.str().find("\"name\": \"depth\", \"calls\": 6"),
+            std::string::npos);
+  EXPECT_NE(CSV.str().find("\nopcode,call,5,,\n"), std::string::npos);
+  EXPECT_NE(CSV.str().find("\nfunction,depth,6,66,"), std::string::npos);
+}
+
+TEST(ProfileTest, Statistics__Selection) {
+  /// Nothing is recorded by default.
+  SSVM::Configure Conf;
+  {
+    SSVM::VM::VM VM(Conf);
+    ASSERT_TRUE(VM.loadWasm(RecursionWasm));
+    ASSERT_TRUE(VM.validate());
+    ASSERT_TRUE(VM.instantiate());
+    std::vector<SSVM::ValVariant> Args = {UINT32_C(5)};
+    ASSERT_TRUE(VM.execute("depth", Args));
+    EXPECT_EQ(VM.getStatistics().getInstrCount(), 0U);
+    EXPECT_EQ(VM.getStatistics().getTotalCost(), 0U);
+  }
+
+  /// Counting and gas are recorded separately.
+  Conf.setInstructionCounting(true);
+  {
+    SSVM::VM::VM VM(Conf);
+    ASSERT_TRUE(VM.loadWasm(RecursionWasm));
+    ASSERT_TRUE(VM.validate());
+    ASSERT_TRUE(VM.instantiate());
+    std::vector<SSVM::ValVariant> Args = {UINT32_C(5)};
+    ASSERT_TRUE(VM.execute("depth", Args));
+    EXPECT_EQ(VM.getStatistics().getInstrCount(), 66U);
+    EXPECT_EQ(VM.getStatistics().getTotalCost(), 0U);
+  }
+}
+
+TEST(ProfileTest, Statistics__CostLimit) {
+  SSVM::Configure Conf;
+  Conf.setCostMeasuring(true);
+  SSVM::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(RecursionWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  /// Every instruction costs 1 by default.
+  std::vector<SSVM::ValVariant> Args = {UINT32_C(5)};
+  ASSERT_TRUE(VM.execute("depth", Args));
+  EXPECT_EQ(VM.getStatistics().getTotalCost(), 66U);
+  EXPECT_EQ(VM.getStatistics().getInstrCount(), 0U);
+
+  VM.getStatistics().setCostLimit(100);
+  auto Res = VM.execute("depth", Args);
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), SSVM::ErrCode::CostLimitExceeded);
+}
+
+TEST(ProfileTest, Statistics__CostLimitOnly) {
+  /// The cost limit alone turns on the cost measuring.
+  SSVM::Configure Conf;
+  SSVM::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(RecursionWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  std::vector<SSVM::ValVariant> Args = {UINT32_C(5)};
+  ASSERT_TRUE(VM.execute("depth", Args));
+  EXPECT_EQ(VM.getStatistics().getTotalCost(), 0U);
+
+  /// Every instruction costs 1 by default, and depth(5) costs 66.
+  VM.getStatistics().setCostLimit(50);
+  auto Res = VM.execute("depth", Args);
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), SSVM::ErrCode::CostLimitExceeded);
+
+  /// So does the cost table alone.
+  VM.getStatistics().clear();
+  VM.getStatistics().setCostLimit(UINT64_MAX);
+  std::vector<uint64_t> Table(UINT16_MAX + 1, 2);
+  VM.getStatistics().setCostTable(Table);
+  ASSERT_TRUE(VM.execute("depth", Args));
+  EXPECT_EQ(VM.getStatistics().getTotalCost(), 132U);
+}
+
+TEST(ProfileTest, Statistics__BlockCosts) {
+  SSVM::Configure Conf;
+  Conf.setCostMeasuring(true);
+  SSVM::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(RecursionWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  /// The blocks are summed again by the table replaced after instantiation,
+  /// and the blocks with i32.eqz overflow the 32 bits block costs.
+  std::vector<uint64_t> Table(UINT16_MAX + 1, 3);
+  Table[uint16_t(SSVM::OpCode::I32__eqz)] = UINT64_C(1) << 40;
+  VM.getStatistics().setCostTable(Table);
+  std::vector<SSVM::ValVariant> Args = {UINT32_C(5)};
+  ASSERT_TRUE(VM.execute("depth", Args));
+  EXPECT_EQ(VM.getStatistics().getTotalCost(),
+            60U * 3U + 6U * (UINT64_C(1) << 40));
+
+  /// The block of the eqz in the last call exceeds the limit.
+  VM.getStatistics().clear();
+  VM.getStatistics().setCostLimit(5U * (UINT64_C(1) << 40) + 1000U);
+  auto Res = VM.execute("depth", Args);
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), SSVM::ErrCode::CostLimitExceeded);
+}
+
+TEST(ProfileTest, Statistics__ConstExprCosts) {
+  /// Both constant expressions cost i32.const and end on every instantiation.
+  SSVM::Configure Conf;
+  Conf.setCostMeasuring(true);
+  {
+    SSVM::VM::VM VM(Conf);
+    ASSERT_TRUE(VM.loadWasm(ConstWasm));
+    ASSERT_TRUE(VM.validate());
+    ASSERT_TRUE(VM.instantiate());
+    EXPECT_EQ(VM.getStatistics().getTotalCost(), 4U);
+    ASSERT_TRUE(VM.instantiate());
+    EXPECT_EQ(VM.getStatistics().getTotalCost(), 8U);
+  }
+
+  SSVM::VM::VM VM(Conf);
+  VM.getStatistics().setCostLimit(3);
+  ASSERT_TRUE(VM.loadWasm(ConstWasm));
+  ASSERT_TRUE(VM.validate());
+  auto Res = VM.instantiate();
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), SSVM::ErrCode::CostLimitExceeded);
+}
+
+TEST(ProfileTest, Sampler__Folded) {
+  SSVM::Configure Conf;
+  SSVM::VM::VM VM(Conf);
+  SSVM::Interpreter::Sampler Samp(1000);
+  VM.setSampler(&Samp);
+  ASSERT_TRUE(VM.loadWasm(LoopWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  /// Run until sampled, as the samples are taken by the CPU time.
+  std::vector<SSVM::ValVariant> Args = {UINT32_C(1000000)};
+  for (uint32_t I = 0; I < 1000 && Samp.getSampleCount() == 0; ++I) {
+    ASSERT_TRUE(VM.execute("spin", Args));
+  }
+  ASSERT_GT(Samp.getSampleCount(), 0U);
+  EXPECT_EQ(Samp.getDroppedCount(), 0U);
+
+  /// Name the functions by the name section.
+  const auto *ModInst = *VM.getStoreManager().getActiveModule();
+  std::vector<std::string> Names(ModInst->getFuncNum());
+  for (uint32_t I = 0; I < ModInst->getFuncNum(); ++I) {
+    const uint32_t Addr = *ModInst->getFuncAddr(I);
+    if (Addr >= Names.size()) {
+      Names.resize(Addr + 1);
+    }
+    Names[Addr] = ModInst->getFuncName(I);
+  }
+  std::ostringstream OS;
+  Samp.dumpFolded(OS, Names);
+  EXPECT_EQ(OS.str().rfind("outer;in:ner ", 0), 0U);
+}
+
+/// Burn the CPU time of the calling thread.
+void spin(const std::chrono::milliseconds Duration) {
+  const auto Stop = std::chrono::steady_clock::now() + Duration;
+  volatile uint64_t Count = 0;
+  while (std::chrono::steady_clock::now() < Stop) {
+    Count = Count + 1;
+  }
+}
+
+TEST(ProfileTest, Sampler__ThreadTimer) {
+  SSVM::Runtime::StackManager StackMgr(1024, 16);
+  StackMgr.pushFrame(0, 0, 0, {}, 1);
+  SSVM::Interpreter::Sampler Samp(1000);
+
+  /// The CPU time of the other threads is not sampled.
+  ASSERT_TRUE(Samp.start(StackMgr));
+  std::thread Worker(spin, std::chrono::milliseconds(200));
+  Worker.join();
+  Samp.stop();
+  EXPECT_EQ(Samp.getSampleCount(), 0U);
+
+  /// The CPU time of the sampling thread is.
+  ASSERT_TRUE(Samp.start(StackMgr));
+  spin(std::chrono::milliseconds(200));
+  Samp.stop();
+  EXPECT_GT(Samp.getSampleCount(), 0U);
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  SSVM::Log::setErrorLoggingLevel();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,124 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "common/configure.h"
+#include "common/value.h"
+#include "vm/vm.h"
+
+#include "gtest/gtest.h"
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+/// Module of the functions run by the register tier:
+///   fac(n: i64): n! by a loop
+///   fib(n): fib(n - 1) + fib(n - 2) by the recursive calls
+///   sum(n): writes mem[i] = i * i for i < n, then sums the loads
+///   sel(x): 10, 20, or 30 by br_table
+///   div(a, b): a / b, which traps on zero
+///   mixed(x): x + ref.is_null(ref.null func), whose callee is left to the
+///             stack-based engine
+std::array<SSVM::Byte, 288> RegisterWasm = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x15, 0x04, 0x60,
+    0x01, 0x7e, 0x01, 0x7e, 0x60, 0x01, 0x7f, 0x01, 0x7f, 0x60, 0x02, 0x7f,
+    0x7f, 0x01, 0x7f, 0x60, 0x00, 0x01, 0x7f, 0x03, 0x08, 0x07, 0x00, 0x01,
+    0x01, 0x01, 0x02, 0x01, 0x03, 0x05, 0x03, 0x01, 0x00, 0x01, 0x07, 0x27,
+    0x06, 0x03, 0x66, 0x61, 0x63, 0x00, 0x00, 0x03, 0x66, 0x69, 0x62, 0x00,
+    0x01, 0x03, 0x73, 0x75, 0x6d, 0x00, 0x02, 0x03, 0x73, 0x65, 0x6c, 0x00,
+    0x03, 0x03, 0x64, 0x69, 0x76, 0x00, 0x04, 0x05, 0x6d, 0x69, 0x78, 0x65,
+    0x64, 0x00, 0x05, 0x0a, 0xc6, 0x01, 0x07, 0x25, 0x01, 0x01, 0x7e, 0x42,
+    0x01, 0x21, 0x01, 0x02, 0x40, 0x03, 0x40, 0x20, 0x00, 0x50, 0x0d, 0x01,
+    0x20, 0x01, 0x20, 0x00, 0x7e, 0x21, 0x01, 0x20, 0x00, 0x42, 0x01, 0x7d,
+    0x21, 0x00, 0x0c, 0x00, 0x0b, 0x0b, 0x20, 0x01, 0x0b, 0x1c, 0x00, 0x20,
+    0x00, 0x41, 0x02, 0x49, 0x04, 0x7f, 0x20, 0x00, 0x05, 0x20, 0x00, 0x41,
+    0x01, 0x6b, 0x10, 0x01, 0x20, 0x00, 0x41, 0x02, 0x6b, 0x10, 0x01, 0x6a,
+    0x0b, 0x0b, 0x50, 0x01, 0x02, 0x7f, 0x02, 0x40, 0x03, 0x40, 0x20, 0x01,
+    0x20, 0x00, 0x4f, 0x0d, 0x01, 0x20, 0x01, 0x41, 0x02, 0x74, 0x20, 0x01,
+    0x20, 0x01, 0x6c, 0x36, 0x02, 0x00, 0x20, 0x01, 0x41, 0x01, 0x6a, 0x21,
+    0x01, 0x0c, 0x00, 0x0b, 0x0b, 0x41, 0x00, 0x21, 0x01, 0x02, 0x40, 0x03,
+    0x40, 0x20, 0x01, 0x20, 0x00, 0x4f, 0x0d, 0x01, 0x20, 0x02, 0x20, 0x01,
+    0x41, 0x02, 0x74, 0x28, 0x02, 0x00, 0x6a, 0x21, 0x02, 0x20, 0x01, 0x41,
+    0x01, 0x6a, 0x21, 0x01, 0x0c, 0x00, 0x0b, 0x0b, 0x20, 0x02, 0x0b, 0x1a,
+    0x00, 0x02, 0x40, 0x02, 0x40, 0x02, 0x40, 0x20, 0x00, 0x0e, 0x02, 0x00,
+    0x01, 0x02, 0x0b, 0x41, 0x0a, 0x0f, 0x0b, 0x41, 0x14, 0x0f, 0x0b, 0x41,
+    0x1e, 0x0b, 0x07, 0x00, 0x20, 0x00, 0x20, 0x01, 0x6d, 0x0b, 0x07, 0x00,
+    0x20, 0x00, 0x10, 0x06, 0x6a, 0x0b, 0x05, 0x00, 0xd0, 0x70, 0xd1, 0x0b,
+};
+
+/// Result of running the function on a new instance.
+struct RunResult {
+  bool Success;
+  std::vector<SSVM::ValVariant> Rets;
+  uint64_t InstrCount;
+  uint64_t TotalCost;
+};
+
+RunResult run(const bool RegisterTier, std::string_view Func,
+              std::vector<SSVM::ValVariant> Args) {
+  SSVM::Configure Conf;
+  Conf.addProposal(SSVM::Proposal::ReferenceTypes);
+  Conf.setRegisterTier(RegisterTier);
+  Conf.setInstructionCounting(true);
+  Conf.setCostMeasuring(true);
+  SSVM::VM::VM VM(Conf);
+  EXPECT_TRUE(VM.loadWasm(RegisterWasm));
+  EXPECT_TRUE(VM.validate());
+  EXPECT_TRUE(VM.instantiate());
+  auto Res = VM.execute(Func, Args);
+  return {static_cast<bool>(Res), Res ? *Res : std::vector<SSVM::ValVariant>{},
+          VM.getStatistics().getInstrCount(),
+          VM.getStatistics().getTotalCost()};
+}
+
+/// Check the register tier returns and charges the same as the stack-based
+/// engine.
+template <typename T>
+void check(std::string_view Func, std::vector<SSVM::ValVariant> Args,
+           const T Expected) {
+  const auto Stack = run(false, Func, Args);
+  const auto Reg = run(true, Func, Args);
+  ASSERT_TRUE(Stack.Success);
+  ASSERT_TRUE(Reg.Success);
+  ASSERT_EQ(Reg.Rets.size(), 1U);
+  EXPECT_EQ(std::get<T>(Stack.Rets[0]), Expected);
+  EXPECT_EQ(std::get<T>(Reg.Rets[0]), Expected);
+  EXPECT_EQ(Reg.InstrCount, Stack.InstrCount);
+  EXPECT_EQ(Reg.TotalCost, Stack.TotalCost);
+}
+
+TEST(RegisterTierTest, Run__Loop) {
+  check("fac", {UINT64_C(20)}, UINT64_C(2432902008176640000));
+}
+
+TEST(RegisterTierTest, Run__Call) { check("fib", {UINT32_C(20)}, 6765U); }
+
+TEST(RegisterTierTest, Run__Memory) {
+  check("sum", {UINT32_C(100)}, 328350U);
+}
+
+TEST(RegisterTierTest, Run__BrTable) {
+  check("sel", {UINT32_C(0)}, 10U);
+  check("sel", {UINT32_C(1)}, 20U);
+  check("sel", {UINT32_C(7)}, 30U);
+}
+
+TEST(RegisterTierTest, Run__Fallback) { check("mixed", {UINT32_C(41)}, 42U); }
+
+TEST(RegisterTierTest, Run__Trap) {
+  check("div", {UINT32_C(42), UINT32_C(6)}, 7U);
+  const auto Stack = run(false, "div", {UINT32_C(1), UINT32_C(0)});
+  const auto Reg = run(true, "div", {UINT32_C(1), UINT32_C(0)});
+  EXPECT_FALSE(Stack.Success);
+  EXPECT_FALSE(Reg.Success);
+  EXPECT_EQ(Reg.InstrCount, Stack.InstrCount);
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  SSVM::Log::setErrorLoggingLevel();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,181 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "common/configure.h"
+#include "common/value.h"
+#include "vm/preinit.h"
+#include "vm/vm.h"
+
+#include "gtest/gtest.h"
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace {
+
+/// Module of a memory, a mutable global, and a table of one function:
+///   init(): mem[16] = 42; g = 7
+///   get(): mem[16] + g
+///   bump(): mem[16] += 1
+///   call(): call_indirect table[0], which is get
+std::array<SSVM::Byte, 135> CounterWasm = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x08, 0x02, 0x60,
+    0x00, 0x00, 0x60, 0x00, 0x01, 0x7f, 0x03, 0x05, 0x04, 0x00, 0x01, 0x00,
+    0x01, 0x04, 0x04, 0x01, 0x70, 0x00, 0x01, 0x05, 0x03, 0x01, 0x00, 0x01,
+    0x06, 0x06, 0x01, 0x7f, 0x01, 0x41, 0x00, 0x0b, 0x07, 0x1c, 0x04, 0x04,
+    0x69, 0x6e, 0x69, 0x74, 0x00, 0x00, 0x03, 0x67, 0x65, 0x74, 0x00, 0x01,
+    0x04, 0x62, 0x75, 0x6d, 0x70, 0x00, 0x02, 0x04, 0x63, 0x61, 0x6c, 0x6c,
+    0x00, 0x03, 0x09, 0x07, 0x01, 0x00, 0x41, 0x00, 0x0b, 0x01, 0x01, 0x0a,
+    0x32, 0x04, 0x0d, 0x00, 0x41, 0x10, 0x41, 0x2a, 0x36, 0x02, 0x00, 0x41,
+    0x07, 0x24, 0x00, 0x0b, 0x0a, 0x00, 0x41, 0x10, 0x28, 0x02, 0x00, 0x23,
+    0x00, 0x6a, 0x0b, 0x0f, 0x00, 0x41, 0x10, 0x41, 0x10, 0x28, 0x02, 0x00,
+    0x41, 0x01, 0x6a, 0x36, 0x02, 0x00, 0x0b, 0x07, 0x00, 0x41, 0x00, 0x11,
+    0x01, 0x00, 0x0b,
+};
+
+/// Module of a table of one function, which the start function clears:
+///   start(): table[0] = null
+///   call(): call_indirect table[0]
+std::array<SSVM::Byte, 77> StartWasm = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x08, 0x02, 0x60,
+    0x00, 0x00, 0x60, 0x00, 0x01, 0x7f, 0x03, 0x04, 0x03, 0x00, 0x01, 0x01,
+    0x04, 0x04, 0x01, 0x70, 0x00, 0x01, 0x07, 0x08, 0x01, 0x04, 0x63, 0x61,
+    0x6c, 0x6c, 0x00, 0x02, 0x08, 0x01, 0x00, 0x09, 0x07, 0x01, 0x00, 0x41,
+    0x00, 0x0b, 0x01, 0x01, 0x0a, 0x17, 0x03, 0x08, 0x00, 0x41, 0x00, 0xd0,
+    0x70, 0x26, 0x00, 0x0b, 0x04, 0x00, 0x41, 0x01, 0x0b, 0x07, 0x00, 0x41,
+    0x00, 0x11, 0x01, 0x00, 0x0b,
+};
+
+uint32_t call(SSVM::VM::VM &VM, std::string_view Func) {
+  auto Res = VM.execute(Func);
+  EXPECT_TRUE(Res);
+  return Res && !Res->empty() ? std::get<uint32_t>((*Res)[0]) : 0;
+}
+
+TEST(SnapshotTest, VM__Restore) {
+  SSVM::Configure Conf;
+  std::shared_ptr<const SSVM::Runtime::Snapshot> Snap;
+  {
+    SSVM::VM::VM VM(Conf);
+    EXPECT_FALSE(VM.snapshot());
+    ASSERT_TRUE(VM.loadWasm(CounterWasm));
+    ASSERT_TRUE(VM.validate());
+    ASSERT_TRUE(VM.instantiate());
+    ASSERT_TRUE(VM.execute("init"));
+    auto Res = VM.snapshot();
+    ASSERT_TRUE(Res);
+    Snap = *Res;
+    EXPECT_EQ(Snap->MemoryPages, 1U);
+
+    /// The original instance keeps running after the snapshot.
+    ASSERT_TRUE(VM.execute("bump"));
+    EXPECT_EQ(call(VM, "get"), 50U);
+  }
+
+  /// The restored instance starts from the initialized state, and the written
+  /// pages are private to the instance.
+  {
+    SSVM::VM::VM VM(Conf);
+    ASSERT_TRUE(VM.instantiate(*Snap));
+    EXPECT_EQ(call(VM, "get"), 49U);
+    EXPECT_EQ(call(VM, "call"), 49U);
+    ASSERT_TRUE(VM.execute("bump"));
+    EXPECT_EQ(call(VM, "get"), 50U);
+  }
+  SSVM::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.instantiate(*Snap));
+  EXPECT_EQ(call(VM, "get"), 49U);
+}
+
+TEST(SnapshotTest, VM__Recycle) {
+  SSVM::Configure Conf;
+  std::shared_ptr<const SSVM::Runtime::Snapshot> Snap;
+  {
+    SSVM::VM::VM VM(Conf);
+    ASSERT_TRUE(VM.loadWasm(CounterWasm));
+    ASSERT_TRUE(VM.validate());
+    ASSERT_TRUE(VM.instantiate());
+    ASSERT_TRUE(VM.execute("init"));
+    auto Res = VM.snapshot();
+    ASSERT_TRUE(Res);
+    Snap = *Res;
+  }
+
+  /// The snapshot outlives the original instance, and the window of the
+  /// restored memory is recycled without the pages of the snapshot.
+  {
+    SSVM::VM::VM VM(Conf);
+    ASSERT_TRUE(VM.instantiate(*Snap));
+    EXPECT_EQ(call(VM, "get"), 49U);
+  }
+  SSVM::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(CounterWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  EXPECT_EQ(call(VM, "get"), 0U);
+}
+
+TEST(SnapshotTest, VM__Preinitialize) {
+  SSVM::Configure Conf;
+  std::vector<SSVM::Byte> Code;
+  {
+    SSVM::VM::VM VM(Conf);
+    ASSERT_TRUE(VM.loadWasm(CounterWasm));
+    ASSERT_TRUE(VM.validate());
+    ASSERT_TRUE(VM.instantiate());
+    auto Base = VM.snapshot();
+    ASSERT_TRUE(Base);
+    ASSERT_TRUE(VM.execute("init"));
+    auto Snap = VM.snapshot();
+    ASSERT_TRUE(Snap);
+    auto Res = SSVM::VM::preinitialize(CounterWasm, **Base, **Snap, "init");
+    ASSERT_TRUE(Res);
+    Code = std::move(*Res);
+
+    /// The changed tables cannot be written.
+    SSVM::Runtime::Snapshot Other;
+    Other.Tables.resize(1);
+    EXPECT_FALSE(SSVM::VM::preinitialize(CounterWasm, Other, **Snap, "init"));
+  }
+
+  /// The written module starts from the initialized state without the
+  /// initializer.
+  SSVM::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(Code));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  EXPECT_FALSE(VM.execute("init"));
+  EXPECT_EQ(call(VM, "get"), 49U);
+  EXPECT_EQ(call(VM, "call"), 49U);
+}
+
+TEST(SnapshotTest, VM__PreinitializeStart) {
+  SSVM::Configure Conf;
+  Conf.addProposal(SSVM::Proposal::ReferenceTypes);
+  auto Stripped = SSVM::VM::removeStart(StartWasm);
+  ASSERT_TRUE(Stripped);
+  SSVM::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.loadWasm(*Stripped));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  EXPECT_EQ(call(VM, "call"), 1U);
+  auto Base = VM.snapshot();
+  ASSERT_TRUE(Base);
+
+  /// The table written by the start function cannot be kept in the binary.
+  ASSERT_TRUE(VM.loadWasm(StartWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+  EXPECT_FALSE(VM.execute("call"));
+  auto Snap = VM.snapshot();
+  ASSERT_TRUE(Snap);
+  EXPECT_FALSE(SSVM::VM::preinitialize(StartWasm, **Base, **Snap, "init"));
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  SSVM::Log::setErrorLoggingLevel();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
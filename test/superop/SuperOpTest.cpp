@@ -0,0 +1,147 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "common/configure.h"
+#include "common/value.h"
+#include "loader/loader.h"
+#include "validator/validator.h"
+#include "vm/vm.h"
+
+#include "gtest/gtest.h"
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+/// Module of the superinstruction sequences, where every function is paired
+/// with the same sequence split by a nop:
+///   add_set(x): local.get 0; i32.const 5; i32.add; local.set 1; local.get 1
+///   add(a, b): local.get 0; local.get 1; i32.add
+///   load(p): local.get 0; i32.load offset=4, where mem[4] = 0x12345678
+///   and(x): local.get 0; i32.const 0xf0; i32.and
+///   eqz(x): block (result i32) i32.const 1; local.get 0; i32.eqz; br_if 0;
+///           drop; i32.const 2; end
+std::array<SSVM::Byte, 263> SuperOpWasm = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x0c, 0x02, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x60, 0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x03, 0x0b,
+    0x0a, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05,
+    0x03, 0x01, 0x00, 0x01, 0x07, 0x5b, 0x0a, 0x07, 0x61, 0x64, 0x64, 0x5f,
+    0x73, 0x65, 0x74, 0x00, 0x00, 0x0b, 0x61, 0x64, 0x64, 0x5f, 0x73, 0x65,
+    0x74, 0x5f, 0x6e, 0x6f, 0x70, 0x00, 0x01, 0x03, 0x61, 0x64, 0x64, 0x00,
+    0x02, 0x07, 0x61, 0x64, 0x64, 0x5f, 0x6e, 0x6f, 0x70, 0x00, 0x03, 0x04,
+    0x6c, 0x6f, 0x61, 0x64, 0x00, 0x04, 0x08, 0x6c, 0x6f, 0x61, 0x64, 0x5f,
+    0x6e, 0x6f, 0x70, 0x00, 0x05, 0x03, 0x61, 0x6e, 0x64, 0x00, 0x06, 0x07,
+    0x61, 0x6e, 0x64, 0x5f, 0x6e, 0x6f, 0x70, 0x00, 0x07, 0x03, 0x65, 0x71,
+    0x7a, 0x00, 0x08, 0x07, 0x65, 0x71, 0x7a, 0x5f, 0x6e, 0x6f, 0x70, 0x00,
+    0x09, 0x0a, 0x74, 0x0a, 0x0d, 0x01, 0x01, 0x7f, 0x20, 0x00, 0x41, 0x05,
+    0x6a, 0x21, 0x01, 0x20, 0x01, 0x0b, 0x0e, 0x01, 0x01, 0x7f, 0x20, 0x00,
+    0x01, 0x41, 0x05, 0x6a, 0x21, 0x01, 0x20, 0x01, 0x0b, 0x07, 0x00, 0x20,
+    0x00, 0x20, 0x01, 0x6a, 0x0b, 0x08, 0x00, 0x20, 0x00, 0x01, 0x20, 0x01,
+    0x6a, 0x0b, 0x07, 0x00, 0x20, 0x00, 0x28, 0x02, 0x04, 0x0b, 0x08, 0x00,
+    0x20, 0x00, 0x01, 0x28, 0x02, 0x04, 0x0b, 0x08, 0x00, 0x20, 0x00, 0x41,
+    0xf0, 0x01, 0x71, 0x0b, 0x09, 0x00, 0x20, 0x00, 0x41, 0xf0, 0x01, 0x01,
+    0x71, 0x0b, 0x0f, 0x00, 0x02, 0x7f, 0x41, 0x01, 0x20, 0x00, 0x45, 0x0d,
+    0x00, 0x1a, 0x41, 0x02, 0x0b, 0x0b, 0x10, 0x00, 0x02, 0x7f, 0x41, 0x01,
+    0x20, 0x00, 0x45, 0x01, 0x0d, 0x00, 0x1a, 0x41, 0x02, 0x0b, 0x0b, 0x0b,
+    0x0a, 0x01, 0x00, 0x41, 0x04, 0x0b, 0x04, 0x78, 0x56, 0x34, 0x12,
+};
+
+/// Run the function on a new instance.
+SSVM::Expect<std::vector<SSVM::ValVariant>>
+run(std::string_view Func, std::vector<SSVM::ValVariant> Args) {
+  SSVM::Configure Conf;
+  SSVM::VM::VM VM(Conf);
+  EXPECT_TRUE(VM.loadWasm(SuperOpWasm));
+  EXPECT_TRUE(VM.validate());
+  EXPECT_TRUE(VM.instantiate());
+  return VM.execute(Func, Args);
+}
+
+/// Check the fused sequence returns or traps the same as the unfused one.
+void check(std::string_view Func, std::vector<SSVM::ValVariant> Args,
+           const SSVM::Expect<uint32_t> Expected) {
+  const auto Fused = run(Func, Args);
+  const auto Unfused = run(std::string(Func) + "_nop", Args);
+  ASSERT_EQ(static_cast<bool>(Fused), static_cast<bool>(Expected));
+  ASSERT_EQ(static_cast<bool>(Unfused), static_cast<bool>(Expected));
+  if (Expected) {
+    EXPECT_EQ(std::get<uint32_t>((*Fused)[0]), *Expected);
+    EXPECT_EQ(std::get<uint32_t>((*Unfused)[0]), *Expected);
+  } else {
+    EXPECT_EQ(Fused.error(), Expected.error());
+    EXPECT_EQ(Unfused.error(), Expected.error());
+  }
+}
+
+TEST(SuperOpTest, Validator__Fuse) {
+  SSVM::Configure Conf;
+  SSVM::Loader::Loader Loader(Conf);
+  SSVM::Validator::Validator Validator(Conf);
+  auto Mod = Loader.parseModule(SuperOpWasm);
+  ASSERT_TRUE(Mod);
+  ASSERT_TRUE(Validator.validate(**Mod));
+
+  /// The fused sequences are marked on their first instruction, and the ones
+  /// split by the nop are left.
+  const std::array<std::pair<uint32_t, SSVM::SuperOp>, 5> Expected = {{
+      {0, SSVM::SuperOp::LocalGet_I32Const_I32Add_LocalSet},
+      {0, SSVM::SuperOp::LocalGet_LocalGet_I32Add},
+      {0, SSVM::SuperOp::LocalGet_I32Load},
+      {1, SSVM::SuperOp::I32Const_I32And},
+      {3, SSVM::SuperOp::I32Eqz_BrIf},
+  }};
+  const auto Segs = (*Mod)->getCodeSection().getContent();
+  ASSERT_EQ(Segs.size(), Expected.size() * 2);
+  for (uint32_t I = 0; I < Expected.size(); ++I) {
+    const auto Fused = Segs[I * 2].getInstrs();
+    for (uint32_t J = 0; J < Fused.size(); ++J) {
+      EXPECT_EQ(Fused[J].getSuperOp(), J == Expected[I].first
+                                           ? Expected[I].second
+                                           : SSVM::SuperOp::None);
+    }
+    for (const auto &Instr : Segs[I * 2 + 1].getInstrs()) {
+      EXPECT_EQ(Instr.getSuperOp(), SSVM::SuperOp::None);
+    }
+  }
+}
+
+TEST(SuperOpTest, Fused__LocalGet_I32Const_I32Add_LocalSet) {
+  check("add_set", {uint32_t(0)}, 5U);
+  check("add_set", {uint32_t(-5)}, 0U);
+  check("add_set", {uint32_t(0x7FFFFFFF)}, 0x80000004U);
+}
+
+TEST(SuperOpTest, Fused__LocalGet_LocalGet_I32Add) {
+  check("add", {uint32_t(1), uint32_t(2)}, 3U);
+  check("add", {uint32_t(0xFFFFFFFF), uint32_t(2)}, 1U);
+}
+
+TEST(SuperOpTest, Fused__LocalGet_I32Load) {
+  check("load", {uint32_t(0)}, 0x12345678U);
+  check("load", {uint32_t(2)}, 0x00001234U);
+  check("load", {uint32_t(65528)}, 0U);
+  check("load", {uint32_t(65529)},
+        SSVM::Unexpect(SSVM::ErrCode::MemoryOutOfBounds));
+  check("load", {uint32_t(0xFFFFFFFF)},
+        SSVM::Unexpect(SSVM::ErrCode::MemoryOutOfBounds));
+}
+
+TEST(SuperOpTest, Fused__I32Const_I32And) {
+  check("and", {uint32_t(0x1234)}, 0x30U);
+  check("and", {uint32_t(0x0F)}, 0U);
+}
+
+TEST(SuperOpTest, Fused__I32Eqz_BrIf) {
+  check("eqz", {uint32_t(0)}, 1U);
+  check("eqz", {uint32_t(7)}, 2U);
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  SSVM::Log::setErrorLoggingLevel();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,113 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "common/configure.h"
+#include "common/value.h"
+#include "vm/vm.h"
+
+#include "gtest/gtest.h"
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace {
+
+/// Module of tail calling functions:
+///   count(n, acc): n == 0 ? acc : return_call count(n - 1, acc + 1)
+///   is_even(n): n == 0 ? 1 : return_call_indirect is_odd(n - 1) by table
+///   is_odd(n): n == 0 ? 0 : return_call is_even(n - 1)
+///   wrap(x): return_call add3(x, 10, 100), with 3 more locals than add3
+///   nested(n): push 5, then return_call count(n, 0) inside a block
+std::array<SSVM::Byte, 210> TailCallWasm = {
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x13, 0x03, 0x60,
+      0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x60, 0x01, 0x7f, 0x01, 0x7f, 0x60, 0x03,
+      0x7f, 0x7f, 0x7f, 0x01, 0x7f, 0x03, 0x07, 0x06, 0x00, 0x01, 0x01, 0x02,
+      0x01, 0x01, 0x04, 0x04, 0x01, 0x70, 0x00, 0x02, 0x07, 0x2c, 0x05, 0x05,
+      0x63, 0x6f, 0x75, 0x6e, 0x74, 0x00, 0x00, 0x07, 0x69, 0x73, 0x5f, 0x65,
+      0x76, 0x65, 0x6e, 0x00, 0x01, 0x06, 0x69, 0x73, 0x5f, 0x6f, 0x64, 0x64,
+      0x00, 0x02, 0x04, 0x77, 0x72, 0x61, 0x70, 0x00, 0x04, 0x06, 0x6e, 0x65,
+      0x73, 0x74, 0x65, 0x64, 0x00, 0x05, 0x09, 0x08, 0x01, 0x00, 0x41, 0x00,
+      0x0b, 0x02, 0x01, 0x02, 0x0a, 0x6c, 0x06, 0x17, 0x00, 0x20, 0x00, 0x45,
+      0x04, 0x7f, 0x20, 0x01, 0x05, 0x20, 0x00, 0x41, 0x01, 0x6b, 0x20, 0x01,
+      0x41, 0x01, 0x6a, 0x12, 0x00, 0x0b, 0x0b, 0x15, 0x00, 0x20, 0x00, 0x45,
+      0x04, 0x7f, 0x41, 0x01, 0x05, 0x20, 0x00, 0x41, 0x01, 0x6b, 0x41, 0x01,
+      0x13, 0x01, 0x00, 0x0b, 0x0b, 0x12, 0x00, 0x20, 0x00, 0x45, 0x04, 0x7f,
+      0x41, 0x00, 0x05, 0x20, 0x00, 0x41, 0x01, 0x6b, 0x12, 0x01, 0x0b, 0x0b,
+      0x0a, 0x00, 0x20, 0x00, 0x20, 0x01, 0x6a, 0x20, 0x02, 0x6a, 0x0b, 0x0d,
+      0x01, 0x03, 0x7f, 0x20, 0x00, 0x41, 0x0a, 0x41, 0xe4, 0x00, 0x12, 0x03,
+      0x0b, 0x10, 0x00, 0x41, 0x05, 0x02, 0x40, 0x20, 0x00, 0x41, 0x00, 0x12,
+      0x00, 0x0b, 0x1a, 0x41, 0x00, 0x0b,
+};
+
+/// Module with "bad" (i32) -> i64 tail calling a function returning i32.
+std::array<SSVM::Byte, 53> TailCallMismatchWasm = {
+      0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x0c, 0x02, 0x60,
+      0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x60, 0x01, 0x7f, 0x01, 0x7e, 0x03, 0x03,
+      0x02, 0x00, 0x01, 0x07, 0x07, 0x01, 0x03, 0x62, 0x61, 0x64, 0x00, 0x01,
+      0x0a, 0x0f, 0x02, 0x04, 0x00, 0x20, 0x00, 0x0b, 0x08, 0x00, 0x20, 0x00,
+      0x20, 0x00, 0x12, 0x00, 0x0b,
+};
+
+SSVM::Configure getConf() {
+  SSVM::Configure Conf;
+  Conf.addProposal(SSVM::Proposal::TailCall);
+  return Conf;
+}
+
+TEST(TailCallTest, Load__Proposal) {
+  SSVM::Configure Conf;
+  SSVM::VM::VM VM(Conf);
+  EXPECT_FALSE(VM.loadWasm(TailCallWasm));
+}
+
+TEST(TailCallTest, Validate__ResultMismatch) {
+  SSVM::VM::VM VM(getConf());
+  ASSERT_TRUE(VM.loadWasm(TailCallMismatchWasm));
+  EXPECT_FALSE(VM.validate());
+}
+
+TEST(TailCallTest, Call__Results) {
+  SSVM::VM::VM VM(getConf());
+  ASSERT_TRUE(VM.loadWasm(TailCallWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  auto Check = [&VM](std::string_view Name,
+                     std::vector<SSVM::ValVariant> Args, uint32_t Expected) {
+    auto Res = VM.execute(Name, Args);
+    ASSERT_TRUE(Res);
+    ASSERT_EQ((*Res).size(), 1U);
+    EXPECT_EQ(std::get<uint32_t>((*Res)[0]), Expected);
+  };
+  Check("wrap", {UINT32_C(1)}, 111U);
+  Check("nested", {UINT32_C(7)}, 7U);
+  Check("is_even", {UINT32_C(10)}, 1U);
+  Check("is_odd", {UINT32_C(10)}, 0U);
+}
+
+TEST(TailCallTest, Call__DeepRecursion) {
+  SSVM::VM::VM VM(getConf());
+  ASSERT_TRUE(VM.loadWasm(TailCallWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  /// The recursions run in the frame of the first call.
+  constexpr uint32_t Depth = 1U << 20;
+  std::vector<SSVM::ValVariant> Args1 = {Depth, UINT32_C(0)};
+  auto Res1 = VM.execute("count", Args1);
+  ASSERT_TRUE(Res1);
+  EXPECT_EQ(std::get<uint32_t>((*Res1)[0]), Depth);
+
+  std::vector<SSVM::ValVariant> Args2 = {Depth + 1};
+  auto Res2 = VM.execute("is_even", Args2);
+  ASSERT_TRUE(Res2);
+  EXPECT_EQ(std::get<uint32_t>((*Res2)[0]), 0U);
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  SSVM::Log::setErrorLoggingLevel();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
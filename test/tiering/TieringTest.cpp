@@ -0,0 +1,114 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "common/configure.h"
+#include "common/errcode.h"
+#include "common/value.h"
+#include "interpreter/tiering.h"
+#include "vm/vm.h"
+
+#include "gtest/gtest.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+/// Module of recursive functions:
+///   depth(n): n == 0 ? 0 : depth(n - 1) + 1
+///   forever(): call forever()
+std::array<SSVM::Byte, 75> RecursionWasm = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x09, 0x02, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x60, 0x00, 0x00, 0x03, 0x03, 0x02, 0x00, 0x01,
+    0x07, 0x13, 0x02, 0x05, 0x64, 0x65, 0x70, 0x74, 0x68, 0x00, 0x00, 0x07,
+    0x66, 0x6f, 0x72, 0x65, 0x76, 0x65, 0x72, 0x00, 0x01, 0x0a, 0x1c, 0x02,
+    0x15, 0x00, 0x20, 0x00, 0x45, 0x04, 0x7f, 0x41, 0x00, 0x05, 0x20, 0x00,
+    0x41, 0x01, 0x6b, 0x10, 0x00, 0x41, 0x01, 0x6a, 0x0b, 0x0b, 0x04, 0x00,
+    0x10, 0x01, 0x0b,
+};
+
+/// Module of a loop with the name section:
+///   outer(n): call in;ner(n), exported as spin
+///   in;ner(n): loop n times
+std::array<SSVM::Byte, 80> LoopWasm = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x05, 0x01, 0x60,
+    0x01, 0x7f, 0x00, 0x03, 0x03, 0x02, 0x00, 0x00, 0x07, 0x08, 0x01, 0x04,
+    0x73, 0x70, 0x69, 0x6e, 0x00, 0x00, 0x0a, 0x17, 0x02, 0x06, 0x00, 0x20,
+    0x00, 0x10, 0x01, 0x0b, 0x0e, 0x00, 0x03, 0x40, 0x20, 0x00, 0x41, 0x01,
+    0x6b, 0x22, 0x00, 0x0d, 0x00, 0x0b, 0x0b, 0x00, 0x17, 0x04, 0x6e, 0x61,
+    0x6d, 0x65, 0x01, 0x10, 0x02, 0x00, 0x05, 0x6f, 0x75, 0x74, 0x65, 0x72,
+    0x01, 0x06, 0x69, 0x6e, 0x3b, 0x6e, 0x65, 0x72,
+};
+
+TEST(TieringTest, Call__Threshold) {
+  /// The compilation fails, so the functions keep running in the interpreter.
+  uint32_t Compiles = 0;
+  SSVM::Interpreter::Tiering Tier(
+      [&Compiles](const std::filesystem::path &) -> SSVM::Expect<void> {
+        ++Compiles;
+        return SSVM::Unexpect(SSVM::ErrCode::InvalidPath);
+      },
+      10);
+  SSVM::Configure Conf;
+  SSVM::VM::VM VM(Conf);
+  VM.setTiering(&Tier);
+  ASSERT_TRUE(VM.loadWasm(RecursionWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  /// depth(5) calls depth() 6 times.
+  std::vector<SSVM::ValVariant> Args = {UINT32_C(5)};
+  auto Res1 = VM.execute("depth", Args);
+  ASSERT_TRUE(Res1);
+  EXPECT_EQ(std::get<uint32_t>((*Res1)[0]), 5U);
+  Tier.wait();
+  EXPECT_EQ(Compiles, 0U);
+
+  auto Res2 = VM.execute("depth", Args);
+  ASSERT_TRUE(Res2);
+  EXPECT_EQ(std::get<uint32_t>((*Res2)[0]), 5U);
+  Tier.wait();
+  EXPECT_EQ(Compiles, 1U);
+  EXPECT_TRUE(Tier.isFailed());
+
+  /// The failed compilation is not retried.
+  auto Res3 = VM.execute("depth", Args);
+  ASSERT_TRUE(Res3);
+  EXPECT_EQ(std::get<uint32_t>((*Res3)[0]), 5U);
+  Tier.wait();
+  EXPECT_EQ(Compiles, 1U);
+}
+
+TEST(TieringTest, Loop__BackEdges) {
+  uint32_t Compiles = 0;
+  SSVM::Interpreter::Tiering Tier(
+      [&Compiles](const std::filesystem::path &) -> SSVM::Expect<void> {
+        ++Compiles;
+        return SSVM::Unexpect(SSVM::ErrCode::InvalidPath);
+      },
+      100);
+  SSVM::Configure Conf;
+  SSVM::VM::VM VM(Conf);
+  VM.setTiering(&Tier);
+  ASSERT_TRUE(VM.loadWasm(LoopWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  /// Each function is called once, and the loop iterations start compiling.
+  std::vector<SSVM::ValVariant> Args = {UINT32_C(50)};
+  ASSERT_TRUE(VM.execute("spin", Args));
+  Tier.wait();
+  EXPECT_EQ(Compiles, 0U);
+
+  Args = {UINT32_C(200)};
+  ASSERT_TRUE(VM.execute("spin", Args));
+  Tier.wait();
+  EXPECT_EQ(Compiles, 1U);
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  SSVM::Log::setErrorLoggingLevel();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
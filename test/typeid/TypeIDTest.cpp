@@ -0,0 +1,84 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "common/configure.h"
+#include "common/value.h"
+#include "runtime/instance/type.h"
+#include "vm/vm.h"
+
+#include "gtest/gtest.h"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace {
+
+/// Provider module exporting the table of [add, neg]:
+///   add(a, b): a + b, which is (i32, i32) -> i32
+///   neg(x): 0 - x, which is (i32) -> i32
+/// Consumer module importing the table as "provider" "tab", with the types
+/// declared in another order:
+///   add(a, b): call_indirect (i32, i32) -> i32 on table[0]
+///   neg(x): call_indirect (i32) -> i32 on table[1]
+///   bad(a, b): call_indirect (i32, i32) -> i32 on table[1]
+std::array<SSVM::Byte, 71> ProviderWasm = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x0c, 0x02, 0x60,
+    0x01, 0x7f, 0x01, 0x7f, 0x60, 0x02, 0x7f, 0x7f, 0x01, 0x7f, 0x03, 0x03,
+    0x02, 0x01, 0x00, 0x04, 0x04, 0x01, 0x70, 0x00, 0x02, 0x07, 0x07, 0x01,
+    0x03, 0x74, 0x61, 0x62, 0x01, 0x00, 0x09, 0x08, 0x01, 0x00, 0x41, 0x00,
+    0x0b, 0x02, 0x00, 0x01, 0x0a, 0x11, 0x02, 0x07, 0x00, 0x20, 0x00, 0x20,
+    0x01, 0x6a, 0x0b, 0x07, 0x00, 0x41, 0x00, 0x20, 0x00, 0x6b, 0x0b,
+};
+std::array<SSVM::Byte, 109> ConsumerWasm = {
+    0x00, 0x61, 0x73, 0x6d, 0x01, 0x00, 0x00, 0x00, 0x01, 0x0f, 0x03, 0x60,
+    0x00, 0x00, 0x60, 0x01, 0x7f, 0x01, 0x7f, 0x60, 0x02, 0x7f, 0x7f, 0x01,
+    0x7f, 0x02, 0x12, 0x01, 0x08, 0x70, 0x72, 0x6f, 0x76, 0x69, 0x64, 0x65,
+    0x72, 0x03, 0x74, 0x61, 0x62, 0x01, 0x70, 0x00, 0x02, 0x03, 0x04, 0x03,
+    0x02, 0x01, 0x02, 0x07, 0x13, 0x03, 0x03, 0x61, 0x64, 0x64, 0x00, 0x00,
+    0x03, 0x6e, 0x65, 0x67, 0x00, 0x01, 0x03, 0x62, 0x61, 0x64, 0x00, 0x02,
+    0x0a, 0x23, 0x03, 0x0b, 0x00, 0x20, 0x00, 0x20, 0x01, 0x41, 0x00, 0x11,
+    0x02, 0x00, 0x0b, 0x09, 0x00, 0x20, 0x00, 0x41, 0x01, 0x11, 0x01, 0x00,
+    0x0b, 0x0b, 0x00, 0x20, 0x00, 0x20, 0x01, 0x41, 0x01, 0x11, 0x02, 0x00,
+    0x0b,
+};
+
+TEST(TypeIDTest, Canonical__Signature) {
+  using SSVM::Runtime::Instance::getCanonicalTypeID;
+  const std::array<SSVM::ValType, 2> I32I32 = {SSVM::ValType::I32,
+                                               SSVM::ValType::I32};
+  const std::array<SSVM::ValType, 1> I32 = {SSVM::ValType::I32};
+  const auto ID = getCanonicalTypeID(I32I32, I32);
+  EXPECT_EQ(getCanonicalTypeID(I32I32, I32), ID);
+  EXPECT_NE(getCanonicalTypeID(I32, I32I32), ID);
+  EXPECT_NE(getCanonicalTypeID(I32, I32), ID);
+  EXPECT_NE(getCanonicalTypeID({}, {}), ID);
+}
+
+TEST(TypeIDTest, CallIndirect__CrossModule) {
+  SSVM::Configure Conf;
+  SSVM::VM::VM VM(Conf);
+  ASSERT_TRUE(VM.registerModule("provider", ProviderWasm));
+  ASSERT_TRUE(VM.loadWasm(ConsumerWasm));
+  ASSERT_TRUE(VM.validate());
+  ASSERT_TRUE(VM.instantiate());
+
+  /// The structurally equal types of the two modules match.
+  auto Res = VM.execute("add", std::vector<SSVM::ValVariant>{3U, 4U});
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(std::get<uint32_t>((*Res)[0]), 7U);
+  Res = VM.execute("neg", std::vector<SSVM::ValVariant>{5U});
+  ASSERT_TRUE(Res);
+  EXPECT_EQ(std::get<uint32_t>((*Res)[0]), uint32_t(-5));
+
+  /// The different types trap.
+  Res = VM.execute("bad", std::vector<SSVM::ValVariant>{3U, 4U});
+  ASSERT_FALSE(Res);
+  EXPECT_EQ(Res.error(), SSVM::ErrCode::IndirectCallTypeMismatch);
+}
+
+} // namespace
+
+GTEST_API_ int main(int argc, char **argv) {
+  SSVM::Log::setErrorLoggingLevel();
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,124 @@
+// SPDX-License-Identifier: Apache-2.0
+#include "common/astdef.h"
+#include "common/configure.h"
+#include "common/filesystem.h"
+#include "common/version.h"
+#include "loader/loader.h"
+#include "po/argument_parser.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <vector>
+
+namespace {
+
+/// Control instructions end a sequence. Execution may enter the instruction
+/// after them, so they can only be the last one of a superinstruction.
+bool isControl(const SSVM::OpCode Code) {
+  return static_cast<uint16_t>(Code) <= 0x11U;
+}
+
+} // namespace
+
+int main(int Argc, const char *Argv[]) {
+  namespace PO = SSVM::PO;
+  using namespace std::literals;
+
+  std::ios::sync_with_stdio(false);
+  SSVM::Log::setErrorLoggingLevel();
+
+  PO::List<std::string> WasmNames(PO::Description("Wasm files"sv),
+                                  PO::MetaVar("WASM"sv));
+  PO::Option<int> MaxLength(
+      PO::Description(
+          "Count the sequences of 2 to N instructions. Default is 4."sv),
+      PO::MetaVar("N"sv));
+  PO::Option<int> Top(
+      PO::Description("Print the COUNT most frequent sequences per length. "
+                      "Default is 20."sv),
+      PO::MetaVar("COUNT"sv));
+
+  auto Parser = PO::ArgumentParser();
+  if (!Parser.add_option(WasmNames)
+           .add_option("length"sv, MaxLength)
+           .add_option("top"sv, Top)
+           .parse(Argc, Argv)) {
+    return EXIT_FAILURE;
+  }
+  if (Parser.isVersion()) {
+    std::cout << Argv[0] << " version "sv << SSVM::kVersionString << '\n';
+    return EXIT_SUCCESS;
+  }
+  const int MaxLenArg = MaxLength.value() ? MaxLength.value() : 4;
+  const int TopArg = Top.value() ? Top.value() : 20;
+  if (MaxLenArg < 2) {
+    std::cout << "Sequence length should be at least 2."sv << std::endl;
+    return EXIT_FAILURE;
+  }
+
+  /// Accept the modules of all proposals in the corpus.
+  SSVM::Configure Conf;
+  Conf.addProposal(SSVM::Proposal::BulkMemoryOperations);
+  Conf.addProposal(SSVM::Proposal::ReferenceTypes);
+  Conf.addProposal(SSVM::Proposal::SIMD);
+  Conf.addProposal(SSVM::Proposal::TailCall);
+  SSVM::Loader::Loader Loader(Conf);
+
+  const size_t MaxLen = static_cast<size_t>(MaxLenArg);
+  std::vector<std::map<std::vector<SSVM::OpCode>, uint64_t>> Counts(MaxLen + 1);
+  uint64_t Total = 0;
+  for (const auto &Name : WasmNames.value()) {
+    auto Res = Loader.parseModule(std::filesystem::absolute(Name));
+    if (!Res) {
+      const auto Err = static_cast<uint32_t>(Res.error());
+      std::cout << Name << ": Load failed. Error code:" << Err << std::endl;
+      return EXIT_FAILURE;
+    }
+    for (const auto &CodeSeg : (*Res)->getCodeSection().getContent()) {
+      auto Instrs = CodeSeg.getInstrs();
+      Total += Instrs.size();
+      for (size_t I = 0; I < Instrs.size(); ++I) {
+        std::vector<SSVM::OpCode> Seq;
+        for (size_t J = I; J < Instrs.size() && Seq.size() < MaxLen; ++J) {
+          Seq.push_back(Instrs[J].getOpCode());
+          if (Seq.size() >= 2) {
+            ++Counts[Seq.size()][Seq];
+          }
+          if (isControl(Instrs[J].getOpCode())) {
+            break;
+          }
+        }
+      }
+    }
+  }
+
+  std::cout << "Total instructions: "sv << Total << '\n';
+  for (size_t Len = 2; Len <= MaxLen; ++Len) {
+    std::vector<std::pair<uint64_t, const std::vector<SSVM::OpCode> *>> Sorted;
+    Sorted.reserve(Counts[Len].size());
+    for (const auto &[Seq, Cnt] : Counts[Len]) {
+      Sorted.emplace_back(Cnt, &Seq);
+    }
+    const size_t Num =
+        std::min(Sorted.size(), static_cast<size_t>(std::max(TopArg, 0)));
+    std::partial_sort(
+        Sorted.begin(), Sorted.begin() + Num, Sorted.end(),
+        [](const auto &L, const auto &R) { return L.first > R.first; });
+
+    std::cout << "\nLength "sv << Len << ":\n"sv;
+    for (size_t I = 0; I < Num; ++I) {
+      const auto &[Cnt, Seq] = Sorted[I];
+      std::cout << std::setw(12) << Cnt << "  "sv << std::fixed
+                << std::setprecision(2) << std::setw(6)
+                << (Total ? 100.0 * Cnt / Total : 0.0) << "%  "sv;
+      for (size_t J = 0; J < Seq->size(); ++J) {
+        std::cout << (J ? "; "sv : ""sv) << SSVM::OpCodeStr[(*Seq)[J]];
+      }
+      std::cout << '\n';
+    }
+  }
+  return EXIT_SUCCESS;
+}
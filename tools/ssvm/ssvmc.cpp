@@ -6,6 +6,7 @@
 #include "loader/loader.h"
 #include "po/argument_parser.h"
 #include "validator/validator.h"
+#include <algorithm>
 #include <iostream>
 
 int main(int Argc, const char *Argv[]) {
@@ -29,11 +30,20 @@ int main(int Argc, const char *Argv[]) {
   PO::Option<PO::Toggle> GasMeasuring(PO::Description(
       "Generate code for counting gas burned during execution."sv));
 
+  PO::Option<PO::Toggle> BoundsChecking(PO::Description(
+      "Generate code for checking the memory bounds instead of relying on the guard pages, so the memory is allocated at its actual size."sv));
+
+  PO::List<int> Jobs(
+      PO::Description(
+          "Optimize and generate the code of the module in parallel by the number of threads. Defaults to 1."sv),
+      PO::MetaVar("N"sv));
+
   PO::Option<PO::Toggle> BulkMemoryOperations(
       PO::Description("Enable Bulk-memory operations"sv));
   PO::Option<PO::Toggle> ReferenceTypes(
       PO::Description("Enable Reference types (externref)"sv));
   PO::Option<PO::Toggle> SIMD(PO::Description("Enable SIMD"sv));
+  PO::Option<PO::Toggle> TailCall(PO::Description("Enable Tail call"sv));
   PO::Option<PO::Toggle> All(PO::Description("Enable all features"sv));
 
   auto Parser = PO::ArgumentParser();
@@ -42,9 +52,12 @@ int main(int Argc, const char *Argv[]) {
            .add_option("dump"sv, DumpIR)
            .add_option("ic"sv, InstructionCounting)
            .add_option("gas"sv, GasMeasuring)
+           .add_option("bounds-check"sv, BoundsChecking)
+           .add_option("jobs"sv, Jobs)
            .add_option("enable-bulk-memory"sv, BulkMemoryOperations)
            .add_option("enable-reference-types"sv, ReferenceTypes)
            .add_option("enable-simd"sv, SIMD)
+           .add_option("enable-tail-call"sv, TailCall)
            .add_option("enable-all"sv, All)
            .parse(Argc, Argv)) {
     return EXIT_FAILURE;
@@ -64,10 +77,14 @@ int main(int Argc, const char *Argv[]) {
   if (SIMD.value()) {
     Conf.addProposal(SSVM::Proposal::SIMD);
   }
+  if (TailCall.value()) {
+    Conf.addProposal(SSVM::Proposal::TailCall);
+  }
   if (All.value()) {
     Conf.addProposal(SSVM::Proposal::BulkMemoryOperations);
     Conf.addProposal(SSVM::Proposal::ReferenceTypes);
     Conf.addProposal(SSVM::Proposal::SIMD);
+    Conf.addProposal(SSVM::Proposal::TailCall);
   }
 
   std::filesystem::path InputPath = std::filesystem::absolute(WasmName.value());
@@ -112,6 +129,12 @@ int main(int Argc, const char *Argv[]) {
     if (GasMeasuring.value()) {
       Compiler.setGasMeasuring();
     }
+    if (BoundsChecking.value()) {
+      Compiler.setBoundsChecking();
+    }
+    if (Jobs.value().size() > 0) {
+      Compiler.setJobs(static_cast<uint32_t>(std::max(Jobs.value().back(), 1)));
+    }
     if (auto Res = Compiler.compile(Data, *Module, OutputPath); !Res) {
       const auto Err = static_cast<uint32_t>(Res.error());
       std::cout << "Compile failed. Error code:" << Err << std::endl;
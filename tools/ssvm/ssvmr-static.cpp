@@ -27,6 +27,7 @@ int main(int Argc, const char *Argv[], const char *Env[]) {
   Conf.addProposal(SSVM::Proposal::BulkMemoryOperations);
   Conf.addProposal(SSVM::Proposal::ReferenceTypes);
   Conf.addProposal(SSVM::Proposal::SIMD);
+  Conf.addProposal(SSVM::Proposal::TailCall);
   SSVM::VM::VM VM(Conf);
 
   SSVM::Host::WasiModule *WasiMod = dynamic_cast<SSVM::Host::WasiModule *>(
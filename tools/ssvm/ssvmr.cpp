@@ -5,11 +5,23 @@
 #include "common/version.h"
 #include "host/ssvm_process/processmodule.h"
 #include "host/wasi/wasimodule.h"
+#include "loader/ldmgr.h"
+#include "loader/loader.h"
 #include "po/argument_parser.h"
+#include "vm/preinit.h"
 #include "vm/vm.h"
+#if SSVM_ENABLE_TIERING
+#include "aot/compiler.h"
+#include "validator/validator.h"
+#endif
 
+#include <algorithm>
 #include <cstdlib>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
 
 int main(int Argc, const char *Argv[]) {
   namespace PO = SSVM::PO;
@@ -25,6 +37,10 @@ int main(int Argc, const char *Argv[]) {
 
   PO::Option<PO::Toggle> Reactor(PO::Description(
       "Enable reactor mode. Reactor mode calls `_initialize` if exported."));
+  PO::List<std::string> PreInit(
+      PO::Description(
+          "Call `_initialize` if exported, and write the Wasm file which starts from the initialized memory and globals without `_initialize`, instead of running a function. The written file can be compiled by ssvmc."sv),
+      PO::MetaVar("WASM_FILE"sv));
 
   PO::List<std::string> Dir(
       PO::Description(
@@ -44,6 +60,7 @@ int main(int Argc, const char *Argv[]) {
   PO::Option<PO::Toggle> ReferenceTypes(
       PO::Description("Enable Reference types (externref)"sv));
   PO::Option<PO::Toggle> SIMD(PO::Description("Enable SIMD"sv));
+  PO::Option<PO::Toggle> TailCall(PO::Description("Enable Tail call"sv));
   PO::Option<PO::Toggle> All(PO::Description("Enable all features"sv));
 
   PO::List<int> MemLim(
@@ -51,6 +68,11 @@ int main(int Argc, const char *Argv[]) {
           "Limitation of pages(as size of 64 KiB) in every memory instance. Upper bound can be specified as --memory-page-limit `PAGE_COUNT`."sv),
       PO::MetaVar("PAGE_COUNT"sv));
 
+  PO::List<int> CallDepthLim(
+      PO::Description(
+          "Limitation of the nested function calls. Upper bound can be specified as --call-depth-limit `DEPTH`."sv),
+      PO::MetaVar("DEPTH"sv));
+
   PO::List<std::string> AllowCmd(
       PO::Description(
           "Allow commands called from ssvm_process host functions. Each command can be specified as --allow-command `COMMAND`."sv),
@@ -58,19 +80,81 @@ int main(int Argc, const char *Argv[]) {
   PO::Option<PO::Toggle> AllowCmdAll(PO::Description(
       "Allow all commands called from ssvm_process host functions."sv));
 
+  PO::Option<PO::Toggle> RegisterTier(PO::Description(
+      "Run functions on the register-based interpreter tier."sv));
+  PO::Option<PO::Toggle> GuardPageCheck(PO::Description(
+      "Trap interpreted out of bounds memory accesses by the guard pages instead of explicit checks."sv));
+
+  PO::Option<PO::Toggle> JIT(PO::Description(
+      "Compile the module in the memory by the JIT before running it."sv));
+  PO::Option<PO::Toggle> LazyJIT(PO::Description(
+      "Compile the functions by the JIT on their first calls. Implies --jit."sv));
+  PO::List<std::string> AOTCache(
+      PO::Description(
+          "Load the AOT compiled Wasm files from the cache directory, and compile them into the cache on a miss."sv),
+      PO::MetaVar("CACHE_DIR"sv));
+  PO::List<int> AOTCacheSize(
+      PO::Description(
+          "Size limit of --aot-cache in MiB, over which the least recently used libraries are removed. Defaults to 1024."sv),
+      PO::MetaVar("MIB"sv));
+
+  PO::Option<PO::Toggle> InstrCount(PO::Description(
+      "Enable counting the executed instructions."sv));
+  PO::Option<PO::Toggle> GasMeasuring(PO::Description(
+      "Enable measuring the gas costs of the executed instructions."sv));
+  PO::Option<PO::Toggle> TimeMeasuring(PO::Description(
+      "Enable measuring the execution time of Wasm and host functions."sv));
+
+  PO::List<std::string> ProfileOut(
+      PO::Description(
+          "Record the execution counts of opcodes and the calls, instructions and time of functions, and write them to the file. The file is written in CSV if its name ends with `.csv`, or in JSON otherwise."sv),
+      PO::MetaVar("PROFILE_FILE"sv));
+  PO::List<std::string> SampleOut(
+      PO::Description(
+          "Sample the call stacks of the Wasm functions by the CPU time, and write them to the file as folded stacks."sv),
+      PO::MetaVar("FOLDED_FILE"sv));
+  PO::List<int> SampleRate(
+      PO::Description(
+          "Sampling frequency of --sample-profile in Hz. Defaults to 1000."sv),
+      PO::MetaVar("HZ"sv));
+
+  PO::Option<PO::Toggle> Tiering(PO::Description(
+      "Start the functions in the interpreter, and switch the hot ones to the code compiled in the background."sv));
+  PO::List<int> TieringThreshold(
+      PO::Description(
+          "Calls and loop iterations of a function to switch it to the compiled code by --tiering. Defaults to 1000."sv),
+      PO::MetaVar("COUNT"sv));
+
   auto Parser = PO::ArgumentParser();
   if (!Parser.add_option(SoName)
            .add_option(Args)
            .add_option("reactor"sv, Reactor)
+           .add_option("pre-initialize"sv, PreInit)
            .add_option("dir"sv, Dir)
            .add_option("env"sv, Env)
            .add_option("enable-bulk-memory"sv, BulkMemoryOperations)
            .add_option("enable-reference-types"sv, ReferenceTypes)
            .add_option("enable-simd"sv, SIMD)
+           .add_option("enable-tail-call"sv, TailCall)
            .add_option("enable-all"sv, All)
            .add_option("memory-page-limit"sv, MemLim)
+           .add_option("call-depth-limit"sv, CallDepthLim)
            .add_option("allow-command"sv, AllowCmd)
            .add_option("allow-command-all"sv, AllowCmdAll)
+           .add_option("register-tier"sv, RegisterTier)
+           .add_option("guard-page-check"sv, GuardPageCheck)
+           .add_option("jit"sv, JIT)
+           .add_option("lazy-jit"sv, LazyJIT)
+           .add_option("aot-cache"sv, AOTCache)
+           .add_option("aot-cache-size"sv, AOTCacheSize)
+           .add_option("enable-instruction-count"sv, InstrCount)
+           .add_option("enable-gas-measuring"sv, GasMeasuring)
+           .add_option("enable-time-measuring"sv, TimeMeasuring)
+           .add_option("profile"sv, ProfileOut)
+           .add_option("sample-profile"sv, SampleOut)
+           .add_option("sample-rate"sv, SampleRate)
+           .add_option("tiering"sv, Tiering)
+           .add_option("tiering-threshold"sv, TieringThreshold)
            .parse(Argc, Argv)) {
     return EXIT_FAILURE;
   }
@@ -89,19 +173,147 @@ int main(int Argc, const char *Argv[]) {
   if (SIMD.value()) {
     Conf.addProposal(SSVM::Proposal::SIMD);
   }
+  if (TailCall.value()) {
+    Conf.addProposal(SSVM::Proposal::TailCall);
+  }
   if (All.value()) {
     Conf.addProposal(SSVM::Proposal::BulkMemoryOperations);
     Conf.addProposal(SSVM::Proposal::ReferenceTypes);
     Conf.addProposal(SSVM::Proposal::SIMD);
+    Conf.addProposal(SSVM::Proposal::TailCall);
   }
   if (MemLim.value().size() > 0) {
     Conf.setMaxMemoryPage(MemLim.value().back());
   }
+  if (CallDepthLim.value().size() > 0) {
+    Conf.setMaxCallDepth(CallDepthLim.value().back());
+  }
+  if (RegisterTier.value()) {
+    Conf.setRegisterTier(true);
+  }
+  if (GuardPageCheck.value()) {
+    Conf.setGuardPageCheck(true);
+  }
+  if (JIT.value() || LazyJIT.value()) {
+    Conf.setJIT(true);
+    Conf.setLazyJIT(LazyJIT.value());
+  }
+  if (AOTCache.value().size() > 0) {
+    Conf.setAOTCache(std::filesystem::absolute(AOTCache.value().back()));
+  }
+  if (AOTCacheSize.value().size() > 0) {
+    Conf.setAOTCacheSize(
+        static_cast<uint64_t>(std::max(AOTCacheSize.value().back(), 0))
+        << 20);
+  }
+  if (InstrCount.value()) {
+    Conf.setInstructionCounting(true);
+  }
+  if (GasMeasuring.value()) {
+    Conf.setCostMeasuring(true);
+  }
+  if (TimeMeasuring.value()) {
+    Conf.setTimeMeasuring(true);
+  }
 
   Conf.addHostRegistration(SSVM::HostRegistration::Wasi);
   Conf.addHostRegistration(SSVM::HostRegistration::SSVM_Process);
   const auto InputPath = std::filesystem::absolute(SoName.value());
   SSVM::VM::VM VM(Conf);
+  if (ProfileOut.value().size() > 0) {
+    VM.getStatistics().setProfiling(true);
+  }
+  std::unique_ptr<SSVM::Interpreter::Sampler> Sampler;
+  if (SampleOut.value().size() > 0) {
+    const int Hz = SampleRate.value().size() > 0 ? SampleRate.value().back()
+                                                 : 1000;
+    Sampler = std::make_unique<SSVM::Interpreter::Sampler>(
+        static_cast<uint32_t>(std::max(Hz, 1)));
+    VM.setSampler(Sampler.get());
+  }
+  std::unique_ptr<SSVM::Interpreter::Tiering> Tier;
+  if (Tiering.value()) {
+#if SSVM_ENABLE_TIERING
+    /// Compile the module by the same configuration as the interpreter.
+    auto Compile = [Conf, InputPath, Profiling = ProfileOut.value().size() > 0](
+                       const std::filesystem::path &OutputPath)
+        -> SSVM::Expect<void> {
+      SSVM::Loader::Loader Loader(Conf);
+      std::vector<SSVM::Byte> Data;
+      if (auto Res = Loader.loadFile(InputPath)) {
+        Data = std::move(*Res);
+      } else {
+        return SSVM::Unexpect(Res);
+      }
+      std::unique_ptr<SSVM::AST::Module> Module;
+      if (auto Res = Loader.parseModule(Data)) {
+        Module = std::move(*Res);
+      } else {
+        return SSVM::Unexpect(Res);
+      }
+      SSVM::Validator::Validator ValidatorEngine(Conf);
+      if (auto Res = ValidatorEngine.validate(*Module); !Res) {
+        return SSVM::Unexpect(Res);
+      }
+      SSVM::AOT::Compiler Compiler;
+      Compiler.setInstructionCounting(Conf.isInstructionCounting() ||
+                                      Profiling);
+      Compiler.setGasMeasuring(Conf.isCostMeasuring());
+      /// The memory is instantiated before compiling, which may be without
+      /// the guard region.
+      Compiler.setBoundsChecking();
+      return Compiler.compile(Data, *Module, OutputPath);
+    };
+    const int Threshold = TieringThreshold.value().size() > 0
+                              ? TieringThreshold.value().back()
+                              : 1000;
+    Tier = std::make_unique<SSVM::Interpreter::Tiering>(
+        std::move(Compile), static_cast<uint32_t>(std::max(Threshold, 1)));
+    VM.setTiering(Tier.get());
+#else
+    std::cerr << "Tiering requires the AOT runtime.\n";
+    return EXIT_FAILURE;
+#endif
+  }
+  auto WriteProfile = [&VM, &ProfileOut, &SampleOut, &Sampler]() {
+    if (ProfileOut.value().empty() && SampleOut.value().empty()) {
+      return;
+    }
+    /// Name the functions of the module by the name section, the exports, or
+    /// the indices.
+    std::vector<std::string> FuncNames;
+    if (auto Res = VM.getStoreManager().getActiveModule()) {
+      const auto *ModInst = *Res;
+      for (uint32_t I = 0; I < ModInst->getFuncNum(); ++I) {
+        const uint32_t Addr = *ModInst->getFuncAddr(I);
+        if (Addr >= FuncNames.size()) {
+          FuncNames.resize(Addr + 1);
+        }
+        FuncNames[Addr] = "func[" + std::to_string(I) + "]";
+      }
+      for (const auto &[Name, Addr] : ModInst->getFuncExports()) {
+        FuncNames[Addr] = Name;
+      }
+      for (uint32_t I = 0; I < ModInst->getFuncNum(); ++I) {
+        if (auto Name = ModInst->getFuncName(I); !Name.empty()) {
+          FuncNames[*ModInst->getFuncAddr(I)] = Name;
+        }
+      }
+    }
+    if (ProfileOut.value().size() > 0) {
+      const auto &Path = ProfileOut.value().back();
+      const auto Format =
+          (Path.size() >= 4 && Path.compare(Path.size() - 4, 4, ".csv"sv) == 0)
+              ? SSVM::Statistics::ProfileFormat::CSV
+              : SSVM::Statistics::ProfileFormat::JSON;
+      std::ofstream OS(Path);
+      VM.getStatistics().dumpProfile(OS, Format, FuncNames);
+    }
+    if (Sampler) {
+      std::ofstream OS(SampleOut.value().back());
+      Sampler->dumpFolded(OS, FuncNames);
+    }
+  };
 
   SSVM::Host::WasiModule *WasiMod = dynamic_cast<SSVM::Host::WasiModule *>(
       VM.getImportModule(SSVM::HostRegistration::Wasi));
@@ -120,9 +332,81 @@ int main(int Argc, const char *Argv[]) {
                          InputPath.filename().replace_extension("wasm"sv),
                          Args.value(), Env.value());
 
-  if (!Reactor.value()) {
+  if (PreInit.value().size() > 0) {
+    // pre-initialization mode
+    using namespace std::literals::string_literals;
+    const auto InitFunc = "_initialize"s;
+    /// The compiled libraries embed the Wasm binary.
+    std::vector<SSVM::Byte> Code;
+    if (InputPath.extension() == ".so"sv) {
+      SSVM::LDMgr LMgr;
+      if (auto Result = LMgr.setPath(InputPath); !Result) {
+        return EXIT_FAILURE;
+      }
+      if (auto Result = LMgr.getWasm()) {
+        Code = std::move(*Result);
+      } else {
+        return EXIT_FAILURE;
+      }
+    } else if (auto Result = SSVM::Loader::Loader(Conf).loadFile(InputPath)) {
+      Code = std::move(*Result);
+    } else {
+      return EXIT_FAILURE;
+    }
+
+    /// The base tables are taken before the start function changes them.
+    auto Stripped = SSVM::VM::removeStart(Code);
+    if (!Stripped) {
+      return EXIT_FAILURE;
+    }
+    if (auto Result = VM.loadWasm(*Stripped); !Result) {
+      return EXIT_FAILURE;
+    }
+    if (auto Result = VM.validate(); !Result) {
+      return EXIT_FAILURE;
+    }
+    if (auto Result = VM.instantiate(); !Result) {
+      return EXIT_FAILURE;
+    }
+    auto Base = VM.snapshot();
+    if (!Base) {
+      return EXIT_FAILURE;
+    }
+    if (auto Result = VM.loadWasm(InputPath.u8string()); !Result) {
+      return EXIT_FAILURE;
+    }
+    if (auto Result = VM.validate(); !Result) {
+      return EXIT_FAILURE;
+    }
+    if (auto Result = VM.instantiate(); !Result) {
+      return EXIT_FAILURE;
+    }
+    for (const auto &Func : VM.getFunctionList()) {
+      if (Func.first == InitFunc) {
+        if (auto Result = VM.execute(InitFunc); !Result) {
+          return EXIT_FAILURE;
+        }
+        break;
+      }
+    }
+    auto Snap = VM.snapshot();
+    if (!Snap) {
+      return EXIT_FAILURE;
+    }
+    WriteProfile();
+    if (auto Result = SSVM::VM::preinitialize(Code, **Base, **Snap, InitFunc)) {
+      std::ofstream OS(PreInit.value().back(), std::ios::binary);
+      OS.write(reinterpret_cast<const char *>(Result->data()),
+               Result->size());
+      return OS ? EXIT_SUCCESS : EXIT_FAILURE;
+    } else {
+      return EXIT_FAILURE;
+    }
+  } else if (!Reactor.value()) {
     // command mode
-    if (auto Result = VM.runWasmFile(InputPath.u8string(), "_start")) {
+    auto Result = VM.runWasmFile(InputPath.u8string(), "_start");
+    WriteProfile();
+    if (Result) {
       return WasiMod->getEnv().getExitCode();
     } else {
       return EXIT_FAILURE;
@@ -202,7 +486,9 @@ int main(int Argc, const char *Argv[]) {
       }
     }
 
-    if (auto Result = VM.execute(FuncName, FuncArgs)) {
+    auto Result = VM.execute(FuncName, FuncArgs);
+    WriteProfile();
+    if (Result) {
       /// Print results.
       for (size_t I = 0; I < FuncType.Returns.size(); ++I) {
         switch (FuncType.Returns[I]) {